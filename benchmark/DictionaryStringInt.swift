@@ -0,0 +1,27 @@
+// Inserting and finding keys in a DictionaryStringInt, as in
+// test/DictionaryStringInt.swift.
+
+var NUM = 1000
+var keys = new String[NUM]
+for i in 0..NUM {
+  keys[i] = "key" + String(i)
+}
+
+var sum = 0
+
+func runDictionaryStringInt() {
+  var d = DictionaryStringInt(2 * NUM + 1)
+  for i in 0..NUM {
+    d.add(keys[i], i)
+  }
+  sum = 0
+  for i in 0..NUM {
+    var t : (found : Bool, i : Int) = d.find(keys[i])
+    if t.found {
+      sum = sum + t.i
+    }
+  }
+}
+
+benchmark("DictionaryStringInt", runDictionaryStringInt)
+assert(sum == NUM * (NUM - 1) / 2)
@@ -0,0 +1,76 @@
+//===--- DynamicCast.cpp - Class cast benchmark ---------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Casts an instance of the most-derived class of a deep hierarchy to the
+// root class, which is the worst case for walking the superclass chain,
+// once with the chain alone and once with ancestor displays.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Benchmark.h"
+#include "../runtime/Metadata.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace swift;
+
+/// A chain of fake class metadata, each a subclass of the one before it.
+static const unsigned ChainDepth = 32;
+static ClassMetadata Chain[ChainDepth];
+static const ClassMetadata *ChainDisplay[ChainDepth];
+
+/// A fake heap object: just the isa pointer.
+struct FakeObject {
+  const ClassMetadata *isa;
+};
+
+/// Fill out the chain, with or without ancestor displays.  Every class
+/// in the chain can share one display, since the ancestor at a given
+/// depth is the same for all of them.
+static void buildChain(bool withDisplay) {
+  for (unsigned i = 0; i != ChainDepth; ++i) {
+    ClassMetadata &cls = Chain[i];
+    cls.Kind = MetadataKind::Class;
+    cls.ValueWitnesses = &_TWVBo;
+    cls.destroy = nullptr;
+    cls.getSize = nullptr;
+    cls.Description = nullptr;
+    cls.SuperClass = i ? &Chain[i-1] : nullptr;
+    cls.Depth = i;
+    cls.Ancestors = withDisplay ? ChainDisplay : nullptr;
+    ChainDisplay[i] = &cls;
+  }
+}
+
+static void benchmarkDeepCast(const char *name) {
+  FakeObject leaf = { &Chain[ChainDepth-1] };
+  // Keep the compiler from hoisting the cast out of the loop.
+  FakeObject * volatile object = &leaf;
+
+  unsigned numFailed = 0;
+  benchmark(name, [&] {
+    numFailed += swift_dynamicCast(object, &Chain[0]) == nullptr;
+  });
+
+  if (numFailed) {
+    fprintf(stderr, "%s: %u casts failed\n", name, numFailed);
+    exit(1);
+  }
+}
+
+int main() {
+  buildChain(false);
+  benchmarkDeepCast("DynamicCastDeepChain");
+  buildChain(true);
+  benchmarkDeepCast("DynamicCastDeepDisplay");
+  return 0;
+}
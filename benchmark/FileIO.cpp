@@ -0,0 +1,70 @@
+//===--- FileIO.cpp - Buffered line reading benchmark ---------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Splits a log-like file into lines with the runtime's buffered reader,
+// and character by character with fgetc for reference.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Benchmark.h"
+#include "../runtime/FileIO.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+using namespace swift;
+
+int main() {
+  std::string contents;
+  for (unsigned i = 0; i != 50000; ++i)
+    contents += "GET /index.html HTTP/1.1 200 " + std::to_string(i) + "\n";
+
+  char path[64];
+  strcpy(path, "/tmp/swift-benchmark-fileio-XXXXXX");
+  int fd = mkstemp(path);
+  if (fd < 0 || write(fd, contents.data(), contents.size()) !=
+                  ssize_t(contents.size())) {
+    perror("FileIO: can't write the input file");
+    return 1;
+  }
+  close(fd);
+
+  size_t stdioBytes = 0;
+  benchmark("ReadLinesFgetc", [&] {
+    stdioBytes = 0;
+    FILE *stream = fopen(path, "r");
+    int c;
+    while ((c = fgetc(stream)) != EOF)
+      stdioBytes += c != '\n';
+    fclose(stream);
+  });
+
+  size_t readerBytes = 0;
+  benchmark("ReadLines", [&] {
+    readerBytes = 0;
+    BufferedReader *reader = swift_reader_open(path);
+    int64_t length;
+    while ((length = swift_reader_nextLine(reader, '\n')) >= 0)
+      readerBytes += length;
+    swift_reader_close(reader);
+  });
+
+  unlink(path);
+  if (stdioBytes != readerBytes) {
+    fprintf(stderr, "ReadLines: read %zu bytes, but fgetc read %zu\n",
+            readerBytes, stdioBytes);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+//===--- Formatting.cpp - Number formatting benchmark ---------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Formats random integers and doubles with the runtime, and with snprintf
+// for reference.  Integers are spread over every magnitude; doubles print
+// as the shortest string that round-trips, against "%.17g".
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Benchmark.h"
+#include "../runtime/Formatting.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace swift;
+
+/// Time formatting the given values, one per iteration, round robin.
+template <typename T, typename Fn>
+static void benchmarkFormatting(const char *name, const std::vector<T> &values,
+                                Fn format) {
+  char buffer[64];
+  size_t next = 0;
+  // Keep the compiler from discarding the formatted strings.
+  volatile size_t totalLength = 0;
+  benchmark(name, [&] {
+    totalLength += format(buffer, values[next]);
+    if (++next == values.size())
+      next = 0;
+  });
+}
+
+int main() {
+  const unsigned Count = 4096;
+  std::mt19937_64 random(0);
+
+  std::vector<int64_t> integers;
+  for (unsigned i = 0; i != Count; ++i)
+    integers.push_back(int64_t(random()) >> (random() % 64));
+
+  std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+  std::vector<double> doubles;
+  for (unsigned i = 0; i != Count; ++i)
+    doubles.push_back(distribution(random));
+
+  benchmarkFormatting("FormatInt64", integers,
+    [](char *buffer, int64_t value) -> size_t {
+      return swift_int64ToString(buffer, 64, value, 10);
+    });
+  benchmarkFormatting("FormatInt64Snprintf", integers,
+    [](char *buffer, int64_t value) -> size_t {
+      return snprintf(buffer, 64, "%lld", (long long) value);
+    });
+  benchmarkFormatting("FormatDouble", doubles,
+    [](char *buffer, double value) -> size_t {
+      return swift_doubleToString(buffer, 64, value);
+    });
+  benchmarkFormatting("FormatDoubleSnprintf", doubles,
+    [](char *buffer, double value) -> size_t {
+      return snprintf(buffer, 64, "%.17g", value);
+    });
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Escape-time iteration counts for the Mandelbrot set and the Burning Ship
+// fractal, from the program in test/Interpreter/fractal.swift.  The counts
+// are summed rather than printed.
+
+struct Complex {
+  Real : Double,
+  Imaginary : Double
+  func magnitude() -> Double {
+    return Real * Real + Imaginary * Imaginary
+  }
+}
+
+func [infix_left=200] * (lhs : Complex, rhs : Complex) -> Complex {
+  return Complex(lhs.Real * rhs.Real - lhs.Imaginary * rhs.Imaginary,
+                 lhs.Real * rhs.Imaginary + lhs.Imaginary * rhs.Real)
+}
+func [infix_left=190] + (lhs: Complex, rhs: Complex) -> Complex {
+  return Complex(lhs.Real + rhs.Real, lhs.Imaginary + rhs.Imaginary)
+}
+
+func absolute(x:Double) -> Double {
+  if (x >= 0.0) { return x }
+  return x * -1.0;
+}
+
+func getMandelbrotIterations(c:Complex, maxIterations:Int) -> Int {
+  var n : Int
+  var z : Complex
+  while (n < maxIterations && z.magnitude() < 4.0) {
+    z = z*z + c
+    n = n + 1
+  }
+  return n
+}
+
+func getBurningShipIterations(c:Complex, maxIterations:Int) -> Int {
+  var n : Int
+  var z : Complex
+  while (n < maxIterations && z.magnitude() < 4.0) {
+    var zTmp = Complex(absolute(z.Real), absolute(z.Imaginary))
+    z = zTmp*zTmp + c
+    n = n + 1
+  }
+  return n
+}
+
+func fractal(densityFunc:(c:Complex, maxIterations:Int) -> Int,
+             xMin:Double, xMax:Double,
+             yMin:Double, yMax:Double,
+             rows:Int, cols:Int,
+             maxIterations:Int) -> Int {
+  var dX = (xMax - xMin) / Double(rows)
+  var dY = (yMax - yMin) / Double(cols)
+  var total = 0
+  var row : Double
+  var col : Double
+  for (row = xMin; row < xMax; row = row + dX) {
+    for (col = yMin; col < yMax; col = col + dY) {
+      var c = Complex(col, row)
+      total = total + densityFunc(c, maxIterations)
+    }
+  }
+  return total
+}
+
+var mandelbrotTotal = 0
+var burningShipTotal = 0
+
+func runFractal() {
+  mandelbrotTotal = fractal(getMandelbrotIterations,
+                            -1.35, 1.4, -2.0, 1.05, 40, 80, 200)
+  burningShipTotal = fractal(getBurningShipIterations,
+                             -2.0, 1.2, -2.1, 1.2, 40, 80, 200)
+}
+
+benchmark("Fractal", runFractal)
+assert(mandelbrotTotal == 130240 && burningShipTotal == 123300)
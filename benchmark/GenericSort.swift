@@ -0,0 +1,20 @@
+// Sorting integers with the generic sort in the standard library.
+
+var NUM = 300
+var numbers = new Int[NUM]
+var seed = 42
+for i in 0..NUM {
+  seed = (seed * 3877 + 29573) % 139968
+  numbers[i] = seed
+}
+
+var sorted = new Int[0]
+
+func runGenericSort() {
+  sorted = sort(numbers)
+}
+
+benchmark("GenericSort", runGenericSort)
+for i in 1..NUM {
+  assert(sorted[i-1] <= sorted[i])
+}
@@ -0,0 +1,64 @@
+// Membership in the Mandelbrot set on an 80x50 grid, from the program in
+// test/Interpreter/mandelbrot.swift.  The points are counted rather than
+// printed.
+
+struct Complex {
+  Real : Double,
+  Imaginary : Double
+  static func zero() -> Complex {
+    return Complex(0.0, 0.0)
+  }
+  func add(x:Complex) -> Complex {
+    return Complex(Real + x.Real, Imaginary + x.Imaginary)
+  }
+  func mult(x:Complex) -> Complex {
+    return Complex(Real * x.Real - Imaginary * x.Imaginary,
+                   Real * x.Imaginary + Imaginary * x.Real)
+  }
+  func magnitude() -> Double {
+    return Real * Real + Imaginary * Imaginary
+  }
+}
+
+func inMandelbrotSet(z:Complex, c:Complex, n:Int) -> Bool {
+  while (n > 0) {
+    if (z.magnitude() > 4.0) {
+      return Bool.false;
+    }
+    z = z.mult(z).add(c)
+    n = n - 1
+  }
+  return Bool.true
+}
+
+func mandelbrot(xMin:Double, xMax:Double,
+                yMin:Double, yMax:Double,
+                rows:Int, cols:Int,
+                maxIterations:Int) -> Int {
+  var dX = (xMax - xMin) / Double.fromInt(rows)
+  var dY = (yMax - yMin) / Double.fromInt(cols)
+  var count = 0
+  var row = 0
+  while (row < rows) {
+    row = row + 1
+    var col = 0;
+    while (col < cols) {
+      col = col + 1
+      var c = Complex(xMin + (dX * Double.fromInt(row)),
+                      yMin + (dY * Double.fromInt(col)))
+      if (inMandelbrotSet(Complex.zero(), c, maxIterations)) {
+        ++count
+      }
+    }
+  }
+  return count
+}
+
+var inSet = 0
+
+func runMandelbrot() {
+  inSet = mandelbrot(-1.5, 0.5, -1.0, 1.0, 50, 80, 200)
+}
+
+benchmark("Mandelbrot", runMandelbrot)
+assert(inSet == 1511)
@@ -0,0 +1,53 @@
+// Multiplication of 10x10 integer matrices, from the shootout program in
+// test/Interpreter/shootout_matrix.swift.
+
+func mkmatrix(rows : Int, cols : Int) -> Int[][] {
+  var count = 1
+  var m = new Int[rows][]
+  for i in 0..rows {
+    m[i] = new Int[cols]
+    for j in 0..cols {
+      //FIXME: m[i][j] = count
+      var tmp = m[i]
+      tmp[j] = count
+      ;++count
+    }
+  }
+  return m
+}
+
+func mmult(rows : Int, cols : Int, m1 : Int[][], m2 : Int[][], m3 : Int[][]) {
+  for i in 0..rows {
+    for j in 0..cols {
+      var val = 0
+      for k in 0..cols {
+        // FIXME: val = val + m1[i][k] * m2[k][j]
+        var t1 = m1[i]
+        var t2 = m2[k]
+        val = val + t1[k] * t2[j]
+      }
+
+      // FIXME: m3[i][j] = val
+      var t3 = m3[i]
+      t3[j] = val
+    }
+  }
+}
+
+var SIZE = 10
+
+var m1 = mkmatrix(SIZE, SIZE)
+var m2 = mkmatrix(SIZE, SIZE)
+var mm = mkmatrix(SIZE, SIZE)
+
+func runMatrix() {
+  mmult(SIZE, SIZE, m1, m2, mm)
+}
+
+benchmark("Matrix", runMatrix)
+
+var t1 = mm[0]
+var t2 = mm[2]
+var t3 = mm[3]
+var t4 = mm[4]
+assert(t1[0] == 3355 && t2[3] == 13320 && t3[2] == 17865 && t4[4] == 23575)
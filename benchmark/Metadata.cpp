@@ -0,0 +1,97 @@
+//===--- Metadata.cpp - Generic metadata benchmark ------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Fetches the metadata of one generic type at many different arguments:
+// on first use, as a program with thousands of types does as it starts up;
+// from the runtime once instantiated; and through a lazily-filled cache
+// variable, which is what a metadata access function does.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Benchmark.h"
+#include "../runtime/Metadata.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace swift;
+
+/// A generic type with one argument, which is copied into the first and
+/// last fields of each instantiation.
+struct GenericPattern {
+  GenericMetadata Header;
+  GenericMetadata::FillOp FillOps[2];
+  void *Fields[3];
+};
+
+static GenericPattern Pattern = {
+  { 1, 2, 3 * sizeof(void*), {} },
+  { { 0, 0 }, { 0, 2 } },
+  { nullptr, nullptr, nullptr }
+};
+
+static const unsigned NumTypes = 4096;
+static char Arguments[NumTypes];
+static std::atomic<const Metadata *> Cache[NumTypes];
+
+static const Metadata *fetch(unsigned i) {
+  void *args[] = { &Arguments[i] };
+  return swift_getGenericMetadata(&Pattern.Header, args);
+}
+
+static void check(const char *name, const Metadata *metadata, unsigned i) {
+  if (((void * const *) metadata)[0] != &Arguments[i]) {
+    fprintf(stderr, "%s: wrong metadata for argument %u\n", name, i);
+    exit(1);
+  }
+}
+
+int main() {
+  // Every NumTypes iterations the runtime's cache for the pattern is
+  // dropped (and leaked), so that each fetch instantiates new metadata.
+  unsigned next = 0;
+  benchmark("GenericMetadataFirstUse", [&] {
+    if (next == 0)
+      memset(Pattern.Header.PrivateData, 0,
+             sizeof(Pattern.Header.PrivateData));
+    check("GenericMetadataFirstUse", fetch(next), next);
+    if (++next == NumTypes)
+      next = 0;
+  });
+
+  memset(Pattern.Header.PrivateData, 0, sizeof(Pattern.Header.PrivateData));
+  for (unsigned i = 0; i != NumTypes; ++i)
+    fetch(i);
+
+  next = 0;
+  benchmark("GenericMetadataRuntime", [&] {
+    check("GenericMetadataRuntime", fetch(next), next);
+    if (++next == NumTypes)
+      next = 0;
+  });
+
+  // The access function's fast path: an acquire load of the cache
+  // variable, which a release store fills on first use.
+  next = 0;
+  benchmark("GenericMetadataAccessor", [&] {
+    const Metadata *metadata = Cache[next].load(std::memory_order_acquire);
+    if (!metadata) {
+      metadata = fetch(next);
+      Cache[next].store(metadata, std::memory_order_release);
+    }
+    check("GenericMetadataAccessor", metadata, next);
+    if (++next == NumTypes)
+      next = 0;
+  });
+  return 0;
+}
@@ -0,0 +1,27 @@
+// The sieve of Eratosthenes up to 8192, from the shootout program in
+// test/Interpreter/shootout_sieve.swift.
+
+// FIXME: Array of bool someday.
+var flags = new Int[8193]
+var count = 0
+
+func runSieve() {
+  count = 0
+  for i in 2..8192+1 {
+    flags[i] = 1
+  }
+
+  for i in 2..8192+1 {
+    if (flags[i] == 1) {
+      /* remove all multiples of prime: i */
+      var k = i+i
+      for (; k <= 8192; k = k + i) {
+        flags[k] = 0;
+      }
+      ++count
+    }
+  }
+}
+
+benchmark("Sieve", runSieve)
+assert(count == 1028)
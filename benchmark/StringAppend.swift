@@ -0,0 +1,17 @@
+// Appending short strings, as in test/StringAppend.swift.
+
+var total = 0
+
+func runStringAppend() {
+  total = 0
+  for i in 0..1000 {
+    var str = "Some"
+    str += " "
+    str += "text"
+    str += '!'
+    total = total + str.byteLength()
+  }
+}
+
+benchmark("StringAppend", runStringAppend)
+assert(total == 10000)
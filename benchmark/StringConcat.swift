@@ -0,0 +1,16 @@
+// Building a string by concatenation, from the shootout program in
+// test/Interpreter/shootout_strcat.swift.
+
+var NUM = 1000
+var length = 0
+
+func runStringConcat() {
+  var str : String
+  for i in 0..NUM {
+    str = str + "hello\n"
+  }
+  length = str.byteLength()
+}
+
+benchmark("StringConcat", runStringConcat)
+assert(length == 6 * NUM)
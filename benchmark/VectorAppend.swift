@@ -0,0 +1,15 @@
+// Growing a Vector one element at a time.
+
+var NUM = 10000
+var length = 0
+
+func runVectorAppend() {
+  var v = Vector<Int>()
+  for i in 0..NUM {
+    v.append(i)
+  }
+  length = v.length
+}
+
+benchmark("VectorAppend", runVectorAppend)
+assert(length == NUM)
@@ -0,0 +1,127 @@
+#!/usr/bin/env python
+#===--- run_benchmarks.py - Run the Swift benchmark suite -----------------===#
+#
+# This source file is part of the Swift.org open source project
+#
+# Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+# Licensed under Apache License v2.0 with Runtime Library Exception
+#
+# See http://swift.org/LICENSE.txt for license information
+# See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+#===-----------------------------------------------------------------------===#
+#
+# Runs benchmark executables, each of which prints one line of JSON per
+# benchmark() call, collects the results into a single JSON file, and
+# optionally compares them against the results of an earlier run.
+#
+#===-----------------------------------------------------------------------===#
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+def run_benchmark(executable):
+    """Run one executable and return the results it printed."""
+    process = subprocess.Popen([executable], stdout=subprocess.PIPE,
+                               universal_newlines=True)
+    output = process.communicate()[0]
+    if process.returncode != 0:
+        raise RuntimeError('%s exited with status %d' %
+                           (executable, process.returncode))
+    results = []
+    for line in output.splitlines():
+        if line.startswith('{'):
+            results.append(json.loads(line))
+    if not results:
+        raise RuntimeError('%s printed no results' % executable)
+    return results
+
+
+def is_significant(old, new, threshold):
+    """Whether the change in median time is larger than both the relative
+    threshold and the noise in the two runs."""
+    difference = abs(new['median_ns'] - old['median_ns'])
+    noise = 3 * (old.get('mad_ns', 0) + new.get('mad_ns', 0))
+    return difference > threshold * old['median_ns'] and difference > noise
+
+
+def compare(baseline, results, threshold):
+    """Print a comparison table and return the names of the benchmarks that
+    got significantly slower."""
+    regressions = []
+    print('%-24s %14s %14s %9s' % ('Benchmark', 'Baseline (ns)', 'Current (ns)',
+                                   'Change'))
+    for name in sorted(results):
+        new = results[name]
+        old = baseline.get(name)
+        if old is None:
+            print('%-24s %14s %14.1f %9s' % (name, '-', new['median_ns'],
+                                             'new'))
+            continue
+        change = new['median_ns'] / old['median_ns'] - 1
+        note = ''
+        if is_significant(old, new, threshold):
+            if change > 0:
+                note = '  (regression)'
+                regressions.append(name)
+            else:
+                note = '  (improvement)'
+        print('%-24s %14.1f %14.1f %+8.1f%%%s' % (name, old['median_ns'],
+                                                  new['median_ns'],
+                                                  change * 100, note))
+    for name in sorted(set(baseline) - set(results)):
+        print('%-24s %14.1f %14s %9s' % (name, baseline[name]['median_ns'],
+                                         '-', 'missing'))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Run Swift benchmarks and compare their results.')
+    parser.add_argument('executables', nargs='+',
+                        help='benchmark executables to run')
+    parser.add_argument('-o', '--output',
+                        help='write the results to this JSON file')
+    parser.add_argument('--baseline',
+                        help='compare against the results in this JSON file')
+    parser.add_argument('--threshold', type=float, default=5,
+                        help='percentage change to report (default: 5)')
+    args = parser.parse_args()
+
+    results = {}
+    for executable in args.executables:
+        name = os.path.basename(executable)
+        print('Running %s...' % name, file=sys.stderr)
+        for result in run_benchmark(executable):
+            results[result['name']] = result
+
+    if args.output:
+        with open(args.output, 'w') as output:
+            json.dump({'benchmarks': results}, output, indent=2,
+                      sort_keys=True)
+            output.write('\n')
+
+    if args.baseline:
+        with open(args.baseline) as baseline:
+            regressions = compare(json.load(baseline)['benchmarks'], results,
+                                  args.threshold / 100)
+        if regressions:
+            print('%d benchmark(s) regressed: %s' %
+                  (len(regressions), ', '.join(regressions)))
+            return 1
+    else:
+        for name in sorted(results):
+            result = results[name]
+            print('%-24s %14.1f ns  +/- %.1f' % (name, result['median_ns'],
+                                                 result['mad_ns']))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,196 @@
+#!/usr/bin/env python
+#===--- run_compile_benchmarks.py - Track the frontend's compile time -----===#
+#
+# This source file is part of the Swift.org open source project
+#
+# Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+# Licensed under Apache License v2.0 with Runtime Library Exception
+#
+# See http://swift.org/LICENSE.txt for license information
+# See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+#===-----------------------------------------------------------------------===#
+#
+# Runs swift-frontend-bench on each synthetic workload at two sizes, and
+# checks how much each phase of the frontend slows down when the input
+# doubles against the budgets in compile-time-baseline.json.  A phase that
+# is linear in its input takes about twice as long; one that has gone
+# quadratic takes about four times as long, on any machine.
+#
+# The baseline file looks like
+#
+#   {"tolerance": 0.5, "min_seconds": 0.01, "min_bytes": 8388608,
+#    "workloads": {"functions": {"scale": 2000,
+#                                "growth": {"default": 2.0}}}}
+#
+# where "growth" gives the expected ratio for each phase, and "memory" for
+# the memory used beyond the standard library.  Phases that take less than
+# min_seconds are too noisy to judge.
+#
+# Absolute times only mean something on one machine, so they are compared
+# only against the results of an earlier run given with --compare-to.
+#
+#===-----------------------------------------------------------------------===#
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+def run_workload(tool, stdlib, workload, scale, constraint_checker):
+    """Run the tool on one workload and return the result it printed."""
+    command = [tool, '-workload=' + workload, '-scale=%d' % scale]
+    if stdlib:
+        command.append('-stdlib=' + stdlib)
+    if constraint_checker:
+        command.append('-constraint-checker')
+    process = subprocess.Popen(command, stdout=subprocess.PIPE,
+                               universal_newlines=True)
+    output = process.communicate()[0]
+    if process.returncode != 0:
+        raise RuntimeError('%s exited with status %d' %
+                           (' '.join(command), process.returncode))
+    for line in output.splitlines():
+        if line.startswith('{'):
+            return json.loads(line)
+    raise RuntimeError('%s printed no results' % ' '.join(command))
+
+
+def memory_used(result):
+    """The memory used to compile the input, beyond the standard library."""
+    phases = result['phases']
+    peak = max(phase['peak_rss_bytes'] for phase in phases.values())
+    return peak - phases['stdlib']['peak_rss_bytes']
+
+
+def check_growth(name, small, large, budget, baseline):
+    """Print how each phase grew when the input doubled, and return the
+    phases that grew by more than the budget allows."""
+    tolerance = baseline.get('tolerance', 0.5)
+    min_seconds = baseline.get('min_seconds', 0.01)
+    min_bytes = baseline.get('min_bytes', 8 << 20)
+    growth = budget.get('growth', {})
+    default = growth.get('default', 2.0)
+    failures = []
+
+    def check(phase, old, new, minimum, unit):
+        expected = growth.get(phase, default)
+        if old < minimum:
+            print('  %-12s %12.4f %12.4f %8s  (too small to judge)' %
+                  (phase, old / unit, new / unit, '-'))
+            return
+        ratio = new / old
+        note = ''
+        if ratio > expected * (1 + tolerance):
+            note = '  (expected %.1fx)' % expected
+            failures.append('%s/%s' % (name, phase))
+        print('  %-12s %12.4f %12.4f %7.2fx%s' % (phase, old / unit,
+                                                  new / unit, ratio, note))
+
+    print('%s (scale %d -> %d)' % (name, small['scale'], large['scale']))
+    for phase in sorted(small['phases']):
+        if phase == 'stdlib' or phase not in large['phases']:
+            continue
+        check(phase, small['phases'][phase]['wall_s'],
+              large['phases'][phase]['wall_s'], min_seconds, 1)
+    check('memory', memory_used(small), memory_used(large), min_bytes,
+          float(1 << 20))
+    return failures
+
+
+def compare_times(earlier, results, threshold, min_seconds):
+    """Print how the phase times changed since an earlier run, and return
+    the phases that got slower by more than the threshold."""
+    regressions = []
+    for name in sorted(results):
+        old = earlier.get(name)
+        new = results[name]
+        if old is None or old['scale'] != new['scale']:
+            continue
+        for phase in sorted(new['phases']):
+            if phase not in old['phases']:
+                continue
+            old_time = old['phases'][phase]['wall_s']
+            new_time = new['phases'][phase]['wall_s']
+            if old_time < min_seconds:
+                continue
+            change = new_time / old_time - 1
+            note = ''
+            if change > threshold:
+                note = '  (regression)'
+                regressions.append('%s/%s' % (name, phase))
+            print('%-24s %10.4f s %10.4f s %+8.1f%%%s' %
+                  (name + '/' + phase, old_time, new_time, change * 100,
+                   note))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Check how the frontend scales on synthetic inputs.')
+    parser.add_argument('tool', help='the swift-frontend-bench executable')
+    parser.add_argument('--baseline',
+                        default=os.path.join(os.path.dirname(__file__),
+                                             'compile-time-baseline.json'),
+                        help='the budgets to check against')
+    parser.add_argument('--stdlib', help='the standard library, swift.swift')
+    parser.add_argument('--constraint-checker', action='store_true',
+                        help='type-check with the constraint solver')
+    parser.add_argument('--workload', action='append',
+                        help='run only this workload (may be repeated)')
+    parser.add_argument('-o', '--output',
+                        help='write the results to this JSON file')
+    parser.add_argument('--compare-to',
+                        help='compare times against an earlier results file')
+    parser.add_argument('--threshold', type=float, default=10,
+                        help='percentage slowdown to report with '
+                             '--compare-to (default: 10)')
+    args = parser.parse_args()
+
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)
+    workloads = baseline['workloads']
+    names = args.workload or sorted(workloads)
+
+    results = {}
+    doubled = {}
+    failures = []
+    for name in names:
+        if name not in workloads:
+            print('error: no budget for workload %s' % name, file=sys.stderr)
+            return 2
+        budget = workloads[name]
+        print('Running %s...' % name, file=sys.stderr)
+        small = run_workload(args.tool, args.stdlib, name, budget['scale'],
+                             args.constraint_checker)
+        large = run_workload(args.tool, args.stdlib, name,
+                             2 * budget['scale'], args.constraint_checker)
+        results[name] = small
+        doubled[name] = large
+        failures += check_growth(name, small, large, budget, baseline)
+
+    if args.output:
+        with open(args.output, 'w') as output:
+            json.dump({'workloads': results, 'doubled': doubled}, output,
+                      indent=2, sort_keys=True)
+            output.write('\n')
+
+    if args.compare_to:
+        with open(args.compare_to) as earlier:
+            failures += compare_times(json.load(earlier)['workloads'], results,
+                                      args.threshold / 100,
+                                      baseline.get('min_seconds', 0.01))
+
+    if failures:
+        print('%d phase(s) regressed: %s' % (len(failures),
+                                             ', '.join(failures)))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -66,6 +66,22 @@ enum class MetadataKind : uintptr_t {
   HeapArray = 65
 };
 
+/// Flags stored in the 'flags' field of a value-witness table.  These
+/// describe properties of the type which let clients bypass the function
+/// witnesses entirely.
+enum class ValueWitnessFlags : uintptr_t {
+  /// Values of this type are plain old data: copies and assignments are
+  /// equivalent to memcpy and destruction is a no-op.
+  IsPOD            = 0x1,
+
+  /// Values of this type can be taken (moved) with memcpy.
+  IsBitwiseTakable = 0x2,
+
+  /// Values of this type are stored inline in a fixed-size buffer
+  /// rather than side-allocated.
+  IsInline         = 0x4
+};
+
 }
 
 #endif
@@ -979,6 +979,7 @@ private:
     SourceRange Braces;
     FuncDecl *Get;       // User-defined getter
     FuncDecl *Set;       // User-defined setter
+    FuncDecl *Address;   // User-defined addressor
   };
   
   GetSetRecord *GetSet;
@@ -998,15 +999,19 @@ public:
   bool isProperty() const { return GetSet != nullptr; }
   
   /// \brief Make this variable into a property, providing a getter and
-  /// setter.
+  /// setter, and optionally an addressor.
   void setProperty(ASTContext &Context, SourceLoc LBraceLoc, FuncDecl *Get,
-                   FuncDecl *Set, SourceLoc RBraceLoc);
+                   FuncDecl *Set, FuncDecl *Address, SourceLoc RBraceLoc);
 
   /// \brief Retrieve the getter used to access the value of this variable.
   FuncDecl *getGetter() const { return GetSet? GetSet->Get : nullptr; }
 
   /// \brief Retrieve the setter used to mutate the value of this variable.
   FuncDecl *getSetter() const { return GetSet? GetSet->Set : nullptr; }
+
+  /// \brief Retrieve the addressor, which returns the address of the
+  /// storage backing this property, or null if the property has none.
+  FuncDecl *getAddressor() const { return GetSet? GetSet->Address : nullptr; }
   
   /// \brief Returns whether the var is settable, either because it is a
   /// simple var or because it is a property with a setter.
@@ -1027,7 +1032,10 @@ class FuncDecl : public ValueDecl {
   SourceLoc NameLoc;
   GenericParamList *GenericParams;
   FuncExpr *Body;
-  llvm::PointerIntPair<Decl *, 1, bool> GetOrSetDecl;
+
+  /// The kinds of accessor a function can be.
+  enum : unsigned { IsGetter, IsSetter, IsAddressor };
+  llvm::PointerIntPair<Decl *, 2, unsigned> GetOrSetDecl;
   FuncDecl *OverriddenDecl;
 
 public:
@@ -1108,34 +1116,50 @@ public:
   /// declaration, which may be either a variable or a subscript declaration.
   void makeGetter(Decl *D) {
     GetOrSetDecl.setPointer(D);
-    GetOrSetDecl.setInt(false);
+    GetOrSetDecl.setInt(IsGetter);
   }
   
   /// makeSetter - Note that this function is the setter for the given
   /// declaration, which may be either a variable or a subscript declaration.
   void makeSetter(Decl *D) {
     GetOrSetDecl.setPointer(D);
-    GetOrSetDecl.setInt(true);
+    GetOrSetDecl.setInt(IsSetter);
+  }
+
+  /// makeAddressor - Note that this function is the addressor for the given
+  /// declaration, which may be either a variable or a subscript declaration.
+  void makeAddressor(Decl *D) {
+    GetOrSetDecl.setPointer(D);
+    GetOrSetDecl.setInt(IsAddressor);
   }
   
   /// getGetterVar - If this function is a getter, retrieve the declaration for
   /// which it is a getter. Otherwise, returns null.
   Decl *getGetterDecl() const {
-    return GetOrSetDecl.getInt()? nullptr : GetOrSetDecl.getPointer();
+    return GetOrSetDecl.getInt() == IsGetter ? GetOrSetDecl.getPointer()
+                                             : nullptr;
   }
 
   /// getSetterVar - If this function is a setter, retrieve the declaration for
   /// which it is a setter. Otherwise, returns null.
   Decl *getSetterDecl() const {
-    return GetOrSetDecl.getInt()? GetOrSetDecl.getPointer() : nullptr;
+    return GetOrSetDecl.getInt() == IsSetter ? GetOrSetDecl.getPointer()
+                                             : nullptr;
   }
 
-  /// isGetterOrSetter - Determine whether this is a getter or a setter vs.
-  /// a normal function.
+  /// getAddressorDecl - If this function is an addressor, retrieve the
+  /// declaration whose storage it addresses. Otherwise, returns null.
+  Decl *getAddressorDecl() const {
+    return GetOrSetDecl.getInt() == IsAddressor ? GetOrSetDecl.getPointer()
+                                                : nullptr;
+  }
+
+  /// isGetterOrSetter - Determine whether this is a getter, a setter or an
+  /// addressor vs. a normal function.
   bool isGetterOrSetter() const { return getGetterOrSetterDecl() != 0; }
 
   /// getGetterOrSetterDecl - Return the declaration for which this function
-  /// is a getter or setter, if it is one.
+  /// is a getter, setter or addressor, if it is one.
   Decl *getGetterOrSetterDecl() const { return GetOrSetDecl.getPointer(); }
 
   /// Given that this is an Objective-C method declaration, produce
@@ -1216,17 +1240,19 @@ class SubscriptDecl : public ValueDecl {
   SourceRange Braces;
   FuncDecl *Get;
   FuncDecl *Set;
+  FuncDecl *Address;
   SubscriptDecl *OverriddenDecl;
 
 public:
   SubscriptDecl(Identifier NameHack, SourceLoc SubscriptLoc, Pattern *Indices,
                 SourceLoc ArrowLoc, TypeLoc ElementTy,
                 SourceRange Braces, FuncDecl *Get, FuncDecl *Set,
-                DeclContext *Parent)
+                FuncDecl *Address, DeclContext *Parent)
     : ValueDecl(DeclKind::Subscript, Parent, NameHack, Type()),
       SubscriptLoc(SubscriptLoc),
       ArrowLoc(ArrowLoc), Indices(Indices), ElementTy(ElementTy),
-      Braces(Braces), Get(Get), Set(Set), OverriddenDecl(nullptr) { }
+      Braces(Braces), Get(Get), Set(Set), Address(Address),
+      OverriddenDecl(nullptr) { }
   
   SourceLoc getStartLoc() const { return SubscriptLoc; }
   SourceLoc getLoc() const;
@@ -1249,6 +1275,13 @@ public:
   ///
   /// The subscript setter is optional.
   FuncDecl *getSetter() const { return Set; }
+
+  /// \brief Retrieve the subscript addressor, a function that takes the
+  /// indices and produces the address of the storage for the element.
+  ///
+  /// The subscript addressor is optional.  When present, it is used to
+  /// access the element in place instead of calling the getter and setter.
+  FuncDecl *getAddressor() const { return Address; }
   
   /// \brief Returns whether the subscript operation has a setter.
   bool isSettable() const { return Set; }
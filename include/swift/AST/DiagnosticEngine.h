@@ -25,9 +25,12 @@
 #include "swift/Basic/Optional.h"
 #include "swift/Basic/SourceLoc.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace llvm {
   class SourceMgr;
@@ -241,6 +244,37 @@ namespace swift {
     /// HadAnyError - True if any error diagnostics have been emitted.
     bool HadAnyError;
 
+    /// \brief Whether the error limit has been hit.  Once it has, every
+    /// further diagnostic is dropped.
+    bool TooManyErrors;
+
+    /// \brief Whether notes are being dropped because the error or warning
+    /// they belong to was.
+    bool SuppressingNotes;
+
+    /// \brief Whether diagnostics are being held in BufferedDiagnostics rather
+    /// than passed to the consumer as they are emitted.
+    bool BufferingDiagnostics;
+
+    /// \brief The number of errors to emit before giving up, or zero for no
+    /// limit.
+    unsigned ErrorLimit;
+
+    /// \brief The number of errors emitted so far.
+    unsigned NumErrors;
+
+    /// \brief The location and ID of every error and warning emitted so far.
+    /// Only the first diagnostic with a given ID at a given location is
+    /// emitted; later ones are dropped along with their notes.
+    llvm::DenseSet<std::pair<const char *, unsigned>> EmittedDiagnostics;
+
+    /// \brief The diagnostics held back while buffering, unformatted.
+    std::vector<std::pair<SourceLoc, Diagnostic>> BufferedDiagnostics;
+
+    /// \brief Storage for copies of the string arguments of buffered
+    /// diagnostics, which may point into temporaries.
+    llvm::BumpPtrAllocator BufferedStrings;
+
     /// \brief The source location of the currently active diagnostic, if there
     /// is one.
     SourceLoc ActiveDiagnosticLoc;
@@ -254,6 +288,8 @@ namespace swift {
     explicit DiagnosticEngine(llvm::SourceMgr &SourceMgr, 
                               DiagnosticConsumer &Consumer)
       : SourceMgr(SourceMgr), Consumer(Consumer), HadAnyError(false), 
+        TooManyErrors(false), SuppressingNotes(false),
+        BufferingDiagnostics(false), ErrorLimit(0), NumErrors(0),
         ActiveDiagnostic() { }
 
     /// hadAnyError - return true if any *error* diagnostics have been emitted.
@@ -261,10 +297,75 @@ namespace swift {
       return HadAnyError;
     }
 
+    /// resetHadAnyError - Forget about the errors emitted so far, including
+    /// for the purposes of the error limit and of dropping repeats.
     void resetHadAnyError() {
       HadAnyError = false;
+      TooManyErrors = false;
+      SuppressingNotes = false;
+      NumErrors = 0;
+      EmittedDiagnostics.clear();
+    }
+
+    /// ErrorState - The engine's record of the errors emitted so far, as
+    /// set aside by saveErrorState.
+    class ErrorState {
+      friend class DiagnosticEngine;
+      bool HadAnyError;
+      bool TooManyErrors;
+      unsigned NumErrors;
+      llvm::DenseSet<std::pair<const char *, unsigned>> EmittedDiagnostics;
+    };
+
+    /// saveErrorState - Set aside the record of the errors emitted so far
+    /// and start a fresh one, as resetHadAnyError does, so that the errors
+    /// of one piece of code can be told apart from the rest.
+    ErrorState saveErrorState() {
+      ErrorState State;
+      State.HadAnyError = HadAnyError;
+      State.TooManyErrors = TooManyErrors;
+      State.NumErrors = NumErrors;
+      State.EmittedDiagnostics.swap(EmittedDiagnostics);
+      resetHadAnyError();
+      return State;
+    }
+
+    /// restoreErrorState - Go back to a record set aside by saveErrorState.
+    /// hadAnyError() stays true if an error was emitted in between.
+    void restoreErrorState(ErrorState &State) {
+      HadAnyError |= State.HadAnyError;
+      TooManyErrors = State.TooManyErrors;
+      SuppressingNotes = false;
+      NumErrors = State.NumErrors;
+      EmittedDiagnostics.swap(State.EmittedDiagnostics);
     }
 
+    /// \brief Set the number of errors after which all further diagnostics
+    /// are dropped.  Zero means no limit.
+    void setErrorLimit(unsigned Limit) { ErrorLimit = Limit; }
+    unsigned getErrorLimit() const { return ErrorLimit; }
+
+    /// hadTooManyErrors - Return true once the error limit has been reached.
+    /// Clients doing expensive checking should stop when this is set, since
+    /// nothing they diagnose will be shown.
+    bool hadTooManyErrors() const { return TooManyErrors; }
+
+    /// \brief Hold diagnostics back instead of formatting them and passing
+    /// them to the consumer as they are emitted.  Turning buffering off
+    /// flushes the diagnostics held so far.
+    ///
+    /// Buffered diagnostics refer to types by pointer, so they must be
+    /// flushed before the ASTContext that owns those types goes away.
+    void setBufferDiagnostics(bool Buffer) {
+      BufferingDiagnostics = Buffer;
+      if (!Buffer)
+        flushBufferedDiagnostics();
+    }
+
+    /// \brief Format the buffered diagnostics and pass them to the consumer,
+    /// in the order they were emitted.
+    void flushBufferedDiagnostics();
+
     /// \brief Emit a diagnostic using a preformatted array of diagnostic
     /// arguments.
     ///
@@ -324,6 +425,13 @@ namespace swift {
   private:
     /// \brief Flush the active diagnostic.
     void flushActiveDiagnostic();
+
+    /// \brief Decide whether the active diagnostic should be dropped, as a
+    /// repeat or because of the error limit, and count it if not.
+    bool shouldSuppressActiveDiagnostic();
+
+    /// \brief Format a diagnostic and pass it to the consumer.
+    void emitDiagnostic(SourceLoc Loc, const Diagnostic &D);
     
     /// \brief Retrieve the active diagnostic.
     Diagnostic &getActiveDiagnostic() { return *ActiveDiagnostic; }
@@ -27,6 +27,7 @@
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SetVector.h"
+#include <atomic>
 
 namespace llvm {
   struct fltSemantics;
@@ -66,10 +67,19 @@ class TypeBase {
   TypeBase(const TypeBase&) = delete;
   void operator=(const TypeBase&) = delete;
   
-  /// CanonicalType - This field is always set to the ASTContext for canonical
-  /// types, and is otherwise lazily populated by ASTContext when the canonical
-  /// form of a non-canonical type is requested.
-  llvm::PointerUnion<TypeBase *, ASTContext*> CanonicalType;
+  typedef llvm::PointerUnion<TypeBase *, ASTContext*> CanonicalTypeUnion;
+
+  /// CanonicalType - The opaque value of a CanonicalTypeUnion.  This field is
+  /// always set to the ASTContext for canonical types, and is otherwise
+  /// lazily populated when the canonical form of a non-canonical type is
+  /// requested.  Threads emitting SIL canonicalize types concurrently, so it
+  /// is published with a release and read with an acquire.
+  std::atomic<void*> CanonicalType;
+
+  CanonicalTypeUnion getCanonicalTypeUnion() const {
+    return CanonicalTypeUnion::getFromOpaqueValue(
+             CanonicalType.load(std::memory_order_acquire));
+  }
 
   /// Kind - The discriminator that indicates what subclass of type this is.
   const TypeKind Kind;
@@ -89,14 +99,19 @@ class TypeBase {
   union {
     TypeBaseBits TypeBase;
   } TypeBits;
+
+  /// computeCanonicalType - Compute, and remember, the canonical version of
+  /// a type that is not canonical itself.
+  CanType computeCanonicalType();
   
 protected:
   TypeBase(TypeKind kind, ASTContext *CanTypeCtx, bool Unresolved,
            bool HasTypeVariable)
-    : CanonicalType((TypeBase*)nullptr), Kind(kind) {
+    : CanonicalType(nullptr), Kind(kind) {
     // If this type is canonical, switch the CanonicalType union to ASTContext.
     if (CanTypeCtx)
-      CanonicalType = CanTypeCtx;
+      CanonicalType.store(CanonicalTypeUnion(CanTypeCtx).getOpaqueValue(),
+                          std::memory_order_relaxed);
     
     setUnresolved(Unresolved);
     setHasTypeVariable(HasTypeVariable);
@@ -116,27 +131,45 @@ public:
   TypeKind getKind() const { return Kind; }
 
   /// isCanonical - Return true if this is a canonical type.
-  bool isCanonical() const { return CanonicalType.is<ASTContext*>(); }
+  bool isCanonical() const {
+    return getCanonicalTypeUnion().is<ASTContext*>();
+  }
   
   /// hasCanonicalTypeComputed - Return true if we've already computed a
   /// canonical version of this type.
-  bool hasCanonicalTypeComputed() const { return !CanonicalType.isNull(); }
+  bool hasCanonicalTypeComputed() const {
+    return !getCanonicalTypeUnion().isNull();
+  }
   
   /// getCanonicalType - Return the canonical version of this type, which has
   /// sugar from all levels stripped off.
-  CanType getCanonicalType();
+  CanType getCanonicalType() {
+    // Canonical types, and types whose canonical form has already been
+    // computed, are answered from the CanonicalType field.
+    CanonicalTypeUnion Canon = getCanonicalTypeUnion();
+    if (Canon.is<ASTContext*>())
+      return CanType(this);
+    if (TypeBase *CT = Canon.get<TypeBase*>())
+      return CanType(CT);
+    return computeCanonicalType();
+  }
   
   /// getASTContext - Return the ASTContext that this type belongs to.
   ASTContext &getASTContext() {
     // If this type is canonical, it has the ASTContext in it.
-    if (CanonicalType.is<ASTContext*>())
-      return *CanonicalType.get<ASTContext*>();
+    CanonicalTypeUnion Canon = getCanonicalTypeUnion();
+    if (Canon.is<ASTContext*>())
+      return *Canon.get<ASTContext*>();
     // If not, canonicalize it to get the Context.
-    return *getCanonicalType()->CanonicalType.get<ASTContext*>();
+    return *getCanonicalType()->getCanonicalTypeUnion().get<ASTContext*>();
   }
   
   /// isEqual - Return true if these two types are equal, ignoring sugar.
-  bool isEqual(Type Other);
+  bool isEqual(Type Other) {
+    if (this == Other.getPointer())
+      return true;
+    return getCanonicalType() == Other->getCanonicalType();
+  }
   
   /// getDesugaredType - If this type is a sugared type, remove all levels of
   /// sugar until we get down to a non-sugar type.
@@ -619,7 +652,7 @@ private:
 
 /// UnboundGenericType - Represents a generic nominal type where the
 /// type arguments have not yet been resolved.
-class UnboundGenericType : public TypeBase, public llvm::FoldingSetNode {
+class UnboundGenericType : public TypeBase {
   NominalTypeDecl *TheDecl;
 
   /// \brief The type of the parent, in which this type is nested.
@@ -652,12 +685,6 @@ public:
 
   void print(raw_ostream &O) const;
 
-  void Profile(llvm::FoldingSetNodeID &ID) {
-    Profile(ID, getDecl(), getParent());
-  }
-  static void Profile(llvm::FoldingSetNodeID &ID, NominalTypeDecl *D,
-                      Type Parent);
-
   // Implement isa/cast/dyncast/etc.
   static bool classof(const TypeBase *T) {
     return T->getKind() == TypeKind::UnboundGeneric;
@@ -862,7 +889,7 @@ public:
 };
 
 /// OneOfType - This represents the type declared by a OneOfDecl.
-class OneOfType : public NominalType, public llvm::FoldingSetNode {
+class OneOfType : public NominalType {
 public:
   /// getDecl() - Returns the decl which declares this type.
   OneOfDecl *getDecl() const {
@@ -875,11 +902,6 @@ public:
 
   void print(raw_ostream &O) const;
 
-  void Profile(llvm::FoldingSetNodeID &ID) {
-    Profile(ID, getDecl(), getParent());
-  }
-  static void Profile(llvm::FoldingSetNodeID &ID, OneOfDecl *D, Type Parent);
-
   // Implement isa/cast/dyncast/etc.
   static bool classof(const TypeBase *T) {
     return T->getKind() == TypeKind::OneOf;
@@ -891,7 +913,7 @@ private:
 };
 
 /// StructType - This represents the type declared by a StructDecl.
-class StructType : public NominalType, public llvm::FoldingSetNode {  
+class StructType : public NominalType {  
 public:
   /// getDecl() - Returns the decl which declares this type.
   StructDecl *getDecl() const {
@@ -904,11 +926,6 @@ public:
 
   void print(raw_ostream &O) const;
 
-  void Profile(llvm::FoldingSetNodeID &ID) {
-    Profile(ID, getDecl(), getParent());
-  }
-  static void Profile(llvm::FoldingSetNodeID &ID, StructDecl *D, Type Parent);
-
   // Implement isa/cast/dyncast/etc.
   static bool classof(const TypeBase *T) {
     return T->getKind() == TypeKind::Struct;
@@ -920,7 +937,7 @@ private:
 };
 
 /// ClassType - This represents the type declared by a ClassDecl.
-class ClassType : public NominalType, public llvm::FoldingSetNode {  
+class ClassType : public NominalType {  
 public:
   /// getDecl() - Returns the decl which declares this type.
   ClassDecl *getDecl() const {
@@ -933,11 +950,6 @@ public:
 
   void print(raw_ostream &O) const;
 
-  void Profile(llvm::FoldingSetNodeID &ID) {
-    Profile(ID, getDecl(), getParent());
-  }
-  static void Profile(llvm::FoldingSetNodeID &ID, ClassDecl *D, Type Parent);
-
   // Implement isa/cast/dyncast/etc.
   static bool classof(const TypeBase *T) {
     return T->getKind() == TypeKind::Class;
@@ -40,8 +40,13 @@ enum class DiagnosticKind {
 /// \brief Extra information carried along with a diagnostic, which may or
 /// may not be of interest to a given diagnostic consumer.
 struct DiagnosticInfo {
+  /// \brief The name of the diagnostic, as spelled in Diagnostics.def.
+  const char *Name;
+
   /// \brief Extra source ranges that are attached to the diagnostic.
   llvm::ArrayRef<SourceRange> Ranges;
+
+  DiagnosticInfo() : Name("") {}
 };
   
 /// \brief Abstract interface for classes that present diagnostics to the user.
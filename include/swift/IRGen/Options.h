@@ -56,7 +56,13 @@ public:
   /// The optimization level, as in -O2.
   unsigned OptLevel : 2;
 
-  Options() : OutputKind(OutputKind::LLVMAssembly), Verify(true), OptLevel(0) {}
+  /// Should function bodies be lowered from the SILModule given to
+  /// performIRGeneration, where the lowering supports them?  This is off
+  /// by default while the lowering is incomplete.
+  unsigned EmitFromSIL : 1;
+
+  Options() : OutputKind(OutputKind::LLVMAssembly), Verify(true), OptLevel(0),
+              EmitFromSIL(false) {}
 };
 
 } // end namespace irgen
@@ -45,6 +45,8 @@ class Lexer {
   Lexer(const Lexer&) = delete;
   void operator=(const Lexer&) = delete;
 
+  friend class TokenCache;
+
   Lexer(llvm::StringRef Buffer, llvm::SourceMgr &SourceMgr,
         DiagnosticEngine *Diags, 
         const char *CurrentPosition);
@@ -120,9 +122,10 @@ public:
     return SourceLoc(llvm::SMLoc::getFromPointer(Loc));
   }
 
-  /// getTokenKind - Retrieve the token kind for the given text, which must
-  /// fall within the given source buffer.
-  tok getTokenKind(StringRef Text);
+  /// getOperatorKind - Classify the operator spelled by the given text,
+  /// which must fall within a buffer starting at BufferStart, the way the
+  /// lexer would, but without lexing anything.
+  static tok getOperatorKind(StringRef Text, const char *BufferStart);
 
 private:
   void lexImpl();
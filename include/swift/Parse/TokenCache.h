@@ -0,0 +1,141 @@
+//===--- TokenCache.h - Cached Token Stream ---------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the TokenCache interface, which records the tokens of a
+//  buffer as they are lexed so that they can be revisited without relexing.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_TOKENCACHE_H
+#define SWIFT_TOKENCACHE_H
+
+#include "Token.h"
+#include <vector>
+
+namespace llvm {
+  class SourceMgr;
+}
+
+namespace swift {
+  class DiagnosticEngine;
+  class Lexer;
+
+/// CachedToken - The compact form of a token held by a TokenCache: its kind
+/// and its extent as an offset into the cached buffer.
+struct CachedToken {
+  unsigned Offset;
+  unsigned Length : 24;
+  unsigned Kind : 8;
+
+  tok getKind() const { return tok(Kind); }
+  unsigned getEndOffset() const { return Offset + Length; }
+};
+
+/// TokenCache - The token stream for a single buffer.  Tokens are lexed
+/// lazily, on first request, and recorded in a flat array so that the parser
+/// gets constant-time lookahead and can save and restore its position by
+/// index.  A cache can outlive the parsers that use it, so a buffer that is
+/// parsed in several pieces (as the REPL and the main module are) is lexed,
+/// and has its lexer diagnostics emitted, only once.
+///
+/// The cached tokens always form one contiguous run starting at the position
+/// where lexing began.  Asking for a position outside of that run, or in the
+/// middle of a cached token, discards the run and starts lexing again from
+/// there.
+class TokenCache {
+  llvm::SourceMgr &SourceMgr;
+  DiagnosticEngine *Diags;
+
+  /// Buffer - The full buffer being tokenized.  Lexing never goes past
+  /// EndOffset, which may be less than the size of the buffer.
+  StringRef Buffer;
+  unsigned EndOffset;
+
+  /// StartOffset - The offset at which the cached run of tokens begins.
+  unsigned StartOffset;
+
+  /// Tokens - The cached run of tokens, in buffer order.  The last entry is
+  /// tok::eof once the end of the buffer has been reached.
+  std::vector<CachedToken> Tokens;
+
+  /// L - The lexer that extends the run, positioned just past the last cached
+  /// token.  It is created lazily and thrown away whenever the run is reset.
+  Lexer *L;
+
+  TokenCache(const TokenCache&) = delete;
+  void operator=(const TokenCache&) = delete;
+
+  /// resetAt - Discard all cached tokens and resume lexing at Offset.
+  void resetAt(unsigned Offset);
+
+  /// getResumeOffset - Return the offset at which lexing continues after the
+  /// last cached token.
+  unsigned getResumeOffset() const {
+    return Tokens.empty() ? StartOffset : Tokens.back().getEndOffset();
+  }
+
+  /// findToken - Return the first cached token starting at or after Offset.
+  std::vector<CachedToken>::iterator findToken(unsigned Offset);
+
+  /// lexMore - Lex and cache one more token.  Returns false if the end of
+  /// the buffer has already been reached.
+  bool lexMore();
+
+  Token makeToken(const CachedToken &Tok) const {
+    Token Result;
+    Result.setToken(Tok.getKind(), Buffer.substr(Tok.Offset, Tok.Length));
+    return Result;
+  }
+
+public:
+  TokenCache(StringRef Buffer, llvm::SourceMgr &SourceMgr,
+             DiagnosticEngine *Diags);
+  ~TokenCache();
+
+  StringRef getBuffer() const { return Buffer; }
+
+  /// getLexer - Return the lexer used to extend the cache.  This is the lexer
+  /// to use for decoding string and character literals within the buffer.
+  Lexer &getLexer();
+
+  /// setEndOffset - Change the offset at which lexing stops.  Tokens that
+  /// could be affected by the text after the old end are dropped and will be
+  /// relexed on demand.
+  void setEndOffset(unsigned NewEndOffset);
+
+  /// getIndexForOffset - Return the index of the token that lexing from the
+  /// given offset would produce first, lexing or relexing as needed.
+  unsigned getIndexForOffset(unsigned Offset);
+
+  /// getToken - Return the token with the given index, lexing up to it if
+  /// needed.  Indexes past the end of the buffer yield the eof token.
+  Token getToken(unsigned Index) {
+    while (Index >= Tokens.size())
+      if (!lexMore())
+        return makeToken(Tokens.back());
+    return makeToken(Tokens[Index]);
+  }
+
+  /// getTokenKind - Retrieve the token kind for the given text, which must
+  /// either be a cached token or the tail of an operator token, such as what
+  /// is left after the parser splits off a leading '<' or '>'.
+  tok getTokenKind(StringRef Text);
+
+  /// getLocForEndOfToken - Retrieve the source location just past the end of
+  /// the token starting at Loc, which must fall within the buffer, lexing up
+  /// to it if needed.
+  SourceLoc getLocForEndOfToken(SourceLoc Loc);
+};
+
+} // end namespace swift
+
+#endif
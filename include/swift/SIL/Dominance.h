@@ -0,0 +1,100 @@
+//===--- Dominance.h - SIL Dominator Trees ----------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the DominanceInfo class, which computes the dominator tree
+// and dominance frontiers of the CFG of a SIL Function.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_DOMINANCE_H
+#define SWIFT_SIL_DOMINANCE_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include <vector>
+
+namespace swift {
+class BasicBlock;
+class Function;
+
+/// DominanceInfo - The dominator tree of a Function, together with the
+/// dominance frontier of each block.  Blocks that are unreachable from the
+/// entry block are not part of the tree.  The information is computed once,
+/// when the DominanceInfo is constructed, and is not updated when the CFG
+/// changes.
+class DominanceInfo {
+  /// RPO - The reachable blocks in reverse post-order.  Blocks are referred
+  /// to by their index in this list below.
+  std::vector<BasicBlock*> RPO;
+
+  /// RPONumbers - The index of each reachable block in RPO.
+  llvm::DenseMap<const BasicBlock*, unsigned> RPONumbers;
+
+  /// IDoms - The index of the immediate dominator of each block.  The entry
+  /// block is its own immediate dominator.
+  std::vector<unsigned> IDoms;
+
+  /// Frontiers - The dominance frontier of each block.
+  std::vector<SmallVector<BasicBlock*, 4>> Frontiers;
+
+  DominanceInfo(const DominanceInfo &) = delete;
+  void operator=(const DominanceInfo &) = delete;
+
+public:
+  explicit DominanceInfo(Function &F);
+
+  /// getRPONumber - Return the position of the given reachable block in
+  /// reverse post-order.  A block has a larger number than its dominators.
+  unsigned getRPONumber(const BasicBlock *BB) const {
+    auto I = RPONumbers.find(BB);
+    assert(I != RPONumbers.end() && "Block is unreachable");
+    return I->second;
+  }
+
+  /// isReachable - Return true if the block is reachable from the entry
+  /// block.
+  bool isReachable(const BasicBlock *BB) const {
+    return RPONumbers.count(BB);
+  }
+
+  /// getIDom - Return the immediate dominator of the given reachable block,
+  /// or null for the entry block.
+  BasicBlock *getIDom(const BasicBlock *BB) const {
+    unsigned N = getRPONumber(BB);
+    return N == 0 ? nullptr : RPO[IDoms[N]];
+  }
+
+  /// dominates - Return true if every path from the entry block to B goes
+  /// through A.  A block dominates itself.
+  bool dominates(const BasicBlock *A, const BasicBlock *B) const;
+
+  /// properlyDominates - Return true if A dominates B and is not B.
+  bool properlyDominates(const BasicBlock *A, const BasicBlock *B) const {
+    return A != B && dominates(A, B);
+  }
+
+  /// getDominanceFrontier - Return the blocks that the given reachable block
+  /// does not strictly dominate but which have a predecessor it dominates.
+  ArrayRef<BasicBlock*> getDominanceFrontier(const BasicBlock *BB) const {
+    return Frontiers[getRPONumber(BB)];
+  }
+
+  /// getReversePostOrder - Return the reachable blocks in reverse
+  /// post-order, so that every block comes after its dominators.
+  ArrayRef<BasicBlock*> getReversePostOrder() const { return RPO; }
+};
+
+} // end swift namespace
+
+#endif
@@ -32,6 +32,7 @@ public:
 
 private:
   friend class BasicBlock;
+  friend class SILReader;
 
   /// Context - This is the context that uniques the types used by this
   /// Function.
@@ -50,6 +51,13 @@ public:
   /// responsibility to 'delete' this object.
   static Function *constructSIL(FuncExpr *FE);
 
+  /// Construct a SIL function for the top-level code of a translation unit,
+  /// from the given decl on, including the initializers of its global
+  /// variables.  Returns null if there is no top-level code.  It is the
+  /// caller's responsibility to 'delete' this object.
+  static Function *constructTopLevelSIL(TranslationUnit *TU,
+                                        unsigned StartElem = 0);
+
   ASTContext &getContext() const { return Context; }
 
   //===--------------------------------------------------------------------===//
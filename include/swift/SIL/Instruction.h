@@ -25,6 +25,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/ilist_node.h"
 #include "llvm/ADT/ilist.h"
+#include <utility>
 
 namespace swift {
 
@@ -104,10 +105,31 @@ public:
   void removeFromParent();
   
   /// eraseFromParent - This method unlinks 'this' from the containing basic
-  /// block and deletes it.
+  /// block and deletes it.  The instruction must not have any uses.
   ///
   void eraseFromParent();
 
+  //===--------------------------------------------------------------------===//
+  // Operand Inspection and Manipulation
+  //===--------------------------------------------------------------------===//
+
+  /// getAllOperands - Return all of the operands of this instruction.
+  MutableArrayRef<Operand> getAllOperands();
+  ArrayRef<Operand> getAllOperands() const {
+    return const_cast<Instruction*>(this)->getAllOperands();
+  }
+
+  unsigned getNumOperands() const { return getAllOperands().size(); }
+
+  Value *getOperand(unsigned Num) const {
+    return getAllOperands()[Num].get();
+  }
+  void setOperand(unsigned Num, Value *V) { getAllOperands()[Num].set(V); }
+
+  /// dropAllReferences - Drop every operand of this instruction, removing it
+  /// from the use lists of the values it used.
+  void dropAllReferences();
+
   static bool classof(const Value *I) {
     return I->getKind() >= ValueKind::First_Instruction &&
            I->getKind() <= ValueKind::Last_Instruction;
@@ -115,6 +137,37 @@ public:
 };
 
 
+/// FixedOperandList - The operands of an instruction that always has the same
+/// number of them.
+template <unsigned N>
+class FixedOperandList {
+  Operand Buffer[N];
+
+  FixedOperandList(const FixedOperandList &) = delete;
+  void operator=(const FixedOperandList &) = delete;
+
+public:
+  template <class... T>
+  FixedOperandList(Instruction *User, T&&...OperandValues)
+    : Buffer{ { User, std::forward<T>(OperandValues) }... } {
+    static_assert(sizeof...(OperandValues) == N,
+                  "Initializing the wrong number of operands");
+  }
+
+  MutableArrayRef<Operand> asArray() { return Buffer; }
+  ArrayRef<Operand> asArray() const { return Buffer; }
+
+  Operand &operator[](unsigned i) { return Buffer[i]; }
+  const Operand &operator[](unsigned i) const { return Buffer[i]; }
+};
+
+/// NO_OPERANDS - The getAllOperands implementation of an instruction that
+/// has no operands.
+#define NO_OPERANDS \
+  MutableArrayRef<Operand> getAllOperands() { \
+    return MutableArrayRef<Operand>(); \
+  }
+
 /// AllocInst - This is the abstract base class common among all the memory
 /// allocation mechanisms.  This can allocate heap or stack memory.
 class AllocInst : public Instruction {
@@ -143,6 +196,8 @@ public:
   /// getDecl - Return the underlying declaration.
   VarDecl *getDecl() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::AllocVarInst;
   }
@@ -159,6 +214,8 @@ public:
 
   AllocTmpInst(MaterializeExpr *E);
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::AllocTmpInst;
   }
@@ -172,13 +229,15 @@ public:
 ///
 class AllocArrayInst : public Instruction {
   Type ElementType;
-  Value *NumElements;
+  FixedOperandList<1> Operands;
 public:
 
   AllocArrayInst(Expr *E, Type ElementType, Value *NumElements);
 
   Type getElementType() const { return ElementType; }
-  Value *getNumElements() const { return NumElements; }
+  Value *getNumElements() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
 
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::AllocArrayInst;
@@ -188,12 +247,11 @@ public:
 
 /// ApplyInst - Represents application of an argument to a function.
 class ApplyInst : public Instruction {
-  /// The instruction representing the called function.
-  Value *Callee;
-
+  /// The number of arguments.  The operands, tail-allocated after the
+  /// instruction, are the callee followed by the arguments.
   unsigned NumArgs;
-  Value **getArgsStorage() { return reinterpret_cast<Value**>(this + 1); }
-  
+  Operand *getOperandsStorage() { return reinterpret_cast<Operand*>(this + 1); }
+
   /// Construct an ApplyInst from a given call expression and the provided
   /// arguments.
   ApplyInst(SILLocation Loc, Type Ty, Value *Callee, ArrayRef<Value*> Args);
@@ -204,16 +262,19 @@ public:
   static ApplyInst *create(Value *Callee, ArrayRef<Value*> Args, Function &F);
 
   
-  Value *getCallee() { return Callee; }
-  
+  /// The instruction representing the called function.
+  Value *getCallee() const { return getAllOperands()[0].get(); }
+
   /// The arguments passed to this ApplyInst.
-  MutableArrayRef<Value*> getArguments() {
-    return MutableArrayRef<Value*>(getArgsStorage(), NumArgs);
+  OperandValueArrayRef getArguments() const {
+    return OperandValueArrayRef(getAllOperands().slice(1));
   }
 
-  /// The arguments passed to this ApplyInst.
-  ArrayRef<Value*> getArguments() const {
-    return const_cast<ApplyInst*>(this)->getArguments();
+  MutableArrayRef<Operand> getAllOperands() {
+    return MutableArrayRef<Operand>(getOperandsStorage(), NumArgs + 1);
+  }
+  ArrayRef<Operand> getAllOperands() const {
+    return const_cast<ApplyInst*>(this)->getAllOperands();
   }
 
   static bool classof(const Value *I) {
@@ -237,6 +298,8 @@ public:
   /// getDecl - Return the underlying declaration.
   ValueDecl *getDecl() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::ConstantRefInst;
   }
@@ -248,6 +311,8 @@ class ZeroValueInst : public Instruction {
 public:
   ZeroValueInst(VarDecl *D);
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::ZeroValueInst;
   }
@@ -264,6 +329,8 @@ public:
   /// getValue - Return the APInt for the underlying integer literal.
   APInt getValue() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::IntegerLiteralInst;
   }
@@ -280,6 +347,8 @@ public:
   /// getValue - Return the APFloat for the underlying FP literal.
   APFloat getValue() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::FloatLiteralInst;
   }
@@ -296,6 +365,8 @@ public:
   /// getValue - Return the value for the underlying literal.
   uint32_t getValue() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::CharacterLiteralInst;
   }
@@ -312,6 +383,8 @@ public:
   /// getValue - Return the string data for the literal.
   StringRef getValue() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::StringLiteralInst;
   }
@@ -323,8 +396,8 @@ public:
 /// memory uninitialized.
 class LoadInst : public Instruction {
   /// The LValue (memory address) to use for the load.
-  Value *LValue;
-  
+  FixedOperandList<1> Operands;
+
   /// IsTake - True if the result of the load instruction takes ownership of the
   /// value and deinitializes the lvalue.
   bool IsTake;
@@ -340,10 +413,12 @@ public:
   ///        lvalue.
   LoadInst(LoadExpr *E, Value *LValue, bool IsTake = false);
 
-  Value *getLValue() const { return LValue; }
-  
+  Value *getLValue() const { return Operands[0].get(); }
+
   bool isTake() const { return IsTake; }
 
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::LoadInst;
   }
@@ -354,7 +429,8 @@ public:
 /// location.
 class StoreInst : public Instruction {
   /// The value being stored and the lvalue being stored to.
-  Value *Src, *Dest;
+  enum { Src, Dest };
+  FixedOperandList<2> Operands;
 
   /// IsInitialization - True if this is the initialization of a memory location
   /// that is uninitialized, not a general store.  In an initialization of an
@@ -367,11 +443,13 @@ public:
   StoreInst(MaterializeExpr *E, Value *Src, Value *Dest);
   StoreInst(Expr *E, bool isInitialization, Value *Src, Value *Dest);
 
-  Value *getSrc() const { return Src; }
-  Value *getDest() const { return Dest; }
+  Value *getSrc() const { return Operands[Src].get(); }
+  Value *getDest() const { return Operands[Dest].get(); }
 
   bool isInitialization() const { return IsInitialization; }
 
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::StoreInst;
   }
@@ -384,10 +462,9 @@ public:
 /// but a copy instruction can be used with types that cannot be
 /// loaded, such as resilient value types.
 class CopyInst : public Instruction {
-  /// Src - The lvalue being loaded from.
-  Value *Src;
-  /// Dest - The lvalue being stored to.
-  Value *Dest;
+  /// The lvalue being loaded from and the lvalue being stored to.
+  enum { Src, Dest };
+  FixedOperandList<2> Operands;
   
   /// IsTakeOfSrc - True if ownership will be taken from the value at the source
   /// memory location.
@@ -401,11 +478,13 @@ public:
            Value *Src, Value *Dest,
            bool IsTakeOfSrc, bool IsInitializationOfDest);
   
-  Value *getSrc() const { return Src; }
-  Value *getDest() const { return Dest; }
+  Value *getSrc() const { return Operands[Src].get(); }
+  Value *getDest() const { return Operands[Dest].get(); }
   bool isTakeOfSrc() const { return IsTakeOfSrc; }
   bool isInitializationOfDest() const { return IsInitializationOfDest; }
-  
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::CopyInst;
   }
@@ -421,12 +500,14 @@ public:
 ///
 class SpecializeInst : public Instruction {
   /// The value being specialized.  It always has FunctionType.
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
 
   SpecializeInst(SpecializeExpr *SE, Value *Operand, Type DestTy);
 
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
 
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::SpecializeInst;
@@ -437,12 +518,14 @@ public:
 /// TypeConversionInst - Change the Type of some value without affecting how it
 /// will codegen.
 class TypeConversionInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
   TypeConversionInst(ImplicitConversionExpr *E, Value *Operand);
   TypeConversionInst(Type Ty, Value *Operand);
 
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::TypeConversionInst;
@@ -452,8 +535,8 @@ public:
 
 /// TupleInst - Represents a constructed tuple.
 class TupleInst : public Instruction {
-  Value **getElementsStorage() {
-    return reinterpret_cast<Value**>(this + 1);
+  Operand *getElementsStorage() {
+    return reinterpret_cast<Operand*>(this + 1);
   }
   unsigned NumArgs;
 
@@ -465,13 +548,15 @@ class TupleInst : public Instruction {
 
 public:
   /// The elements referenced by this TupleInst.
-  MutableArrayRef<Value*> getElements() {
-    return MutableArrayRef<Value*>(getElementsStorage(), NumArgs);
+  OperandValueArrayRef getElements() const {
+    return OperandValueArrayRef(getAllOperands());
   }
 
-  /// The elements referenced by this TupleInst.
-  ArrayRef<Value*> getElements() const {
-    return const_cast<TupleInst*>(this)->getElements();
+  MutableArrayRef<Operand> getAllOperands() {
+    return MutableArrayRef<Operand>(getElementsStorage(), NumArgs);
+  }
+  ArrayRef<Operand> getAllOperands() const {
+    return const_cast<TupleInst*>(this)->getAllOperands();
   }
 
   /// Construct a TupleInst.  The two forms are used to ensure that these are
@@ -506,6 +591,8 @@ public:
   /// returns.
   Type getMetaType() const;
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::MetatypeInst;
   }
@@ -514,14 +601,16 @@ public:
 
 /// TupleElementInst - Extract a numbered element out of a value of tuple type.
 class TupleElementInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
   unsigned FieldNo;
 public:
   TupleElementInst(TupleElementExpr *E, Value *Operand, unsigned FieldNo);
   TupleElementInst(Type ResultTy, Value *Operand, unsigned FieldNo);
   
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
   unsigned getFieldNo() const { return FieldNo; }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::TupleElementInst;
@@ -530,11 +619,13 @@ public:
 
 /// RetainInst - Increase the retain count of a value.
 class RetainInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
   RetainInst(Expr *E, Value *Operand);
   
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::RetainInst;
@@ -544,11 +635,13 @@ public:
 /// ReleaseInst - Decrease the retain count of a value, and dealloc the value
 /// if its retain count is zero.
 class ReleaseInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
   ReleaseInst(Expr *E, Value *Operand);
   
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::ReleaseInst;
@@ -557,11 +650,13 @@ public:
 
 /// DeallocInst - Dealloc a value, releasing any resources it owns.
 class DeallocInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
   DeallocInst(Expr *E, Value *Operand);
   
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::DeallocInst;
@@ -576,14 +671,16 @@ public:
 /// but a destroy instruction can be used for types that cannot be loaded,
 /// such as resilient value types.
 class DestroyInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
 public:
   DestroyInst(Expr *E, Value *Operand);
   
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
   
   static bool classof(const Value *I) {
-    return I->getKind() == ValueKind::ReleaseInst;
+    return I->getKind() == ValueKind::DestroyInst;
   }
 };
 
@@ -596,14 +693,16 @@ public:
 /// This takes an lvalue and indexes over the pointer, striding by the type of
 /// the lvalue.  This is used to index into arrays of uniform elements.
 class IndexLValueInst : public Instruction {
-  Value *Operand;
+  FixedOperandList<1> Operands;
   unsigned Index;
 public:
   IndexLValueInst(Expr *E, Value *Operand, unsigned Index);
 
-  Value *getOperand() const { return Operand; }
+  Value *getOperand() const { return Operands[0].get(); }
   unsigned getIndex() const { return Index; }
 
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::IndexLValueInst;
   }
@@ -618,6 +717,8 @@ public:
 
   uint64_t getValue() const { return Val; }
 
+  NO_OPERANDS
+
   static bool classof(const Value *I) {
     return I->getKind() == ValueKind::IntegerValueInst;
   }
@@ -656,7 +757,9 @@ public:
 class UnreachableInst : public TermInst {
 public:
   UnreachableInst(Function &F);
-  
+
+  NO_OPERANDS
+
   SuccessorListTy getSuccessors() {
     // No Successors.
     return SuccessorListTy();
@@ -670,8 +773,8 @@ public:
 /// ReturnInst - Representation of a ReturnStmt.
 class ReturnInst : public TermInst {
   /// The value to be returned.  This is never null.
-  Value *ReturnValue;
-  
+  FixedOperandList<1> Operands;
+
 public:
   /// Constructs a ReturnInst representing an \b explicit return.
   ///
@@ -681,7 +784,9 @@ public:
   ///
   ReturnInst(ReturnStmt *S, Value *ReturnValue);
 
-  Value *getReturnValue() const { return ReturnValue; }
+  Value *getReturnValue() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
 
   SuccessorListTy getSuccessors() {
     // No Successors.
@@ -693,19 +798,41 @@ public:
   }
 };
 
-/// BranchInst - An unconditional branch.
+/// BranchInst - An unconditional branch.  The branch passes a value for each
+/// of the arguments of its destination block.
 class BranchInst : public TermInst {
-  llvm::ArrayRef<Value*> Arguments;
   SILSuccessor DestBB;
+
+  /// The number of arguments, which are tail-allocated after the instruction
+  /// as operands.
+  unsigned NumArgs;
+  Operand *getArgsStorage() { return reinterpret_cast<Operand*>(this + 1); }
+
+  /// Private constructor.  Because of the storage requirements of
+  /// BranchInst, object creation goes through 'create()'.
+  BranchInst(BasicBlock *DestBB, ArrayRef<Value*> Args, Function &F);
+
 public:
-  typedef ArrayRef<Value*> ArgsTy;
-  
-  /// Construct an BranchInst that will branches to the specified block.
-  BranchInst(BasicBlock *DestBB, Function &F);
-  
+  typedef OperandValueArrayRef ArgsTy;
+
+  /// Construct a BranchInst that will branch to the specified block, passing
+  /// it the given arguments.
+  static BranchInst *create(BasicBlock *DestBB, ArrayRef<Value*> Args,
+                            Function &F);
+
   /// The jump target for the branch.
   BasicBlock *getDestBB() const { return DestBB; }
 
+  /// The arguments passed to the destination block.
+  ArgsTy getArgs() const { return OperandValueArrayRef(getAllOperands()); }
+
+  MutableArrayRef<Operand> getAllOperands() {
+    return MutableArrayRef<Operand>(getArgsStorage(), NumArgs);
+  }
+  ArrayRef<Operand> getAllOperands() const {
+    return const_cast<BranchInst*>(this)->getAllOperands();
+  }
+
   SuccessorListTy getSuccessors() {
     return DestBB;
   }
@@ -717,7 +844,7 @@ public:
 
 class CondBranchInst : public TermInst {
   /// The condition value used for the branch.
-  Value *Condition;
+  FixedOperandList<1> Operands;
 
   SILSuccessor DestBBs[2];
 public:
@@ -725,7 +852,9 @@ public:
   CondBranchInst(Stmt *TheStmt, Value *Condition,
                  BasicBlock *TrueBB, BasicBlock *FalseBB);
 
-  Value *getCondition() const { return Condition; }
+  Value *getCondition() const { return Operands[0].get(); }
+
+  MutableArrayRef<Operand> getAllOperands() { return Operands.asArray(); }
 
   SuccessorListTy getSuccessors() {
     return DestBBs;
@@ -744,6 +873,8 @@ public:
   }
 };
 
+#undef NO_OPERANDS
+
 } // end swift namespace
 
 //===----------------------------------------------------------------------===//
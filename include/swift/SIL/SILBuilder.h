@@ -250,8 +250,9 @@ public:
                                                Target1, Target2));
   }
     
-  BranchInst *createBranch(BasicBlock *TargetBlock) {
-    return insertTerminator(new BranchInst(TargetBlock, F));
+  BranchInst *createBranch(BasicBlock *TargetBlock,
+                           ArrayRef<Value*> Args = ArrayRef<Value*>()) {
+    return insertTerminator(BranchInst::create(TargetBlock, Args, F));
   }
 
 
@@ -0,0 +1,105 @@
+//===--- SILModule.h - Defines the SILModule class --------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the SILModule class, which holds the SIL for a whole
+// TranslationUnit.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_SILMODULE_H
+#define SWIFT_SIL_SILMODULE_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include <utility>
+#include <vector>
+
+namespace swift {
+class FuncDecl;
+class Function;
+class TranslationUnit;
+
+/// SILModule - The SIL for a TranslationUnit: a Function for the body of
+/// each of its top-level functions, and one for its top-level code, which
+/// includes the initializers of its global variables.  The module owns its
+/// functions.
+class SILModule {
+public:
+  typedef std::vector<std::pair<FuncDecl*, Function*>> FunctionListType;
+
+private:
+  TranslationUnit *TU;
+
+  /// Functions - The functions of the module, in declaration order.
+  FunctionListType Functions;
+
+  /// FunctionIndex - The position of each function in Functions.
+  llvm::DenseMap<FuncDecl*, unsigned> FunctionIndex;
+
+  /// TopLevelCode - The function for the top-level code, or null if the
+  /// translation unit has none.
+  Function *TopLevelCode;
+
+  // Intentionally marked private so that we need to use 'constructSIL()'
+  // to construct a SILModule.
+  explicit SILModule(TranslationUnit *TU) : TU(TU), TopLevelCode(nullptr) {}
+
+  SILModule(const SILModule &) = delete;
+  void operator=(const SILModule &) = delete;
+
+public:
+  ~SILModule();
+
+  /// constructSIL - Lower the declarations of a translation unit, from
+  /// StartElem on, to SIL.  Function bodies are independent of each other,
+  /// and are emitted on up to NumThreads threads; 0 means one per hardware
+  /// thread.  It is the caller's responsibility to 'delete' this object.
+  static SILModule *constructSIL(TranslationUnit *TU, unsigned StartElem = 0,
+                                 unsigned NumThreads = 0);
+
+  TranslationUnit *getTranslationUnit() const { return TU; }
+
+  //===--------------------------------------------------------------------===//
+  // Function List Access
+  //===--------------------------------------------------------------------===//
+
+  typedef FunctionListType::const_iterator iterator;
+
+  bool empty() const { return Functions.empty() && !TopLevelCode; }
+  iterator begin() const { return Functions.begin(); }
+  iterator end() const { return Functions.end(); }
+
+  /// getFunction - Return the SIL for the body of the given function, or
+  /// null if it is not part of the module.
+  Function *getFunction(FuncDecl *FD) const;
+
+  /// getTopLevelCode - Return the SIL for the top-level code, or null if
+  /// there is none.
+  Function *getTopLevelCode() const { return TopLevelCode; }
+
+  //===--------------------------------------------------------------------===//
+  // Miscellaneous
+  //===--------------------------------------------------------------------===//
+
+  /// verify - Run the SIL verifier over every function in the module.
+  void verify() const;
+
+  /// Pretty-print the module.
+  void dump() const;
+
+  /// Pretty-print the module with the designated stream.
+  void print(raw_ostream &OS) const;
+};
+
+} // end swift namespace
+
+#endif
@@ -0,0 +1,113 @@
+//===--- SILPassManager.h - Running Passes over SIL -------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the SILFunctionPass and SILPassManager classes, which
+// run transformations over SIL Functions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_SILPASSMANAGER_H
+#define SWIFT_SIL_SILPASSMANAGER_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/OwningPtr.h"
+#include <vector>
+
+namespace llvm {
+  class Timer;
+  class TimerGroup;
+}
+
+namespace swift {
+class Function;
+
+/// SILFunctionPass - A transformation that runs over a single SIL Function
+/// at a time.  Passes may not look at or change any other function.
+class SILFunctionPass {
+  const char *Name;
+
+  SILFunctionPass(const SILFunctionPass &) = delete;
+  void operator=(const SILFunctionPass &) = delete;
+
+public:
+  explicit SILFunctionPass(const char *Name) : Name(Name) {}
+  virtual ~SILFunctionPass();
+
+  /// getName - Return the name of the pass, as used in timing and statistics
+  /// reports.
+  const char *getName() const { return Name; }
+
+  /// runOnFunction - Run the pass over the given function.  Returns true if
+  /// the function was changed.
+  virtual bool runOnFunction(Function &F) = 0;
+};
+
+/// SILPassManager - Runs a pipeline of SILFunctionPasses.  Each function is
+/// taken through the whole pipeline before the next one is started, so that
+/// the function being worked on stays hot.  The pass manager owns its passes.
+class SILPassManager {
+public:
+  struct Options {
+    /// VerifyAfterEachPass - Run the SIL verifier on a function after every
+    /// pass that changed it.
+    bool VerifyAfterEachPass = false;
+
+    /// PrintAfterEachPass - Print a function to stderr after every pass that
+    /// changed it.
+    bool PrintAfterEachPass = false;
+
+    /// TimePasses - Time each pass.  The report is printed when the pass
+    /// manager is destroyed.
+    bool TimePasses = false;
+  };
+
+private:
+  /// PassEntry - A pass in the pipeline, with its statistics.
+  struct PassEntry {
+    SILFunctionPass *Pass;
+    llvm::Timer *Timer;
+
+    /// NumRuns - The number of functions the pass has been run over.
+    unsigned NumRuns;
+
+    /// NumChanged - The number of those functions the pass changed.
+    unsigned NumChanged;
+  };
+
+  Options Opts;
+  std::vector<PassEntry> Passes;
+  llvm::OwningPtr<llvm::TimerGroup> Timers;
+
+  SILPassManager(const SILPassManager &) = delete;
+  void operator=(const SILPassManager &) = delete;
+
+public:
+  explicit SILPassManager(const Options &Opts = Options());
+  ~SILPassManager();
+
+  /// add - Add a pass to the end of the pipeline, taking ownership of it.
+  void add(SILFunctionPass *P);
+
+  bool empty() const { return Passes.empty(); }
+
+  /// run - Run the pipeline over the given function.  Returns true if any
+  /// pass changed it.
+  bool run(Function &F);
+
+  /// printStatistics - Print how often each pass ran and how often it
+  /// changed something.
+  void printStatistics(raw_ostream &OS) const;
+};
+
+} // end swift namespace
+
+#endif
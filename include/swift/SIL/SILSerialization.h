@@ -0,0 +1,125 @@
+//===--- SILSerialization.h - In-Process SIL Cache --------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the interface for caching SIL Functions in a compact
+// binary form and reading them back, without going back to the AST and
+// SILGen.
+//
+// The encoding is an in-process index, not an on-disk format.  Types and source
+// locations are written as indexes into a SILSerializationTable, which holds
+// pointers into the ASTContext, so a stream can only be read back by the
+// process that wrote it, against the same table and context.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_SILSERIALIZATION_H
+#define SWIFT_SIL_SILSERIALIZATION_H
+
+#include "swift/Basic/LLVM.h"
+#include "swift/AST/Type.h"
+#include "swift/SIL/SILLocation.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/OwningPtr.h"
+#include <vector>
+
+namespace llvm {
+  class MemoryBuffer;
+}
+
+namespace swift {
+class ASTContext;
+class Function;
+class TypeBase;
+
+/// SILSerializationTable - The types and AST nodes that serialized SIL refers
+/// to, by index.  Serialized SIL does not spell out types or source
+/// locations; it refers to them through the table of the module it was
+/// written for.  All the functions of a module share one table, and they
+/// must be read back with the table they were written with, while the
+/// ASTContext that owns the types is still alive.
+class SILSerializationTable {
+  /// Types - The types in the table.  Index 0 is the null type.
+  std::vector<TypeBase*> Types;
+  llvm::DenseMap<TypeBase*, unsigned> TypeIDs;
+
+  /// Locations - The AST nodes in the table.  Index 0 is the null location.
+  std::vector<SILLocation> Locations;
+  llvm::DenseMap<void*, unsigned> LocationIDs;
+
+public:
+  SILSerializationTable();
+
+  /// getTypeID - Return the index of the given type, adding it to the table
+  /// if it is not there yet.
+  unsigned getTypeID(Type Ty);
+
+  /// getType - Return the type with the given index.
+  Type getType(unsigned ID) const { return Types[ID]; }
+
+  unsigned getNumTypes() const { return Types.size(); }
+
+  /// getLocationID - Return the index of the given location, adding it to
+  /// the table if it is not there yet.
+  unsigned getLocationID(SILLocation Loc);
+
+  /// getLocation - Return the location with the given index.
+  SILLocation getLocation(unsigned ID) const { return Locations[ID]; }
+
+  unsigned getNumLocations() const { return Locations.size(); }
+};
+
+/// writeSIL - Write the given functions to the stream in the binary SIL
+/// format, adding the types and locations they use to the table.
+void writeSIL(ArrayRef<const Function*> Functions,
+              SILSerializationTable &Table, raw_ostream &OS);
+
+/// SILReader - Reads back functions written by writeSIL in this process.
+/// Opening a buffer only finds where each function starts; functions are
+/// decoded one at a time, on demand, so a reader can sit on top of a large
+/// buffer and only touch the functions that are needed.
+class SILReader {
+  ASTContext &Context;
+  const SILSerializationTable &Table;
+  llvm::OwningPtr<llvm::MemoryBuffer> Buffer;
+
+  /// FunctionOffsets - The bit offset of each function in the buffer.
+  std::vector<uint64_t> FunctionOffsets;
+
+  /// Malformed - Whether the buffer is not a valid SIL stream.
+  bool Malformed;
+
+  SILReader(const SILReader &) = delete;
+  void operator=(const SILReader &) = delete;
+
+public:
+  /// Create a reader for the given buffer, taking ownership of it.
+  SILReader(llvm::MemoryBuffer *Buffer, ASTContext &Context,
+            const SILSerializationTable &Table);
+  ~SILReader();
+
+  /// isMalformed - Return true if the buffer is not a valid SIL stream.
+  bool isMalformed() const { return Malformed; }
+
+  /// getNumFunctions - Return the number of functions in the buffer, in the
+  /// order they were written.
+  unsigned getNumFunctions() const { return FunctionOffsets.size(); }
+
+  /// readFunction - Decode the function with the given index.  Returns null
+  /// if its encoding is malformed.  The caller is responsible for deleting
+  /// the function.
+  Function *readFunction(unsigned Index);
+};
+
+} // end swift namespace
+
+#endif
@@ -18,8 +18,14 @@
 #define SWIFT_SIL_VALUE_H
 
 #include "swift/AST/Type.h"
+#include "swift/SIL/SILBase.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace swift {
+  class Instruction;
+  class Operand;
+  class ValueUseIterator;
+
   enum class ValueKind {
 #define VALUE(Id, Parent) Id,
 #define VALUE_RANGE(Id, FirstId, LastId) \
@@ -30,20 +36,183 @@ namespace swift {
   /// Value - This class is a value that can be used as an "operand" to an
   /// instruction.  It is either a reference to another instruction, or an
   /// incoming basic block argument.
+  ///
+  /// Every Value keeps a list of the Operands that use it, so that the users
+  /// of a value can be found (and rewritten) without scanning the function.
   class Value : public SILAllocated<Value> {
     Type Ty;
     const ValueKind Kind;
+
+    /// FirstUse - The head of the list of operands that refer to this value.
+    /// This is automatically managed by the Operand class.
+    Operand *FirstUse;
+    friend class Operand;
+
   protected:
-    Value(ValueKind Kind, Type Ty) : Ty(Ty), Kind(Kind) {}
+    Value(ValueKind Kind, Type Ty) : Ty(Ty), Kind(Kind), FirstUse(nullptr) {}
   public:
 
     ValueKind getKind() const { return Kind; }
     Type getType() const { return Ty; }
 
+    //===------------------------------------------------------------------===//
+    // Use List Inspection and Manipulation
+    //===------------------------------------------------------------------===//
+
+    typedef ValueUseIterator use_iterator;
+
+    inline use_iterator use_begin() const;
+    inline use_iterator use_end() const;
+
+    /// use_empty - Return true if nothing uses this value.
+    bool use_empty() const { return FirstUse == nullptr; }
+
+    /// hasOneUse - Return true if exactly one operand uses this value.
+    inline bool hasOneUse() const;
+
+    /// replaceAllUsesWith - Change every operand that uses this value to use
+    /// the given value instead.  Afterwards, this value has no uses.
+    void replaceAllUsesWith(Value *Other);
+
     /// Pretty-print the Instruction.
     void dump() const;
     void print(raw_ostream &OS) const;
   };
+
+  /// Operand - A reference from an Instruction to a Value that it uses.  Each
+  /// operand is linked into the use list of the value it refers to, and
+  /// unlinks itself when it is changed or dropped.
+  class Operand {
+    /// TheValue - The value being used, or null if the operand was dropped.
+    Value *TheValue;
+
+    /// NextUse - The next operand in the use list of TheValue.
+    Operand *NextUse;
+
+    /// Back - The pointer to this operand in the use list of TheValue:
+    /// either TheValue->FirstUse or the NextUse of the previous operand.
+    Operand **Back;
+
+    /// Owner - The instruction that this operand belongs to.
+    Instruction *Owner;
+
+    Operand(const Operand &) = delete;
+    void operator=(const Operand &) = delete;
+
+  public:
+    Operand(Instruction *Owner)
+      : TheValue(nullptr), NextUse(nullptr), Back(nullptr), Owner(Owner) {}
+    Operand(Instruction *Owner, Value *TheValue)
+      : TheValue(TheValue), NextUse(nullptr), Back(nullptr), Owner(Owner) {
+      insertIntoCurrent();
+    }
+    ~Operand() { removeFromCurrent(); }
+
+    /// get - Return the value being used.
+    Value *get() const { return TheValue; }
+
+    /// set - Change the value being used, moving this operand from the use
+    /// list of the old value to that of the new one.
+    void set(Value *NewValue) {
+      removeFromCurrent();
+      TheValue = NewValue;
+      insertIntoCurrent();
+    }
+
+    /// drop - Stop using the current value.
+    void drop() {
+      removeFromCurrent();
+      TheValue = nullptr;
+    }
+
+    /// getUser - Return the instruction that uses the value.
+    Instruction *getUser() { return Owner; }
+    const Instruction *getUser() const { return Owner; }
+
+    /// getOperandNumber - Return the index of this operand within the
+    /// operands of its user.
+    unsigned getOperandNumber() const;
+
+  private:
+    void removeFromCurrent() {
+      if (!Back) return;
+      *Back = NextUse;
+      if (NextUse) NextUse->Back = Back;
+      NextUse = nullptr;
+      Back = nullptr;
+    }
+
+    void insertIntoCurrent() {
+      if (!TheValue) return;
+      Back = &TheValue->FirstUse;
+      NextUse = TheValue->FirstUse;
+      if (NextUse) NextUse->Back = &NextUse;
+      TheValue->FirstUse = this;
+    }
+
+    friend class Value;
+    friend class ValueUseIterator;
+  };
+
+  /// ValueUseIterator - An iterator over the operands that use a Value.
+  class ValueUseIterator {
+    Operand *Cur;
+  public:
+    explicit ValueUseIterator(Operand *Cur = nullptr) : Cur(Cur) {}
+
+    bool operator==(ValueUseIterator I2) const { return Cur == I2.Cur; }
+    bool operator!=(ValueUseIterator I2) const { return Cur != I2.Cur; }
+
+    ValueUseIterator &operator++() {
+      assert(Cur && "Trying to advance past end");
+      Cur = Cur->NextUse;
+      return *this;
+    }
+
+    Operand *operator*() const { return Cur; }
+    Operand *operator->() const { return Cur; }
+
+    /// getUser - Return the instruction that the current operand belongs to.
+    Instruction *getUser() const { return Cur->getUser(); }
+  };
+
+  inline Value::use_iterator Value::use_begin() const {
+    return use_iterator(FirstUse);
+  }
+  inline Value::use_iterator Value::use_end() const {
+    return use_iterator();
+  }
+  inline bool Value::hasOneUse() const {
+    return FirstUse && !FirstUse->NextUse;
+  }
+
+  /// OperandValueArrayRef - A view of an array of operands that presents the
+  /// values they refer to, for instructions with a variable number of
+  /// operands.
+  class OperandValueArrayRef {
+    ArrayRef<Operand> Operands;
+  public:
+    explicit OperandValueArrayRef(ArrayRef<Operand> Operands)
+      : Operands(Operands) {}
+
+    /// iterator - An iterator over the values of the operands.
+    class iterator {
+      const Operand *Ptr;
+    public:
+      explicit iterator(const Operand *Ptr) : Ptr(Ptr) {}
+      Value *operator*() const { return Ptr->get(); }
+      iterator &operator++() { ++Ptr; return *this; }
+      bool operator==(iterator I2) const { return Ptr == I2.Ptr; }
+      bool operator!=(iterator I2) const { return Ptr != I2.Ptr; }
+    };
+
+    Value *operator[](unsigned i) const { return Operands[i].get(); }
+    unsigned size() const { return Operands.size(); }
+    bool empty() const { return Operands.empty(); }
+
+    iterator begin() const { return iterator(Operands.begin()); }
+    iterator end() const { return iterator(Operands.end()); }
+  };
 } // end namespace swift
 
 #endif
@@ -20,12 +20,16 @@
 namespace llvm {
   class Module;
   class FunctionPass;
+  class ModulePass;
 }
 
 namespace swift {
   class TranslationUnit;
   class ASTContext;
   class Component;
+  class TokenCache;
+  class SILFunctionPass;
+  class SILModule;
 
   namespace irgen {
     class Options;
@@ -39,10 +43,13 @@ namespace swift {
   /// parseIntoTranslationUnit - Parse a single buffer into the given
   /// taranslation unit.  If the translation unit is the main module, stop
   /// parsing after the next stmt-brace-item with side-effects.  Returns
-  /// the number of bytes parsed from the given buffer.
+  /// the number of bytes parsed from the given buffer.  If the buffer is
+  /// going to be parsed in several pieces, passing the same TokenCache to
+  /// each call avoids relexing it.
   bool parseIntoTranslationUnit(TranslationUnit *TU, unsigned BufferID,
                                 unsigned *BufferOffset = 0,
-                                unsigned BufferEndOffset = 0);
+                                unsigned BufferEndOffset = 0,
+                                TokenCache *Toks = 0);
 
   /// performNameBinding - Once parsing is complete, this walks the AST to
   /// resolve names and do other top-level validation.  StartElem indicates
@@ -63,13 +70,21 @@ namespace swift {
 
   /// performIRGeneration - Turn the given translation unit into
   /// either LLVM IR or native code.  StartElem indicates where to start for
-  /// incremental IRGen in the main module.
+  /// incremental IRGen in the main module.  If SILMod is given and
+  /// Opts.EmitFromSIL is set, the bodies of the functions in it are lowered
+  /// from their (possibly optimized) SIL wherever IRGen supports every
+  /// instruction used, and from the AST otherwise.
   void performIRGeneration(irgen::Options &Opts, llvm::Module *Module,
-                           TranslationUnit *TU, unsigned StartElem = 0);
+                           TranslationUnit *TU, unsigned StartElem = 0,
+                           SILModule *SILMod = nullptr);
 
   // Optimization passes.
   llvm::FunctionPass *createSwiftARCOptPass();
   llvm::FunctionPass *createSwiftARCExpandPass();
+  llvm::ModulePass *createSwiftClosureSpecializePass();
+
+  // SIL optimization passes.
+  SILFunctionPass *createSILMem2RegPass();
 } // end namespace swift
 
 #endif
@@ -19,6 +19,7 @@
 #include "swift/AST/DiagnosticEngine.h"
 #include "swift/AST/ExprHandle.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringMap.h"
@@ -26,6 +27,8 @@
 
 using namespace swift;
 
+typedef llvm::sys::SmartScopedLock<true> TypeLock;
+
 struct ASTContext::Implementation {
   Implementation();
   ~Implementation();
@@ -33,6 +36,13 @@ struct ASTContext::Implementation {
   llvm::BumpPtrAllocator Allocator; // used in later initializations
   llvm::StringMap<char, llvm::BumpPtrAllocator&> IdentifierTable;
 
+  /// TypeMutex - Guards the type uniquing tables, and the allocations made
+  /// for new types, so that types can be created from several threads at
+  /// once, as SIL emission does.  It is recursive because building one type
+  /// can build others, and it only locks once llvm_start_multithreaded() has
+  /// been called.  Creating AST nodes is not thread-safe.
+  llvm::sys::SmartMutex<true> TypeMutex;
+
   /// \brief Structure that captures data that is segregated into different
   /// arenas.
   struct Arena {
@@ -46,10 +56,11 @@ struct ASTContext::Implementation {
     llvm::DenseMap<std::pair<Type, LValueType::Qual::opaque_type>, LValueType*>
       LValueTypes;
     llvm::DenseMap<std::pair<Type, Type>, SubstitutedType *> SubstitutedTypes;
-    llvm::FoldingSet<OneOfType> OneOfTypes;
-    llvm::FoldingSet<StructType> StructTypes;
-    llvm::FoldingSet<ClassType> ClassTypes;
-    llvm::FoldingSet<UnboundGenericType> UnboundGenericTypes;
+    llvm::DenseMap<std::pair<OneOfDecl*, Type>, OneOfType*> OneOfTypes;
+    llvm::DenseMap<std::pair<StructDecl*, Type>, StructType*> StructTypes;
+    llvm::DenseMap<std::pair<ClassDecl*, Type>, ClassType*> ClassTypes;
+    llvm::DenseMap<std::pair<NominalTypeDecl*, Type>, UnboundGenericType*>
+      UnboundGenericTypes;
     llvm::FoldingSet<BoundGenericType> BoundGenericTypes;
   };
   
@@ -175,6 +186,7 @@ bool ASTContext::hadError() const {
 
 Optional<ArrayRef<Substitution>>
 ASTContext::getSubstitutions(BoundGenericType* Bound) {
+  TypeLock Lock(Impl.TypeMutex);
   assert(Bound->isCanonical() && "Requesting non-canonical substitutions");
   auto Known = Impl.BoundGenericSubstitutions.find(Bound);
   if (Known == Impl.BoundGenericSubstitutions.end())
@@ -185,6 +197,7 @@ ASTContext::getSubstitutions(BoundGenericType* Bound) {
 
 void ASTContext::setSubstitutions(BoundGenericType* Bound,
                                   ArrayRef<Substitution> Subs) {
+  TypeLock Lock(Impl.TypeMutex);
   assert(Bound->isCanonical() && "Requesting non-canonical substitutions");
   assert(Impl.BoundGenericSubstitutions.count(Bound) == 0 &&
          "Already have substitutions?");
@@ -203,6 +216,7 @@ Type UnstructuredUnresolvedType::get(ASTContext &C) {
 
 
 BuiltinIntegerType *BuiltinIntegerType::get(unsigned BitWidth, ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   BuiltinIntegerType *&Result = C.Impl.IntegerTypes[BitWidth];
   if (Result == 0)
     Result = new (C, AllocationArena::Permanent) BuiltinIntegerType(BitWidth,C);
@@ -216,6 +230,7 @@ static AllocationArena getArena(bool hasTypeVariable) {
 }
 
 ParenType *ParenType::get(ASTContext &C, Type underlying) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = underlying->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
   ParenType *&Result = C.Impl.getArena(arena).ParenTypes[underlying];
@@ -243,6 +258,8 @@ Type TupleType::get(ArrayRef<TupleTypeElt> Fields, ASTContext &C) {
   if (Fields.size() == 1 && !Fields[0].isVararg() && !Fields[0].hasName())
     return ParenType::get(C, Fields[0].getType());
 
+  TypeLock Lock(C.Impl.TypeMutex);
+
   bool HasAnyDefaultValues = false;
   bool HasTypeVariable = false;
 
@@ -295,29 +312,19 @@ Type TupleType::get(ArrayRef<TupleTypeElt> Fields, ASTContext &C) {
   return New;
 }
 
-void UnboundGenericType::Profile(llvm::FoldingSetNodeID &ID,
-                                 NominalTypeDecl *TheDecl, Type Parent) {
-  ID.AddPointer(TheDecl);
-  ID.AddPointer(Parent.getPointer());
-}
-
 UnboundGenericType* UnboundGenericType::get(NominalTypeDecl *TheDecl,
                                             Type Parent,
                                             ASTContext &C) {
-  llvm::FoldingSetNodeID ID;
-  UnboundGenericType::Profile(ID, TheDecl, Parent);
-  void *InsertPos = 0;
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Parent && Parent->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
-  if (auto unbound = C.Impl.getArena(arena).UnboundGenericTypes
-                        .FindNodeOrInsertPos(ID, InsertPos))
-    return unbound;
+  UnboundGenericType *&Entry
+    = C.Impl.getArena(arena).UnboundGenericTypes[{TheDecl, Parent}];
+  if (Entry) return Entry;
 
-  auto result = new (C, arena) UnboundGenericType(TheDecl, Parent, C,
-                                                  hasTypeVariable);
-  C.Impl.getArena(arena).UnboundGenericTypes.InsertNode(result, InsertPos);
-  return result;
+  return Entry = new (C, arena) UnboundGenericType(TheDecl, Parent, C,
+                                                   hasTypeVariable);
 }
 
 void BoundGenericType::Profile(llvm::FoldingSetNodeID &ID,
@@ -361,6 +368,7 @@ BoundGenericType *BoundGenericType::get(NominalTypeDecl *TheDecl,
                                         Type Parent,
                                         ArrayRef<Type> GenericArgs) {
   ASTContext &C = TheDecl->getDeclContext()->getASTContext();
+  TypeLock Lock(C.Impl.TypeMutex);
   llvm::FoldingSetNodeID ID;
   bool HasTypeVariable = false;
   BoundGenericType::Profile(ID, TheDecl, Parent, GenericArgs, HasTypeVariable);
@@ -425,25 +433,14 @@ OneOfType::OneOfType(OneOfDecl *TheDecl, Type Parent, ASTContext &C,
   : NominalType(TypeKind::OneOf, &C, TheDecl, Parent, HasTypeVariable) { }
 
 OneOfType *OneOfType::get(OneOfDecl *D, Type Parent, ASTContext &C) {
-  llvm::FoldingSetNodeID id;
-  OneOfType::Profile(id, D, Parent);
-
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Parent && Parent->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
-  void *insertPos = 0;
-  if (auto oneOfTy
-        = C.Impl.getArena(arena).OneOfTypes.FindNodeOrInsertPos(id, insertPos))
-    return oneOfTy;
+  OneOfType *&Entry = C.Impl.getArena(arena).OneOfTypes[{D, Parent}];
+  if (Entry) return Entry;
 
-  auto oneOfTy = new (C, arena) OneOfType(D, Parent, C, hasTypeVariable);
-  C.Impl.getArena(arena).OneOfTypes.InsertNode(oneOfTy, insertPos);
-  return oneOfTy;
-}
-
-void OneOfType::Profile(llvm::FoldingSetNodeID &ID, OneOfDecl *D, Type Parent) {
-  ID.AddPointer(D);
-  ID.AddPointer(Parent.getPointer());
+  return Entry = new (C, arena) OneOfType(D, Parent, C, hasTypeVariable);
 }
 
 StructType::StructType(StructDecl *TheDecl, Type Parent, ASTContext &C,
@@ -451,25 +448,14 @@ StructType::StructType(StructDecl *TheDecl, Type Parent, ASTContext &C,
   : NominalType(TypeKind::Struct, &C, TheDecl, Parent, HasTypeVariable) { }
 
 StructType *StructType::get(StructDecl *D, Type Parent, ASTContext &C) {
-  llvm::FoldingSetNodeID id;
-  StructType::Profile(id, D, Parent);
-
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Parent && Parent->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
-  void *insertPos = 0;
-  if (auto structTy
-        = C.Impl.getArena(arena).StructTypes.FindNodeOrInsertPos(id, insertPos))
-    return structTy;
-
-  auto structTy = new (C, arena) StructType(D, Parent, C, hasTypeVariable);
-  C.Impl.getArena(arena).StructTypes.InsertNode(structTy, insertPos);
-  return structTy;
-}
+  StructType *&Entry = C.Impl.getArena(arena).StructTypes[{D, Parent}];
+  if (Entry) return Entry;
 
-void StructType::Profile(llvm::FoldingSetNodeID &ID, StructDecl *D, Type Parent) {
-  ID.AddPointer(D);
-  ID.AddPointer(Parent.getPointer());
+  return Entry = new (C, arena) StructType(D, Parent, C, hasTypeVariable);
 }
 
 ClassType::ClassType(ClassDecl *TheDecl, Type Parent, ASTContext &C,
@@ -477,25 +463,14 @@ ClassType::ClassType(ClassDecl *TheDecl, Type Parent, ASTContext &C,
   : NominalType(TypeKind::Class, &C, TheDecl, Parent, HasTypeVariable) { }
 
 ClassType *ClassType::get(ClassDecl *D, Type Parent, ASTContext &C) {
-  llvm::FoldingSetNodeID id;
-  ClassType::Profile(id, D, Parent);
-
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Parent && Parent->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
-  void *insertPos = 0;
-  if (auto classTy
-        = C.Impl.getArena(arena).ClassTypes.FindNodeOrInsertPos(id, insertPos))
-    return classTy;
-
-  auto classTy = new (C, arena) ClassType(D, Parent, C, hasTypeVariable);
-  C.Impl.getArena(arena).ClassTypes.InsertNode(classTy, insertPos);
-  return classTy;
-}
+  ClassType *&Entry = C.Impl.getArena(arena).ClassTypes[{D, Parent}];
+  if (Entry) return Entry;
 
-void ClassType::Profile(llvm::FoldingSetNodeID &ID, ClassDecl *D, Type Parent) {
-  ID.AddPointer(D);
-  ID.AddPointer(Parent.getPointer());
+  return Entry = new (C, arena) ClassType(D, Parent, C, hasTypeVariable);
 }
 
 IdentifierType *IdentifierType::getNew(ASTContext &C,
@@ -506,6 +481,7 @@ IdentifierType *IdentifierType::getNew(ASTContext &C,
 
 ProtocolCompositionType *
 ProtocolCompositionType::build(ASTContext &C, ArrayRef<Type> Protocols) {
+  TypeLock Lock(C.Impl.TypeMutex);
   // Check to see if we've already seen this protocol composition before.
   void *InsertPos = 0;
   llvm::FoldingSetNodeID ID;
@@ -531,6 +507,7 @@ ProtocolCompositionType::build(ASTContext &C, ArrayRef<Type> Protocols) {
 
 
 MetaTypeType *MetaTypeType::get(Type T, ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = T->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
@@ -548,7 +525,8 @@ MetaTypeType::MetaTypeType(Type T, ASTContext *C, bool HasTypeVariable)
 
 ModuleType *ModuleType::get(Module *M) {
   ASTContext &C = M->getASTContext();
-  
+  TypeLock Lock(C.Impl.TypeMutex);
+
   ModuleType *&Entry = C.Impl.ModuleTypes[M];
   if (Entry) return Entry;
   
@@ -559,6 +537,7 @@ ModuleType *ModuleType::get(Module *M) {
 /// input and result.
 FunctionType *FunctionType::get(Type Input, Type Result, bool isAutoClosure,
                                 ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Input->hasTypeVariable() || Result->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
@@ -587,6 +566,7 @@ FunctionType::FunctionType(Type input, Type output, bool isAutoClosure,
 PolymorphicFunctionType *PolymorphicFunctionType::get(Type input, Type output,
                                                       GenericParamList *params,
                                                       ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   // FIXME: one day we should do canonicalization properly.
   bool hasTypeVariable = input->hasTypeVariable() || output->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
@@ -610,6 +590,7 @@ PolymorphicFunctionType::PolymorphicFunctionType(Type input, Type output,
 /// Return a uniqued array type with the specified base type and the
 /// specified size.
 ArrayType *ArrayType::get(Type BaseType, uint64_t Size, ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   assert(Size != 0);
 
   bool hasTypeVariable = BaseType->hasTypeVariable();
@@ -631,6 +612,7 @@ ArrayType::ArrayType(Type base, uint64_t size, bool hasTypeVariable)
 
 /// Return a uniqued array slice type with the specified base type.
 ArraySliceType *ArraySliceType::get(Type base, ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = base->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
@@ -645,6 +627,7 @@ ProtocolType::ProtocolType(ProtocolDecl *TheDecl, ASTContext &Ctx)
                 /*HasTypeVariable=*/false) { }
 
 LValueType *LValueType::get(Type objectTy, Qual quals, ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = objectTy->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
@@ -661,6 +644,7 @@ LValueType *LValueType::get(Type objectTy, Qual quals, ASTContext &C) {
 /// Return a uniqued substituted type.
 SubstitutedType *SubstitutedType::get(Type Original, Type Replacement,
                                       ASTContext &C) {
+  TypeLock Lock(C.Impl.TypeMutex);
   bool hasTypeVariable = Replacement->hasTypeVariable();
   auto arena = getArena(hasTypeVariable);
 
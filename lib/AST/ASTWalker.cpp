@@ -510,6 +510,11 @@ class Traversal : public ASTVisitor<Traversal, Expr*, Stmt*> {
           if (doIt(Set))
             return true;
         }
+
+        if (FuncDecl *Address = Var->getAddressor()) {
+          if (doIt(Address))
+            return true;
+        }
       }
       return false;
 
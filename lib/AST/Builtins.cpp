@@ -284,6 +284,44 @@ static Type getPointerSizeType(ASTContext &Context) {
   return BuiltinIntegerType::get(64, Context);
 }
 
+static ValueDecl *getDestroyArrayOperation(ASTContext &Context,
+                                           Identifier id) {
+  Type genericTy;
+  GenericParamList *paramList;
+  std::tie(genericTy, paramList) = getGenericParam(Context);
+
+  TupleTypeElt argElts[] = {
+    TupleTypeElt(MetaTypeType::get(genericTy, Context), Identifier()),
+    TupleTypeElt(Context.TheRawPointerType, Identifier()),
+    TupleTypeElt(getPointerSizeType(Context), Identifier())
+  };
+  Type argTy = TupleType::get(argElts, Context);
+  Type fnTy = PolymorphicFunctionType::get(argTy, TupleType::getEmpty(Context),
+                                           paramList, Context);
+  return new (Context) FuncDecl(SourceLoc(), SourceLoc(), id, SourceLoc(),
+                                paramList, fnTy, /*init*/ nullptr,
+                                Context.TheBuiltinModule);
+}
+
+static ValueDecl *getArrayInitOperation(ASTContext &Context, Identifier id) {
+  Type genericTy;
+  GenericParamList *paramList;
+  std::tie(genericTy, paramList) = getGenericParam(Context);
+
+  TupleTypeElt argElts[] = {
+    TupleTypeElt(MetaTypeType::get(genericTy, Context), Identifier()),
+    TupleTypeElt(Context.TheRawPointerType, Identifier()),
+    TupleTypeElt(Context.TheRawPointerType, Identifier()),
+    TupleTypeElt(getPointerSizeType(Context), Identifier())
+  };
+  Type argTy = TupleType::get(argElts, Context);
+  Type fnTy = PolymorphicFunctionType::get(argTy, TupleType::getEmpty(Context),
+                                           paramList, Context);
+  return new (Context) FuncDecl(SourceLoc(), SourceLoc(), id, SourceLoc(),
+                                paramList, fnTy, /*init*/ nullptr,
+                                Context.TheBuiltinModule);
+}
+
 static ValueDecl *getSizeOrAlignOfOperation(ASTContext &Context, Identifier Id) {
   Type GenericTy;
   GenericParamList *ParamList;
@@ -374,6 +412,8 @@ static const OverloadedBuiltinKind OverloadedBuiltinKinds[] = {
 #define BUILTIN_ASSIGN(id, name) OverloadedBuiltinKind::Special,
 #define BUILTIN_INIT(id, name) OverloadedBuiltinKind::Special,
 #define BUILTIN_DESTROY(id, name) OverloadedBuiltinKind::Special,
+#define BUILTIN_DESTROYARRAY(id, name) OverloadedBuiltinKind::Special,
+#define BUILTIN_ARRAYINIT(id, name) OverloadedBuiltinKind::Special,
 #define BUILTIN_SIZEOF(id, name) OverloadedBuiltinKind::Special,
 #define BUILTIN_STRIDEOF(id, name) OverloadedBuiltinKind::Special,
 #define BUILTIN_ALIGNOF(id, name) OverloadedBuiltinKind::Special,
@@ -560,6 +600,16 @@ ValueDecl *swift::getBuiltinValue(ASTContext &Context, Identifier Id) {
     if (!Types.empty()) return nullptr;
     return getDestroyOperation(Context, Id);
 
+  case BuiltinValueKind::DestroyArray:
+    if (!Types.empty()) return nullptr;
+    return getDestroyArrayOperation(Context, Id);
+
+  case BuiltinValueKind::CopyArray:
+  case BuiltinValueKind::TakeArrayFrontToBack:
+  case BuiltinValueKind::TakeArrayBackToFront:
+    if (!Types.empty()) return nullptr;
+    return getArrayInitOperation(Context, Id);
+
   case BuiltinValueKind::Assign:
   case BuiltinValueKind::Init:
     if (!Types.empty()) return nullptr;
@@ -517,18 +517,22 @@ TypeAliasDecl *ProtocolDecl::getThis() const {
 }
 
 void VarDecl::setProperty(ASTContext &Context, SourceLoc LBraceLoc,
-                          FuncDecl *Get, FuncDecl *Set, SourceLoc RBraceLoc) {
+                          FuncDecl *Get, FuncDecl *Set, FuncDecl *Address,
+                          SourceLoc RBraceLoc) {
   assert(!GetSet && "Variable is already a property?");
   void *Mem = Context.Allocate(sizeof(GetSetRecord), alignof(GetSetRecord));
   GetSet = new (Mem) GetSetRecord;
   GetSet->Braces = SourceRange(LBraceLoc, RBraceLoc);
   GetSet->Get = Get;
   GetSet->Set = Set;
+  GetSet->Address = Address;
   
   if (Get)
     Get->makeGetter(this);
   if (Set)
     Set->makeSetter(this);
+  if (Address)
+    Address->makeAddressor(this);
 }
 
 /// getNaturalArgumentCount - Returns the "natural" number of
@@ -965,6 +969,12 @@ namespace {
           OS << "set =";
           printRec(Set);
         }
+        if (FuncDecl *Address = VD->getAddressor()) {
+          OS << "\n";
+          OS.indent(Indent + 2);
+          OS << "address =";
+          printRec(Address);
+        }
       }
       OS << ')';
     }
@@ -1037,6 +1047,12 @@ namespace {
         OS << "set = ";
         printRec(Set);
       }
+      if (FuncDecl *Address = SD->getAddressor()) {
+        OS << "\n";
+        OS.indent(Indent + 2);
+        OS << "address = ";
+        printRec(Address);
+      }
       OS << ')';
     }
 
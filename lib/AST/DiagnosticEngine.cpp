@@ -20,6 +20,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstring>
 using namespace swift;
 
 struct StoredDiagnosticInfo {
@@ -30,17 +31,20 @@ struct StoredDiagnosticInfo {
   
   /// \brief Text associated with the diagnostic
   const char *Text;
+
+  /// \brief The name of the diagnostic in Diagnostics.def.
+  const char *Name;
 };
 
 static StoredDiagnosticInfo StoredDiagnosticInfos[] = {
 #define ERROR(ID,Category,Options,Text,Signature) \
-  { DiagnosticKind::Error, Text },
+  { DiagnosticKind::Error, Text, #ID },
 #define WARNING(ID,Category,Options,Text,Signature) \
-  { DiagnosticKind::Warning, Text },
+  { DiagnosticKind::Warning, Text, #ID },
 #define NOTE(ID,Category,Options,Text,Signature) \
-  { DiagnosticKind::Note, Text },
+  { DiagnosticKind::Note, Text, #ID },
 #include "swift/AST/Diagnostics.def"
-  { DiagnosticKind::Error, "<not a diagnostic>" }
+  { DiagnosticKind::Error, "<not a diagnostic>", "" }
 };
 
 void InFlightDiagnostic::flush() {
@@ -216,35 +220,107 @@ static void formatDiagnosticText(StringRef InText,
   }
 }
                              
-void DiagnosticEngine::flushActiveDiagnostic() {
-  assert(ActiveDiagnostic && "No active diagnostic to flush");
+bool DiagnosticEngine::shouldSuppressActiveDiagnostic() {
+  if (TooManyErrors)
+    return true;
+
   const StoredDiagnosticInfo &StoredInfo
     = StoredDiagnosticInfos[(unsigned)ActiveDiagnostic->getID()];
 
-  // Check whether this is an error.
-  switch (StoredInfo.Kind) {
-  case DiagnosticKind::Error:
-    HadAnyError = true;
-    break;
-    
-  case DiagnosticKind::Note:
-  case DiagnosticKind::Warning:
-    break;
+  // Notes stand or fall with the diagnostic they are attached to.
+  if (StoredInfo.Kind == DiagnosticKind::Note)
+    return SuppressingNotes;
+
+  // Drop repeats, which tend to come in floods when the same broken
+  // expression is checked over and over.  Diagnostics without a location
+  // can't be told apart this way, so they are all kept.
+  SuppressingNotes = ActiveDiagnosticLoc.isValid() &&
+    !EmittedDiagnostics.insert(
+      std::make_pair(ActiveDiagnosticLoc.Value.getPointer(),
+                     unsigned(ActiveDiagnostic->getID()))).second;
+  if (SuppressingNotes)
+    return true;
+
+  if (StoredInfo.Kind != DiagnosticKind::Error)
+    return false;
+
+  HadAnyError = true;
+  if (ErrorLimit && NumErrors == ErrorLimit) {
+    // Say so once, then drop everything from here on.
+    TooManyErrors = true;
+    SuppressingNotes = true;
+    Diagnostic TooMany(DiagID::too_many_errors,
+                       ArrayRef<DiagnosticArgument>());
+    if (BufferingDiagnostics)
+      BufferedDiagnostics.push_back(std::make_pair(ActiveDiagnosticLoc,
+                                                   TooMany));
+    else
+      emitDiagnostic(ActiveDiagnosticLoc, TooMany);
+    return true;
   }
-  
+  ++NumErrors;
+  return false;
+}
+
+void DiagnosticEngine::emitDiagnostic(SourceLoc Loc, const Diagnostic &D) {
+  const StoredDiagnosticInfo &StoredInfo
+    = StoredDiagnosticInfos[(unsigned)D.getID()];
+
   // Actually substitute the diagnostic arguments into the diagnostic text.
   llvm::SmallString<256> Text;
   {
     llvm::raw_svector_ostream Out(Text);
-    formatDiagnosticText(StoredInfo.Text, ActiveDiagnostic->getArgs(), Out);
+    formatDiagnosticText(StoredInfo.Text, D.getArgs(), Out);
   }
   
   // Pass the diagnostic off to the consumer.
   DiagnosticInfo Info;
-  Info.Ranges = ActiveDiagnostic->getRanges();
-  Consumer.handleDiagnostic(SourceMgr, ActiveDiagnosticLoc, StoredInfo.Kind,
-                            Text, Info);
-  
+  Info.Name = StoredInfo.Name;
+  Info.Ranges = D.getRanges();
+  Consumer.handleDiagnostic(SourceMgr, Loc, StoredInfo.Kind, Text, Info);
+}
+
+void DiagnosticEngine::flushActiveDiagnostic() {
+  assert(ActiveDiagnostic && "No active diagnostic to flush");
+
+  // Nothing is formatted for a diagnostic that is dropped.
+  if (shouldSuppressActiveDiagnostic()) {
+    ActiveDiagnostic.reset();
+    return;
+  }
+
+  if (!BufferingDiagnostics) {
+    emitDiagnostic(ActiveDiagnosticLoc, *ActiveDiagnostic);
+    ActiveDiagnostic.reset();
+    return;
+  }
+
+  // Keep the compact form.  String arguments need copies, since they often
+  // point into the caller's temporaries.
+  SmallVector<DiagnosticArgument, 3> Args;
+  for (const DiagnosticArgument &Arg : ActiveDiagnostic->getArgs()) {
+    if (Arg.getKind() != DiagnosticArgumentKind::String) {
+      Args.push_back(Arg);
+      continue;
+    }
+    StringRef Str = Arg.getAsString();
+    char *Copy = BufferedStrings.Allocate<char>(Str.size());
+    memcpy(Copy, Str.data(), Str.size());
+    Args.push_back(StringRef(Copy, Str.size()));
+  }
+
+  Diagnostic Stored(ActiveDiagnostic->getID(), Args);
+  for (SourceRange R : ActiveDiagnostic->getRanges())
+    Stored << R;
+  BufferedDiagnostics.push_back(std::make_pair(ActiveDiagnosticLoc, Stored));
+
   // Reset the active diagnostic.
   ActiveDiagnostic.reset();
 }
+
+void DiagnosticEngine::flushBufferedDiagnostics() {
+  for (auto &LocAndDiag : BufferedDiagnostics)
+    emitDiagnostic(LocAndDiag.first, LocAndDiag.second);
+  BufferedDiagnostics.clear();
+  BufferedStrings.Reset();
+}
@@ -75,7 +75,7 @@ static void DoGlobalExtensionLookup(Type BaseType, Identifier Name,
       for (Decl *Member : ED->getMembers()) {
         if (ValueDecl *VD = dyn_cast<ValueDecl>(Member)) {
           if (VD->getName() == Name &&
-              (IsTypeLookup || isa<TypeDecl>(VD) ||
+              (IsTypeLookup || isa<TypeDecl>(VD) || CurModuleTypes.empty() ||
                !CurModuleTypes.count(VD->getType()->getCanonicalType()))) {
             Result.push_back(VD);
           }
@@ -87,7 +87,7 @@ static void DoGlobalExtensionLookup(Type BaseType, Identifier Name,
   if (BaseModule != CurModule) {
     for (ValueDecl *VD : BaseMembers) {
       if (VD->getName() == Name &&
-          (IsTypeLookup || isa<TypeDecl>(VD) ||
+          (IsTypeLookup || isa<TypeDecl>(VD) || CurModuleTypes.empty() ||
            !CurModuleTypes.count(VD->getType()->getCanonicalType()))) {
         Result.push_back(VD);
       }
@@ -652,7 +652,7 @@ UnqualifiedLookup::UnqualifiedLookup(Identifier Name, DeclContext *DC,
     ImpEntry.second->lookupValue(ImpEntry.first, Name, NLKind::UnqualifiedLookup,
                                  ImportedModuleResults);
     for (ValueDecl *VD : ImportedModuleResults) {
-      if (IsTypeLookup || isa<TypeDecl>(VD) ||
+      if (IsTypeLookup || isa<TypeDecl>(VD) || CurModuleTypes.empty() ||
           !CurModuleTypes.count(VD->getType()->getCanonicalType())) {
         Results.push_back(Result::getModuleMember(VD));
       }
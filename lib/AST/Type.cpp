@@ -45,11 +45,6 @@ bool CanType::isActuallyCanonicalOrNull() const {
 // Various Type Methods.
 //===----------------------------------------------------------------------===//
 
-/// isEqual - Return true if these two types are equal, ignoring sugar.
-bool TypeBase::isEqual(Type Other) {
-  return getCanonicalType() == Other.getPointer()->getCanonicalType();
-}
-
 /// isMaterializable - Is this type 'materializable' according to the
 /// rules of the language?  Basically, does it not contain any l-value
 /// types?
@@ -593,18 +588,10 @@ static int compareProtocols(const void *V1, const void *V2) {
 
 /// getCanonicalType - Return the canonical version of this type, which has
 /// sugar from all levels stripped off.
-CanType TypeBase::getCanonicalType() {
+CanType TypeBase::computeCanonicalType() {
   assert(this != 0 &&
          "Cannot call getCanonicalType before name binding is complete");
 
-  // If the type is itself canonical, return it.
-  if (CanonicalType.is<ASTContext*>())
-    return CanType(this);
-  // If the canonical type was already computed, just return what we have.
-  if (TypeBase *CT = CanonicalType.get<TypeBase*>())
-    return CanType(CT);
-  
-  // Otherwise, compute and cache it.
   TypeBase *Result = 0;
   switch (getKind()) {
 #define ALWAYS_CANONICAL_TYPE(id, parent) case TypeKind::id:
@@ -613,13 +600,28 @@ CanType TypeBase::getCanonicalType() {
 #include "swift/AST/TypeNodes.def"
     llvm_unreachable("these types are always canonical");
 
-#define SUGARED_TYPE(id, parent) \
-  case TypeKind::id: \
-    Result = cast<id##Type>(this)-> \
-             getDesugaredType()->getCanonicalType().getPointer(); \
+  // Sugared types strip one level of sugar at a time, so that every type on
+  // a chain of sugar remembers its canonical type, not just the outermost.
+  case TypeKind::NameAlias:
+    Result = cast<NameAliasType>(this)->getDecl()->getUnderlyingType()
+               ->getCanonicalType().getPointer();
+    break;
+  case TypeKind::Identifier:
+    Result = cast<IdentifierType>(this)->getMappedType()
+               ->getCanonicalType().getPointer();
+    break;
+  case TypeKind::Paren:
+    Result = cast<ParenType>(this)->getUnderlyingType()
+               ->getCanonicalType().getPointer();
+    break;
+  case TypeKind::Substituted:
+    Result = cast<SubstitutedType>(this)->getReplacementType()
+               ->getCanonicalType().getPointer();
+    break;
+  case TypeKind::ArraySlice:
+    Result = cast<ArraySliceType>(this)->getImplementationType()
+               ->getCanonicalType().getPointer();
     break;
-#define TYPE(id, parent)
-#include "swift/AST/TypeNodes.def"
 
   case TypeKind::OneOf:
   case TypeKind::Struct:
@@ -723,9 +725,16 @@ CanType TypeBase::getCanonicalType() {
   }
     
   
-  // Cache the canonical type for future queries.
+  // Cache the canonical type for future queries.  Threads emitting SIL may
+  // race to canonicalize the same type; since the result is uniqued, the
+  // thread that loses finds the same pointer already there.
   assert(Result && "Case not implemented!");
-  CanonicalType = Result;
+  void *Expected = nullptr;
+  void *Canon = CanonicalTypeUnion(Result).getOpaqueValue();
+  if (!CanonicalType.compare_exchange_strong(Expected, Canon,
+                                             std::memory_order_release,
+                                             std::memory_order_acquire))
+    assert(Expected == Canon && "Canonical type already computed");
   return CanType(Result);
 }
 
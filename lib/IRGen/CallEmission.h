@@ -68,6 +68,7 @@ private:
 
   void forceCallee();
   void setFromCallee();
+  bool isNextArgGuaranteed() const;
   void emitToUnmappedMemory(Address addr);
   void emitToUnmappedExplosion(Explosion &out);
   llvm::CallSite emitCallSite(bool hasIndirectResult);
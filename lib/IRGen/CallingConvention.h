@@ -40,11 +40,29 @@ enum class AbstractCC : unsigned char {
   Freestanding,
 
   /// The calling convention used for calling an instance method.
+  /// The 'this' argument is passed at +0; see getThisConvention.
   Method
 };
 
+/// How ownership of a reference-counted argument is passed.
+enum class ParameterConvention : unsigned char {
+  /// The caller passes a +1 reference, which the callee is responsible
+  /// for releasing.
+  Owned,
+
+  /// The caller keeps the reference alive for the duration of the
+  /// call.  The callee neither retains nor releases it, and must copy
+  /// it if it needs the value to outlive the call.
+  Guaranteed
+};
+
 AbstractCC getAbstractCC(ValueDecl *fn);
 
+/// Return the convention for the 'this' clause (i.e. the outermost
+/// argument clause) of a function with the given abstract calling
+/// convention.
+ParameterConvention getThisConvention(AbstractCC convention);
+
 /// Expand an abstract calling convention into a physical convention
 /// and a set of attributes.
 llvm::CallingConv::ID expandAbstractCC(IRGenModule &IGM, AbstractCC convention,
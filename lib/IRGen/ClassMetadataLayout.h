@@ -29,6 +29,20 @@ class IRGenModule;
 /// The number of fields in a HeapMetadata object.
 const unsigned NumHeapMetadataFields = 4;
 
+/// The index of the class depth field in class metadata.
+const unsigned ClassDepthIndex = NumHeapMetadataFields + 2;
+
+/// The index of the ancestor display field in class metadata.
+const unsigned ClassAncestorsIndex = NumHeapMetadataFields + 3;
+
+/// Return the number of superclasses of the given class.
+unsigned getClassDepth(ClassDecl *theClass);
+
+/// Can the ancestor display for the given class be emitted as a
+/// constant?  This is false if the class or any of its superclasses is
+/// generic, since their metadata is only instantiated at runtime.
+bool hasStaticAncestorDisplay(ClassDecl *theClass);
+
 /// Does the given class method require a different dispatch-table
 /// entry from from all of the methods it overrides?  The restrictions
 /// on overriding generally prevent this, but it can happen when a
@@ -37,6 +51,10 @@ bool doesMethodRequireOverrideEntry(IRGenModule &IGM, FuncDecl *fn,
                                     ExplosionKind explosionLevel,
                                     unsigned uncurryLevel);
 
+/// Return the explosion level of the dispatch-table entries for the
+/// given class method.
+ExplosionKind getVirtualExplosionLevel(IRGenModule &IGM, FuncDecl *fn);
+
 /// A CRTP class for laying out class metadata.  Note that this does
 /// *not* handle the metadata template stuff.
 template <class Impl> class ClassMetadataLayout : public MetadataLayout<Impl> {
@@ -64,6 +82,8 @@ public:
     // ClassMetadata header.
     asImpl().addNominalTypeDescriptor();
     asImpl().addSuperClass();
+    asImpl().addClassDepth();
+    asImpl().addAncestorDisplay();
 
     // Class members.
     addClassMembers(TargetClass);
@@ -108,9 +128,8 @@ private:
   }
 
   void addMethodEntries(FuncDecl *fn) {
-    // TODO: consider emitting at different explosion levels and
-    // uncurryings.
-    auto explosionLevel = ExplosionKind::Minimal;
+    // TODO: consider emitting at different uncurryings.
+    auto explosionLevel = getVirtualExplosionLevel(IGM, fn);
     unsigned uncurryLevel = 1; // whether static or not
 
     maybeAddMethod(fn, explosionLevel, uncurryLevel);
@@ -156,6 +175,8 @@ public:
   void addNominalTypeDescriptor() { NextIndex++; }
   void addParentMetadataRef(ClassDecl *forClass) { NextIndex++; }
   void addSuperClass() { NextIndex++; }
+  void addClassDepth() { NextIndex++; }
+  void addAncestorDisplay() { NextIndex++; }
   void addMethod(FunctionRef fn) { NextIndex++; }
   void addGenericArgument(ArchetypeType *argument, ClassDecl *forClass) {
     NextIndex++;
@@ -24,14 +24,15 @@
 namespace swift {
 namespace irgen {
 
-/// A ValueDecl --- either a function, a getter, or a setter --- at a
-/// specific explosion and uncurrying level.
+/// A ValueDecl --- either a function, a getter, a setter, or an
+/// addressor --- at a specific explosion and uncurrying level.
 class CodeRef {
 public:
   enum class Kind {
     Function,
     Getter,
-    Setter
+    Setter,
+    Addressor
   };
 
 private:
@@ -86,6 +87,13 @@ public:
     return CodeRef(Kind::Setter, value, explosionLevel, uncurryLevel);
   }
 
+  static CodeRef forAddressor(ValueDecl *value,
+                              ExplosionKind explosionLevel,
+                              unsigned uncurryLevel) {
+    assert(isa<VarDecl>(value) || isa<SubscriptDecl>(value));
+    return CodeRef(Kind::Addressor, value, explosionLevel, uncurryLevel);
+  }
+
   ValueDecl *getDecl() const { return TheDecl; }
   Kind getKind() const { return Kind(TheKind); }
   unsigned getUncurryLevel() const { return UncurryLevel; }
@@ -259,12 +259,15 @@ bool LinkEntity::isLocalLinkage() const {
   case Kind::ValueWitness:
   case Kind::ValueWitnessTable:
   case Kind::TypeMetadata:
+  case Kind::TypeMetadataAccessFunction:
+  case Kind::TypeMetadataLazyCacheVariable:
     return isLocalLinkageType(getType());
 
   case Kind::WitnessTableOffset:
   case Kind::Function:
   case Kind::Getter:
   case Kind::Setter:
+  case Kind::Addressor:
   case Kind::Other:
     return isLocalLinkageDecl(getDecl());
   }
@@ -283,8 +286,9 @@ LinkInfo LinkInfo::get(IRGenModule &IGM, const LinkEntity &entity) {
     result.Linkage = llvm::GlobalValue::InternalLinkage;
     result.Visibility = llvm::GlobalValue::DefaultVisibility;
     return result;
-  } else if (entity.isValueWitness()) {
-    // The linkage for a value witness is linkonce_odr.
+  } else if (entity.isValueWitness() || entity.isTypeMetadataAccess()) {
+    // The linkage for a value witness or a metadata accessor is
+    // linkonce_odr.
     result.Linkage = llvm::GlobalValue::LinkOnceODRLinkage;
     result.Visibility = llvm::GlobalValue::HiddenVisibility;
   } else {
@@ -453,6 +457,18 @@ static bool hasIndirectResult(IRGenModule &IGM, CanType type,
 /// Fetch the declaration of the given known function.
 llvm::Function *IRGenModule::getAddrOfFunction(FunctionRef fn,
                                                ExtraData extraData) {
+  // Only the minimally-exploded entrypoints of a global function are
+  // emitted.  Every type has the same signature at both levels for now,
+  // so a maximally-exploded reference just names the minimal entrypoint.
+  if (fn.getExplosionLevel() == ExplosionKind::Maximal &&
+      !fn.getDecl()->getDeclContext()->isLocalContext()) {
+    assert(!differsByExplosion(fn.getDecl()->getType()->getCanonicalType(),
+                               fn.getUncurryLevel(), extraData) &&
+           "no maximally-exploded entrypoint is emitted for this function");
+    fn = FunctionRef(fn.getDecl(), ExplosionKind::Minimal,
+                     fn.getUncurryLevel());
+  }
+
   LinkEntity entity = LinkEntity::forFunction(fn);
 
   // Check whether we've cached this.
@@ -603,6 +619,41 @@ llvm::Constant *IRGenModule::getAddrOfTypeMetadata(CanType concreteType,
                                TypeMetadataPtrTy);
 }
 
+/// Returns the address of the function that returns the metadata for
+/// the given concrete type.  The function is emitted on first use.
+llvm::Function *
+IRGenModule::getAddrOfTypeMetadataAccessFunction(CanType concreteType) {
+  LinkEntity entity = LinkEntity::forTypeMetadataAccessFunction(concreteType);
+
+  llvm::Function *&entry = GlobalFuncs[entity];
+  if (entry) return entry;
+
+  auto fnType = llvm::FunctionType::get(TypeMetadataPtrTy, false);
+  LinkInfo link = LinkInfo::get(*this, entity);
+  entry = link.createFunction(*this, fnType, RuntimeCC,
+                              ArrayRef<llvm::AttributeWithIndex>());
+  entry->setDoesNotThrow();
+  return entry;
+}
+
+/// Returns the address of the variable in which the access function
+/// for the given concrete type caches its metadata.  The variable starts
+/// out null.
+llvm::Constant *
+IRGenModule::getAddrOfTypeMetadataLazyCacheVariable(CanType concreteType) {
+  LinkEntity entity =
+    LinkEntity::forTypeMetadataLazyCacheVariable(concreteType);
+
+  llvm::GlobalVariable *&entry = GlobalVars[entity];
+  if (entry) return entry;
+
+  LinkInfo link = LinkInfo::get(*this, entity);
+  entry = link.createVariable(*this, TypeMetadataPtrTy);
+  entry->setInitializer(llvm::ConstantPointerNull::get(TypeMetadataPtrTy));
+  entry->setAlignment(getPointerAlignment().getValue());
+  return entry;
+}
+
 /// Fetch the declaration of the given known function.
 llvm::Function *IRGenModule::getAddrOfDestructor(ClassDecl *cd) {
   LinkEntity entity = LinkEntity::forDestructor(cd);
@@ -792,6 +843,52 @@ llvm::Function *IRGenModule::getAddrOfSetter(ValueDecl *value,
   return entry;
 }
 
+/// getTypeOfAddressor - Return the formal type of an addressor for a
+/// variable or subscripted object.
+FormalType IRGenModule::getTypeOfAddressor(ValueDecl *value) {
+  // The formal type of an addressor function is one of:
+  //   S -> () -> Builtin.RawPointer (for a nontype member)
+  //   A -> S -> () -> Builtin.RawPointer (for a type member)
+  // where S is the index type (this clause is skipped for a
+  // non-subscript addressor).
+  unsigned uncurryLevel = 0;
+  CanType formalType =
+    CanType(FunctionType::get(TupleType::getEmpty(Context),
+                              Context.TheRawPointerType, Context));
+  addIndexArgument(Context, value, formalType, uncurryLevel);
+  auto cc = addOwnerArgument(Context, value, formalType, uncurryLevel);
+
+  return FormalType(formalType, cc, uncurryLevel);
+}
+
+llvm::Function *IRGenModule::getAddrOfAddressor(ValueDecl *value,
+                                                ExplosionKind explosionLevel) {
+  return getAddrOfAddressor(value, getTypeOfAddressor(value), explosionLevel);
+}
+
+/// getAddrOfAddressor - Get the address of the function which computes
+/// the address of the storage of a variable or subscripted object.
+llvm::Function *IRGenModule::getAddrOfAddressor(ValueDecl *value,
+                                                FormalType formal,
+                                                ExplosionKind explosionLevel) {
+  LinkEntity entity =
+    LinkEntity::forFunction(CodeRef::forAddressor(value, explosionLevel, 0));
+
+  llvm::Function *&entry = GlobalFuncs[entity];
+  if (entry) return entry;
+
+  llvm::FunctionType *fnType =
+    getFunctionType(formal.getType(), explosionLevel,
+                    formal.getNaturalUncurryLevel(), ExtraData::None);
+
+  SmallVector<llvm::AttributeWithIndex, 4> attrs;
+  auto convention = expandAbstractCC(*this, formal.getCC(), false, attrs);
+
+  LinkInfo link = LinkInfo::get(*this, entity);
+  entry = link.createFunction(*this, fnType, convention, attrs);
+  return entry;
+}
+
 static Address getAddrOfWitnessTableOffset(IRGenModule &IGM,
                     llvm::DenseMap<LinkEntity, llvm::GlobalVariable*> &cache,
                                            LinkEntity entity) {
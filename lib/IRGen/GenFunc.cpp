@@ -62,6 +62,7 @@
 #include "llvm/Intrinsics.h"
 #include "llvm/Module.h"
 #include "llvm/Support/CallSite.h"
+#include "llvm/Support/SaveAndRestore.h"
 
 #include "ASTVisitor.h"
 #include "CallingConvention.h"
@@ -74,6 +75,7 @@
 #include "GenObjC.h"
 #include "GenPoly.h"
 #include "GenProto.h"
+#include "GenSIL.h"
 #include "GenType.h"
 #include "IRGenFunction.h"
 #include "IRGenModule.h"
@@ -569,24 +571,63 @@ IRGenModule::getFunctionType(CanType type, ExplosionKind explosionKind,
   return sig.getType();
 }
 
+/// Does the maximally-exploded signature of the given function type
+/// differ from the minimally-exploded one?  If it did, a global function
+/// would need a maximally-exploded entrypoint of its own, which isn't
+/// emitted yet.
+bool IRGenModule::differsByExplosion(CanType type, unsigned curryingLevel,
+                                     ExtraData extraData) {
+  assert(isa<AnyFunctionType>(type));
+  const FuncTypeInfo &fnTypeInfo = getFragileTypeInfo(type).as<FuncTypeInfo>();
+  Signature minimal = fnTypeInfo.getSignature(*this, ExplosionKind::Minimal,
+                                              curryingLevel, extraData);
+  Signature maximal = fnTypeInfo.getSignature(*this, ExplosionKind::Maximal,
+                                              curryingLevel, extraData);
+  return minimal.getType() != maximal.getType() ||
+         minimal.hasIndirectReturn() != maximal.hasIndirectReturn();
+}
+
+/// Return the best explosion level at which code in this component
+/// can directly call the given function.  Everything but the entrypoints
+/// that other components see by name can be maximally exploded.
+ExplosionKind irgen::getDirectExplosionLevel(IRGenModule &IGM,
+                                             FuncDecl *fn) {
+  if (fn->isGetterOrSetter() || !fn->getAttrs().AsmName.empty() ||
+      IGM.isResilient(fn))
+    return ExplosionKind::Minimal;
+  return ExplosionKind::Maximal;
+}
+
 AbstractCC irgen::getAbstractCC(ValueDecl *fn) {
   if (fn->isInstanceMember())
     return AbstractCC::Method;
   return AbstractCC::Freestanding;
 }
 
+ParameterConvention irgen::getThisConvention(AbstractCC convention) {
+  switch (convention) {
+  case AbstractCC::C:
+  case AbstractCC::Freestanding:
+    return ParameterConvention::Owned;
+
+  // Methods are overwhelmingly called on a 'this' which the caller
+  // holds anyway, and they mostly just pass it along to further method
+  // calls, so don't make every call boundary retain and release it.
+  case AbstractCC::Method:
+    return ParameterConvention::Guaranteed;
+  }
+  llvm_unreachable("bad calling convention!");
+}
+
 /// Construct the best known limits on how we can call the given function.
 static AbstractCallee getAbstractDirectCallee(IRGenFunction &IGF,
                                               ValueDecl *val) {
   bool isLocal = val->getDeclContext()->isLocalContext();
 
-  // FIXME: be more aggressive about all this.
-  ExplosionKind level;
-  if (isLocal) {
-    level = ExplosionKind::Maximal;
-  } else {
-    level = ExplosionKind::Minimal;
-  }
+  // FIXME: be more aggressive about constructors and oneof elements.
+  ExplosionKind level = ExplosionKind::Minimal;
+  if (FuncDecl *fn = dyn_cast<FuncDecl>(val))
+    level = getDirectExplosionLevel(IGF.IGM, fn);
 
   unsigned minUncurry = 0;
   if (val->getDeclContext()->isTypeContext())
@@ -653,6 +694,10 @@ static Callee emitDirectCallee(IRGenFunction &IGF, ValueDecl *val,
     AbstractCallee absCallee = getAbstractDirectCallee(IGF, val);
     bestUncurry = std::min(bestUncurry, absCallee.getMaxUncurryLevel());
     bestExplosion = absCallee.getBestExplosionLevel();
+
+    // Only the fully-uncurried entrypoint is maximally exploded.
+    if (bestUncurry != absCallee.getMaxUncurryLevel())
+      bestExplosion = ExplosionKind::Minimal;
   }
 
   if (ConstructorDecl *ctor = dyn_cast<ConstructorDecl>(val)) {
@@ -702,10 +747,11 @@ static Callee emitDirectCallee(IRGenFunction &IGF, ValueDecl *val,
     }
   }
 
+  // The data pointer is guaranteed, and the local function's data is
+  // kept alive by the scope which declares it, so we don't need to
+  // retain it just to make the call.
   auto fnPtr = IGF.getAddrOfLocalFunction(fnRef);
-  Explosion e(ExplosionKind::Maximal);
-  IGF.emitRetain(IGF.getLocalFuncData(fn), e);
-  ManagedValue data = e.claimNext();
+  ManagedValue data(IGF.getLocalFuncData(fn));
   if (isa<llvm::ConstantPointerNull>(data.getValue()))
     data = ManagedValue(nullptr);
   return Callee::forKnownFunction(AbstractCC::Freestanding,
@@ -1017,7 +1063,14 @@ void irgen::emitRValueForFunction(IRGenFunction &IGF, FuncDecl *fn,
   assert(callee.getExplosionLevel() == ExplosionKind::Minimal);
   assert(callee.getUncurryLevel() == 0);
   explosion.addUnmanaged(callee.getOpaqueFunctionPointer(IGF));
-  explosion.add(callee.getDataPointer(IGF));
+
+  // The callee's data pointer is only guaranteed for the duration of
+  // a call; a function value needs its own reference.
+  llvm::Value *data = callee.getDataPointer(IGF).getValue();
+  if (isa<llvm::ConstantPointerNull>(data))
+    explosion.addUnmanaged(data);
+  else
+    IGF.emitRetain(data, explosion);
 }
 
 static void extractUnmanagedScalarResults(IRGenFunction &IGF,
@@ -1379,6 +1432,43 @@ static void emitBuiltinCall(IRGenFunction &IGF, FuncDecl *fn,
     return;
   }
 
+  if (BuiltinName == "destroyArray" || BuiltinName == "copyArray" ||
+      BuiltinName == "takeArrayFrontToBack" ||
+      BuiltinName == "takeArrayBackToFront") {
+    // The type of the operation is the first element of the argument tuple.
+    CanType valueTy = argExpr->getType()->getCanonicalType();
+    valueTy = CanType(cast<TupleType>(valueTy)->getElementType(0));
+    valueTy = CanType(cast<MetaTypeType>(valueTy)->getInstanceType());
+
+    // Skip the metatype if it has a non-trivial representation.
+    if (!IGF.IGM.hasTrivialMetatype(valueTy))
+      args.claimUnmanagedNext();
+
+    const TypeInfo &valueTI = IGF.IGM.getFragileTypeInfo(valueTy);
+
+    llvm::Value *destValue = args.claimUnmanagedNext();
+    Address dest = getAddressForUnsafePointer(IGF, valueTI, destValue);
+    Address src;
+    if (BuiltinName != "destroyArray") {
+      llvm::Value *srcValue = args.claimUnmanagedNext();
+      src = getAddressForUnsafePointer(IGF, valueTI, srcValue);
+    }
+    llvm::Value *count = args.claimUnmanagedNext();
+    count = IGF.Builder.CreateIntCast(count, IGF.IGM.SizeTy, /*signed*/ false);
+
+    if (BuiltinName == "destroyArray")
+      valueTI.destroyArray(IGF, dest, count);
+    else if (BuiltinName == "copyArray")
+      valueTI.initializeArrayWithCopy(IGF, dest, src, count);
+    else if (BuiltinName == "takeArrayFrontToBack")
+      valueTI.initializeArrayWithTakeFrontToBack(IGF, dest, src, count);
+    else
+      valueTI.initializeArrayWithTakeBackToFront(IGF, dest, src, count);
+
+    emission.setVoidResult();
+    return;
+  }
+
   if (BuiltinName == "assign") {
     // The type of the operation is the type of the first argument of
     // the store function.
@@ -1469,18 +1559,72 @@ static void emitBuiltinCall(IRGenFunction &IGF, FuncDecl *fn,
   llvm_unreachable("IRGen unimplemented for this builtin!");
 }
 
+/// Try to emit the given expression without taking ownership of its
+/// value, which is possible when the value is already kept alive by
+/// the current scope.  This is only valid for values passed under the
+/// guaranteed convention, and only when nothing evaluated before the
+/// call can release the value; we just look for loads from immutable
+/// local variables.
+static bool tryEmitGuaranteedRValue(IRGenFunction &IGF, Expr *E,
+                                    Explosion &out) {
+  E = E->getSemanticsProvidingExpr();
+
+  // Class upcasts don't change the value.
+  if (auto upcast = dyn_cast<DerivedToBaseExpr>(E)) {
+    Explosion sub(out.getKind());
+    if (!tryEmitGuaranteedRValue(IGF, upcast->getSubExpr(), sub))
+      return false;
+    llvm::Type *baseTy = IGF.getFragileTypeInfo(E->getType()).StorageType;
+    out.addUnmanaged(IGF.Builder.CreateBitCast(sub.claimUnmanagedNext(),
+                                               baseTy));
+    return true;
+  }
+
+  auto load = dyn_cast<LoadExpr>(E);
+  if (!load) return false;
+  auto declRef =
+    dyn_cast<DeclRefExpr>(load->getSubExpr()->getSemanticsProvidingExpr());
+  if (!declRef) return false;
+  auto var = dyn_cast<VarDecl>(declRef->getDecl());
+  if (!var || !var->getDeclContext()->isLocalContext() ||
+      var->isProperty() || var->getType()->is<LValueType>())
+    return false;
+
+  // The variable must not be reassigned, and must not have been moved
+  // to the heap, where something else might be keeping it.
+  if (!var->hasFixedLifetime() || !var->isNeverUsedAsLValue())
+    return false;
+
+  // Load the value out of the variable without retaining it.
+  const TypeInfo &varTI = IGF.getFragileTypeInfo(var->getType());
+  Explosion temp(out.getKind());
+  varTI.loadAsTake(IGF, IGF.getLocalVar(var), temp);
+  while (!temp.empty())
+    out.addUnmanaged(temp.forwardNext(IGF));
+  return true;
+}
+
 /// Prepare a CallEmission for this callee source.  All the arguments
 /// will have been streamed into it.
 CallEmission CalleeSource::prepareCall(IRGenFunction &IGF,
                                        unsigned numExtraArgs,
                                        ExplosionKind maxExplosion) {
+  // Only the last argument clause may address a [byref] l-value in place;
+  // the clauses after it could invalidate the address.  Within a clause,
+  // emitTupleLiteral projects [byref] addresses last.
+  llvm::SaveAndRestore<bool> saveProject(IGF.CanProjectAddressors, false);
+
   // Prepare the root.
   unsigned numArgs = getCallSites().size() + numExtraArgs;
   CallEmission emission = prepareRootCall(IGF, numArgs, maxExplosion);
 
   // Collect call sites.
-  for (auto site : getCallSites())
-    emission.addArg(site.getArg());
+  auto sites = getCallSites();
+  for (unsigned i = 0, e = sites.size(); i != e; ++i) {
+    if (i + 1 == e && numExtraArgs == 0)
+      IGF.CanProjectAddressors = saveProject.get();
+    emission.addArg(sites[i].getArg());
+  }
 
   return emission;
 }
@@ -1514,15 +1658,18 @@ CallEmission CalleeSource::prepareRootCall(IRGenFunction &IGF,
   }
 
   case Kind::Virtual: {
-    // Emit the base.
+    // Emit the base.  It's passed as a guaranteed 'this', so we can
+    // borrow it if the current scope is keeping it alive.
     Explosion baseValues(ExplosionKind::Minimal);
-    IGF.emitRValue(getCallSites().front().getArg(), baseValues);
+    Expr *base = getCallSites().front().getArg();
+    if (!tryEmitGuaranteedRValue(IGF, base, baseValues))
+      IGF.emitRValue(base, baseValues);
     CallSites.erase(CallSites.begin());
 
     // Grab the base value before adding it as an argument.
-    llvm::Value *base = baseValues.begin()->getValue();
+    llvm::Value *baseValue = baseValues.begin()->getValue();
 
-    CallEmission emission(IGF, emitVirtualCallee(IGF, base,
+    CallEmission emission(IGF, emitVirtualCallee(IGF, baseValue,
                                                  getVirtualFunction(),
                                                  SubstResultType,
                                                  getSubstitutions(),
@@ -1540,9 +1687,12 @@ CallEmission CalleeSource::prepareRootCall(IRGenFunction &IGF,
                                            IndirectLiteral.Data));
 
   case Kind::Indirect: {
+    // The data pointer is guaranteed, so we can borrow the function
+    // value if the current scope is keeping it alive.
     Explosion fnValues(ExplosionKind::Maximal);
     Expr *fn = getIndirectFunction();
-    IGF.emitRValue(fn, fnValues);
+    if (!tryEmitGuaranteedRValue(IGF, fn, fnValues))
+      IGF.emitRValue(fn, fnValues);
 
     llvm::Value *fnPtr = fnValues.claimUnmanagedNext();
     ManagedValue dataPtr = fnValues.claimNext();
@@ -2188,10 +2338,12 @@ void CallEmission::setFromCallee() {
   // We should not have any cleanups at this point.
   assert(Cleanups.empty());
 
-  // Add the data pointer if we have one.
+  // Add the data pointer if we have one.  Data pointers are
+  // guaranteed, so leave any cleanup active; it will release the
+  // data after the call.
   if (CurCallee.hasDataPointer()) {
     assert(LastArgWritten > 0);
-    Args[--LastArgWritten] = CurCallee.getDataPointer(IGF).split(Cleanups);
+    Args[--LastArgWritten] = CurCallee.getDataPointer(IGF).getValue();
   }
 }
 
@@ -2275,8 +2427,20 @@ static bool isLeftToRight(AbstractCC cc) {
   return cc == AbstractCC::C;
 }
 
+/// Is the next argument clause the 'this' clause of a callee which
+/// takes it at +0?
+bool CallEmission::isNextArgGuaranteed() const {
+  return RemainingArgsForCallee == CurCallee.getUncurryLevel() + 1 &&
+         getThisConvention(CurCallee.getConvention())
+           == ParameterConvention::Guaranteed;
+}
+
 /// Add a new set of arguments to the function.
 void CallEmission::addArg(Explosion &arg) {
+  // Guaranteed arguments keep their cleanups, which will destroy them
+  // after the call instead of in the callee.
+  bool isGuaranteed = isNextArgGuaranteed();
+
   forceCallee();
 
   // Add the given number of arguments.
@@ -2301,7 +2465,7 @@ void CallEmission::addArg(Explosion &arg) {
 
   auto argIterator = Args.begin() + targetIndex;
   for (auto value : arg.claimAll()) {
-    *argIterator++ = value.split(Cleanups);
+    *argIterator++ = (isGuaranteed ? value.getValue() : value.split(Cleanups));
   }
 
   // Walk into the original function type.
@@ -2338,7 +2502,8 @@ void CallEmission::addArg(Expr *arg) {
       auto substInputType = arg->getType()->getCanonicalType();
       emitPolymorphicArguments(IGF, polyFn, substInputType, subs, argE);
     }
-  } else {
+  } else if (!isNextArgGuaranteed() ||
+             !tryEmitGuaranteedRValue(IGF, arg, argE)) {
     IGF.emitRValue(arg, argE);
   }
 
@@ -2466,7 +2631,8 @@ Explosion IRGenFunction::collectParameters() {
 }
 
 OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
-                                                Explosion &paramValues) {
+                                                Explosion &paramValues,
+                                       ParameterConvention convention) {
   const TypeInfo &paramType = IGM.getFragileTypeInfo(param->getType());
 
   ExplosionSchema paramSchema(paramValues.getKind());
@@ -2484,7 +2650,8 @@ OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
     if (param->getType()->castTo<LValueType>()->isHeap()) {
       owner = paramValues.claimUnmanagedNext();
       owner->setName(name + ".owner");
-      enterReleaseCleanup(owner);
+      if (convention == ParameterConvention::Owned)
+        enterReleaseCleanup(owner);
     }
 
     return OwnedAddress(Address(addr, paramType.StorageAlignment), owner);
@@ -2492,6 +2659,11 @@ OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
 
   OnHeap_t onHeap = param->hasFixedLifetime() ? NotOnHeap : OnHeap;
 
+  // A guaranteed parameter can be used without copying it as long as
+  // the function neither modifies it nor lets it escape.
+  bool isBorrowed = convention == ParameterConvention::Guaranteed &&
+                    !onHeap && param->isNeverUsedAsLValue();
+
   // If the schema contains a single aggregate, assume we can
   // just treat the next parameter as that type.
   if (paramSchema.size() == 1 && paramSchema.begin()->isAggregate()) {
@@ -2503,7 +2675,9 @@ OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
 
     // If we don't locally need the variable on the heap, just use the
     // original address.
-    if (!onHeap) {
+    if (isBorrowed)
+      return OwnedAddress(paramAddr, IGM.RefCountedNull);
+    if (!onHeap && convention == ParameterConvention::Owned) {
       // Enter a cleanup to destroy the element.
       if (!paramType.isPOD(ResilienceScope::Local))
         enterDestroyCleanup(paramAddr, paramType);
@@ -2511,26 +2685,34 @@ OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
       return OwnedAddress(paramAddr, IGM.RefCountedNull);
     }
 
-    // Otherwise, we have to move it to the heap.
+    // Otherwise, we have to move it to the heap, or copy it into a
+    // variable of our own.
     Initialization paramInit;
     InitializedObject paramObj = paramInit.getObjectForDecl(param);
-    paramInit.registerObject(*this, paramObj, OnHeap, paramType);
+    paramInit.registerObject(*this, paramObj, onHeap, paramType);
 
     OwnedAddress paramHeapAddr =
-      paramInit.emitLocalAllocation(*this, paramObj, OnHeap, paramType,
-                                    name + ".heap");
+      paramInit.emitLocalAllocation(*this, paramObj, onHeap, paramType,
+                                    name + (onHeap ? ".heap" : ".addr"));
 
     // Do a 'take' initialization to directly transfer responsibility.
-    paramType.initializeWithTake(*this, paramHeapAddr, paramAddr);
+    if (convention == ParameterConvention::Owned)
+      paramType.initializeWithTake(*this, paramHeapAddr, paramAddr);
+    else
+      paramType.initializeWithCopy(*this, paramHeapAddr, paramAddr);
     paramInit.markInitialized(*this, paramObj);
 
     return paramHeapAddr;
   }
 
-  // Otherwise, make an alloca and load into it.
+  // Otherwise, make an alloca and load into it.  A borrowed value is
+  // still owned by the caller, so don't destroy it.
   Initialization paramInit;
   InitializedObject paramObj = paramInit.getObjectForDecl(param);
-  paramInit.registerObject(*this, paramObj, onHeap, paramType);
+  if (isBorrowed)
+    paramInit.registerObjectWithoutDestroy(paramObj);
+  else
+    paramInit.registerObject(*this, paramObj, onHeap, paramType);
 
   OwnedAddress paramAddr =
     paramInit.emitLocalAllocation(*this, paramObj, onHeap, paramType,
@@ -2540,7 +2722,14 @@ OwnedAddress IRGenFunction::getAddrForParameter(VarDecl *param,
   // is really ugly.
   auto storedStart = paramValues.begin();
 
-  paramType.initialize(*this, paramValues, paramAddr);
+  // If the value is guaranteed but we need our own reference, copy it.
+  if (convention == ParameterConvention::Guaranteed && !isBorrowed) {
+    Explosion copy(paramValues.getKind());
+    paramType.copy(*this, paramValues, copy);
+    paramType.initialize(*this, copy, paramAddr);
+  } else {
+    paramType.initialize(*this, paramValues, paramAddr);
+  }
   paramInit.markInitialized(*this, paramObj);
 
   // Set names for argument(s)
@@ -2560,10 +2749,12 @@ namespace {
       public irgen::PatternVisitor<ParamPatternEmitter> {
     IRGenFunction &IGF;
     Explosion &Args;
+    ParameterConvention Convention;
 
   public:
-    ParamPatternEmitter(IRGenFunction &IGF, Explosion &args)
-      : IGF(IGF), Args(args) {}
+    ParamPatternEmitter(IRGenFunction &IGF, Explosion &args,
+                        ParameterConvention convention)
+      : IGF(IGF), Args(args), Convention(convention) {}
 
     void visitTuplePattern(TuplePattern *tuple) {
       for (auto &field : tuple->getFields())
@@ -2572,7 +2763,7 @@ namespace {
 
     void visitNamedPattern(NamedPattern *pattern) {
       VarDecl *decl = pattern->getDecl();
-      OwnedAddress addr = IGF.getAddrForParameter(decl, Args);
+      OwnedAddress addr = IGF.getAddrForParameter(decl, Args, Convention);
 
       // FIXME: heap byrefs.
       IGF.setLocalVar(decl, addr);
@@ -2589,12 +2780,13 @@ namespace {
 
 /// Emit a specific parameter clause.
 static void emitParameterClause(IRGenFunction &IGF, AnyFunctionType *fnType,
-                                Pattern *param, Explosion &args) {
+                                Pattern *param, Explosion &args,
+                                ParameterConvention convention) {
   assert(param->getType()->getUnlabeledType(IGF.IGM.Context)
          ->isEqual(fnType->getInput()->getUnlabeledType(IGF.IGM.Context)));
 
   // Emit the pattern.
-  ParamPatternEmitter(IGF, args).visit(param);
+  ParamPatternEmitter(IGF, args, convention).visit(param);
 
   // If the function type at this level is polymorphic, bind all the
   // archetypes.
@@ -2608,17 +2800,19 @@ static void emitParameterClause(IRGenFunction &IGF, AnyFunctionType *fnType,
 static void emitParameterClauses(IRGenFunction &IGF,
                                  Type type,
                                  llvm::ArrayRef<Pattern*> paramClauses,
-                                 Explosion &args) {
+                                 Explosion &args,
+                                 ParameterConvention firstConvention) {
   assert(!paramClauses.empty());
 
   AnyFunctionType *fnType = type->castTo<AnyFunctionType>();
 
   // When uncurrying, later argument clauses are emitted first.
   if (paramClauses.size() != 1)
-    emitParameterClauses(IGF, fnType->getResult(), paramClauses.slice(1), args);
+    emitParameterClauses(IGF, fnType->getResult(), paramClauses.slice(1), args,
+                         ParameterConvention::Owned);
 
   // Finally, emit this clause.
-  emitParameterClause(IGF, fnType, paramClauses[0], args);
+  emitParameterClause(IGF, fnType, paramClauses[0], args, firstConvention);
 }
 
 /// Emit the prologue for the function.
@@ -2676,12 +2870,13 @@ void IRGenFunction::emitPrologue() {
 
   // Set up the parameters.
   auto params = CurFuncParamPatterns.slice(0, CurUncurryLevel + 1);
-  emitParameterClauses(*this, CurFuncType, params, values);
+  emitParameterClauses(*this, CurFuncType, params, values,
+                       getThisConvention(CurConvention));
 
+  // The context pointer is guaranteed by the caller.
   if (CurPrologue == Prologue::StandardWithContext) {
     ContextPtr = values.claimUnmanagedNext();
     ContextPtr->setName(".context");
-    enterReleaseCleanup(ContextPtr);
   }
 
   assert(values.empty() && "didn't exhaust all parameters?");
@@ -2816,15 +3011,26 @@ namespace {
     /// The clauses of the function that we're actually going to curry.
     llvm::SmallVector<Clause, 4> Clauses;
 
+    /// The convention of the first parameter clause.
+    ParameterConvention ThisConvention;
+
+    /// The index in AllDataTypes of the first parameter of the first
+    /// clause, or AllDataTypes.size() if it isn't curried.
+    unsigned ThisDataTypesBeginIndex;
+
   public:
     CurriedData(IRGenModule &IGM, FuncExpr *funcExpr,
                 ExplosionKind explosionLevel,
                 unsigned minUncurryLevel,
-                unsigned maxUncurryLevel)
+                unsigned maxUncurryLevel,
+                ParameterConvention thisConvention)
       : IGM(IGM), Func(funcExpr), ExplosionLevel(explosionLevel),
-        CurClause(minUncurryLevel) {
+        CurClause(minUncurryLevel), ThisConvention(thisConvention),
+        ThisDataTypesBeginIndex(0) {
       accumulateClauses(funcExpr->getType()->getCanonicalType(),
                         maxUncurryLevel);
+      if (Clauses.empty())
+        ThisDataTypesBeginIndex = AllDataTypes.size();
     }
 
     void emitCurriedEntrypoint(llvm::Function *entrypoint,
@@ -2889,9 +3095,19 @@ namespace {
 
       if (auto polyFn = dyn_cast<PolymorphicFunctionType>(fn))
         accumulatePolymorphicSignatureTypes(polyFn);
+      if (clauseIndex == 0)
+        ThisDataTypesBeginIndex = AllDataTypes.size();
       accumulateParameterDataTypes(CanType(fn->getInput()));
     }
 
+    /// Is the given field of the current clause's layout a parameter
+    /// that the entrypoints receive at +0?
+    bool isGuaranteedField(unsigned fieldIndex) const {
+      unsigned index = Clauses[CurClause].DataTypesBeginIndex + fieldIndex;
+      return ThisConvention == ParameterConvention::Guaranteed &&
+             index >= ThisDataTypesBeginIndex;
+    }
+
     /// Accumulate the given parameter type.
     void accumulateParameterDataTypes(CanType ty) {
       // As an optimization, expand tuples instead of grabbing their TypeInfo.
@@ -2978,10 +3194,19 @@ namespace {
 
         Address dataAddr = layout.emitCastOfAlloc(IGF, data);
 
-        // Perform the store.
-        for (auto &fieldLayout : layout.getElements()) {
+        // Perform the store.  Guaranteed parameters have to be copied
+        // into the data, since the caller still owns them.
+        auto elements = layout.getElements();
+        for (unsigned i = 0, e = elements.size(); i != e; ++i) {
+          auto &fieldLayout = elements[i];
           Address fieldAddr = fieldLayout.project(IGF, dataAddr);
-          fieldLayout.Type->initialize(IGF, params, fieldAddr);
+          if (isGuaranteedField(i)) {
+            Explosion copy(params.getKind());
+            fieldLayout.Type->copy(IGF, params, copy);
+            fieldLayout.Type->initialize(IGF, copy, fieldAddr);
+          } else {
+            fieldLayout.Type->initialize(IGF, params, fieldAddr);
+          }
         }
       }
 
@@ -3024,16 +3249,18 @@ namespace {
         llvm::Value *rawData = params.takeLast().getUnmanagedValue();
         Address data = layout.emitCastOfAlloc(IGF, rawData);
 
-        // Perform the loads.
-        for (auto &fieldLayout : layout.getElements()) {
+        // Perform the loads.  The data pointer is guaranteed, so the
+        // fields that the next entrypoint also takes at +0 can be
+        // passed along without a retain.
+        auto elements = layout.getElements();
+        for (unsigned i = 0, e = elements.size(); i != e; ++i) {
+          auto &fieldLayout = elements[i];
           Address fieldAddr = fieldLayout.project(IGF, data);
-          fieldLayout.Type->load(IGF, fieldAddr, params);
+          if (isGuaranteedField(i))
+            fieldLayout.Type->loadAsTake(IGF, fieldAddr, params);
+          else
+            fieldLayout.Type->load(IGF, fieldAddr, params);
         }
-
-        // Kill the allocated data pointer immediately.  The safety of
-        // this assumes that neither this release nor any of the loads
-        // can throw.
-        IGF.emitRelease(rawData);
       }
 
       llvm::SmallVector<llvm::Value*, 8> args;
@@ -3066,7 +3293,6 @@ static void emitFunction(IRGenModule &IGM, FuncDecl *func,
   ExtraData extraData = ExtraData::None;
 
   // FIXME: variant currying levels!
-  // FIXME: also emit entrypoints with maximal explosion when all types are known!
   unsigned naturalUncurryLevel = getNaturalUncurryLevel(func);
   assert(startingUncurryLevel <= naturalUncurryLevel);
 
@@ -3078,13 +3304,16 @@ static void emitFunction(IRGenModule &IGM, FuncDecl *func,
     entrypoint = IGM.getAddrOfGetter(cast<ValueDecl>(var), explosionLevel);
   } else if (Decl *var = func->getSetterDecl()) {
     entrypoint = IGM.getAddrOfSetter(cast<ValueDecl>(var), explosionLevel);
+  } else if (Decl *var = func->getAddressorDecl()) {
+    entrypoint = IGM.getAddrOfAddressor(cast<ValueDecl>(var), explosionLevel);
   } else {
     auto fnRef = FunctionRef(func, explosionLevel, startingUncurryLevel);
     entrypoint = IGM.getAddrOfFunction(fnRef, extraData);
   }
 
   CurriedData curriedData(IGM, funcExpr, explosionLevel,
-                          startingUncurryLevel, naturalUncurryLevel);
+                          startingUncurryLevel, naturalUncurryLevel,
+                          getThisConvention(getAbstractCC(func)));
 
   // Emit the curried entrypoints.  At the end of each iteration,
   // fnAddr will point to the next entrypoint in the currying sequence.
@@ -3099,11 +3328,17 @@ static void emitFunction(IRGenModule &IGM, FuncDecl *func,
     entrypoint = nextEntrypoint;
   }
 
+  // Prefer to emit the body from SIL if we have it.
+  if (startingUncurryLevel == 0 && naturalUncurryLevel == 0 &&
+      tryEmitFunctionFromSIL(IGM, func, entrypoint))
+    return;
+
   // Finally, emit the uncurried entrypoint.
   PrettyStackTraceDecl stackTrace("emitting IR for", func);
   IRGenFunction(IGM, funcExpr->getType()->getCanonicalType(),
                 funcExpr->getBodyParamPatterns(), explosionLevel,
-                naturalUncurryLevel, entrypoint)
+                naturalUncurryLevel, entrypoint, Prologue::Standard,
+                getAbstractCC(func))
     .emitFunctionTopLevel(funcExpr->getBody());
 }
 
@@ -19,6 +19,7 @@
 #define SWIFT_IRGEN_GENFUNC_H
 
 #include "CallingConvention.h"
+#include "IRGen.h"
 
 namespace swift {
   class ApplyExpr;
@@ -31,8 +32,13 @@ namespace irgen {
   class CallEmission;
   class Explosion;
   class IRGenFunction;
+  class IRGenModule;
   class TypeInfo;
 
+  /// Return the best explosion level for direct calls to the given
+  /// function from within this component.
+  ExplosionKind getDirectExplosionLevel(IRGenModule &IGM, FuncDecl *fn);
+
   /// Emit an r-value reference to a function.
   void emitRValueForFunction(IRGenFunction &IGF, FuncDecl *Fn,
                              Explosion &explosion);
@@ -194,54 +194,6 @@ ArrayHeapLayout::ArrayHeapLayout(IRGenFunction &IGF, CanType T)
   Align = align;
 }
 
-/// Destroy all the elements of an array.
-static void emitArrayDestroy(IRGenFunction &IGF,
-                             llvm::Value *begin, llvm::Value *end,
-                             const TypeInfo &elementTI,
-                             llvm::Value *elementSize) {
-  assert(!elementTI.isPOD(ResilienceScope::Local));
-
-  llvm::BasicBlock *endBB = IGF.createBasicBlock("end");
-  llvm::BasicBlock *bodyBB = IGF.createBasicBlock("loop-body");
-
-  // First, check whether the array is empty.  This is possible unless
-  // we ban allocating a zero-length array (or use a static allocation
-  // for one) and therefore never enter this code.
-  llvm::Value *isEmpty = IGF.Builder.CreateICmpEQ(begin, end, "empty");
-  IGF.Builder.CreateCondBr(isEmpty, endBB, bodyBB);
-
-  llvm::BasicBlock *entryBB = IGF.Builder.GetInsertBlock();
-  IGF.Builder.emitBlock(bodyBB);
-
-  // Destroy things in reverse order for no particular reason.
-  // Slightly better cache locality, maybe.
-  llvm::PHINode *prev = IGF.Builder.CreatePHI(begin->getType(), 2, "prev");
-  prev->addIncoming(end, entryBB);
-
-  // 'prev' points one past the end of the valid array; make something
-  // that points at the end.
-  llvm::Value *cur;
-  if (elementTI.StorageType->isSized()) {
-    cur = IGF.Builder.CreateInBoundsGEP(prev, getSizeMax(IGF), "cur");
-  } else {
-    cur = IGF.Builder.CreateBitCast(prev, IGF.IGM.Int8PtrTy);
-    llvm::Value *strideBytes = IGF.Builder.CreateNeg(elementSize);
-    cur = IGF.Builder.CreateInBoundsGEP(cur, strideBytes);
-    cur = IGF.Builder.CreateBitCast(cur, prev->getType());
-  }
-
-  // Destroy this element.
-  elementTI.destroy(IGF, Address(cur, elementTI.StorageAlignment));
-
-  // Loop if we haven't reached the end.
-  prev->addIncoming(cur, IGF.Builder.GetInsertBlock());
-  llvm::Value *done = IGF.Builder.CreateICmpEQ(cur, end, "done");
-  IGF.Builder.CreateCondBr(done, endBB, bodyBB);
-
-  // Done.
-  IGF.Builder.emitBlock(endBB);
-}
-
 /// Create the destructor function for an array layout.
 /// TODO: give this some reasonable name and possibly linkage.
 static llvm::Constant *
@@ -263,21 +215,11 @@ createArrayDtorFn(IRGenModule &IGM,
   bindNecessaryBindings(IGF, bindings, Address(header, layout.getAlignment()));
 
   // If the layout isn't known to be POD, we actually have to do work here.
-  if (!layout.getElementTypeInfo().isPOD(ResilienceScope::Local)) {
-    llvm::Value *elementSize = layout.getElementTypeInfo().getStride(IGF);
-
+  const TypeInfo &elementTI = layout.getElementTypeInfo();
+  if (!elementTI.isPOD(ResilienceScope::Local)) {
     llvm::Value *begin = layout.getBeginPointer(IGF, header);
-    llvm::Value *end;
-    if (layout.getElementTypeInfo().StorageType->isSized()) {
-      end = IGF.Builder.CreateInBoundsGEP(begin, length, "end");
-    } else {
-      end = IGF.Builder.CreateBitCast(begin, IGF.IGM.Int8PtrTy);
-      llvm::Value *lengthBytes = IGF.Builder.CreateMul(elementSize, length);
-      end = IGF.Builder.CreateInBoundsGEP(end, lengthBytes);
-      end = IGF.Builder.CreateBitCast(end, begin->getType());
-    }
-
-    emitArrayDestroy(IGF, begin, end, layout.getElementTypeInfo(), elementSize);
+    elementTI.destroyArray(IGF, Address(begin, elementTI.StorageAlignment),
+                           length);
   }
 
   llvm::Value *size = layout.getAllocationSize(IGF, length, false, false);
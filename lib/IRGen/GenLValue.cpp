@@ -85,6 +85,14 @@ void IRGenFunction::emitLoad(const LValue &lvalue, const TypeInfo &type,
       continue;
     }
 
+    // If the component can be addressed in place, do that instead of
+    // copying the value out.
+    if (component.asLogical().isAddressable()) {
+      address = component.asLogical().projectAddress(*this, address,
+                                                     ConsumeValues);
+      continue;
+    }
+
     // If this is the last component, load it and return that as the result.
     if (i == e)
       return component.asLogical().loadExplosion(*this, address, explosion,
@@ -115,6 +123,14 @@ void swift::irgen::emitLoadAsInit(IRGenFunction &IGF, const LValue &lvalue,
       continue;
     }
 
+    // If the component can be addressed in place, do that instead of
+    // copying the value out.
+    if (component.asLogical().isAddressable()) {
+      baseAddress = component.asLogical().projectAddress(IGF, baseAddress,
+                                                         ConsumeValues);
+      continue;
+    }
+
     // If this is the last component, load it and return that as the result.
     if (i == e)
       return component.asLogical().loadMaterialized(IGF, baseAddress, dest,
@@ -177,14 +193,19 @@ static void emitAssignRecursive(IRGenFunction &IGF,
                                 Explosion *finalExplosion,
                                 LValue::const_iterator pathStart,
                                 LValue::const_iterator pathEnd) {
-  // Drill into any physical components.
+  // Drill into any physical or addressable components.
   while (true) {
     assert(pathStart != pathEnd);
 
     const PathComponent &component = *pathStart;
-    if (component.isLogical()) break;
-    base = component.asPhysical().offset(IGF,
+    if (component.isPhysical()) {
+      base = component.asPhysical().offset(IGF,
                                    OwnedAddress(base, IGF.IGM.RefCountedNull));
+    } else if (component.asLogical().isAddressable()) {
+      base = component.asLogical().projectAddress(IGF, base, ConsumeValues);
+    } else {
+      break;
+    }
 
     // If we reach the end, do an assignment and we're done.
     if (++pathStart == pathEnd) {
@@ -220,8 +241,26 @@ static void emitAssignRecursive(IRGenFunction &IGF,
 }
                            
 
+/// Does the given l-value have any components which are accessed in
+/// place through an addressor?
+static bool hasAddressableComponents(const LValue &lvalue) {
+  for (auto &component : lvalue)
+    if (component.isLogical() && component.asLogical().isAddressable())
+      return true;
+  return false;
+}
+
 void IRGenFunction::emitAssign(Expr *E, const LValue &lvalue,
                               const TypeInfo &type) {
+  // An addressor hands out storage which evaluating the r-value might
+  // invalidate (say, by growing a vector), so evaluate the r-value
+  // before projecting any addresses.
+  if (hasAddressableComponents(lvalue)) {
+    Explosion value(ExplosionKind::Maximal);
+    emitRValue(E, value);
+    return emitAssign(value, lvalue, type);
+  }
+
   emitAssignRecursive(*this, Address(), type, E, nullptr,
                       lvalue.begin(), lvalue.end());
 }
@@ -247,6 +286,16 @@ static OwnedAddress emitMaterializeWithWriteback(IRGenFunction &IGF,
   OwnedAddress address;
   for (auto &component : lvalue) {
     if (component.isLogical()) {
+      // If the component can be addressed in place, there's nothing to
+      // materialize or write back.  The projected address has no owner,
+      // so it can't be used for a heap l-value.
+      if (onHeap == NotOnHeap && IGF.CanProjectAddressors &&
+          component.asLogical().isAddressable()) {
+        address = component.asLogical().projectAddress(IGF, address,
+                                                       ConsumeValues);
+        continue;
+      }
+
       // FIXME: we only need to materialize the *final* logical value
       // to the heap.
       address = component.asLogical().loadAndMaterialize(IGF, onHeap, address,
@@ -430,6 +479,13 @@ void swift::irgen::emitRequalify(IRGenFunction &IGF, RequalifyExpr *E,
   return IGF.emitRValue(E->getSubExpr(), explosion);
 }
 
+/// Return the addressor for the given variable or subscript, if any.
+static FuncDecl *findAddressor(ValueDecl *target) {
+  if (auto subscript = dyn_cast<SubscriptDecl>(target))
+    return subscript->getAddressor();
+  return cast<VarDecl>(target)->getAddressor();
+}
+
 /// Must accesses to the given variable be performed as a
 /// logical access?
 static bool isVarAccessLogical(IRGenFunction &IGF, VarDecl *var) {
@@ -636,6 +692,33 @@ namespace {
       return emission;
     }
 
+    bool isAddressable() const final {
+      return findAddressor(getTarget()) != nullptr;
+    }
+
+    /// Call the addressor and turn the raw pointer it returns into an
+    /// address of the object type.
+    OwnedAddress projectAddress(IRGenFunction &IGF, Address base,
+                       ShouldPreserveValues shouldPreserve) const final {
+      ExplosionKind explosionLevel = ExplosionKind::Minimal;
+      Callee callee = getAddressor(IGF, explosionLevel);
+
+      CallEmission emission(IGF, callee);
+      addArgs(emission, base, shouldPreserve);
+      emission.addEmptyArg();
+
+      Explosion result(ExplosionKind::Maximal);
+      emission.emitToExplosion(result);
+
+      const TypeInfo &valueTI = IGF.getFragileTypeInfo(getSubstObjectType());
+      llvm::Value *addr =
+        IGF.Builder.CreateBitCast(result.claimUnmanagedNext(),
+                                  valueTI.getStorageType()->getPointerTo(),
+                                  "addressor.result");
+      return OwnedAddress(Address(addr, valueTI.StorageAlignment),
+                          IGF.IGM.RefCountedNull);
+    }
+
   private:
     void addArgs(CallEmission &emission, Address base,
                  ShouldPreserveValues shouldPreserve) const {
@@ -675,6 +758,23 @@ namespace {
                                       formal.getNaturalUncurryLevel());
     }
 
+    Callee getAddressor(IRGenFunction &IGF,
+                        ExplosionKind explosionLevel) const {
+      auto target = getTarget();
+      FormalType formal = IGF.IGM.getTypeOfAddressor(target);
+      llvm::Constant *fn =
+        IGF.IGM.getAddrOfAddressor(target, formal, explosionLevel);
+
+      CanType substResultType =
+        IGF.IGM.Context.TheRawPointerType->getCanonicalType();
+      return Callee::forKnownFunction(formal.getCC(), formal.getType(),
+                                      substResultType,
+                                      getSubstitutions(),
+                                      fn, ManagedValue(nullptr),
+                                      explosionLevel,
+                                      formal.getNaturalUncurryLevel());
+    }
+
     /// Add the index argument.
     void addIndexArg(CallEmission &emission,
                      ShouldPreserveValues shouldPreserve) const {
@@ -32,6 +32,7 @@
 #include "ClassMetadataLayout.h"
 #include "FixedTypeInfo.h"
 #include "GenClass.h"
+#include "GenFunc.h"
 #include "GenHeap.h"
 #include "GenPoly.h"
 #include "GenProto.h"
@@ -85,22 +86,45 @@ namespace {
   };
 }
 
-/// Returns a metadata reference for a class type.
-llvm::Value *irgen::emitNominalMetadataRef(IRGenFunction &IGF,
-                                           NominalTypeDecl *theDecl,
-                                           CanType theType) {
-  auto generics = theDecl->getGenericParamsOfContext();
+/// Is the given type fully concrete?  The metadata for such a type is
+/// the same wherever it is used.
+static bool isConcreteType(CanType type) {
+  if (isa<BuiltinType>(type))
+    return true;
+  if (auto tuple = dyn_cast<TupleType>(type)) {
+    for (auto &field : tuple->getFields())
+      if (!isConcreteType(CanType(field.getType())))
+        return false;
+    return true;
+  }
+  if (auto nominal = dyn_cast<NominalType>(type))
+    return !nominal->getParent() ||
+           isConcreteType(CanType(nominal->getParent()));
+  if (auto bound = dyn_cast<BoundGenericType>(type)) {
+    if (bound->getParent() && !isConcreteType(CanType(bound->getParent())))
+      return false;
+    for (Type arg : bound->getGenericArgs())
+      if (!isConcreteType(CanType(arg)))
+        return false;
+    return true;
+  }
+  if (auto fn = dyn_cast<FunctionType>(type))
+    return isConcreteType(CanType(fn->getInput())) &&
+           isConcreteType(CanType(fn->getResult()));
+  if (auto meta = dyn_cast<MetaTypeType>(type))
+    return isConcreteType(CanType(meta->getInstanceType()));
+
+  // Archetypes obviously aren't concrete; be conservative about the rest.
+  return false;
+}
 
+/// Emit a reference to the metadata for a nominal type, instantiating
+/// it from its pattern if the type is generic.
+static llvm::Value *emitNominalMetadataInstantiation(IRGenFunction &IGF,
+                                                     NominalTypeDecl *theDecl,
+                                                     CanType theType) {
+  auto generics = theDecl->getGenericParamsOfContext();
   bool isPattern = (generics != nullptr);
-  assert(!isPattern || isa<BoundGenericType>(theType));
-  assert(isPattern || isa<NominalType>(theType));
-
-  // If this is generic, check to see if we've maybe got a local
-  // reference already.
-  if (isPattern) {
-    if (auto cache = IGF.tryGetLocalTypeData(theType, LocalTypeData::Metatype))
-      return cache;
-  }
 
   bool isIndirect = false; // FIXME
 
@@ -110,8 +134,6 @@ llvm::Value *irgen::emitNominalMetadataRef(IRGenFunction &IGF,
                                                         isIndirect, isPattern);
 
   // If it's indirected, go ahead and load the true value to use.
-  // TODO: startup performance might force this to be some sort of
-  // lazy check.
   if (isIndirect) {
     auto addr = Address(metadata, IGF.IGM.getPointerAlignment());
     metadata = IGF.Builder.CreateLoad(addr, "metadata.direct");
@@ -158,6 +180,86 @@ llvm::Value *irgen::emitNominalMetadataRef(IRGenFunction &IGF,
   return result;
 }
 
+/// Return the access function for the metadata of a concrete instance
+/// of a generic type, emitting it if this is its first use in the module.
+/// The function instantiates the metadata the first time it is called
+/// and caches it in a global variable for every later call.
+static llvm::Function *getTypeMetadataAccessFunction(IRGenModule &IGM,
+                                                     NominalTypeDecl *theDecl,
+                                                     CanType theType) {
+  llvm::Function *accessor = IGM.getAddrOfTypeMetadataAccessFunction(theType);
+  if (!accessor->empty())
+    return accessor;
+
+  Address cache(IGM.getAddrOfTypeMetadataLazyCacheVariable(theType),
+                IGM.getPointerAlignment());
+
+  IRGenFunction IGF(IGM, CanType(), nullptr,
+                    ExplosionKind::Minimal, 0, accessor, Prologue::Bare);
+
+  // The acquire pairs with the release below, so that a thread which sees
+  // the cached pointer also sees the metadata it points to.
+  llvm::LoadInst *cached = IGF.Builder.CreateLoad(cache, "metadata.cached");
+  cached->setOrdering(llvm::Acquire);
+  llvm::Value *isNull = IGF.Builder.CreateICmpEQ(cached,
+                     llvm::ConstantPointerNull::get(IGM.TypeMetadataPtrTy));
+  llvm::BasicBlock *entryBB = IGF.Builder.GetInsertBlock();
+  llvm::BasicBlock *initBB = IGF.createBasicBlock("cache.init");
+  llvm::BasicBlock *contBB = IGF.createBasicBlock("cache.done");
+  IGF.Builder.CreateCondBr(isNull, initBB, contBB);
+
+  // Instantiate the metadata and remember it.  Racing threads will
+  // store the same uniqued metadata.
+  IGF.Builder.emitBlock(initBB);
+  llvm::Value *metadata =
+    emitNominalMetadataInstantiation(IGF, theDecl, theType);
+  IGF.Builder.CreateStore(metadata, cache)->setOrdering(llvm::Release);
+  llvm::BasicBlock *initEndBB = IGF.Builder.GetInsertBlock();
+  IGF.Builder.CreateBr(contBB);
+
+  IGF.Builder.emitBlock(contBB);
+  llvm::PHINode *result =
+    IGF.Builder.CreatePHI(IGM.TypeMetadataPtrTy, 2, "metadata");
+  result->addIncoming(cached, entryBB);
+  result->addIncoming(metadata, initEndBB);
+  IGF.Builder.CreateRet(result);
+  return accessor;
+}
+
+/// Returns a metadata reference for a class type.
+llvm::Value *irgen::emitNominalMetadataRef(IRGenFunction &IGF,
+                                           NominalTypeDecl *theDecl,
+                                           CanType theType) {
+  auto generics = theDecl->getGenericParamsOfContext();
+
+  bool isPattern = (generics != nullptr);
+  assert(!isPattern || isa<BoundGenericType>(theType));
+  assert(isPattern || isa<NominalType>(theType));
+
+  if (!isPattern)
+    return emitNominalMetadataInstantiation(IGF, theDecl, theType);
+
+  // If this is generic, check to see if we've maybe got a local
+  // reference already.
+  if (auto cache = IGF.tryGetLocalTypeData(theType, LocalTypeData::Metatype))
+    return cache;
+
+  // Instances of generic types that don't depend on any archetypes go
+  // through an access function, which only asks the runtime for the
+  // metadata the first time.
+  if (!isConcreteType(theType))
+    return emitNominalMetadataInstantiation(IGF, theDecl, theType);
+
+  llvm::Function *accessor =
+    getTypeMetadataAccessFunction(IGF.IGM, theDecl, theType);
+  llvm::CallInst *result = IGF.Builder.CreateCall(accessor);
+  result->setCallingConv(accessor->getCallingConv());
+  result->setDoesNotThrow();
+
+  IGF.setScopedLocalTypeData(theType, LocalTypeData::Metatype, result);
+  return result;
+}
+
 /// Emit a string encoding the labels in the given tuple type.
 static llvm::Constant *getTupleLabelsString(IRGenModule &IGM,
                                             TupleType *type) {
@@ -650,10 +752,61 @@ namespace {
     }
 
     void addSuperClass() {
-      // FIXME!
+      // FIXME: generic superclasses have to be filled in when the
+      // metadata is instantiated.
+      if (Type base = TargetClass->getBaseClass()) {
+        CanType baseType = base->getCanonicalType();
+        if (isa<ClassType>(baseType) &&
+            !baseType->getClassOrBoundGenericClass()
+                     ->getGenericParamsOfContext()) {
+          Fields.push_back(IGM.getAddrOfTypeMetadata(baseType,
+                                                     /*indirect*/ false,
+                                                     /*pattern*/ false));
+          return;
+        }
+      }
       Fields.push_back(llvm::ConstantPointerNull::get(IGM.TypeMetadataPtrTy));
     }
 
+    void addClassDepth() {
+      Fields.push_back(llvm::ConstantInt::get(IGM.SizeTy,
+                                              getClassDepth(TargetClass)));
+    }
+
+    void addAncestorDisplay() {
+      auto displayPtrTy = IGM.TypeMetadataPtrTy->getPointerTo();
+      if (!hasStaticAncestorDisplay(TargetClass)) {
+        Fields.push_back(llvm::ConstantPointerNull::get(displayPtrTy));
+        return;
+      }
+
+      // Fill in the metadata for the class and its superclasses in
+      // root-first order.
+      SmallVector<llvm::Constant*, 4> ancestors(getClassDepth(TargetClass) + 1);
+      ClassDecl *cls = TargetClass;
+      for (unsigned i = ancestors.size(); i != 0; --i) {
+        CanType type = cls->getDeclaredType()->getCanonicalType();
+        ancestors[i - 1] = IGM.getAddrOfTypeMetadata(type,
+                                                     /*indirect*/ false,
+                                                     /*pattern*/ false);
+        if (cls->hasBaseClass())
+          cls = cls->getBaseClass()->getClassOrBoundGenericClass();
+      }
+
+      auto displayTy = llvm::ArrayType::get(IGM.TypeMetadataPtrTy,
+                                            ancestors.size());
+      auto display = new llvm::GlobalVariable(IGM.Module, displayTy,
+                                              /*constant*/ true,
+                                        llvm::GlobalVariable::InternalLinkage,
+                                    llvm::ConstantArray::get(displayTy,
+                                                             ancestors),
+                                              "ancestors");
+      llvm::Constant *zero = llvm::ConstantInt::get(IGM.Int32Ty, 0);
+      llvm::Constant *indices[] = { zero, zero };
+      Fields.push_back(llvm::ConstantExpr::getInBoundsGetElementPtr(display,
+                                                                  indices));
+    }
+
     void addMethod(FunctionRef fn) {
       // If this function is associated with the target class, go
       // ahead and emit the witness offset variable.
@@ -754,6 +907,29 @@ void irgen::emitClassMetadata(IRGenModule &IGM, ClassDecl *classDecl,
   var->setInitializer(init);
 }
 
+unsigned irgen::getClassDepth(ClassDecl *theClass) {
+  unsigned depth = 0;
+  while (theClass->hasBaseClass()) {
+    theClass = theClass->getBaseClass()->getClassOrBoundGenericClass();
+    ++depth;
+  }
+  return depth;
+}
+
+bool irgen::hasStaticAncestorDisplay(ClassDecl *theClass) {
+  while (true) {
+    if (theClass->getGenericParamsOfContext())
+      return false;
+    if (!theClass->hasBaseClass())
+      return true;
+
+    CanType base = theClass->getBaseClass()->getCanonicalType();
+    if (!isa<ClassType>(base))
+      return false;
+    theClass = base->getClassOrBoundGenericClass();
+  }
+}
+
 namespace {
   /// A visitor for checking whether two types are compatible.
   ///
@@ -909,6 +1085,16 @@ bool irgen::doesMethodRequireOverrideEntry(IRGenModule &IGM, FuncDecl *fn,
   return true;
 }
 
+/// Return the explosion level of the v-table entries for the given
+/// method.  A method has to agree with everything it overrides, so
+/// the method which introduced the original entry decides.
+ExplosionKind irgen::getVirtualExplosionLevel(IRGenModule &IGM,
+                                              FuncDecl *fn) {
+  while (FuncDecl *overridden = fn->getOverriddenDecl())
+    fn = overridden;
+  return getDirectExplosionLevel(IGM, fn);
+}
+
 /// Emit a load from the given metadata at a constant index.
 static llvm::Value *emitLoadFromMetadataAtIndex(IRGenFunction &IGF,
                                                 llvm::Value *metadata,
@@ -1280,8 +1466,7 @@ namespace {
 /// Provide the abstract parameters for virtual calls to the given method.
 AbstractCallee irgen::getAbstractVirtualCallee(IRGenFunction &IGF,
                                                FuncDecl *method) {
-  // TODO: maybe use better versions in the v-table sometimes?
-  ExplosionKind bestExplosion = ExplosionKind::Minimal;
+  ExplosionKind bestExplosion = getVirtualExplosionLevel(IGF.IGM, method);
   unsigned naturalUncurry = method->getNaturalArgumentCount() - 1;
 
   return AbstractCallee(AbstractCC::Method, bestExplosion,
@@ -1313,8 +1498,7 @@ Callee irgen::emitVirtualCallee(IRGenFunction &IGF, llvm::Value *base,
                                 llvm::ArrayRef<Substitution> substitutions,
                                 ExplosionKind maxExplosion,
                                 unsigned bestUncurry) {
-  // TODO: maybe use better versions in the v-table sometimes?
-  ExplosionKind bestExplosion = ExplosionKind::Minimal;
+  ExplosionKind bestExplosion = getVirtualExplosionLevel(IGF.IGM, method);
 
   unsigned naturalUncurry = method->getNaturalArgumentCount() - 1;
   bestUncurry = std::min(bestUncurry, naturalUncurry);
@@ -31,6 +31,7 @@
 #include "swift/AST/Types.h"
 #include "swift/AST/Decl.h"
 #include "swift/AST/Expr.h"
+#include "swift/ABI/MetadataValues.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/DerivedTypes.h"
@@ -145,9 +146,29 @@ static llvm::FunctionType *createWitnessFunctionType(IRGenModule &IGM,
     return llvm::FunctionType::get(ptrTy, args, false);
   }
 
+  // void (*destroyArray)(T *array, size_t n, M *self);
+  case ValueWitness::DestroyArray: {
+    llvm::Type *args[] = { IGM.OpaquePtrTy, IGM.SizeTy, IGM.TypeMetadataPtrTy };
+    return llvm::FunctionType::get(IGM.VoidTy, args, false);
+  }
+
+  // T *(*initializeArrayWithCopy)(T *dest, T *src, size_t n, M *self);
+  // T *(*initializeArrayWithTakeFrontToBack)(T *dest, T *src, size_t n,
+  //                                          M *self);
+  // T *(*initializeArrayWithTakeBackToFront)(T *dest, T *src, size_t n,
+  //                                          M *self);
+  case ValueWitness::InitializeArrayWithCopy:
+  case ValueWitness::InitializeArrayWithTakeFrontToBack:
+  case ValueWitness::InitializeArrayWithTakeBackToFront: {
+    llvm::Type *ptrTy = IGM.OpaquePtrTy;
+    llvm::Type *args[] = { ptrTy, ptrTy, IGM.SizeTy, IGM.TypeMetadataPtrTy };
+    return llvm::FunctionType::get(ptrTy, args, false);
+  }
+
   case ValueWitness::Size:
   case ValueWitness::Alignment:
   case ValueWitness::Stride:
+  case ValueWitness::Flags:
     llvm_unreachable("these witnesses aren't value witnesses!");
   }
   llvm_unreachable("bad value witness!");
@@ -198,12 +219,22 @@ static llvm::StringRef getValueWitnessLabel(ValueWitness index) {
     return "initializeWithCopy";
   case ValueWitness::InitializeWithTake:
     return "initializeWithTake";
+  case ValueWitness::DestroyArray:
+    return "destroyArray";
+  case ValueWitness::InitializeArrayWithCopy:
+    return "initializeArrayWithCopy";
+  case ValueWitness::InitializeArrayWithTakeFrontToBack:
+    return "initializeArrayWithTakeFrontToBack";
+  case ValueWitness::InitializeArrayWithTakeBackToFront:
+    return "initializeArrayWithTakeBackToFront";
   case ValueWitness::Size:
     return "size";
   case ValueWitness::Alignment:
     return "alignment";
   case ValueWitness::Stride:
     return "stride";
+  case ValueWitness::Flags:
+    return "flags";
   }
   llvm_unreachable("bad value witness index");
 }
@@ -489,6 +520,106 @@ static void emitDeallocateBufferCall(IRGenFunction &IGF,
   setHelperAttributes(call);
 }
 
+/// Emit a call to do a 'destroyArray' operation.
+static void emitDestroyArrayCall(IRGenFunction &IGF,
+                                 llvm::Value *witnessTable,
+                                 llvm::Value *metadata,
+                                 llvm::Value *array,
+                                 llvm::Value *count) {
+  llvm::Value *fn = loadValueWitness(IGF, witnessTable,
+                                     ValueWitness::DestroyArray);
+  llvm::CallInst *call = IGF.Builder.CreateCall3(fn, array, count, metadata);
+  call->setCallingConv(IGF.IGM.RuntimeCC);
+  setHelperAttributes(call);
+}
+
+/// Emit a call to do one of the array initialization operations:
+/// 'initializeArrayWithCopy' or one of the
+/// 'initializeArrayWithTake' operations.
+static void emitInitializeArrayCall(IRGenFunction &IGF,
+                                    llvm::Value *witnessTable,
+                                    llvm::Value *metadata,
+                                    ValueWitness index,
+                                    llvm::Value *destArray,
+                                    llvm::Value *srcArray,
+                                    llvm::Value *count) {
+  llvm::Value *fn = loadValueWitness(IGF, witnessTable, index);
+  llvm::CallInst *call =
+    IGF.Builder.CreateCall4(fn, destArray, srcArray, count, metadata);
+  call->setCallingConv(IGF.IGM.RuntimeCC);
+  setHelperAttributes(call);
+}
+
+/// Given a witness table, emit a test of one of its value witness flags.
+static llvm::Value *emitValueWitnessFlagTest(IRGenFunction &IGF,
+                                             llvm::Value *witnessTable,
+                                             ValueWitnessFlags flag) {
+  llvm::Value *flags = loadValueWitness(IGF, witnessTable, ValueWitness::Flags);
+  auto mask = llvm::ConstantInt::get(IGF.IGM.SizeTy, uint64_t(flag));
+  auto zero = llvm::ConstantInt::get(IGF.IGM.SizeTy, 0);
+  return IGF.Builder.CreateICmpNE(IGF.Builder.CreateAnd(flags, mask), zero);
+}
+
+/// The signature shared by the emit*Call functions for the copy, take
+/// and assignment witnesses.
+typedef void CopyWitnessCallEmitter(IRGenFunction &IGF,
+                                    llvm::Value *witnessTable,
+                                    llvm::Value *metadata,
+                                    llvm::Value *destObject,
+                                    llvm::Value *srcObject);
+
+/// Emit a copy, take or assignment between two objects of a dependent
+/// type.  If the type has the given flag, the value is simply copied
+/// bitwise; otherwise the value witness is called.
+static void emitCopyWithFlagTest(IRGenFunction &IGF,
+                                 llvm::Value *witnessTable,
+                                 llvm::Value *metadata,
+                                 Address dest, Address src,
+                                 ValueWitnessFlags flag, bool isAssignment,
+                                 CopyWitnessCallEmitter *emitWitnessCall) {
+  llvm::BasicBlock *bitwiseBB = IGF.createBasicBlock("bitwise");
+  llvm::BasicBlock *witnessBB = IGF.createBasicBlock("witness");
+  llvm::BasicBlock *contBB = IGF.createBasicBlock("cont");
+  llvm::Value *hasFlag = emitValueWitnessFlagTest(IGF, witnessTable, flag);
+  IGF.Builder.CreateCondBr(hasFlag, bitwiseBB, witnessBB);
+
+  // Assignments have to tolerate the source and destination aliasing.
+  IGF.Builder.emitBlock(bitwiseBB);
+  llvm::Value *size = loadValueWitness(IGF, witnessTable, ValueWitness::Size);
+  unsigned align = std::min(dest.getAlignment(), src.getAlignment()).getValue();
+  if (isAssignment)
+    IGF.Builder.CreateMemMove(dest.getAddress(), src.getAddress(), size, align);
+  else
+    IGF.Builder.CreateMemCpy(dest.getAddress(), src.getAddress(), size, align);
+  IGF.Builder.CreateBr(contBB);
+
+  IGF.Builder.emitBlock(witnessBB);
+  emitWitnessCall(IGF, witnessTable, metadata,
+                  dest.getAddress(), src.getAddress());
+  IGF.Builder.CreateBr(contBB);
+
+  IGF.Builder.emitBlock(contBB);
+}
+
+/// Emit a 'destroy' of an object of a dependent type, skipping the call
+/// entirely if the type is POD.
+static void emitDestroyWithPODTest(IRGenFunction &IGF,
+                                   llvm::Value *witnessTable,
+                                   llvm::Value *metadata,
+                                   llvm::Value *object) {
+  llvm::BasicBlock *destroyBB = IGF.createBasicBlock("destroy");
+  llvm::BasicBlock *contBB = IGF.createBasicBlock("cont");
+  llvm::Value *isPOD =
+    emitValueWitnessFlagTest(IGF, witnessTable, ValueWitnessFlags::IsPOD);
+  IGF.Builder.CreateCondBr(isPOD, contBB, destroyBB);
+
+  IGF.Builder.emitBlock(destroyBB);
+  emitDestroyCall(IGF, witnessTable, metadata, object);
+  IGF.Builder.CreateBr(contBB);
+
+  IGF.Builder.emitBlock(contBB);
+}
+
 /// Given the address of an existential object, destroy it.
 static void emitDestroyExistential(IRGenFunction &IGF, Address addr,
                                    ExistentialLayout layout) {
@@ -1047,34 +1178,79 @@ namespace {
     }
 
     void assignWithCopy(IRGenFunction &IGF, Address dest, Address src) const {
-      emitAssignWithCopyCall(IGF, getValueWitnessTable(IGF),
-                             getMetadataRef(IGF),
-                             dest.getAddress(), src.getAddress());
+      emitCopyWithFlagTest(IGF, getValueWitnessTable(IGF),
+                           getMetadataRef(IGF), dest, src,
+                           ValueWitnessFlags::IsPOD, /*assignment*/ true,
+                           &emitAssignWithCopyCall);
     }
 
     void assignWithTake(IRGenFunction &IGF, Address dest, Address src) const {
-      emitAssignWithTakeCall(IGF, getValueWitnessTable(IGF),
-                             getMetadataRef(IGF),
-                             dest.getAddress(), src.getAddress());
+      emitCopyWithFlagTest(IGF, getValueWitnessTable(IGF),
+                           getMetadataRef(IGF), dest, src,
+                           ValueWitnessFlags::IsPOD, /*assignment*/ true,
+                           &emitAssignWithTakeCall);
     }
 
     void initializeWithCopy(IRGenFunction &IGF,
                             Address dest, Address src) const {
-      emitInitializeWithCopyCall(IGF, getValueWitnessTable(IGF),
-                                 getMetadataRef(IGF),
-                                 dest.getAddress(), src.getAddress());
+      emitCopyWithFlagTest(IGF, getValueWitnessTable(IGF),
+                           getMetadataRef(IGF), dest, src,
+                           ValueWitnessFlags::IsPOD, /*assignment*/ false,
+                           &emitInitializeWithCopyCall);
     }
 
     void initializeWithTake(IRGenFunction &IGF,
                             Address dest, Address src) const {
-      emitInitializeWithTakeCall(IGF, getValueWitnessTable(IGF),
-                                 getMetadataRef(IGF),
-                                 dest.getAddress(), src.getAddress());
+      emitCopyWithFlagTest(IGF, getValueWitnessTable(IGF),
+                           getMetadataRef(IGF), dest, src,
+                           ValueWitnessFlags::IsBitwiseTakable,
+                           /*assignment*/ false,
+                           &emitInitializeWithTakeCall);
     }
 
     void destroy(IRGenFunction &IGF, Address addr) const {
-      emitDestroyCall(IGF, getValueWitnessTable(IGF), getMetadataRef(IGF),
-                      addr.getAddress());
+      emitDestroyWithPODTest(IGF, getValueWitnessTable(IGF),
+                             getMetadataRef(IGF), addr.getAddress());
+    }
+
+    // The array witnesses check the flags themselves, so there is no
+    // point in testing them inline.
+
+    void destroyArray(IRGenFunction &IGF, Address array,
+                      llvm::Value *count) const {
+      emitDestroyArrayCall(IGF, getValueWitnessTable(IGF),
+                           getMetadataRef(IGF), array.getAddress(), count);
+    }
+
+    void initializeArrayWithCopy(IRGenFunction &IGF, Address destArray,
+                                 Address srcArray, llvm::Value *count) const {
+      emitInitializeArrayCall(IGF, getValueWitnessTable(IGF),
+                              getMetadataRef(IGF),
+                              ValueWitness::InitializeArrayWithCopy,
+                              destArray.getAddress(), srcArray.getAddress(),
+                              count);
+    }
+
+    void initializeArrayWithTakeFrontToBack(IRGenFunction &IGF,
+                                            Address destArray,
+                                            Address srcArray,
+                                            llvm::Value *count) const {
+      emitInitializeArrayCall(IGF, getValueWitnessTable(IGF),
+                              getMetadataRef(IGF),
+                              ValueWitness::InitializeArrayWithTakeFrontToBack,
+                              destArray.getAddress(), srcArray.getAddress(),
+                              count);
+    }
+
+    void initializeArrayWithTakeBackToFront(IRGenFunction &IGF,
+                                            Address destArray,
+                                            Address srcArray,
+                                            llvm::Value *count) const {
+      emitInitializeArrayCall(IGF, getValueWitnessTable(IGF),
+                              getMetadataRef(IGF),
+                              ValueWitness::InitializeArrayWithTakeBackToFront,
+                              destArray.getAddress(), srcArray.getAddress(),
+                              count);
     }
 
     std::pair<llvm::Value*,llvm::Value*>
@@ -1516,9 +1692,48 @@ static void buildValueWitnessFunction(IRGenModule &IGM,
     return;
   }
 
+  case ValueWitness::DestroyArray: {
+    Address array = getArgAs(IGF, argv, type, "array");
+    llvm::Value *count = getArg(argv, "count");
+    type.destroyArray(IGF, array, count);
+    IGF.Builder.CreateRetVoid();
+    return;
+  }
+
+  case ValueWitness::InitializeArrayWithCopy: {
+    Address dest = getArgAs(IGF, argv, type, "dest");
+    Address src = getArgAs(IGF, argv, type, "src");
+    llvm::Value *count = getArg(argv, "count");
+    type.initializeArrayWithCopy(IGF, dest, src, count);
+    dest = IGF.Builder.CreateBitCast(dest, IGF.IGM.OpaquePtrTy);
+    IGF.Builder.CreateRet(dest.getAddress());
+    return;
+  }
+
+  case ValueWitness::InitializeArrayWithTakeFrontToBack: {
+    Address dest = getArgAs(IGF, argv, type, "dest");
+    Address src = getArgAs(IGF, argv, type, "src");
+    llvm::Value *count = getArg(argv, "count");
+    type.initializeArrayWithTakeFrontToBack(IGF, dest, src, count);
+    dest = IGF.Builder.CreateBitCast(dest, IGF.IGM.OpaquePtrTy);
+    IGF.Builder.CreateRet(dest.getAddress());
+    return;
+  }
+
+  case ValueWitness::InitializeArrayWithTakeBackToFront: {
+    Address dest = getArgAs(IGF, argv, type, "dest");
+    Address src = getArgAs(IGF, argv, type, "src");
+    llvm::Value *count = getArg(argv, "count");
+    type.initializeArrayWithTakeBackToFront(IGF, dest, src, count);
+    dest = IGF.Builder.CreateBitCast(dest, IGF.IGM.OpaquePtrTy);
+    IGF.Builder.CreateRet(dest.getAddress());
+    return;
+  }
+
   case ValueWitness::Size:
   case ValueWitness::Alignment:
   case ValueWitness::Stride:
+  case ValueWitness::Flags:
     llvm_unreachable("these value witnesses aren't functions");
   }
   llvm_unreachable("bad value witness kind!");
@@ -1916,6 +2131,18 @@ static llvm::Constant *getValueWitness(IRGenModule &IGM,
       return asOpaquePtr(IGM, getReturnSelfFunction(IGM));
     goto standard;
 
+  // Note that, as with the memcpy functions above, we're assuming that
+  // it's safe to call the no-op function with an extra count argument.
+  case ValueWitness::DestroyArray:
+    if (concreteTI.isPOD(ResilienceScope::Local))
+      return asOpaquePtr(IGM, getNoOpVoidFunction(IGM));
+    goto standard;
+
+  case ValueWitness::InitializeArrayWithCopy:
+  case ValueWitness::InitializeArrayWithTakeFrontToBack:
+  case ValueWitness::InitializeArrayWithTakeBackToFront:
+    goto standard;
+
   case ValueWitness::Size: {
     if (auto value = concreteTI.getStaticSize(IGM))
       return llvm::ConstantExpr::getIntToPtr(value, IGM.Int8PtrTy);
@@ -1940,6 +2167,18 @@ static llvm::Constant *getValueWitness(IRGenModule &IGM,
     return llvm::ConstantPointerNull::get(IGM.Int8PtrTy);
   }
 
+  case ValueWitness::Flags: {
+    // Every type we lay out is taken with a memcpy; see InitializeWithTake
+    // above.
+    uint64_t flags = uint64_t(ValueWitnessFlags::IsBitwiseTakable);
+    if (concreteTI.isPOD(ResilienceScope::Local))
+      flags |= uint64_t(ValueWitnessFlags::IsPOD);
+    if (isNeverAllocated(packing))
+      flags |= uint64_t(ValueWitnessFlags::IsInline);
+    auto value = llvm::ConstantInt::get(IGM.SizeTy, flags);
+    return llvm::ConstantExpr::getIntToPtr(value, IGM.Int8PtrTy);
+  }
+
   }
   llvm_unreachable("bad value witness kind");
 
@@ -2153,13 +2392,17 @@ namespace {
       // instead we're going to emit this as a call to a monomorphic
       // function and do all our own translation.
       // FIXME: virtual calls!
+      // An abstracted 'this' means the implementation is a class method,
+      // which takes 'this' at +0.
+      AbstractCC implCC = (HasAbstractedThis ? AbstractCC::Method
+                                             : AbstractCC::Freestanding);
       CallEmission emission(IGF,
-          Callee::forFreestandingFunction(ImplTy,
-                                          argSites.back().getImplResultType(),
-                                          ArrayRef<Substitution>(),
-                                          ImplPtr,
-                                          ExplosionLevel,
-                                          UncurryLevel));
+          Callee::forKnownFunction(implCC, ImplTy,
+                                   argSites.back().getImplResultType(),
+                                   ArrayRef<Substitution>(),
+                                   ImplPtr, ManagedValue(nullptr),
+                                   ExplosionLevel,
+                                   UncurryLevel));
 
       // Now actually pass the arguments.
       for (unsigned i = 0, e = UncurryLevel + 1; i != e; ++i) {
@@ -2191,10 +2434,14 @@ namespace {
 
           // Cast to T* and load.  In theory this might require
           // remapping, but in practice the constraints (which we
-          // assert just above) don't permit that.
+          // assert just above) don't permit that.  The method only
+          // borrows 'this', so we don't need to retain it.
           auto implPtrTy = implTI.getStorageType()->getPointerTo();
           sigThis = IGF.Builder.CreateBitCast(sigThis, implPtrTy);
-          implTI.load(IGF, sigThis, implArgs);
+          Explosion temp(ExplosionLevel);
+          implTI.loadAsTake(IGF, sigThis, temp);
+          while (!temp.empty())
+            implArgs.addUnmanaged(temp.forwardNext(IGF));
 
         // Otherwise, the impl type is the result of some substitution
         // on the sig type.
@@ -0,0 +1,675 @@
+//===--- GenSIL.cpp - Swift IR Generation From SIL ------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements IR generation of function bodies from SIL.
+//
+//  Every SIL value is lowered to the scalars of its minimal explosion.  An
+//  l-value is lowered to its address, followed by its owner if it is on
+//  the heap, which is how l-values are passed as arguments.  The scalars
+//  are unmanaged: SIL makes every retain and release explicit, so the
+//  lowering only adds the copies and destructions that the semantics of
+//  individual instructions call for (a load that isn't a take copies the
+//  value, an assigning store destroys the old one, and so on).
+//
+//  Functions that use anything the lowering does not handle yet are left
+//  to the AST-based emitter.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "irgen-sil"
+#include "swift/AST/Decl.h"
+#include "swift/AST/Expr.h"
+#include "swift/AST/Module.h"
+#include "swift/AST/PrettyStackTrace.h"
+#include "swift/AST/Types.h"
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILVisitor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/DerivedTypes.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+
+#include "Callee.h"
+#include "CallEmission.h"
+#include "Explosion.h"
+#include "FunctionRef.h"
+#include "GenFunc.h"
+#include "GenMeta.h"
+#include "GenTuple.h"
+#include "IRGenFunction.h"
+#include "IRGenModule.h"
+#include "Scope.h"
+#include "TypeInfo.h"
+
+#include "GenSIL.h"
+
+using namespace swift;
+using namespace irgen;
+
+STATISTIC(NumFunctionsFromSIL, "Number of function bodies emitted from SIL");
+STATISTIC(NumFunctionsFromAST,
+          "Number of function bodies with SIL emitted from the AST instead");
+
+/// Does a value of the given type explode to scalars alone?  The lowering
+/// keeps every value in SSA form, so it can't handle aggregates that the
+/// AST emitter keeps in memory.
+static bool explodesToScalars(IRGenModule &IGM, Type type) {
+  ExplosionSchema schema = IGM.getSchema(type->getCanonicalType(),
+                                         ExplosionKind::Minimal);
+  return !schema.containsAggregate();
+}
+
+/// Can a reference to the given declaration be lowered to the address of
+/// a function that takes no data pointer?
+static bool isDirectlyCallable(ValueDecl *D) {
+  FuncDecl *fn = dyn_cast<FuncDecl>(D);
+  if (!fn || fn->getGetterOrSetterDecl())
+    return false;
+
+  DeclContext *DC = fn->getDeclContext();
+  if (!DC->isModuleContext() || isa<BuiltinModule>(DC))
+    return false;
+
+  return isa<FunctionType>(fn->getType()->getCanonicalType()) &&
+         fn->getBody()->getNaturalArgumentCount() == 1;
+}
+
+/// Can the given conversion be lowered?  Conversions from an l-value
+/// change the type of its address; all others must reinterpret each
+/// scalar as one of the same size.
+static bool canLowerConversion(IRGenModule &IGM, TypeConversionInst *I) {
+  Type srcType = I->getOperand()->getType();
+  Type destType = I->getType();
+  if (srcType->is<LValueType>())
+    return destType->is<LValueType>() ||
+           IGM.getExplosionSize(destType->getCanonicalType(),
+                                ExplosionKind::Minimal) == 1;
+  if (destType->is<LValueType>())
+    return false;
+
+  ExplosionSchema src = IGM.getSchema(srcType->getCanonicalType(),
+                                      ExplosionKind::Minimal);
+  ExplosionSchema dest = IGM.getSchema(destType->getCanonicalType(),
+                                       ExplosionKind::Minimal);
+  if (src.size() != dest.size())
+    return false;
+  for (auto si = src.begin(), di = dest.begin(); si != src.end(); ++si, ++di)
+    if (!llvm::CastInst::isBitCastable(si->getScalarType(),
+                                       di->getScalarType()))
+      return false;
+  return true;
+}
+
+/// Can the given instruction be lowered?  The instruction's own type and
+/// those of its operands are known to explode to scalars.
+static bool canLowerInstruction(IRGenModule &IGM, Instruction &I) {
+  switch (I.getKind()) {
+  case ValueKind::BBArgument:
+    llvm_unreachable("not an instruction");
+
+  // Arrays and generic specialization aren't lowered yet.
+  case ValueKind::AllocArrayInst:
+  case ValueKind::SpecializeInst:
+    return false;
+
+  // A variable captured by a closure needs a box on the heap.
+  case ValueKind::AllocVarInst:
+    return cast<AllocVarInst>(I).getDecl()->hasFixedLifetime();
+
+  case ValueKind::ConstantRefInst:
+    return isDirectlyCallable(cast<ConstantRefInst>(I).getDecl());
+
+  case ValueKind::MetatypeInst:
+    return cast<MetatypeInst>(I).getExpr()->getBase() == nullptr;
+
+  case ValueKind::TypeConversionInst:
+    return canLowerConversion(IGM, cast<TypeConversionInst>(&I));
+
+  // An element of an l-value must be an l-value itself.
+  case ValueKind::TupleElementInst:
+    return !cast<TupleElementInst>(I).getOperand()->getType()
+              ->is<LValueType>() ||
+           I.getType()->is<LValueType>();
+
+  // Only stack allocations are lowered, so only they can be deallocated.
+  case ValueKind::DeallocInst:
+    return isa<AllocInst>(cast<DeallocInst>(I).getOperand());
+
+  case ValueKind::CondBranchInst: {
+    Value *cond = cast<CondBranchInst>(I).getCondition();
+    ExplosionSchema schema = IGM.getSchema(cond->getType()->getCanonicalType(),
+                                           ExplosionKind::Minimal);
+    return schema.size() == 1 && schema.begin()->isScalar() &&
+           schema.begin()->getScalarType() == IGM.Int1Ty;
+  }
+
+  case ValueKind::AllocTmpInst:
+  case ValueKind::ApplyInst:
+  case ValueKind::ZeroValueInst:
+  case ValueKind::IntegerLiteralInst:
+  case ValueKind::FloatLiteralInst:
+  case ValueKind::CharacterLiteralInst:
+  case ValueKind::StringLiteralInst:
+  case ValueKind::LoadInst:
+  case ValueKind::StoreInst:
+  case ValueKind::CopyInst:
+  case ValueKind::TupleInst:
+  case ValueKind::RetainInst:
+  case ValueKind::ReleaseInst:
+  case ValueKind::DestroyInst:
+  case ValueKind::IndexLValueInst:
+  case ValueKind::IntegerValueInst:
+  case ValueKind::UnreachableInst:
+  case ValueKind::ReturnInst:
+  case ValueKind::BranchInst:
+    return true;
+  }
+  llvm_unreachable("bad value kind");
+}
+
+/// Can every reachable block of a function be lowered?  The blocks are
+/// given in reverse post-order, starting with the entry block.
+static bool canLowerFunction(IRGenModule &IGM, ArrayRef<BasicBlock*> blocks) {
+  // The arguments of the entry block are the function's parameters, so
+  // there are no incoming values to merge into them.
+  BasicBlock *entry = blocks[0];
+  if (!entry->pred_empty())
+    return false;
+
+  // The callee owns the box of a heap l-value parameter, and SIL doesn't
+  // say when to release it.
+  for (auto i = entry->bbarg_begin(), e = entry->bbarg_end(); i != e; ++i)
+    if (LValueType *lv = (*i)->getType()->getAs<LValueType>())
+      if (lv->isHeap())
+        return false;
+
+  for (BasicBlock *BB : blocks) {
+    for (auto i = BB->bbarg_begin(), e = BB->bbarg_end(); i != e; ++i)
+      if (!explodesToScalars(IGM, (*i)->getType()))
+        return false;
+    for (Instruction &I : *BB)
+      if (!explodesToScalars(IGM, I.getType()) ||
+          !canLowerInstruction(IGM, I))
+        return false;
+  }
+  return true;
+}
+
+namespace {
+  /// SILLowering - Emits the body of a function from SIL that passed
+  /// canLowerFunction.
+  class SILLowering : public SILVisitor<SILLowering> {
+    IRGenFunction &IGF;
+    IRGenModule &IGM;
+
+    /// The address to emit the result into, if it is returned indirectly.
+    Address IndirectResult;
+
+    /// The scalars each SIL value has been lowered to.
+    llvm::DenseMap<Value*, SmallVector<llvm::Value*, 2>> Scalars;
+
+    /// The LLVM block each reachable SIL block is emitted into.
+    llvm::DenseMap<BasicBlock*, llvm::BasicBlock*> Blocks;
+
+  public:
+    explicit SILLowering(IRGenFunction &IGF) : IGF(IGF), IGM(IGF.IGM) {}
+
+    void emitFunction(ArrayRef<BasicBlock*> blocks, CanType resultType);
+
+  private:
+    ArrayRef<llvm::Value*> getScalars(Value *V) {
+      auto it = Scalars.find(V);
+      assert(it != Scalars.end() && "SIL value used before it was lowered");
+      return it->second;
+    }
+
+    /// Record the scalars a value was lowered to.  The scalars are copied
+    /// first, since they may live in the map being inserted into.
+    void setScalars(Value *V, ArrayRef<llvm::Value*> scalars) {
+      SmallVector<llvm::Value*, 2> copy(scalars.begin(), scalars.end());
+      Scalars[V] = copy;
+    }
+
+    /// Record the scalars of an explosion as the lowering of a value,
+    /// forwarding any cleanups on them.
+    void setScalars(Value *V, Explosion &explosion) {
+      SmallVector<llvm::Value*, 2> scalars;
+      for (ManagedValue value : explosion.claimAll())
+        scalars.push_back(value.forward(IGF));
+      Scalars[V] = scalars;
+    }
+
+    void addToExplosion(Value *V, Explosion &out) {
+      for (llvm::Value *scalar : getScalars(V))
+        out.addUnmanaged(scalar);
+    }
+
+    const TypeInfo &getObjectTypeInfo(Value *lvalue) {
+      LValueType *type = lvalue->getType()->castTo<LValueType>();
+      return IGM.getFragileTypeInfo(type->getObjectType());
+    }
+
+    Address getAddress(Value *lvalue) {
+      return Address(getScalars(lvalue)[0],
+                     getObjectTypeInfo(lvalue).StorageAlignment);
+    }
+
+    /// Return the owner of an l-value, which is null unless the l-value is
+    /// on the heap.
+    llvm::Value *getOwner(Value *lvalue) {
+      ArrayRef<llvm::Value*> scalars = getScalars(lvalue);
+      return scalars.size() > 1 ? scalars[1] : IGM.RefCountedNull;
+    }
+
+    void setAddress(Value *lvalue, llvm::Value *addr, llvm::Value *owner) {
+      SmallVector<llvm::Value*, 2> scalars;
+      scalars.push_back(addr);
+      if (lvalue->getType()->castTo<LValueType>()->isHeap())
+        scalars.push_back(owner);
+      Scalars[lvalue] = scalars;
+    }
+
+    Callee getCallee(Value *fn, CanType fnType, CanType resultType);
+
+  public:
+    void visitValue(Value *V) {
+      llvm_unreachable("SIL value passed canLowerFunction but isn't lowered");
+    }
+
+    void visitAllocVarInst(AllocVarInst *I) {
+      const TypeInfo &TI = getObjectTypeInfo(I);
+      Address addr = IGF.createAlloca(TI.getStorageType(), TI.StorageAlignment,
+                                      I->getDecl()->getName().str());
+      setAddress(I, addr.getAddress(), IGM.RefCountedNull);
+    }
+
+    void visitAllocTmpInst(AllocTmpInst *I) {
+      const TypeInfo &TI = getObjectTypeInfo(I);
+      Address addr = IGF.createAlloca(TI.getStorageType(), TI.StorageAlignment,
+                                      "temporary");
+      setAddress(I, addr.getAddress(), IGM.RefCountedNull);
+    }
+
+    void visitApplyInst(ApplyInst *I);
+
+    void visitConstantRefInst(ConstantRefInst *I) {
+      Explosion fn(ExplosionKind::Minimal);
+      emitRValueForFunction(IGF, cast<FuncDecl>(I->getDecl()), fn);
+      setScalars(I, fn);
+    }
+
+    void visitZeroValueInst(ZeroValueInst *I) {
+      ExplosionSchema schema = IGM.getSchema(I->getType()->getCanonicalType(),
+                                             ExplosionKind::Minimal);
+      SmallVector<llvm::Value*, 2> zeros;
+      for (auto &elt : schema)
+        zeros.push_back(llvm::Constant::getNullValue(elt.getScalarType()));
+      setScalars(I, zeros);
+    }
+
+    void visitIntegerLiteralInst(IntegerLiteralInst *I) {
+      setScalars(I, llvm::ConstantInt::get(IGM.LLVMContext, I->getValue()));
+    }
+
+    void visitFloatLiteralInst(FloatLiteralInst *I) {
+      setScalars(I, llvm::ConstantFP::get(IGM.LLVMContext, I->getValue()));
+    }
+
+    void visitCharacterLiteralInst(CharacterLiteralInst *I) {
+      setScalars(I, llvm::ConstantInt::get(IGM.Int32Ty, I->getValue()));
+    }
+
+    void visitStringLiteralInst(StringLiteralInst *I) {
+      SmallVector<llvm::Value*, 2> scalars;
+      scalars.push_back(IGM.getAddrOfGlobalString(I->getValue()));
+      if (!I->getType()->is<BuiltinRawPointerType>())
+        scalars.push_back(IGF.Builder.getInt64(I->getValue().size()));
+      setScalars(I, scalars);
+    }
+
+    void visitIntegerValueInst(IntegerValueInst *I) {
+      llvm::Type *type = IGM.getFragileType(I->getType()->getCanonicalType());
+      setScalars(I, llvm::ConstantInt::get(type, I->getValue()));
+    }
+
+    void visitLoadInst(LoadInst *I) {
+      const TypeInfo &TI = getObjectTypeInfo(I->getLValue());
+      Address addr = getAddress(I->getLValue());
+      Explosion value(ExplosionKind::Minimal);
+      if (I->isTake())
+        TI.loadAsTake(IGF, addr, value);
+      else
+        TI.load(IGF, addr, value);
+      setScalars(I, value);
+    }
+
+    void visitStoreInst(StoreInst *I) {
+      const TypeInfo &TI = getObjectTypeInfo(I->getDest());
+      Explosion value(ExplosionKind::Minimal);
+      addToExplosion(I->getSrc(), value);
+      Address dest = getAddress(I->getDest());
+      if (I->isInitialization())
+        TI.initialize(IGF, value, dest);
+      else
+        TI.assign(IGF, value, dest);
+    }
+
+    void visitCopyInst(CopyInst *I) {
+      const TypeInfo &TI = getObjectTypeInfo(I->getDest());
+      Address src = getAddress(I->getSrc());
+      Address dest = getAddress(I->getDest());
+      if (I->isInitializationOfDest()) {
+        if (I->isTakeOfSrc())
+          TI.initializeWithTake(IGF, dest, src);
+        else
+          TI.initializeWithCopy(IGF, dest, src);
+      } else {
+        if (I->isTakeOfSrc())
+          TI.assignWithTake(IGF, dest, src);
+        else
+          TI.assignWithCopy(IGF, dest, src);
+      }
+    }
+
+    void visitTypeConversionInst(TypeConversionInst *I);
+
+    void visitTupleInst(TupleInst *I) {
+      SmallVector<llvm::Value*, 4> scalars;
+      for (Value *elt : I->getElements()) {
+        ArrayRef<llvm::Value*> eltScalars = getScalars(elt);
+        scalars.append(eltScalars.begin(), eltScalars.end());
+      }
+      setScalars(I, scalars);
+    }
+
+    void visitMetatypeInst(MetatypeInst *I) {
+      CanType type = I->getMetaType()->getCanonicalType();
+      Explosion metadata(ExplosionKind::Minimal);
+      emitMetaTypeRef(IGF, CanType(cast<MetaTypeType>(type)->getInstanceType()),
+                      metadata);
+      setScalars(I, metadata);
+    }
+
+    void visitTupleElementInst(TupleElementInst *I);
+
+    void visitRetainInst(RetainInst *I) {
+      Value *operand = I->getOperand();
+      const TypeInfo &TI = IGM.getFragileTypeInfo(operand->getType());
+      Explosion value(ExplosionKind::Minimal), copy(ExplosionKind::Minimal);
+      addToExplosion(operand, value);
+      TI.copy(IGF, value, copy);
+      setScalars(I, copy);
+    }
+
+    void visitReleaseInst(ReleaseInst *I) {
+      Value *operand = I->getOperand();
+      const TypeInfo &TI = IGM.getFragileTypeInfo(operand->getType());
+      if (TI.isPOD(ResilienceScope::Local))
+        return;
+
+      // Put the value under cleanups, which know how to release every kind
+      // of reference, and leave them for the scope around the instruction
+      // to run.
+      Explosion value(ExplosionKind::Minimal), managed(ExplosionKind::Minimal);
+      addToExplosion(operand, value);
+      TI.manage(IGF, value, managed);
+      managed.claimAll();
+    }
+
+    /// Stack allocations go away when the function returns.
+    void visitDeallocInst(DeallocInst *I) {}
+
+    void visitDestroyInst(DestroyInst *I) {
+      Value *lvalue = I->getOperand();
+      getObjectTypeInfo(lvalue).destroy(IGF, getAddress(lvalue));
+    }
+
+    void visitIndexLValueInst(IndexLValueInst *I) {
+      Value *lvalue = I->getOperand();
+      llvm::Value *addr =
+        IGF.Builder.CreateConstInBoundsGEP1_32(getAddress(lvalue).getAddress(),
+                                               I->getIndex());
+      setAddress(I, addr, getOwner(lvalue));
+    }
+
+    void visitUnreachableInst(UnreachableInst *I) {
+      IGF.Builder.CreateUnreachable();
+    }
+
+    void visitReturnInst(ReturnInst *I) {
+      Value *result = I->getReturnValue();
+      Explosion value(ExplosionKind::Minimal);
+      addToExplosion(result, value);
+      if (!IndirectResult.isValid()) {
+        IGF.emitScalarReturn(value);
+        return;
+      }
+
+      IGM.getFragileTypeInfo(result->getType())
+        .initialize(IGF, value, IndirectResult);
+      IGF.Builder.CreateRetVoid();
+    }
+
+    void visitBranchInst(BranchInst *I);
+
+    void visitCondBranchInst(CondBranchInst *I) {
+      llvm::Value *cond = getScalars(I->getCondition())[0];
+      IGF.Builder.CreateCondBr(cond, Blocks.lookup(I->getTrueBB()),
+                               Blocks.lookup(I->getFalseBB()));
+    }
+  };
+}
+
+void SILLowering::emitFunction(ArrayRef<BasicBlock*> blocks,
+                               CanType resultType) {
+  // The parameters are the indirect result slot, if there is one, followed
+  // by the explosions of the entry block's arguments.
+  Explosion params = IGF.collectParameters();
+  const TypeInfo &resultTI = IGM.getFragileTypeInfo(resultType);
+  if (resultTI.getSchema(ExplosionKind::Minimal).requiresIndirectResult())
+    IndirectResult = Address(params.claimUnmanagedNext(),
+                             resultTI.StorageAlignment);
+
+  BasicBlock *entry = blocks[0];
+  for (auto i = entry->bbarg_begin(), e = entry->bbarg_end(); i != e; ++i) {
+    unsigned size = IGM.getExplosionSize((*i)->getType()->getCanonicalType(),
+                                         ExplosionKind::Minimal);
+    SmallVector<llvm::Value*, 2> scalars;
+    params.claimUnmanaged(size, scalars);
+    setScalars(*i, scalars);
+  }
+  assert(params.empty() && "didn't claim all parameters?");
+
+  // The entry block continues the block the prologue was emitted into.
+  // Every other block merges the values of its arguments with phis.
+  Blocks[entry] = IGF.Builder.GetInsertBlock();
+  for (BasicBlock *BB : blocks.slice(1)) {
+    llvm::BasicBlock *llvmBB = IGF.createBasicBlock("bb");
+    IGF.CurFn->getBasicBlockList().push_back(llvmBB);
+    Blocks[BB] = llvmBB;
+
+    for (auto i = BB->bbarg_begin(), e = BB->bbarg_end(); i != e; ++i) {
+      ExplosionSchema schema =
+        IGM.getSchema((*i)->getType()->getCanonicalType(),
+                      ExplosionKind::Minimal);
+      SmallVector<llvm::Value*, 2> phis;
+      for (auto &elt : schema)
+        phis.push_back(llvm::PHINode::Create(elt.getScalarType(), 2, "",
+                                             llvmBB));
+      setScalars(*i, phis);
+    }
+  }
+
+  // In reverse post-order every value is lowered before any of its uses.
+  for (BasicBlock *BB : blocks) {
+    IGF.Builder.SetInsertPoint(Blocks.lookup(BB));
+    for (Instruction &I : *BB) {
+      // Pop the cleanups left dead by forwarding the instruction's values,
+      // and run those a release left active.
+      FullExpr scope(IGF);
+      visit(&I);
+    }
+  }
+}
+
+/// Return the callee of a call to the given function value.
+Callee SILLowering::getCallee(Value *fn, CanType fnType, CanType resultType) {
+  // Call functions referenced by name directly.
+  if (ConstantRefInst *ref = dyn_cast<ConstantRefInst>(fn)) {
+    FuncDecl *decl = cast<FuncDecl>(ref->getDecl());
+    FunctionRef fnRef(decl, ExplosionKind::Minimal, 0);
+    llvm::Constant *fnPtr = IGM.getAddrOfFunction(fnRef, ExtraData::None);
+    return Callee::forFreestandingFunction(fnType, resultType,
+                                           ArrayRef<Substitution>(), fnPtr,
+                                           ExplosionKind::Minimal, 0);
+  }
+
+  // Otherwise, call through the function pointer, passing the data
+  // pointer if there is one.
+  ArrayRef<llvm::Value*> scalars = getScalars(fn);
+  llvm::Value *fnPtr = scalars[0];
+  llvm::Value *data = scalars[1];
+  ExtraData extraData = isa<llvm::ConstantPointerNull>(data)
+    ? ExtraData::None : ExtraData::Retainable;
+  llvm::Type *fnPtrTy = IGM.getFunctionType(fnType, ExplosionKind::Minimal, 0,
+                                            extraData)->getPointerTo();
+  fnPtr = IGF.Builder.CreateBitCast(fnPtr, fnPtrTy);
+  return Callee::forIndirectCall(fnType, resultType, ArrayRef<Substitution>(),
+                                 fnPtr, ManagedValue(data));
+}
+
+void SILLowering::visitApplyInst(ApplyInst *I) {
+  CanType fnType = I->getCallee()->getType()->getCanonicalType();
+  CanType resultType = CanType(cast<FunctionType>(fnType)->getResult());
+
+  CallEmission emission(IGF, getCallee(I->getCallee(), fnType, resultType));
+  Explosion args(ExplosionKind::Minimal);
+  for (Value *arg : I->getArguments())
+    addToExplosion(arg, args);
+  emission.addArg(args);
+
+  Explosion result(ExplosionKind::Minimal);
+  emission.emitToExplosion(result);
+  setScalars(I, result);
+
+  // The apply consumes the function value, but the callee only borrows
+  // its data pointer, so release that here.  A function referenced by name
+  // is called directly, but its value still holds the reference that
+  // emitRValueForFunction retained.
+  llvm::Value *data = getScalars(I->getCallee())[1];
+  if (!isa<llvm::ConstantPointerNull>(data))
+    IGF.emitRelease(data);
+}
+
+void SILLowering::visitTypeConversionInst(TypeConversionInst *I) {
+  Value *operand = I->getOperand();
+  ArrayRef<llvm::Value*> src = getScalars(operand);
+
+  // Converting between l-values changes the type of the address.
+  if (I->getType()->is<LValueType>()) {
+    llvm::Type *addrTy = getObjectTypeInfo(I).getStorageType()->getPointerTo();
+    setAddress(I, IGF.Builder.CreateBitCast(src[0], addrTy),
+               getOwner(operand));
+    return;
+  }
+
+  // Otherwise reinterpret each scalar, which for an l-value converted to
+  // a raw pointer is just its address.
+  ExplosionSchema schema = IGM.getSchema(I->getType()->getCanonicalType(),
+                                         ExplosionKind::Minimal);
+  SmallVector<llvm::Value*, 2> scalars;
+  auto elt = schema.begin();
+  for (llvm::Value *scalar : src.slice(0, schema.size())) {
+    scalars.push_back(IGF.Builder.CreateBitCast(scalar,
+                                                elt->getScalarType()));
+    ++elt;
+  }
+  setScalars(I, scalars);
+}
+
+void SILLowering::visitTupleElementInst(TupleElementInst *I) {
+  Value *operand = I->getOperand();
+
+  // An element of an l-value is at an offset from its address.
+  if (LValueType *lv = operand->getType()->getAs<LValueType>()) {
+    CanType tupleType = lv->getObjectType()->getCanonicalType();
+    Address elt = projectTupleElementAddress(IGF, getAddress(operand),
+                                             tupleType, I->getFieldNo());
+    llvm::Value *addr = elt.isValid()
+      ? elt.getAddress()
+      : llvm::UndefValue::get(
+                      getObjectTypeInfo(I).getStorageType()->getPointerTo());
+    setAddress(I, addr, getOwner(operand));
+    return;
+  }
+
+  // An element of an r-value is a subrange of its scalars.
+  CanType tupleType = operand->getType()->getCanonicalType();
+  std::pair<unsigned, unsigned> range =
+    getTupleElementExplosionRange(IGF, tupleType, I->getFieldNo(),
+                                  ExplosionKind::Minimal);
+  setScalars(I, getScalars(operand).slice(range.first,
+                                          range.second - range.first));
+}
+
+void SILLowering::visitBranchInst(BranchInst *I) {
+  BasicBlock *dest = I->getDestBB();
+  llvm::BasicBlock *from = IGF.Builder.GetInsertBlock();
+
+  auto destArg = dest->bbarg_begin();
+  for (Value *arg : I->getArgs()) {
+    ArrayRef<llvm::Value*> phis = getScalars(*destArg++);
+    ArrayRef<llvm::Value*> incoming = getScalars(arg);
+    assert(phis.size() == incoming.size() && "branch argument type mismatch");
+    for (unsigned i = 0, e = phis.size(); i != e; ++i)
+      cast<llvm::PHINode>(phis[i])->addIncoming(incoming[i], from);
+  }
+
+  IGF.Builder.CreateBr(Blocks.lookup(dest));
+}
+
+bool irgen::tryEmitFunctionFromSIL(IRGenModule &IGM, FuncDecl *func,
+                                   llvm::Function *entrypoint) {
+  if (!IGM.SILMod)
+    return false;
+  Function *F = IGM.SILMod->getFunction(func);
+  if (!F)
+    return false;
+
+  // Generic functions take type metadata that SIL doesn't model, and
+  // methods take 'this' at +0, which SIL doesn't model either.
+  FuncExpr *funcExpr = func->getBody();
+  CanType fnType = funcExpr->getType()->getCanonicalType();
+  if (!isa<FunctionType>(fnType) || func->getGetterOrSetterDecl() ||
+      getAbstractCC(func) != AbstractCC::Freestanding) {
+    ++NumFunctionsFromAST;
+    return false;
+  }
+
+  DominanceInfo DI(*F);
+  ArrayRef<BasicBlock*> blocks = DI.getReversePostOrder();
+  if (blocks.empty() || !canLowerFunction(IGM, blocks)) {
+    ++NumFunctionsFromAST;
+    return false;
+  }
+
+  PrettyStackTraceDecl stackTrace("emitting IR from SIL for", func);
+  IRGenFunction IGF(IGM, fnType, funcExpr->getBodyParamPatterns(),
+                    ExplosionKind::Minimal, 0, entrypoint, Prologue::Bare);
+  SILLowering(IGF).emitFunction(blocks,
+                                CanType(cast<FunctionType>(fnType)
+                                          ->getResult()));
+  ++NumFunctionsFromSIL;
+  return true;
+}
@@ -0,0 +1,42 @@
+//===--- GenSIL.h - Swift IR Generation From SIL ----------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file provides the private interface to the code that emits
+//  function bodies from SIL instead of from the AST.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_IRGEN_GENSIL_H
+#define SWIFT_IRGEN_GENSIL_H
+
+namespace llvm {
+  class Function;
+}
+
+namespace swift {
+  class FuncDecl;
+
+namespace irgen {
+  class IRGenModule;
+
+  /// Try to emit the body of the given function into the given
+  /// entrypoint from the SIL in IGM.SILMod.  Returns false, having
+  /// emitted nothing, if there is no SIL for the function or it uses
+  /// something the SIL lowering does not support; the caller should
+  /// then emit the body from the AST.
+  bool tryEmitFunctionFromSIL(IRGenModule &IGM, FuncDecl *func,
+                              llvm::Function *entrypoint);
+
+} // end namespace irgen
+} // end namespace swift
+
+#endif
@@ -125,8 +125,40 @@ void swift::irgen::emitTupleLiteral(IRGenFunction &IGF, TupleExpr *E,
    }
 
   // Emit all the sub-expressions.
-  for (Expr *elt : E->getElements())
-    IGF.emitRValue(elt, explosion);
+  auto elts = E->getElements();
+  bool hasByref = false;
+  for (Expr *elt : elts)
+    hasByref |= elt->getType()->is<LValueType>();
+  if (!hasByref) {
+    for (Expr *elt : elts)
+      IGF.emitRValue(elt, explosion);
+    return;
+  }
+
+  // An addressor hands out storage which evaluating the later elements
+  // might invalidate, so, as in emitAssign, evaluate everything else
+  // before projecting the address of a [byref] element.
+  std::vector<Explosion> values;
+  values.reserve(elts.size());
+  std::vector<std::pair<unsigned, LValue>> byrefs;
+  for (unsigned i = 0, e = elts.size(); i != e; ++i) {
+    values.emplace_back(explosion.getKind());
+    if (elts[i]->getType()->is<LValueType>())
+      byrefs.push_back(std::pair<unsigned, LValue>(i,
+                                                   IGF.emitLValue(elts[i])));
+    else
+      IGF.emitRValue(elts[i], values.back());
+  }
+
+  for (auto &byref : byrefs) {
+    LValueType *type = elts[byref.first]->getType()->castTo<LValueType>();
+    IGF.emitLValueAsScalar(std::move(byref.second),
+                           type->isHeap() ? OnHeap : NotOnHeap,
+                           values[byref.first]);
+  }
+
+  for (Explosion &value : values)
+    explosion.add(value.claimAll());
 }
 
 namespace {
@@ -215,6 +247,25 @@ swift::irgen::tryEmitTupleElementAsAddress(IRGenFunction &IGF,
   return field.projectAddress(IGF, tupleAddr.getValue());
 }
 
+Address swift::irgen::projectTupleElementAddress(IRGenFunction &IGF,
+                                                 Address tuple,
+                                                 CanType tupleType,
+                                                 unsigned fieldNo) {
+  const TupleTypeInfo &tupleTI = getAsTupleTypeInfo(IGF, tupleType);
+  const TupleFieldInfo &field = tupleTI.getFields()[fieldNo];
+  if (field.isEmpty()) return Address();
+  return field.projectAddress(IGF, tuple);
+}
+
+std::pair<unsigned, unsigned>
+swift::irgen::getTupleElementExplosionRange(IRGenFunction &IGF,
+                                            CanType tupleType,
+                                            unsigned fieldNo,
+                                            ExplosionKind kind) {
+  const TupleTypeInfo &tupleTI = getAsTupleTypeInfo(IGF, tupleType);
+  return tupleTI.getFields()[fieldNo].getProjectionRange(kind);
+}
+
 LValue swift::irgen::emitTupleElementLValue(IRGenFunction &IGF,
                                             TupleElementExpr *E) {
   assert(E->getType()->is<LValueType>());
@@ -17,7 +17,10 @@
 #ifndef SWIFT_IRGEN_GENTUPLE_H
 #define SWIFT_IRGEN_GENTUPLE_H
 
+#include <utility>
+
 namespace swift {
+  class CanType;
   class TupleElementExpr;
   class TupleExpr;
   class TuplePattern;
@@ -27,6 +30,7 @@ namespace swift {
 namespace irgen {
   class Address;
   class Explosion;
+  enum class ExplosionKind : unsigned;
   class IRGenFunction;
   class Initialization;
   class LValue;
@@ -39,6 +43,17 @@ namespace irgen {
   Optional<Address> tryEmitTupleElementAsAddress(IRGenFunction &IGF,
                                                  TupleElementExpr *E);
 
+  /// Project the address of an element of a tuple held in memory.
+  /// Returns an invalid address if the element requires no storage.
+  Address projectTupleElementAddress(IRGenFunction &IGF, Address tuple,
+                                     CanType tupleType, unsigned fieldNo);
+
+  /// Return the [begin, end) range of an element's values within an
+  /// explosion of the whole tuple.
+  std::pair<unsigned, unsigned>
+  getTupleElementExplosionRange(IRGenFunction &IGF, CanType tupleType,
+                                unsigned fieldNo, ExplosionKind kind);
+
   /// Emit an element projection l-value.
   LValue emitTupleElementLValue(IRGenFunction &IGF, TupleElementExpr *E);
 
@@ -44,6 +44,112 @@ ExplosionSchema TypeInfo::getSchema(ExplosionKind kind) const {
   return schema;
 }
 
+/// Emit a loop which runs the given body once for each index in
+/// [0, count).  The indices are visited in increasing order unless
+/// 'backwards' is set.
+template <class BodyFn>
+static void emitArrayLoop(IRGenFunction &IGF, llvm::Value *count,
+                          bool backwards, BodyFn body) {
+  llvm::BasicBlock *bodyBB = IGF.createBasicBlock("array-loop");
+  llvm::BasicBlock *endBB = IGF.createBasicBlock("array-end");
+
+  // Skip the loop entirely for an empty array.
+  llvm::Value *zero = llvm::ConstantInt::get(IGF.IGM.SizeTy, 0);
+  llvm::Value *isEmpty = IGF.Builder.CreateICmpEQ(count, zero, "empty");
+  llvm::BasicBlock *entryBB = IGF.Builder.GetInsertBlock();
+  IGF.Builder.CreateCondBr(isEmpty, endBB, bodyBB);
+
+  IGF.Builder.emitBlock(bodyBB);
+  llvm::PHINode *iteration = IGF.Builder.CreatePHI(IGF.IGM.SizeTy, 2, "i");
+  iteration->addIncoming(zero, entryBB);
+  llvm::Value *next = IGF.Builder.CreateAdd(iteration,
+                               llvm::ConstantInt::get(IGF.IGM.SizeTy, 1));
+  llvm::Value *index = iteration;
+  if (backwards)
+    index = IGF.Builder.CreateSub(count, next);
+
+  body(index);
+
+  iteration->addIncoming(next, IGF.Builder.GetInsertBlock());
+  llvm::Value *done = IGF.Builder.CreateICmpEQ(next, count, "done");
+  IGF.Builder.CreateCondBr(done, endBB, bodyBB);
+
+  IGF.Builder.emitBlock(endBB);
+}
+
+/// Return the address of the element with the given index in an array
+/// of objects of the given type.
+static Address emitArrayElementAddress(IRGenFunction &IGF,
+                                       const TypeInfo &type,
+                                       Address array, llvm::Value *index) {
+  llvm::Value *addr = array.getAddress();
+  if (type.StorageType->isSized()) {
+    addr = IGF.Builder.CreateInBoundsGEP(addr, index);
+  } else {
+    llvm::Value *offset = IGF.Builder.CreateMul(index, type.getStride(IGF));
+    llvm::Type *addrTy = addr->getType();
+    addr = IGF.Builder.CreateBitCast(addr, IGF.IGM.Int8PtrTy);
+    addr = IGF.Builder.CreateInBoundsGEP(addr, offset);
+    addr = IGF.Builder.CreateBitCast(addr, addrTy);
+  }
+  return Address(addr, type.StorageAlignment);
+}
+
+/// Emit a memcpy or memmove of an entire array of objects of the given
+/// type.
+static void emitArrayBitwiseCopy(IRGenFunction &IGF, const TypeInfo &type,
+                                 Address dest, Address src,
+                                 llvm::Value *count, bool mayOverlap) {
+  llvm::Value *size = IGF.Builder.CreateMul(count, type.getStride(IGF));
+  unsigned align = type.StorageAlignment.getValue();
+  if (mayOverlap)
+    IGF.Builder.CreateMemMove(dest.getAddress(), src.getAddress(), size, align);
+  else
+    IGF.Builder.CreateMemCpy(dest.getAddress(), src.getAddress(), size, align);
+}
+
+void TypeInfo::destroyArray(IRGenFunction &IGF, Address array,
+                            llvm::Value *count) const {
+  if (isPOD(ResilienceScope::Local))
+    return;
+
+  emitArrayLoop(IGF, count, /*backwards*/ false, [&](llvm::Value *index) {
+    destroy(IGF, emitArrayElementAddress(IGF, *this, array, index));
+  });
+}
+
+void TypeInfo::initializeArrayWithCopy(IRGenFunction &IGF, Address destArray,
+                                       Address srcArray,
+                                       llvm::Value *count) const {
+  if (isPOD(ResilienceScope::Local))
+    return emitArrayBitwiseCopy(IGF, *this, destArray, srcArray, count,
+                                /*mayOverlap*/ false);
+
+  emitArrayLoop(IGF, count, /*backwards*/ false, [&](llvm::Value *index) {
+    initializeWithCopy(IGF,
+                       emitArrayElementAddress(IGF, *this, destArray, index),
+                       emitArrayElementAddress(IGF, *this, srcArray, index));
+  });
+}
+
+/// Every type we lay out can be taken with a memcpy, so a take of a
+/// whole array, in either direction, is just a memmove.
+void TypeInfo::initializeArrayWithTakeFrontToBack(IRGenFunction &IGF,
+                                                  Address destArray,
+                                                  Address srcArray,
+                                                  llvm::Value *count) const {
+  emitArrayBitwiseCopy(IGF, *this, destArray, srcArray, count,
+                       /*mayOverlap*/ true);
+}
+
+void TypeInfo::initializeArrayWithTakeBackToFront(IRGenFunction &IGF,
+                                                  Address destArray,
+                                                  Address srcArray,
+                                                  llvm::Value *count) const {
+  emitArrayBitwiseCopy(IGF, *this, destArray, srcArray, count,
+                       /*mayOverlap*/ true);
+}
+
 /// Copy a value from one object to a new object, directly taking
 /// responsibility for anything it might have.  This is like C++
 /// move-initialization, except the old object will not be destroyed.
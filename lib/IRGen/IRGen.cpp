@@ -64,8 +64,15 @@ static void addSwiftExpandPass(const PassManagerBuilder &Builder,
     PM.add(createSwiftARCExpandPass());
 }
 
+static void addSwiftClosureSpecializePass(const PassManagerBuilder &Builder,
+                                          PassManagerBase &PM) {
+  if (Builder.OptLevel > 0)
+    PM.add(createSwiftClosureSpecializePass());
+}
+
 void swift::performIRGeneration(Options &Opts, llvm::Module *Module,
-                                TranslationUnit *TU, unsigned StartElem) {
+                                TranslationUnit *TU, unsigned StartElem,
+                                SILModule *SILMod) {
   assert(!TU->Ctx.hadError());
 
   std::unique_ptr<LLVMContext> Context;
@@ -116,7 +123,8 @@ void swift::performIRGeneration(Options &Opts, llvm::Module *Module,
   Module->setDataLayout(DataLayout->getStringRepresentation());
 
   // Emit the translation unit.
-  IRGenModule IRM(TU->Ctx, Opts, *Module, *DataLayout);
+  IRGenModule IRM(TU->Ctx, Opts, *Module, *DataLayout,
+                  Opts.EmitFromSIL ? SILMod : nullptr);
   IRM.emitTranslationUnit(TU, StartElem);
 
   // Bail out if there are any errors.
@@ -208,6 +216,11 @@ void swift::performIRGeneration(Options &Opts, llvm::Module *Module,
                          addSwiftARCOptPass);
   PMBuilder.addExtension(PassManagerBuilder::EP_OptimizerLast,
                          addSwiftExpandPass);
+
+  // Specialize higher-order functions for the closures passed to them
+  // before the inliner runs, so that it can see through the calls.
+  PMBuilder.addExtension(PassManagerBuilder::EP_ModuleOptimizerEarly,
+                         addSwiftClosureSpecializePass);
   
   // Configure the function passes.
   FunctionPassManager FunctionPasses(Module);
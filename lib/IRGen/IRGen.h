@@ -44,6 +44,8 @@ enum class ExtraData : unsigned char {
   None,
 
   /// The function requires a retainable object pointer of extra data.
+  /// The extra data is always guaranteed: the caller keeps it alive for
+  /// the duration of the call, and the callee does not release it.
   Retainable,
 
   /// The function requires a metatype object as extra data.
@@ -29,11 +29,12 @@ using namespace irgen;
 IRGenFunction::IRGenFunction(IRGenModule &IGM, CanType t, ArrayRef<Pattern*> p,
                              ExplosionKind explosionLevel,
                              unsigned uncurryLevel, llvm::Function *Fn,
-                             Prologue prologue)
+                             Prologue prologue, AbstractCC convention)
   : IGM(IGM), Builder(IGM.getLLVMContext()), CurFuncType(t),
     CurFuncParamPatterns(p), CurFn(Fn),
     CurExplosionLevel(explosionLevel), CurUncurryLevel(uncurryLevel),
-    CurPrologue(prologue), ContextPtr(nullptr),
+    CurPrologue(prologue), CurConvention(convention), ContextPtr(nullptr),
+    CanProjectAddressors(true),
     UnreachableBB(nullptr), JumpDestSlot(nullptr),
     InnermostScope(Cleanups.stable_end()) {
   emitPrologue();
@@ -22,6 +22,7 @@
 #include "swift/AST/Type.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/CallingConv.h"
+#include "CallingConvention.h"
 #include "IRBuilder.h"
 #include "JumpDest.h"
 
@@ -134,12 +135,20 @@ public:
   ExplosionKind CurExplosionLevel;
   unsigned CurUncurryLevel;
   Prologue CurPrologue;
+  AbstractCC CurConvention;
   llvm::Value *ContextPtr;
 
+  /// Whether a [byref] l-value may be materialized by projecting its
+  /// address through an addressor.  This is off while later argument
+  /// clauses of a curried call remain to be evaluated, since they could
+  /// invalidate the address before the call uses it.
+  bool CanProjectAddressors;
+
   IRGenFunction(IRGenModule &IGM, CanType t, ArrayRef<Pattern*> p,
                 ExplosionKind explosion,
                 unsigned uncurryLevel, llvm::Function *fn,
-                Prologue prologue = Prologue::Standard);
+                Prologue prologue = Prologue::Standard,
+                AbstractCC convention = AbstractCC::Freestanding);
   ~IRGenFunction();
 
   void unimplemented(SourceLoc Loc, StringRef Message);
@@ -342,7 +351,8 @@ public:
   void emitAssign(Explosion &explosion, const LValue &lvalue,
                   const TypeInfo &type);
 
-  OwnedAddress getAddrForParameter(VarDecl *param, Explosion &paramValues);
+  OwnedAddress getAddrForParameter(VarDecl *param, Explosion &paramValues,
+                                   ParameterConvention convention);
 
   void emitNullaryCall(llvm::Value *fn, CanType resultType, Explosion &result);
 
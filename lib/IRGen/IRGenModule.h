@@ -53,6 +53,7 @@ namespace swift {
   class OneOfDecl;
   class ProtocolCompositionType;
   class ProtocolDecl;
+  class SILModule;
   class SourceLoc;
   class StructDecl;
   class TranslationUnit;
@@ -86,6 +87,10 @@ public:
   llvm::LLVMContext &LLVMContext;
   const llvm::DataLayout &DataLayout;
 
+  /// The SIL for the translation unit, if function bodies should be
+  /// lowered from SIL where possible rather than from the AST.
+  SILModule *SILMod;
+
   llvm::Type *VoidTy;                  /// void (usually {})
   llvm::IntegerType *Int1Ty;           /// i1
   llvm::IntegerType *Int8Ty;           /// i8
@@ -133,7 +138,7 @@ private:
   Size PtrSize;
   llvm::Type *FixedBufferTy;           /// [N x i8], where N == 3 * sizeof(void*)
 
-  enum { NumValueWitnessFunctions = 12 };
+  enum { NumValueWitnessFunctions = 16 };
   llvm::PointerType *ValueWitnessTys[NumValueWitnessFunctions]; /// pointer-to-functions
 
 //--- Types -----------------------------------------------------------------
@@ -221,7 +226,8 @@ private:
 //--- Generic ---------------------------------------------------------------
 public:
   IRGenModule(ASTContext &Context, Options &Opts, llvm::Module &Module,
-              const llvm::DataLayout &DataLayout);
+              const llvm::DataLayout &DataLayout,
+              SILModule *SILMod = nullptr);
   ~IRGenModule();
 
   llvm::LLVMContext &getLLVMContext() const { return LLVMContext; }
@@ -241,9 +247,12 @@ public:
   llvm::FunctionType *getFunctionType(CanType fnType, ExplosionKind kind,
                                       unsigned uncurryLevel,
                                       ExtraData data);
+  bool differsByExplosion(CanType fnType, unsigned uncurryLevel,
+                          ExtraData data);
 
   FormalType getTypeOfGetter(ValueDecl *D);
   FormalType getTypeOfSetter(ValueDecl *D);
+  FormalType getTypeOfAddressor(ValueDecl *D);
 
   Address getAddrOfGlobalVariable(VarDecl *D);
   llvm::Function *getAddrOfFunction(FunctionRef ref, ExtraData data);
@@ -254,6 +263,9 @@ public:
   llvm::Function *getAddrOfSetter(ValueDecl *D, FormalType type,
                                   ExplosionKind kind);
   llvm::Function *getAddrOfSetter(ValueDecl *D, ExplosionKind kind);
+  llvm::Function *getAddrOfAddressor(ValueDecl *D, FormalType type,
+                                     ExplosionKind kind);
+  llvm::Function *getAddrOfAddressor(ValueDecl *D, ExplosionKind kind);
   Address getAddrOfWitnessTableOffset(CodeRef code);
   Address getAddrOfWitnessTableOffset(VarDecl *field);
   llvm::Function *getAddrOfValueWitness(CanType concreteType,
@@ -265,6 +277,8 @@ public:
   llvm::Constant *getAddrOfTypeMetadata(CanType concreteType,
                                         bool isIndirect, bool isPattern,
                                         llvm::Type *definitionType = nullptr);
+  llvm::Function *getAddrOfTypeMetadataAccessFunction(CanType concreteType);
+  llvm::Constant *getAddrOfTypeMetadataLazyCacheVariable(CanType concreteType);
 };
 
 } // end namespace irgen
@@ -20,6 +20,7 @@
 #include "Address.h"
 #include "IRGen.h"
 #include "swift/Basic/DiverseList.h"
+#include "llvm/Support/ErrorHandling.h"
 
 namespace llvm {
   template <class T> class SmallVectorImpl;
@@ -159,6 +160,18 @@ public:
   virtual OwnedAddress loadAndMaterialize(IRGenFunction &IGF,
                                           OnHeap_t onHeap, Address base,
                                     ShouldPreserveValues preserve) const = 0;
+
+  /// Can the storage for this path be accessed in place by calling
+  /// projectAddress, instead of being copied out and back in?
+  virtual bool isAddressable() const { return false; }
+
+  /// Compute the address of the storage for this path.  This is only
+  /// valid if isAddressable() is true.  The result is only good until
+  /// the next operation which might change the base.
+  virtual OwnedAddress projectAddress(IRGenFunction &IGF, Address base,
+                                      ShouldPreserveValues preserve) const {
+    llvm_unreachable("path component is not addressable");
+  }
 };
 
 inline LogicalPathComponent &PathComponent::asLogical() {
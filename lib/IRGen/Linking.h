@@ -82,6 +82,10 @@ class LinkEntity {
     /// The pointer is a VarDecl* or SubscriptDecl*.
     Setter,
 
+    /// The addressor for an entity.
+    /// The pointer is a VarDecl* or SubscriptDecl*.
+    Addressor,
+
     /// The destructor for a class.
     /// The pointer is a ClassDecl*.
     Destructor,
@@ -107,7 +111,17 @@ class LinkEntity {
 
     /// The metadata or metadata template for a class.
     /// The pointer is a canonical TypeBase*.
-    TypeMetadata
+    TypeMetadata,
+
+    /// A function which returns the metadata for a concrete type,
+    /// instantiating it the first time it is called.
+    /// The pointer is a canonical TypeBase*.
+    TypeMetadataAccessFunction,
+
+    /// The variable in which a type metadata access function caches
+    /// the metadata it returns.
+    /// The pointer is a canonical TypeBase*.
+    TypeMetadataLazyCacheVariable
   };
   friend struct llvm::DenseMapInfo<LinkEntity>;
 
@@ -146,6 +160,7 @@ class LinkEntity {
     case FunctionRef::Kind::Function: return Kind::Function;
     case FunctionRef::Kind::Getter: return Kind::Getter;
     case FunctionRef::Kind::Setter: return Kind::Setter;
+    case FunctionRef::Kind::Addressor: return Kind::Addressor;
     }
     llvm_unreachable("bad FunctionRef kind");
   }
@@ -194,6 +209,22 @@ public:
     return entity;
   }
 
+  static LinkEntity forTypeMetadataAccessFunction(CanType concreteType) {
+    LinkEntity entity;
+    entity.Pointer = concreteType.getPointer();
+    entity.Data = LINKENTITY_SET_FIELD(Kind,
+                                   unsigned(Kind::TypeMetadataAccessFunction));
+    return entity;
+  }
+
+  static LinkEntity forTypeMetadataLazyCacheVariable(CanType concreteType) {
+    LinkEntity entity;
+    entity.Pointer = concreteType.getPointer();
+    entity.Data = LINKENTITY_SET_FIELD(Kind,
+                                unsigned(Kind::TypeMetadataLazyCacheVariable));
+    return entity;
+  }
+
   static LinkEntity forValueWitness(CanType concreteType, ValueWitness witness) {
     LinkEntity entity;
     entity.Pointer = concreteType.getPointer();
@@ -225,6 +256,13 @@ public:
   }
 
   bool isValueWitness() const { return getKind() == Kind::ValueWitness; }
+
+  /// Is this a type metadata access function or its cache variable?
+  /// These are emitted in every module that uses them.
+  bool isTypeMetadataAccess() const {
+    return getKind() == Kind::TypeMetadataAccessFunction ||
+           getKind() == Kind::TypeMetadataLazyCacheVariable;
+  }
   CanType getType() const {
     assert(isTypeKind(getKind()));
     return CanType(reinterpret_cast<TypeBase*>(Pointer));
@@ -236,8 +236,7 @@ void Mangler::mangleDeclContext(DeclContext *ctx) {
 
 void Mangler::mangleGetterOrSetterContext(FuncDecl *func) {
   assert(func->isGetterOrSetter());
-  Decl *D = func->getGetterDecl();
-  if (!D) D = func->getSetterDecl();
+  Decl *D = func->getGetterOrSetterDecl();
   assert(D && "no value type for getter/setter!");
   assert(isa<VarDecl>(D) || isa<SubscriptDecl>(D));
 
@@ -250,8 +249,10 @@ void Mangler::mangleGetterOrSetterContext(FuncDecl *func) {
 
   if (func->getGetterDecl()) {
     Buffer << 'g';
-  } else {
+  } else if (func->getSetterDecl()) {
     Buffer << 's';
+  } else {
+    Buffer << 'a';
   }
 }
 
@@ -652,10 +653,15 @@ static StringRef mangleValueWitness(ValueWitness witness) {
   case ValueWitness::InitializeBufferWithTake: return "Tk";
   case ValueWitness::InitializeWithTake: return "tk";
   case ValueWitness::ProjectBuffer: return "pr";
+  case ValueWitness::DestroyArray: return "Xx";
+  case ValueWitness::InitializeArrayWithCopy: return "Cc";
+  case ValueWitness::InitializeArrayWithTakeFrontToBack: return "Tt";
+  case ValueWitness::InitializeArrayWithTakeBackToFront: return "tT";
 
   case ValueWitness::Size:
   case ValueWitness::Alignment:
   case ValueWitness::Stride:
+  case ValueWitness::Flags:
     llvm_unreachable("not a function witness");
   }
   llvm_unreachable("bad witness kind");
@@ -714,6 +720,18 @@ void LinkEntity::mangle(raw_ostream &buffer) const {
     return;
   }
 
+  //   global ::= 'Ma' type               // type metadata access function
+  case Kind::TypeMetadataAccessFunction:
+    buffer << "Ma";
+    mangler.mangleType(getType(), ExplosionKind::Minimal, 0);
+    return;
+
+  //   global ::= 'ML' type               // type metadata lazy cache variable
+  case Kind::TypeMetadataLazyCacheVariable:
+    buffer << "ML";
+    mangler.mangleType(getType(), ExplosionKind::Minimal, 0);
+    return;
+
   //   global ::= 'Wo' entity
   case Kind::WitnessTableOffset:
     buffer << "Wo";
@@ -753,6 +771,13 @@ void LinkEntity::mangle(raw_ostream &buffer) const {
     mangler.mangleEntity(getDecl(), getExplosionKind(), getUncurryLevel());
     buffer << 's';
     return;
+
+  //   entity ::= declaration 'a'                 // addressor
+  case Kind::Addressor:
+    if (isLocalLinkage()) buffer << 'L';
+    mangler.mangleEntity(getDecl(), getExplosionKind(), getUncurryLevel());
+    buffer << 'a';
+    return;
   }
   llvm_unreachable("bad entity kind!");
 }
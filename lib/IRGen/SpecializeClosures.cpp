@@ -0,0 +1,303 @@
+//===--- SpecializeClosures.cpp - Specialize Callees for Known Closures ---===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements closure specialization.  A function value is passed
+// as a function pointer and a context object, and a higher-order function
+// like Vector.each or sort calls it indirectly, which the inliner can't see
+// through.  When a call site passes a known function as the function
+// pointer, and the callee's body is available, we clone the callee with
+// that parameter replaced by the function itself.  The indirect calls in
+// the clone become direct calls which still take the captures through the
+// context argument, and the inliner can then inline the closure body into
+// the clone, and the clone into its caller.  Once that has happened the
+// context object is often only stored to and released, and the ARC
+// optimizer deletes it.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "swift-closure-specialize"
+#include "swift/Subsystems.h"
+#include "llvm/Constants.h"
+#include "llvm/DerivedTypes.h"
+#include "llvm/Instructions.h"
+#include "llvm/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumCallsSpecialized,
+          "Number of calls rewritten to use a closure specialization");
+STATISTIC(NumSpecializations,
+          "Number of closure specializations created");
+
+/// The largest callee, in instructions, that we are willing to clone.
+static const unsigned MaxCalleeSize = 500;
+
+/// The most specializations we create of any single callee.
+static const unsigned MaxSpecializationsPerCallee = 8;
+
+/// isCalledThrough - Return true if the value, or a pointer cast of it, is
+/// used as the callee of a call.
+static bool isCalledThrough(Value *V) {
+  for (auto UI = V->use_begin(), E = V->use_end(); UI != E; ++UI) {
+    User *U = *UI;
+    if (CallInst *CI = dyn_cast<CallInst>(U)) {
+      if (CI->getCalledValue() == V)
+        return true;
+      continue;
+    }
+    if (isa<BitCastInst>(U) && isCalledThrough(U))
+      return true;
+  }
+  return false;
+}
+
+/// getFunctionSize - Return the number of instructions in the function.
+static unsigned getFunctionSize(Function &F) {
+  unsigned Size = 0;
+  for (BasicBlock &BB : F)
+    Size += BB.size();
+  return Size;
+}
+
+/// foldConstantCasts - Fold every bitcast of a constant in the function,
+/// so that calls through the closure's function pointer become direct calls
+/// to the closure.
+static void foldConstantCasts(Function &F) {
+  bool Changed;
+  do {
+    Changed = false;
+    for (BasicBlock &BB : F) {
+      for (auto II = BB.begin(), IE = BB.end(); II != IE; ) {
+        BitCastInst *BCI = dyn_cast<BitCastInst>(&*II++);
+        if (!BCI)
+          continue;
+        Constant *Op = dyn_cast<Constant>(BCI->getOperand(0));
+        if (!Op)
+          continue;
+        BCI->replaceAllUsesWith(ConstantExpr::getBitCast(Op, BCI->getType()));
+        BCI->eraseFromParent();
+        Changed = true;
+      }
+    }
+  } while (Changed);
+}
+
+/// canSpecialize - Return true if we may clone the given callee.
+static bool canSpecialize(Function *F) {
+  // We need a body, and it must be the one that will be used at runtime.
+  // An available_externally body is fine: that's what the inliner would
+  // use too.
+  if (F->isDeclaration() || F->mayBeOverridden() || F->isVarArg())
+    return false;
+
+  return getFunctionSize(*F) <= MaxCalleeSize;
+}
+
+/// findClosureArgument - Find an argument of the call which is a known
+/// function that the callee calls through.  Returns the index of the
+/// argument, or ~0U if there is none.
+static unsigned findClosureArgument(CallInst *CI, Function *Callee) {
+  unsigned Index = 0;
+  for (auto AI = Callee->arg_begin(), AE = Callee->arg_end(); AI != AE;
+       ++AI, ++Index) {
+    Function *Closure =
+      dyn_cast<Function>(CI->getArgOperand(Index)->stripPointerCasts());
+    if (!Closure || Closure->isDeclaration())
+      continue;
+    if (isCalledThrough(&*AI))
+      return Index;
+  }
+  return ~0U;
+}
+
+namespace {
+  /// A callee, the index of one of its parameters, and the function known
+  /// to be passed for that parameter.
+  typedef std::pair<Function *, std::pair<unsigned, Function *>>
+    SpecializationKey;
+
+  class ClosureSpecializer {
+    Module &M;
+    DenseMap<SpecializationKey, Function *> Specializations;
+    DenseMap<Function *, unsigned> NumSpecializationsOf;
+    SmallVector<CallInst *, 32> Worklist;
+
+  public:
+    ClosureSpecializer(Module &M) : M(M) {}
+
+    bool run();
+
+  private:
+    void addCallsIn(Function &F);
+    bool trySpecialize(CallInst *CI);
+    Function *getSpecialization(Function *Callee, unsigned Index,
+                                Constant *Closure);
+  };
+}
+
+/// addCallsIn - Add every direct call in the function to the worklist.
+void ClosureSpecializer::addCallsIn(Function &F) {
+  for (BasicBlock &BB : F)
+    for (Instruction &I : BB)
+      if (CallInst *CI = dyn_cast<CallInst>(&I))
+        if (CI->getCalledFunction())
+          Worklist.push_back(CI);
+}
+
+bool ClosureSpecializer::run() {
+  for (Function &F : M)
+    if (!F.isDeclaration())
+      addCallsIn(F);
+
+  bool Changed = false;
+  while (!Worklist.empty()) {
+    CallInst *CI = Worklist.pop_back_val();
+    Changed |= trySpecialize(CI);
+  }
+  return Changed;
+}
+
+/// getSpecialization - Return a clone of the callee with the given
+/// parameter replaced by the given closure function, creating it if
+/// necessary.  Returns null if we've made too many clones of the callee.
+Function *ClosureSpecializer::getSpecialization(Function *Callee,
+                                                unsigned Index,
+                                                Constant *Closure) {
+  Function *ClosureFn = cast<Function>(Closure->stripPointerCasts());
+  SpecializationKey Key(Callee, std::make_pair(Index, ClosureFn));
+  Function *&Entry = Specializations[Key];
+  if (Entry)
+    return Entry;
+
+  unsigned &NumClones = NumSpecializationsOf[Callee];
+  if (NumClones == MaxSpecializationsPerCallee)
+    return nullptr;
+  ++NumClones;
+
+  // The clone takes every parameter but the closure.
+  FunctionType *FTy = Callee->getFunctionType();
+  SmallVector<Type *, 8> ParamTys;
+  for (unsigned I = 0, E = FTy->getNumParams(); I != E; ++I)
+    if (I != Index)
+      ParamTys.push_back(FTy->getParamType(I));
+  FunctionType *NewFTy =
+    FunctionType::get(FTy->getReturnType(), ParamTys, /*isVarArg*/ false);
+
+  Function *NewF = Function::Create(NewFTy, GlobalValue::InternalLinkage,
+                              Callee->getName() + ".closure." +
+                                ClosureFn->getName(),
+                              &M);
+  NewF->setCallingConv(Callee->getCallingConv());
+
+  // Map the closure parameter to the closure and the rest to the clone's
+  // parameters.
+  ValueToValueMapTy VMap;
+  Function::arg_iterator NewAI = NewF->arg_begin();
+  unsigned I = 0;
+  for (auto AI = Callee->arg_begin(), AE = Callee->arg_end(); AI != AE;
+       ++AI, ++I) {
+    if (I == Index) {
+      VMap[&*AI] = Closure;
+      continue;
+    }
+    NewAI->setName(AI->getName());
+    VMap[&*AI] = &*NewAI++;
+  }
+
+  SmallVector<ReturnInst *, 8> Returns;
+  CloneFunctionInto(NewF, Callee, VMap, /*ModuleLevelChanges*/ false,
+                    Returns);
+  foldConstantCasts(*NewF);
+
+  DEBUG(dbgs() << "Specialized " << Callee->getName() << " for "
+               << ClosureFn->getName() << "\n");
+  ++NumSpecializations;
+
+  // The clone may pass the closure along to other higher-order functions.
+  addCallsIn(*NewF);
+
+  Entry = NewF;
+  return NewF;
+}
+
+/// trySpecialize - If the call passes a known closure to a callee that
+/// calls it, redirect it to a specialization of the callee.
+bool ClosureSpecializer::trySpecialize(CallInst *CI) {
+  Function *Callee = CI->getCalledFunction();
+  if (!Callee || !canSpecialize(Callee))
+    return false;
+
+  unsigned Index = findClosureArgument(CI, Callee);
+  if (Index == ~0U)
+    return false;
+
+  Constant *Closure = cast<Constant>(CI->getArgOperand(Index));
+  Function *NewF = getSpecialization(Callee, Index, Closure);
+  if (!NewF)
+    return false;
+
+  SmallVector<Value *, 8> Args;
+  for (unsigned I = 0, E = CI->getNumArgOperands(); I != E; ++I)
+    if (I != Index)
+      Args.push_back(CI->getArgOperand(I));
+
+  CallInst *NewCI = CallInst::Create(NewF, Args, "", CI);
+  NewCI->setCallingConv(CI->getCallingConv());
+  NewCI->setAttributes(NewF->getAttributes());
+  NewCI->setTailCall(CI->isTailCall());
+  NewCI->setDebugLoc(CI->getDebugLoc());
+  NewCI->takeName(CI);
+  CI->replaceAllUsesWith(NewCI);
+  CI->eraseFromParent();
+  ++NumCallsSpecialized;
+
+  // The call may pass more than one closure.
+  Worklist.push_back(NewCI);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+//                        SwiftClosureSpecialize Pass
+//===----------------------------------------------------------------------===//
+
+namespace llvm {
+  void initializeSwiftClosureSpecializePass(PassRegistry&);
+}
+
+namespace {
+  class SwiftClosureSpecialize : public ModulePass {
+    virtual bool runOnModule(Module &M) {
+      return ClosureSpecializer(M).run();
+    }
+
+  public:
+    static char ID;
+    SwiftClosureSpecialize() : ModulePass(ID) {
+      initializeSwiftClosureSpecializePass(*PassRegistry::getPassRegistry());
+    }
+  };
+}
+
+char SwiftClosureSpecialize::ID = 0;
+INITIALIZE_PASS(SwiftClosureSpecialize,
+                "swift-closure-specialize", "Swift closure specialization",
+                false, false)
+
+llvm::ModulePass *swift::createSwiftClosureSpecializePass() {
+  return new SwiftClosureSpecialize();
+}
@@ -14,6 +14,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/DataLayout.h"
 #include "llvm/DerivedTypes.h"
@@ -60,6 +61,26 @@ void irgen::addHeapHeaderToLayout(IRGenModule &IGM,
   fields.push_back(IGM.RefCountedStructTy);
 }
 
+/// Decide the order in which to allocate storage for the given
+/// fields.  The universal strategy has to use declaration order.  The
+/// optimal strategy places fields in order of decreasing alignment,
+/// which, since sizes are multiples of alignments, leaves no padding
+/// between fields and packs small fields together at the end;  ties
+/// keep declaration order.
+static void computeFieldOrder(LayoutStrategy strategy,
+                              llvm::ArrayRef<const TypeInfo *> types,
+                              SmallVectorImpl<unsigned> &order) {
+  for (unsigned i = 0, e = types.size(); i != e; ++i)
+    order.push_back(i);
+  if (strategy != LayoutStrategy::Optimal)
+    return;
+
+  std::stable_sort(order.begin(), order.end(),
+                   [&](unsigned lhs, unsigned rhs) {
+    return types[lhs]->StorageAlignment > types[rhs]->StorageAlignment;
+  });
+}
+
 /// Perform structure layout on the given types.
 StructLayout::StructLayout(IRGenModule &IGM, LayoutKind layoutKind,
                            LayoutStrategy strategy,
@@ -67,9 +88,6 @@ StructLayout::StructLayout(IRGenModule &IGM, LayoutKind layoutKind,
                            llvm::StructType *typeToFill) {
   assert(typeToFill == nullptr || typeToFill->isOpaque());
 
-  // For now, we actually only have one algorithm, and it's not
-  // exactly optimal.
-
   Size storageSize(0);
   Alignment storageAlign(1);
   llvm::SmallVector<llvm::Type*, 8> storageTypes;
@@ -83,12 +101,20 @@ StructLayout::StructLayout(IRGenModule &IGM, LayoutKind layoutKind,
   
   ResilienceScope resilience = getResilienceScopeForStrategy(strategy);
 
+  // The elements stay parallel to the fields, whatever order we
+  // allocate their storage in.
+  SmallVector<unsigned, 8> order;
+  computeFieldOrder(strategy, types, order);
+  Elements.resize(types.size());
+
   bool isEmpty = true;
-  for (const TypeInfo *type : types) {
+  for (unsigned index : order) {
+    const TypeInfo *type = types[index];
+
     // Skip types known to be empty.
     if (type->isEmpty(resilience)) {
       ElementLayout element = { Size(0), (unsigned) -1, type };
-      Elements.push_back(element);
+      Elements[index] = element;
       continue;
     }
 
@@ -120,7 +146,7 @@ StructLayout::StructLayout(IRGenModule &IGM, LayoutKind layoutKind,
 
     ElementLayout element =
       { storageSize, (unsigned) storageTypes.size(), type };
-    Elements.push_back(element);
+    Elements[index] = element;
 
     storageTypes.push_back(type->getStorageType());
     storageSize += type->StorageSize;
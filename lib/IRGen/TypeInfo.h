@@ -25,6 +25,7 @@ namespace llvm {
   class Constant;
   class Twine;
   class Type;
+  class Value;
 }
 
 namespace swift {
@@ -204,6 +205,34 @@ public:
   /// Destroy an object of this type in memory.
   virtual void destroy(IRGenFunction &IGF, Address address) const = 0;
 
+  /// Destroy an array of objects of this type in memory.  The default
+  /// implementation does nothing for POD types and otherwise destroys
+  /// each element in turn.
+  virtual void destroyArray(IRGenFunction &IGF, Address array,
+                            llvm::Value *count) const;
+
+  /// Perform a copy-initialization of an array of objects from another,
+  /// non-overlapping array.
+  virtual void initializeArrayWithCopy(IRGenFunction &IGF, Address destArray,
+                                       Address srcArray,
+                                       llvm::Value *count) const;
+
+  /// Perform a take-initialization of an array of objects from another,
+  /// moving elements from first to last.  The arrays may overlap as long
+  /// as the destination starts below the source.
+  virtual void initializeArrayWithTakeFrontToBack(IRGenFunction &IGF,
+                                                  Address destArray,
+                                                  Address srcArray,
+                                                  llvm::Value *count) const;
+
+  /// Perform a take-initialization of an array of objects from another,
+  /// moving elements from last to first.  The arrays may overlap as long
+  /// as the destination starts above the source.
+  virtual void initializeArrayWithTakeBackToFront(IRGenFunction &IGF,
+                                                  Address destArray,
+                                                  Address srcArray,
+                                                  llvm::Value *count) const;
+
   /// Should optimizations be enabled which rely on the representation
   /// for this type being a single retainable object pointer?
   ///
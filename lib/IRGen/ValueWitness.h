@@ -61,8 +61,13 @@ namespace irgen {
 /// memcpy of the buffer (-1), and take-assigning a buffer from a
 /// buffer is just a destroy and a memcpy (-1).
 ///
-/// This leaves us with 12 data operations, to which we add the
-/// meta-operation 'sizeAndAlign' for a total of 13.
+/// This leaves us with 12 data operations.  Generic code that works
+/// with contiguous arrays of values (such as Vector) also gets bulk
+/// versions of destroy, initWithCopy and initWithTake which act on N
+/// elements at once, for a total of 16, to which we add the
+/// meta-operations 'size', 'alignment' and 'stride'.  A final 'flags'
+/// field records properties (such as being POD) that let callers skip
+/// the data operations entirely.
 enum class ValueWitness : unsigned {
   // destroyBuffer comes first because I expect it to be the most
   // common operation (both by code size and occurrence), since it's
@@ -153,6 +158,39 @@ enum class ValueWitness : unsigned {
   /// that object.
   AllocateBuffer,
 
+  ///   void (*destroyArray)(T *array, size_t n, M *self);
+  ///
+  /// Given a valid array of n objects of this type, destroy them,
+  /// leaving the array invalid.
+  DestroyArray,
+
+  ///   T *(*initializeArrayWithCopy)(T *dest, T *src, size_t n, M *self);
+  ///
+  /// Given an invalid array of n objects of this type, initialize
+  /// them as copies of the objects in the source array.  The arrays
+  /// must not overlap.  Returns the dest array.
+  InitializeArrayWithCopy,
+
+  ///   T *(*initializeArrayWithTakeFrontToBack)(T *dest, T *src, size_t n,
+  ///                                            M *self);
+  ///
+  /// Given an invalid array of n objects of this type, initialize
+  /// them by taking the values of the objects in the source array,
+  /// first to last.  The source objects become invalid.  This is
+  /// safe if the arrays overlap and dest is below src.  Returns the
+  /// dest array.
+  InitializeArrayWithTakeFrontToBack,
+
+  ///   T *(*initializeArrayWithTakeBackToFront)(T *dest, T *src, size_t n,
+  ///                                            M *self);
+  ///
+  /// Given an invalid array of n objects of this type, initialize
+  /// them by taking the values of the objects in the source array,
+  /// last to first.  The source objects become invalid.  This is
+  /// safe if the arrays overlap and dest is above src.  Returns the
+  /// dest array.
+  InitializeArrayWithTakeBackToFront,
+
   ///   size_t size;
   ///
   /// The required storage size of a single object of this type.
@@ -166,12 +204,20 @@ enum class ValueWitness : unsigned {
   ///   size_t stride;
   ///
   /// The required size per element of an array of this type.
-  Stride
+  Stride,
+
+  ///   size_t flags;
+  ///
+  /// A set of ValueWitnessFlags: whether the type is POD, whether it
+  /// can be taken with memcpy, and whether it is stored inline in a
+  /// fixed-size buffer.
+  Flags
 };
  
 enum {
-  NumValueWitnesses = unsigned(ValueWitness::Stride) + 1,
-  NumValueWitnessFunctions = NumValueWitnesses - 3
+  NumValueWitnesses = unsigned(ValueWitness::Flags) + 1,
+  NumValueWitnessFunctions =
+    unsigned(ValueWitness::InitializeArrayWithTakeBackToFront) + 1
 };
 
 static inline bool isValueWitnessFunction(ValueWitness witness) {
@@ -22,8 +22,13 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/ADT/SmallString.h"
-#include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Twine.h"
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 using namespace swift;
 
 //===----------------------------------------------------------------------===//
@@ -140,6 +145,245 @@ static uint32_t validateUTF8CharacterAndAdvance(const char *&Ptr) {
   return EncodedBytes == 4 ? CharValue : ~0U;
 }
 
+//===----------------------------------------------------------------------===//
+// Vectorized Scanning Helpers
+//===----------------------------------------------------------------------===//
+//
+// The scanners below skip over long runs of "uninteresting" bytes a vector at
+// a time and stop at the first byte the scalar lexer has to look at.  They
+// only ever load full vectors that lie entirely before the end of the buffer;
+// the last partial vector is always left to the scalar code, which already
+// knows how to stop at the terminating character of the buffer.
+//
+// AVX2 or SSE2 is picked at compile time, and everything degrades to the
+// plain scalar loops when neither is available.
+
+namespace {
+#if defined(__AVX2__)
+  typedef __m256i CharVector;
+  enum { CharVectorWidth = 32 };
+
+  inline CharVector loadChars(const char *P) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(P));
+  }
+  inline CharVector splatChar(char C) { return _mm256_set1_epi8(C); }
+  inline CharVector matchChar(CharVector V, char C) {
+    return _mm256_cmpeq_epi8(V, splatChar(C));
+  }
+  inline CharVector matchRange(CharVector V, char Lo, char Hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(V, splatChar(Lo - 1)),
+                            _mm256_cmpgt_epi8(splatChar(Hi + 1), V));
+  }
+  inline CharVector orChars(CharVector A, CharVector B) {
+    return _mm256_or_si256(A, B);
+  }
+  inline unsigned maskOf(CharVector V) {
+    return unsigned(_mm256_movemask_epi8(V));
+  }
+  #define SWIFT_LEXER_HAS_VECTOR_SCAN 1
+#elif defined(__SSE2__)
+  typedef __m128i CharVector;
+  enum { CharVectorWidth = 16 };
+
+  inline CharVector loadChars(const char *P) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(P));
+  }
+  inline CharVector splatChar(char C) { return _mm_set1_epi8(C); }
+  inline CharVector matchChar(CharVector V, char C) {
+    return _mm_cmpeq_epi8(V, splatChar(C));
+  }
+  inline CharVector matchRange(CharVector V, char Lo, char Hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(V, splatChar(Lo - 1)),
+                         _mm_cmpgt_epi8(splatChar(Hi + 1), V));
+  }
+  inline CharVector orChars(CharVector A, CharVector B) {
+    return _mm_or_si128(A, B);
+  }
+  inline unsigned maskOf(CharVector V) {
+    return unsigned(_mm_movemask_epi8(V));
+  }
+  #define SWIFT_LEXER_HAS_VECTOR_SCAN 1
+#endif
+
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  /// vectorScan - Advance Ptr a vector at a time until StopMask reports a
+  /// byte of interest or fewer than a full vector of bytes remain before End.
+  /// StopMask maps a loaded vector to a bitmask with one bit set for each
+  /// byte that the caller needs to handle itself.
+  template<typename StopMaskFn>
+  inline const char *vectorScan(const char *Ptr, const char *End,
+                                StopMaskFn StopMask) {
+    while (End - Ptr >= CharVectorWidth) {
+      if (unsigned Mask = StopMask(loadChars(Ptr)))
+        return Ptr + llvm::CountTrailingZeros_32(Mask);
+      Ptr += CharVectorWidth;
+    }
+    return Ptr;
+  }
+#endif
+} // end anonymous namespace
+
+/// skipWhitespaceRun - Return the first character at or after Ptr that is not
+/// a space, tab, or newline.
+static const char *skipWhitespaceRun(const char *Ptr, const char *End) {
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  Ptr = vectorScan(Ptr, End, [](CharVector V) -> unsigned {
+    return ~maskOf(orChars(orChars(matchChar(V, ' '), matchChar(V, '\t')),
+                           orChars(matchChar(V, '\n'), matchChar(V, '\r'))))
+      & ((1ULL << CharVectorWidth) - 1);
+  });
+#endif
+  while (*Ptr == ' ' || *Ptr == '\t' || *Ptr == '\n' || *Ptr == '\r')
+    ++Ptr;
+  return Ptr;
+}
+
+/// skipIdentifierContinuation - Return the first character at or after Ptr
+/// that cannot continue an identifier, i.e. is not one of [a-zA-Z_$0-9].
+static const char *skipIdentifierContinuation(const char *Ptr,
+                                              const char *End) {
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  Ptr = vectorScan(Ptr, End, [](CharVector V) -> unsigned {
+    CharVector Ok = orChars(orChars(matchRange(V, 'a', 'z'),
+                                    matchRange(V, 'A', 'Z')),
+                            orChars(matchRange(V, '0', '9'),
+                                    orChars(matchChar(V, '_'),
+                                            matchChar(V, '$'))));
+    return ~maskOf(Ok) & ((1ULL << CharVectorWidth) - 1);
+  });
+#endif
+  while (isalnum(*Ptr) || *Ptr == '_' || *Ptr == '$')
+    ++Ptr;
+  return Ptr;
+}
+
+/// skipLineCommentRun - Return the first character at or after Ptr that the
+/// body of a // comment needs to look at: a newline, a nul, or the start of a
+/// multi-byte UTF-8 sequence.  Only the vector part is done here; the caller's
+/// scalar loop takes it from there.
+static const char *skipLineCommentRun(const char *Ptr, const char *End) {
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  Ptr = vectorScan(Ptr, End, [](CharVector V) -> unsigned {
+    return maskOf(orChars(orChars(matchChar(V, '\n'), matchChar(V, '\r')),
+                          matchChar(V, '\0'))) | maskOf(V);
+  });
+#endif
+  return Ptr;
+}
+
+/// skipBlockCommentRun - Return the first character at or after Ptr that the
+/// body of a /* comment needs to look at: a '*' or '/' that might close or
+/// open a nested comment, a nul, or the start of a multi-byte UTF-8 sequence.
+static const char *skipBlockCommentRun(const char *Ptr, const char *End) {
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  Ptr = vectorScan(Ptr, End, [](CharVector V) -> unsigned {
+    return maskOf(orChars(orChars(matchChar(V, '*'), matchChar(V, '/')),
+                          matchChar(V, '\0'))) | maskOf(V);
+  });
+#endif
+  return Ptr;
+}
+
+/// skipStringLiteralRun - Return the first character at or after Ptr that
+/// lexCharacter would not simply accept as itself inside a double-quoted
+/// string: a quote, a backslash, a newline, a nul, or the start of a
+/// multi-byte UTF-8 sequence.
+static const char *skipStringLiteralRun(const char *Ptr, const char *End) {
+#ifdef SWIFT_LEXER_HAS_VECTOR_SCAN
+  Ptr = vectorScan(Ptr, End, [](CharVector V) -> unsigned {
+    return maskOf(orChars(orChars(matchChar(V, '"'), matchChar(V, '\\')),
+                          orChars(orChars(matchChar(V, '\n'),
+                                          matchChar(V, '\r')),
+                                  matchChar(V, '\0')))) | maskOf(V);
+  });
+#endif
+  return Ptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Keyword Recognition
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// KeywordEntry - One slot of the perfect hash table of keywords.
+  struct KeywordEntry {
+    const char *Text;
+    unsigned Length;
+    tok Kind;
+  };
+}
+
+/// MinKeywordLength/MaxKeywordLength - The range of keyword lengths, used to
+/// reject most identifiers without hashing them at all.
+static const unsigned MinKeywordLength = 2;
+static const unsigned MaxKeywordLength = 11;
+
+/// keywordHash - A perfect hash over the keyword set, computed from the
+/// length and the first and last characters of the identifier.  If a keyword
+/// is added, this may need new multipliers; the static_asserts below will
+/// fire if two keywords collide or a keyword is missing from the table.
+static constexpr unsigned keywordHash(const char *Text, unsigned Length) {
+  return (unsigned(Text[0]) + unsigned(Text[Length-1]) * 17 + Length * 3) & 63;
+}
+
+#define KEYWORD(X) { #X, sizeof(#X) - 1, tok::kw_##X }
+#define NO_KEYWORD { nullptr, 0, tok::identifier }
+static constexpr KeywordEntry KeywordTable[64] = {
+  /*  0 */ NO_KEYWORD,        KEYWORD(for),         KEYWORD(subscript),
+  /*  3 */ NO_KEYWORD,        KEYWORD(oneof),       KEYWORD(func),
+  /*  6 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /*  9 */ KEYWORD(do),       NO_KEYWORD,           NO_KEYWORD,
+  /* 12 */ KEYWORD(break),    NO_KEYWORD,           KEYWORD(extension),
+  /* 15 */ NO_KEYWORD,        NO_KEYWORD,           KEYWORD(var),
+  /* 18 */ KEYWORD(return),   NO_KEYWORD,           KEYWORD(destructor),
+  /* 21 */ KEYWORD(class),    KEYWORD(constructor), NO_KEYWORD,
+  /* 24 */ KEYWORD(static),   NO_KEYWORD,           NO_KEYWORD,
+  /* 27 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /* 30 */ KEYWORD(new),      NO_KEYWORD,           NO_KEYWORD,
+  /* 33 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /* 36 */ NO_KEYWORD,        NO_KEYWORD,           KEYWORD(else),
+  /* 39 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /* 42 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /* 45 */ KEYWORD(requires), NO_KEYWORD,           KEYWORD(import),
+  /* 48 */ KEYWORD(continue), NO_KEYWORD,           KEYWORD(typealias),
+  /* 51 */ NO_KEYWORD,        KEYWORD(protocol),    KEYWORD(if),
+  /* 54 */ NO_KEYWORD,        NO_KEYWORD,           NO_KEYWORD,
+  /* 57 */ KEYWORD(struct),   KEYWORD(metatype),    KEYWORD(while),
+  /* 60 */ NO_KEYWORD,        KEYWORD(in),          NO_KEYWORD,
+  /* 63 */ NO_KEYWORD
+};
+#undef NO_KEYWORD
+#undef KEYWORD
+
+// Check at compile time that every keyword lands in its own slot.
+#define KEYWORD(X)                                                    \
+  static_assert(KeywordTable[keywordHash(#X, sizeof(#X) - 1)].Kind == \
+                  tok::kw_##X,                                        \
+                "keyword table is out of sync with keywordHash for '" \
+                #X "'");
+  KEYWORD(class)     KEYWORD(constructor) KEYWORD(destructor)
+  KEYWORD(extension) KEYWORD(func)        KEYWORD(import)
+  KEYWORD(oneof)     KEYWORD(metatype)    KEYWORD(protocol)
+  KEYWORD(requires)  KEYWORD(struct)      KEYWORD(typealias)
+  KEYWORD(var)       KEYWORD(static)      KEYWORD(subscript)
+  KEYWORD(if)        KEYWORD(in)          KEYWORD(do)
+  KEYWORD(else)      KEYWORD(for)         KEYWORD(while)
+  KEYWORD(return)    KEYWORD(break)       KEYWORD(continue)
+  KEYWORD(new)
+#undef KEYWORD
+
+/// getKeywordKind - Return the keyword token kind for the given identifier
+/// text, or tok::identifier if it is not a keyword.
+static tok getKeywordKind(const char *Text, unsigned Length) {
+  if (Length < MinKeywordLength || Length > MaxKeywordLength)
+    return tok::identifier;
+
+  const KeywordEntry &Entry = KeywordTable[keywordHash(Text, Length)];
+  if (Entry.Length == Length && memcmp(Entry.Text, Text, Length) == 0)
+    return Entry.Kind;
+  return tok::identifier;
+}
+
 
 //===----------------------------------------------------------------------===//
 // Setup and Helper Methods
@@ -165,16 +409,6 @@ InFlightDiagnostic Lexer::diagnose(const char *Loc, Diag<> ID) {
   return InFlightDiagnostic();
 }
 
-tok Lexer::getTokenKind(StringRef Text) {
-  assert(Text.data() >= BufferStart && Text.data() <= BufferEnd &&
-         "Text string does not fall within lexer's buffer");
-  Lexer L(StringRef(BufferStart, BufferEnd - BufferStart), SourceMgr, Diags,
-          Text.data());
-  Token Result;
-  L.lex(Result);
-  return Result.getKind();
-}
-
 void Lexer::formToken(tok Kind, const char *TokStart) {
   NextToken.setToken(Kind, StringRef(TokStart, CurPtr-TokStart));
 }
@@ -198,6 +432,7 @@ bool Lexer::isPrecededBySpace() {
 void Lexer::skipSlashSlashComment() {
   assert(CurPtr[-1] == '/' && CurPtr[0] == '/' && "Not a // comment");
   while (1) {
+    CurPtr = skipLineCommentRun(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '\n':
     case '\r':
@@ -239,6 +474,7 @@ void Lexer::skipSlashStarComment() {
   unsigned Depth = 1;
   
   while (1) {
+    CurPtr = skipBlockCommentRun(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '*':
       // Check for a '*/'
@@ -308,44 +544,9 @@ void Lexer::lexIdentifier() {
   assert(isValidStartOfIdentifier(*TokStart) && "Unexpected start");
   
   // Lex [a-zA-Z_$0-9]*
-  while (isValidContinuationOfIdentifier(*CurPtr))
-    ++CurPtr;
-  
-  tok Kind =
-  llvm::StringSwitch<tok>(StringRef(TokStart, CurPtr-TokStart))
-    // decl and type keywords
-    .Case("class", tok::kw_class)
-    .Case("constructor", tok::kw_constructor)
-    .Case("destructor", tok::kw_destructor)
-    .Case("extension", tok::kw_extension)
-    .Case("func", tok::kw_func)
-    .Case("import", tok::kw_import)
-    .Case("metatype", tok::kw_metatype)
-    .Case("oneof", tok::kw_oneof)
-    .Case("protocol", tok::kw_protocol)
-    .Case("requires", tok::kw_requires)
-    .Case("struct", tok::kw_struct)
-    .Case("typealias", tok::kw_typealias)
-    .Case("var", tok::kw_var)
-    .Case("static", tok::kw_static)
-    .Case("subscript", tok::kw_subscript)
-  
-    // Statements
-    .Case("if", tok::kw_if)
-    .Case("in", tok::kw_in)
-    .Case("else", tok::kw_else)
-    .Case("for", tok::kw_for)
-    .Case("do", tok::kw_do)
-    .Case("while", tok::kw_while)
-    .Case("return", tok::kw_return)
-    .Case("break", tok::kw_break)
-    .Case("continue", tok::kw_continue)
-
-    // Expressions
-    .Case("new", tok::kw_new)
-
-    .Default(tok::identifier);
-  
+  CurPtr = skipIdentifierContinuation(CurPtr, BufferEnd);
+
+  tok Kind = getKeywordKind(TokStart, CurPtr-TokStart);
   return formToken(Kind, TokStart);
 }
 
@@ -380,20 +581,33 @@ static bool isRightBound(const char *tokEnd) {
   }
 }
 
-/// formOperatorToken - Form some kind of operator token.
-void Lexer::formOperatorToken(const char *TokStart) {
-  // Decide between the binary, prefix, and postfix cases.
+/// getBoundOperatorKind - Decide between the binary, prefix, and postfix
+/// cases for the operator spanning [TokStart, TokEnd).
+static tok getBoundOperatorKind(const char *TokStart, const char *TokEnd,
+                                const char *BufferStart) {
   bool leftBound = isLeftBound(TokStart, BufferStart);
-  bool rightBound = isRightBound(CurPtr);
+  bool rightBound = isRightBound(TokEnd);
 
   // It's binary if either both sides are bound or both sides are not bound.
-  if (leftBound == rightBound) {
-    formToken(tok::oper_binary, TokStart);
+  if (leftBound == rightBound)
+    return tok::oper_binary;
 
   // Otherwise, it's postfix if left-bound and prefix if right-bound.
-  } else {
-    formToken(leftBound ? tok::oper_postfix : tok::oper_prefix, TokStart);
-  }
+  return leftBound ? tok::oper_postfix : tok::oper_prefix;
+}
+
+/// formOperatorToken - Form some kind of operator token.
+void Lexer::formOperatorToken(const char *TokStart) {
+  formToken(getBoundOperatorKind(TokStart, CurPtr, BufferStart), TokStart);
+}
+
+tok Lexer::getOperatorKind(StringRef Text, const char *BufferStart) {
+  // Match various reserved words.
+  if (Text == "=")
+    return tok::equal;
+  if (Text == "->")
+    return tok::arrow;
+  return getBoundOperatorKind(Text.begin(), Text.end(), BufferStart);
 }
 
 /// lexOperatorIdentifier - Match identifiers formed out of punctuation.
@@ -402,20 +616,9 @@ void Lexer::lexOperatorIdentifier() {
 
   while (Identifier::isOperatorChar(*CurPtr) && *CurPtr != '.')
     ++CurPtr;
-  
-  // Match various reserved words.
-  if (CurPtr-TokStart == 1) {
-    switch (TokStart[0]) {
-    case '=': return formToken(tok::equal, TokStart);
-    }
-  } else if (CurPtr-TokStart == 2) {
-    switch ((TokStart[0] << 8) | TokStart[1]) {
-    case ('-' << 8) | '>': // ->
-      return formToken(tok::arrow, TokStart);
-    }
-  }
-  
-  formOperatorToken(TokStart);
+
+  formToken(getOperatorKind(StringRef(TokStart, CurPtr-TokStart), BufferStart),
+            TokStart);
 }
 
 /// lexDollarIdent - Match $[0-9a-zA-Z_$]*
@@ -424,8 +627,7 @@ void Lexer::lexDollarIdent() {
   assert(*TokStart == '$');
   
   // Lex [a-zA-Z_$0-9]*
-  while (isalnum(*CurPtr) || *CurPtr == '_' || *CurPtr == '$')
-    ++CurPtr;
+  CurPtr = skipIdentifierContinuation(CurPtr, BufferEnd);
   
   return formToken(tok::dollarident, TokStart);
 }
@@ -755,6 +957,9 @@ void Lexer::lexStringLiteral() {
   bool wasErroneous = false;
   
   while (1) {
+    // Skip over the run of ordinary characters in one go.
+    CurPtr = skipStringLiteralRun(CurPtr, BufferEnd);
+
     if (*CurPtr == '\\' && *(CurPtr + 1) == '(') {
       // Consume tokens until we hit the corresponding ')'.
       CurPtr += 2;
@@ -805,11 +1010,17 @@ void Lexer::getEncodedStringLiteral(const Token &Str, ASTContext &Ctx,
   // range check subscripting on the StringRef.
   const char *BytesPtr = Bytes.begin();
   while (BytesPtr != Bytes.end()) {
-    char CurChar = *BytesPtr++;
-    if (CurChar != '\\') {
-      TempString += CurChar;
+    // Copy everything up to the next escape at once.
+    if (*BytesPtr != '\\') {
+      const char *RunEnd = static_cast<const char *>(
+                     memchr(BytesPtr, '\\', Bytes.end() - BytesPtr));
+      if (!RunEnd)
+        RunEnd = Bytes.end();
+      TempString.append(BytesPtr, RunEnd);
+      BytesPtr = RunEnd;
       continue;
     }
+    ++BytesPtr;
     
     // Invalid escapes are accepted by the lexer but diagnosed as an error.  We
     // just ignore them here.
@@ -921,7 +1132,9 @@ Restart:
   case '\t':
   case '\n':
   case '\r':
-    goto Restart;  // Skip whitespace.
+    // Skip the whole run of whitespace.
+    CurPtr = skipWhitespaceRun(CurPtr, BufferEnd);
+    goto Restart;
   case 0:
     // If this is a random nul character in the middle of a buffer, skip it as
     // whitespace.
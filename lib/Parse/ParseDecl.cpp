@@ -288,7 +288,7 @@ bool Parser::parseAttribute(DeclAttributes &Attributes) {
     }
 
     llvm::SmallVector<Lexer::StringSegment, 1> Segments;
-    L->getEncodedStringLiteral(Tok, Context, Segments);
+    getLexer().getEncodedStringLiteral(Tok, Context, Segments);
     if (Segments.size() != 1 ||
         Segments.front().Kind == Lexer::StringSegment::Expr) {
       diagnose(TokLoc, diag::asmname_interpolated_string);
@@ -642,6 +642,10 @@ void Parser::addVarsToScope(Pattern *Pat,
         Set->setDeclContext(CurDeclContext);
         Decls.push_back(Set);
       }
+      if (FuncDecl *Address = VD->getAddressor()) {
+        Address->setDeclContext(CurDeclContext);
+        Decls.push_back(Address);
+      }
     }
     
     Decls.push_back(VD);
@@ -719,15 +723,18 @@ static Pattern *clonePattern(ASTContext &Context, Pattern *Pat) {
 
 
 /// parseSetGet - Parse a get-set clause, containing a getter and (optionally)
-/// a setter.
+/// a setter and an addressor.
 ///
 ///   get-set:
-///      get var-set?
-///      set var-get
+///      get var-set? address?
+///      set var-get address?
 ///
 ///   get:
 ///     'get' stmt-brace
 ///
+///   address:
+///     'address' stmt-brace
+///
 ///   set:
 ///     'set' set-name? stmt-brace
 ///
@@ -735,15 +742,17 @@ static Pattern *clonePattern(ASTContext &Context, Pattern *Pat) {
 ///     '(' identifier ')'
 bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
                          Type ElementTy, FuncDecl *&Get, FuncDecl *&Set,
-                         SourceLoc &LastValidLoc) {
+                         FuncDecl *&Address, SourceLoc &LastValidLoc) {
   if (GetIdent.empty()) {
     GetIdent = Context.getIdentifier("get");
     SetIdent = Context.getIdentifier("set");
+    AddressIdent = Context.getIdentifier("address");
   }
 
   bool Invalid = false;
   Get = 0;
   Set = 0;
+  Address = 0;
   
   while (true) {
     if (!Tok.is(tok::identifier))
@@ -751,16 +760,23 @@ bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
     
     Identifier Id = Context.getIdentifier(Tok.getText());
     
-    if (Id == GetIdent) {
+    if (Id == GetIdent || Id == AddressIdent) {
       //   get         ::= 'get' stmt-brace
+      //   address     ::= 'address' stmt-brace
+      //
+      // An addressor takes the same arguments as the getter, but returns
+      // the address of the storage instead of a copy of the value.
+      bool IsAddressor = (Id == AddressIdent);
+      unsigned AccessorKind = IsAddressor ? 2 : 0;
+      FuncDecl *&Accessor = IsAddressor ? Address : Get;
       
-      // Have we already parsed a get clause?
-      if (Get) {
-        diagnose(Tok.getLoc(), diag::duplicate_getset, false);
-        diagnose(Get->getLoc(), diag::previous_getset, false);
+      // Have we already parsed this clause?
+      if (Accessor) {
+        diagnose(Tok.getLoc(), diag::duplicate_getset, AccessorKind);
+        diagnose(Accessor->getLoc(), diag::previous_getset, AccessorKind);
         
         // Forget the previous version.
-        Get = 0;
+        Accessor = 0;
       }
       
       SourceLoc GetLoc = consumeToken();
@@ -770,13 +786,13 @@ bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
       if (Tok.isAnyLParen() && peekToken().is(tok::r_paren)) {
         SourceLoc StartLoc = consumeToken();
         SourceLoc EndLoc = consumeToken();
-        diagnose(StartLoc, diag::empty_parens_getsetname, false)
+        diagnose(StartLoc, diag::empty_parens_getsetname, AccessorKind)
           << SourceRange(StartLoc, EndLoc);
       }
       
-      // Set up a function declaration for the getter and parse its body.
+      // Set up a function declaration for the accessor and parse its body.
       
-      // Create the parameter list(s) for the getter.
+      // Create the parameter list(s) for the accessor.
       llvm::SmallVector<Pattern *, 3> Params;
       
       // Add the implicit 'this' to Params, if needed.
@@ -799,7 +815,7 @@ bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
       Scope FnBodyScope(this, /*AllowLookup=*/true);
 
       // Start the function.
-      Type GetterRetTy = ElementTy;
+      Type GetterRetTy = IsAddressor ? Context.TheRawPointerType : ElementTy;
       FuncExpr *GetFn = actOnFuncExprStart(GetLoc,
                                            TypeLoc::withoutLoc(GetterRetTy),
                                            Params, Params);
@@ -807,7 +823,9 @@ bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
       // Establish the new context.
       ContextChange CC(*this, GetFn);
       
-      NullablePtr<BraceStmt> Body = parseStmtBrace(diag::expected_lbrace_get);
+      NullablePtr<BraceStmt> Body =
+        parseStmtBrace(IsAddressor ? diag::expected_lbrace_address
+                                   : diag::expected_lbrace_get);
       if (Body.isNull()) {
         GetLoc = SourceLoc();
         skipUntilDeclRBrace();
@@ -819,10 +837,11 @@ bool Parser::parseGetSet(bool HasContainerType, Pattern *Indices,
 
       LastValidLoc = Body.get()->getRBraceLoc();
       
-      Get = new (Context) FuncDecl(/*StaticLoc=*/SourceLoc(), GetLoc,
-                                   Identifier(), GetLoc, /*generic=*/nullptr,
-                                   Type(), GetFn, CurDeclContext);
-      GetFn->setDecl(Get);
+      Accessor = new (Context) FuncDecl(/*StaticLoc=*/SourceLoc(), GetLoc,
+                                        Identifier(), GetLoc,
+                                        /*generic=*/nullptr, Type(), GetFn,
+                                        CurDeclContext);
+      GetFn->setDecl(Accessor);
       continue;
     }
     
@@ -979,11 +998,13 @@ void Parser::parseDeclVarGetSet(Pattern &pattern, bool hasContainerType) {
   
   SourceLoc LBLoc = consumeToken(tok::l_brace);
     
-  // Parse getter and setter.
+  // Parse getter, setter and addressor.
   FuncDecl *Get = 0;
   FuncDecl *Set = 0;
+  FuncDecl *Address = 0;
   SourceLoc LastValidLoc = LBLoc;
-  if (parseGetSet(hasContainerType, /*Indices=*/0, Ty, Get, Set, LastValidLoc))
+  if (parseGetSet(hasContainerType, /*Indices=*/0, Ty, Get, Set, Address,
+                  LastValidLoc))
     Invalid = true;
   
   // Parse the final '}'.
@@ -1005,9 +1026,17 @@ void Parser::parseDeclVarGetSet(Pattern &pattern, bool hasContainerType) {
     Invalid = true;
   }
 
+  if (Address && !Get) {
+    if (!Invalid)
+      diagnose(Address->getLoc(), diag::var_address_without_get);
+
+    Address = nullptr;
+    Invalid = true;
+  }
+
   // If things went well, turn this variable into a property.
   if (!Invalid && PrimaryVar && (Set || Get))
-    PrimaryVar->setProperty(Context, LBLoc, Get, Set, RBLoc);
+    PrimaryVar->setProperty(Context, LBLoc, Get, Set, Address, RBLoc);
 }
 
 /// parseDeclVar - Parse a 'var' declaration, returning true (and doing no
@@ -1662,7 +1691,7 @@ bool Parser::parseDeclSubscript(bool HasContainerType,
       = new (Context) SubscriptDecl(Context.getIdentifier("__subscript"),
                                     SubscriptLoc, Indices.get(), ArrowLoc,
                                     ElementTy, SourceRange(),
-                                    0, 0, CurDeclContext);
+                                    0, 0, 0, CurDeclContext);
     Decls.push_back(Subscript);
     return false;
   }
@@ -1674,12 +1703,13 @@ bool Parser::parseDeclSubscript(bool HasContainerType,
   }
   SourceLoc LBLoc = consumeToken();
   
-  // Parse getter and setter.
+  // Parse getter, setter and addressor.
   FuncDecl *Get = 0;
   FuncDecl *Set = 0;
+  FuncDecl *Address = 0;
   SourceLoc LastValidLoc = LBLoc;
   if (parseGetSet(HasContainerType, Indices.get(), ElementTy.getType(),
-                  Get, Set, LastValidLoc))
+                  Get, Set, Address, LastValidLoc))
     Invalid = true;
 
   // Parse the final '}'.
@@ -1700,6 +1730,14 @@ bool Parser::parseDeclSubscript(bool HasContainerType,
     Set = nullptr;
     Invalid = true;
   }
+
+  if (Address && !Get) {
+    if (!Invalid)
+      diagnose(Address->getLoc(), diag::address_without_get_subscript);
+
+    Address = nullptr;
+    Invalid = true;
+  }
   
   if (!Invalid && (Set || Get)) {
     // FIXME: We should build the declarations even if they are invalid.
@@ -1709,7 +1747,7 @@ bool Parser::parseDeclSubscript(bool HasContainerType,
       = new (Context) SubscriptDecl(Context.getIdentifier("__subscript"),
                                     SubscriptLoc, Indices.get(), ArrowLoc,
                                     ElementTy, SourceRange(LBLoc, RBLoc),
-                                    Get, Set, CurDeclContext);
+                                    Get, Set, Address, CurDeclContext);
     Decls.push_back(Subscript);
 
     // FIXME: Order of get/set not preserved.
@@ -1723,7 +1761,13 @@ bool Parser::parseDeclSubscript(bool HasContainerType,
       Get->setDeclContext(CurDeclContext);
       Get->makeGetter(Subscript);
       Decls.push_back(Get);
-    }    
+    }
+
+    if (Address) {
+      Address->setDeclContext(CurDeclContext);
+      Address->makeAddressor(Subscript);
+      Decls.push_back(Address);
+    }
   }
   return Invalid;
 }
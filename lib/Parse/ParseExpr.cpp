@@ -17,6 +17,7 @@
 #include "Parser.h"
 #include "swift/AST/Diagnostics.h"
 #include "swift/Parse/Lexer.h"
+#include "swift/Parse/TokenCache.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/SaveAndRestore.h"
 using namespace swift;
@@ -254,7 +255,7 @@ NullablePtr<Expr> Parser::parseExprPostfix(Diag<> ID) {
     break;
   }
   case tok::character_literal: {
-    uint32_t Codepoint = L->getEncodedCharacterLiteral(Tok);
+    uint32_t Codepoint = getLexer().getEncodedCharacterLiteral(Tok);
     SourceLoc Loc = consumeToken(tok::character_literal);
     Result = new (Context) CharacterLiteralExpr(Codepoint, Loc);
     break;
@@ -381,7 +382,7 @@ NullablePtr<Expr> Parser::parseExprPostfix(Diag<> ID) {
 ///     string_literal
 Expr *Parser::parseExprStringLiteral() {
   llvm::SmallVector<Lexer::StringSegment, 1> Segments;
-  L->getEncodedStringLiteral(Tok, Context, Segments);
+  getLexer().getEncodedStringLiteral(Tok, Context, Segments);
   SourceLoc Loc = consumeToken();
     
   // The simple case: just a single literal segment.
@@ -402,11 +403,13 @@ Expr *Parser::parseExprStringLiteral() {
     }
         
     case Lexer::StringSegment::Expr: {
-      // Create a temporary lexer that lexes from the body of the string.
-      Lexer LocalLex(Segment.Data, SourceMgr, &Diags);
+      // Create a temporary token stream over the body of the string.
+      TokenCache LocalToks(Segment.Data, SourceMgr, &Diags);
       
-      // Temporarily swap out the parser's current lexer with our new one.
-      llvm::SaveAndRestore<Lexer*> T(L, &LocalLex);
+      // Temporarily swap out the parser's current token stream with our new
+      // one.
+      llvm::SaveAndRestore<TokenCache*> T(Toks, &LocalToks);
+      llvm::SaveAndRestore<unsigned> TI(NextTokIndex, 0);
       
       // Prime the new lexer with a '(' as the first token.
       assert(Segment.Data.data()[-1] == '(' &&
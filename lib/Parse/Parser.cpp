@@ -19,6 +19,7 @@
 #include "swift/AST/PrettyStackTrace.h"
 #include "Parser.h"
 #include "swift/Parse/Lexer.h"
+#include "swift/Parse/TokenCache.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SourceMgr.h"
@@ -45,11 +46,12 @@ namespace {
 bool swift::parseIntoTranslationUnit(TranslationUnit *TU,
                                      unsigned BufferID,
                                      unsigned *BufferOffset,
-                                     unsigned BufferEndOffset) {
+                                     unsigned BufferEndOffset,
+                                     TokenCache *Toks) {
   Parser P(BufferID, TU->getComponent(), TU->Ctx,
            BufferOffset ? *BufferOffset : 0, BufferEndOffset,
            TU->Kind == TranslationUnit::Main ||
-           TU->Kind == TranslationUnit::Repl);
+           TU->Kind == TranslationUnit::Repl, Toks);
   PrettyStackTraceParser stackTrace(P);
   P.parseTranslationUnit(TU);
   if (BufferOffset)
@@ -63,53 +65,64 @@ bool swift::parseIntoTranslationUnit(TranslationUnit *TU,
 // Setup and Helper Methods
 //===----------------------------------------------------------------------===//
 
-/// ComputeLexStart - Compute the start of lexing; if there's an offset, take
-/// that into account.  If there's a #! line in a main module, ignore it.
-static StringRef ComputeLexStart(StringRef File, unsigned Offset,
-                                 unsigned EndOffset, bool IsMainModule) {
-  if (EndOffset)
-    return File.slice(Offset, EndOffset);
-  else if (Offset)
-    return File.substr(Offset);
+/// computeLexStart - Compute the offset at which to start lexing; if there's
+/// an offset, take that into account.  If there's a #! line in a main module,
+/// ignore it.
+static unsigned computeLexStart(StringRef File, unsigned Offset,
+                                unsigned EndOffset, bool IsMainModule) {
+  if (EndOffset || Offset)
+    return Offset;
 
   if (IsMainModule && File.startswith("#!")) {
     StringRef::size_type Pos = File.find_first_of("\n\r");
     if (Pos != StringRef::npos)
-      return File.substr(Pos);
+      return Pos;
   }
 
-  return File;
+  return 0;
 }
 
 
 Parser::Parser(unsigned BufferID, swift::Component *Comp, ASTContext &Context,
-               unsigned Offset, unsigned EndOffset, bool IsMainModule)
+               unsigned Offset, unsigned EndOffset, bool IsMainModule,
+               TokenCache *SharedToks)
   : SourceMgr(Context.SourceMgr),
     Diags(Context.Diags),
     Buffer(SourceMgr.getMemoryBuffer(BufferID)),
-    L(new Lexer(ComputeLexStart(Buffer->getBuffer(), Offset, EndOffset,
-                                 IsMainModule),
-                 SourceMgr, &Diags)),
+    OwnedToks(SharedToks ? nullptr
+                         : new TokenCache(Buffer->getBuffer(), SourceMgr,
+                                          &Diags)),
+    Toks(SharedToks ? SharedToks : OwnedToks.get()),
     Component(Comp),
     Context(Context),
     ScopeInfo(*this),
     IsMainModule(IsMainModule),
     FoundSideEffects(false) {
+  assert(Toks->getBuffer().data() == Buffer->getBufferStart() &&
+         "Token cache is for a different buffer");
+  Toks->setEndOffset(EndOffset ? EndOffset : Buffer->getBufferSize());
+  NextTokIndex = Toks->getIndexForOffset(
+           computeLexStart(Buffer->getBuffer(), Offset, EndOffset,
+                           IsMainModule));
 }
 
 Parser::~Parser() {
-  delete L;
 }
 
-/// peekToken - Return the next token that will be installed by consumeToken.
-const Token &Parser::peekToken() {
-  return L->peekNextToken();
+Lexer &Parser::getLexer() {
+  return Toks->getLexer();
+}
+
+/// peekToken - Return the token Distance tokens after the current one.
+Token Parser::peekToken(unsigned Distance) {
+  assert(Distance != 0 && "Use Tok to look at the current token");
+  return Toks->getToken(NextTokIndex + Distance - 1);
 }
 
 SourceLoc Parser::consumeToken() {
   SourceLoc Loc = Tok.getLoc();
   assert(Tok.isNot(tok::eof) && "Lexing past eof!");
-  L->lex(Tok);
+  Tok = Toks->getToken(NextTokIndex++);
   return Loc;
 }
 
@@ -122,7 +135,7 @@ SourceLoc Parser::consumeStartingLess() {
   // Skip the starting '<' in the existing token.
   SourceLoc Loc = Tok.getLoc();  
   StringRef Remaining =Tok.getText().substr(1);
-  Tok.setToken(L->getTokenKind(Remaining), Remaining);
+  Tok.setToken(Toks->getTokenKind(Remaining), Remaining);
   return Loc;
 }
 
@@ -135,7 +148,7 @@ SourceLoc Parser::consumeStartingGreater() {
   // Skip the starting '>' in the existing token.
   SourceLoc Loc = Tok.getLoc();
   StringRef Remaining =Tok.getText().substr(1);
-  Tok.setToken(L->getTokenKind(Remaining), Remaining);
+  Tok.setToken(Toks->getTokenKind(Remaining), Remaining);
   return Loc;
 }
 
@@ -22,6 +22,7 @@
 #include "swift/AST/AST.h"
 #include "swift/AST/Diagnostics.h"
 #include "llvm/ADT/SetVector.h"
+#include <memory>
 
 namespace llvm {
   class Component;
@@ -34,6 +35,7 @@ namespace swift {
   class DiagnosticEngine;
   class Lexer;
   class ScopeInfo;
+  class TokenCache;
   struct TypeLoc;
   class TupleType;
   
@@ -45,12 +47,23 @@ class Parser {
   
   Identifier GetIdent;
   Identifier SetIdent;
+  Identifier AddressIdent;
   
 public:
   llvm::SourceMgr &SourceMgr;
   DiagnosticEngine &Diags;
   const llvm::MemoryBuffer *Buffer;
-  Lexer *L;
+
+  /// OwnedToks - The token stream for Buffer, if this parser was not handed
+  /// one to share.
+  std::unique_ptr<TokenCache> OwnedToks;
+
+  /// Toks - The token stream being parsed.
+  TokenCache *Toks;
+
+  /// NextTokIndex - The index in Toks of the token after Tok.
+  unsigned NextTokIndex;
+
   DeclContext *CurDeclContext;
   swift::Component *Component;
   ASTContext &Context;
@@ -90,17 +103,22 @@ public:
     }
   };
 
-
   Parser(unsigned BufferID, swift::Component *Component, ASTContext &Ctx,
-         unsigned Offset, unsigned EndOffset, bool IsMainModule);
+         unsigned Offset, unsigned EndOffset, bool IsMainModule,
+         TokenCache *Toks = nullptr);
   ~Parser();
   
   //===--------------------------------------------------------------------===//
   // Utilities
   
-  /// peekToken - Return the next token that will be installed by consumeToken.
-  const Token &peekToken();
-  
+  /// getLexer - Return the lexer for the buffer being parsed, which is needed
+  /// to decode string and character literals.
+  Lexer &getLexer();
+
+  /// peekToken - Return the token Distance tokens after the current one; by
+  /// default, the next token that will be installed by consumeToken.
+  Token peekToken(unsigned Distance = 1);
+
   // Utilities.
   SourceLoc consumeToken();
   SourceLoc consumeToken(tok K) {
@@ -247,7 +265,8 @@ public:
   bool parseDeclClass(SmallVectorImpl<Decl*> &Decls);
   bool parseDeclVar(bool hasContainerType, SmallVectorImpl<Decl*> &Decls);
   bool parseGetSet(bool HasContainerType, Pattern *Indices, Type ElementTy, 
-                   FuncDecl *&Get, FuncDecl *&Set, SourceLoc &LastValidLoc);
+                   FuncDecl *&Get, FuncDecl *&Set, FuncDecl *&Address,
+                   SourceLoc &LastValidLoc);
   void parseDeclVarGetSet(Pattern &pattern, bool hasContainerType);
   
   Pattern *buildImplicitThisParameter();
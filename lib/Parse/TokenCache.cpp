@@ -0,0 +1,147 @@
+//===--- TokenCache.cpp - Cached Token Stream -----------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the TokenCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Parse/TokenCache.h"
+#include "swift/Parse/Lexer.h"
+#include <algorithm>
+using namespace swift;
+
+TokenCache::TokenCache(StringRef Buffer, llvm::SourceMgr &SourceMgr,
+                       DiagnosticEngine *Diags)
+  : SourceMgr(SourceMgr), Diags(Diags), Buffer(Buffer),
+    EndOffset(Buffer.size()), StartOffset(0), L(nullptr) {
+}
+
+TokenCache::~TokenCache() {
+  delete L;
+}
+
+Lexer &TokenCache::getLexer() {
+  if (!L)
+    L = new Lexer(Buffer.substr(0, EndOffset), SourceMgr, Diags,
+                  Buffer.data() + getResumeOffset());
+  return *L;
+}
+
+void TokenCache::resetAt(unsigned Offset) {
+  assert(Offset <= EndOffset && "Resetting past the end of the buffer");
+  Tokens.clear();
+  StartOffset = Offset;
+  delete L;
+  L = nullptr;
+}
+
+bool TokenCache::lexMore() {
+  if (!Tokens.empty() && Tokens.back().getKind() == tok::eof)
+    return false;
+
+  Token Tok;
+  getLexer().lex(Tok);
+
+  CachedToken Entry;
+  Entry.Offset = Tok.getText().data() - Buffer.data();
+  Entry.Length = Tok.getLength();
+  Entry.Kind = unsigned(Tok.getKind());
+  assert(Entry.Length == Tok.getLength() && "Token too long to cache");
+  Tokens.push_back(Entry);
+  return true;
+}
+
+void TokenCache::setEndOffset(unsigned NewEndOffset) {
+  assert(NewEndOffset <= Buffer.size() && "End offset out of range");
+  if (NewEndOffset == EndOffset)
+    return;
+
+  if (NewEndOffset < EndOffset || StartOffset > NewEndOffset) {
+    EndOffset = NewEndOffset;
+    resetAt(std::min(StartOffset, NewEndOffset));
+    return;
+  }
+
+  // The buffer grew.  The eof token, and anything that ran up against the
+  // old end (an identifier, or an unterminated literal), has to be relexed
+  // now that there is more text after it.
+  unsigned Keep = Tokens.size();
+  while (Keep != 0 && Tokens[Keep-1].getEndOffset() >= EndOffset)
+    --Keep;
+  EndOffset = NewEndOffset;
+  Tokens.erase(Tokens.begin() + Keep, Tokens.end());
+  delete L;
+  L = nullptr;
+}
+
+std::vector<CachedToken>::iterator TokenCache::findToken(unsigned Offset) {
+  return std::lower_bound(Tokens.begin(), Tokens.end(), Offset,
+                          [](const CachedToken &Tok, unsigned Offset) {
+                            return Tok.Offset < Offset;
+                          });
+}
+
+unsigned TokenCache::getIndexForOffset(unsigned Offset) {
+  assert(Offset <= EndOffset && "Offset out of range");
+
+  // Anything before the cached run has to be lexed from scratch.
+  if (Offset < StartOffset) {
+    resetAt(Offset);
+    return 0;
+  }
+
+  // Make sure the cached run reaches the offset.
+  while (getResumeOffset() < Offset && lexMore())
+    ;
+
+  auto I = findToken(Offset);
+  unsigned Index = I - Tokens.begin();
+
+  // Starting exactly at a token, or exactly at the end of the previous one,
+  // produces the same tokens as the cached run does from that point on.
+  // Anything else (a position inside a token or a comment) must be relexed.
+  if (I != Tokens.end() && I->Offset == Offset)
+    return Index;
+  if (Index == 0 ? Offset == StartOffset
+                 : Tokens[Index-1].getEndOffset() == Offset)
+    return Index;
+
+  resetAt(Offset);
+  return 0;
+}
+
+tok TokenCache::getTokenKind(StringRef Text) {
+  assert(Text.data() >= Buffer.data() &&
+         Text.data() <= Buffer.data() + EndOffset &&
+         "Text string does not fall within the cached buffer");
+  unsigned Offset = Text.data() - Buffer.data();
+
+  auto I = findToken(Offset);
+  if (I != Tokens.end() && I->Offset == Offset && I->Length == Text.size())
+    return I->getKind();
+
+  // Otherwise this is the tail of a split operator.  Its kind only depends
+  // on its spelling and the characters around it, so there's nothing to
+  // lex.
+  return Lexer::getOperatorKind(Text, Buffer.data());
+}
+
+SourceLoc TokenCache::getLocForEndOfToken(SourceLoc Loc) {
+  if (!Loc.isValid())
+    return Loc;
+
+  const char *Ptr = Loc.Value.getPointer();
+  assert(Ptr >= Buffer.data() && Ptr <= Buffer.data() + EndOffset &&
+         "Location does not fall within the cached buffer");
+  unsigned Index = getIndexForOffset(Ptr - Buffer.data());
+  return Loc.getAdvancedLoc(getToken(Index).getLength());
+}
@@ -0,0 +1,128 @@
+//===--- Dominance.cpp - SIL Dominator Trees ------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file computes dominator trees and dominance frontiers for SIL, using
+// the iterative algorithm of Cooper, Harvey and Kennedy, "A Simple, Fast
+// Dominance Algorithm".  SIL functions are small enough that it beats the
+// asymptotically faster Lengauer-Tarjan algorithm in practice.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/Function.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include <algorithm>
+#include <utility>
+using namespace swift;
+
+/// Sentinel for a block whose immediate dominator is not known yet.
+static const unsigned Undefined = ~0U;
+
+DominanceInfo::DominanceInfo(Function &F) {
+  if (F.empty())
+    return;
+
+  // Number the reachable blocks in reverse post-order with an explicit DFS
+  // stack, so that deep CFGs cannot overflow the native stack.
+  {
+    llvm::SmallPtrSet<BasicBlock*, 32> Visited;
+    SmallVector<std::pair<BasicBlock*, unsigned>, 32> Stack;
+    BasicBlock *Entry = &*F.begin();
+    Visited.insert(Entry);
+    Stack.push_back(std::make_pair(Entry, 0U));
+    while (!Stack.empty()) {
+      BasicBlock *BB = Stack.back().first;
+      unsigned SuccNo = Stack.back().second++;
+      auto Succs = BB->getSuccs();
+      if (SuccNo == Succs.size()) {
+        RPO.push_back(BB);
+        Stack.pop_back();
+        continue;
+      }
+      BasicBlock *Succ = Succs[SuccNo];
+      if (Visited.insert(Succ))
+        Stack.push_back(std::make_pair(Succ, 0U));
+    }
+    std::reverse(RPO.begin(), RPO.end());
+  }
+
+  for (unsigned i = 0, e = RPO.size(); i != e; ++i)
+    RPONumbers[RPO[i]] = i;
+
+  // Walk up the partially built tree from two blocks until they meet.  The
+  // immediate dominator of a block always has a smaller RPO number.
+  auto intersect = [&](unsigned A, unsigned B) -> unsigned {
+    while (A != B) {
+      while (A > B) A = IDoms[A];
+      while (B > A) B = IDoms[B];
+    }
+    return A;
+  };
+
+  IDoms.assign(RPO.size(), Undefined);
+  IDoms[0] = 0;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (unsigned N = 1, e = RPO.size(); N != e; ++N) {
+      BasicBlock *BB = RPO[N];
+      unsigned NewIDom = Undefined;
+      for (auto PI = BB->pred_begin(), PE = BB->pred_end(); PI != PE; ++PI) {
+        auto PredI = RPONumbers.find(*PI);
+        if (PredI == RPONumbers.end() || IDoms[PredI->second] == Undefined)
+          continue;
+        NewIDom = NewIDom == Undefined ? PredI->second
+                                       : intersect(PredI->second, NewIDom);
+      }
+      if (NewIDom != IDoms[N]) {
+        IDoms[N] = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+
+  // A block is in the dominance frontier of every block on the dominator
+  // tree path from each of its predecessors up to (but not including) its
+  // immediate dominator.  Only join points can be in a frontier.
+  Frontiers.resize(RPO.size());
+  for (unsigned N = 1, e = RPO.size(); N != e; ++N) {
+    BasicBlock *BB = RPO[N];
+    auto PI = BB->pred_begin(), PE = BB->pred_end();
+    if (PI == PE)
+      continue;
+    auto NextPI = PI;
+    ++NextPI;
+    if (NextPI == PE)
+      continue;
+
+    for (; PI != PE; ++PI) {
+      auto PredI = RPONumbers.find(*PI);
+      if (PredI == RPONumbers.end())
+        continue;
+      for (unsigned Runner = PredI->second; Runner != IDoms[N];
+           Runner = IDoms[Runner]) {
+        auto &Frontier = Frontiers[Runner];
+        if (!Frontier.empty() && Frontier.back() == BB)
+          break;
+        Frontier.push_back(BB);
+      }
+    }
+  }
+}
+
+bool DominanceInfo::dominates(const BasicBlock *A, const BasicBlock *B) const {
+  unsigned ANum = getRPONumber(A);
+  unsigned BNum = getRPONumber(B);
+  while (BNum > ANum)
+    BNum = IDoms[BNum];
+  return BNum == ANum;
+}
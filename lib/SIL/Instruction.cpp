@@ -77,9 +77,50 @@ void Instruction::removeFromParent() {
 /// block and deletes it.
 ///
 void Instruction::eraseFromParent() {
+  assert(use_empty() && "Erasing an instruction that still has uses");
+  dropAllReferences();
   getParent()->getInsts().erase(this);
 }
 
+MutableArrayRef<Operand> Instruction::getAllOperands() {
+  switch (getKind()) {
+#define INST(CLASS, PARENT) \
+  case ValueKind::CLASS: \
+    return static_cast<CLASS *>(this)->getAllOperands();
+#include "swift/SIL/SILNodes.def"
+  case ValueKind::BBArgument:
+    break;
+  }
+  llvm_unreachable("not an instruction");
+}
+
+void Instruction::dropAllReferences() {
+  for (Operand &Op : getAllOperands())
+    Op.drop();
+
+  // Instructions are not destroyed when they are erased, so a terminator has
+  // to unlink itself from the predecessor lists of its successors here.
+  if (TermInst *TI = dyn_cast<TermInst>(this))
+    for (const SILSuccessor &Succ : TI->getSuccessors())
+      const_cast<SILSuccessor&>(Succ) = nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Value and Operand Implementation
+//===----------------------------------------------------------------------===//
+
+void Value::replaceAllUsesWith(Value *Other) {
+  assert(Other != this && "Replacing a value with itself");
+  assert(Other->getType()->isEqual(getType()) &&
+         "Replacing a value with one of a different type");
+  while (!use_empty())
+    (*use_begin())->set(Other);
+}
+
+unsigned Operand::getOperandNumber() const {
+  return this - getUser()->getAllOperands().begin();
+}
+
 //===----------------------------------------------------------------------===//
 // Instruction Subclasses
 //===----------------------------------------------------------------------===//
@@ -117,20 +158,22 @@ static Type getAllocArrayType(Type EltTy) {
 AllocArrayInst::AllocArrayInst(Expr *E, Type ElementType,
                                Value *NumElements)
   : Instruction(ValueKind::AllocArrayInst, E, getAllocArrayType(ElementType)),
-    ElementType(ElementType), NumElements(NumElements) {
+    ElementType(ElementType), Operands(this, NumElements) {
 }
 
 ApplyInst::ApplyInst(SILLocation Loc, Type Ty, Value *Callee,
                      ArrayRef<Value*> Args)
-  : Instruction(ValueKind::ApplyInst, Loc, Ty), Callee(Callee),
-    NumArgs(Args.size()) {
-  memcpy(getArgsStorage(), Args.data(), Args.size() * sizeof(Value*));
+  : Instruction(ValueKind::ApplyInst, Loc, Ty), NumArgs(Args.size()) {
+  Operand *Storage = getOperandsStorage();
+  ::new(&Storage[0]) Operand(this, Callee);
+  for (unsigned i = 0, e = Args.size(); i != e; ++i)
+    ::new(&Storage[i + 1]) Operand(this, Args[i]);
 }
 
 ApplyInst *ApplyInst::create(ApplyExpr *Expr, Value *Callee,
                              ArrayRef<Value*> Args, Function &F) {
   void *Buffer = F.allocate(sizeof(ApplyInst) +
-                            Args.size() * sizeof(Value*),
+                            (Args.size() + 1) * sizeof(Operand),
                             llvm::AlignOf<ApplyInst>::Alignment);
   Type ResTy = Callee->getType()->castTo<FunctionType>()->getResult();
   assert(ResTy->isEqual(Expr->getType()));
@@ -139,7 +182,7 @@ ApplyInst *ApplyInst::create(ApplyExpr *Expr, Value *Callee,
 
 ApplyInst *ApplyInst::create(Value *Callee, ArrayRef<Value*> Args, Function &F) {
   void *Buffer = F.allocate(sizeof(ApplyInst) +
-                            Args.size() * sizeof(Value*),
+                            (Args.size() + 1) * sizeof(Operand),
                             llvm::AlignOf<ApplyInst>::Alignment);
   Type ResTy = Callee->getType()->castTo<FunctionType>()->getResult();
   return ::new(Buffer) ApplyInst(SILLocation(), ResTy, Callee, Args);
@@ -214,56 +257,57 @@ StringRef StringLiteralInst::getValue() const {
 
 LoadInst::LoadInst(LoadExpr *E, Value *LValue, bool IsTake)
   : Instruction(ValueKind::LoadInst, E, E->getType()),
-    LValue(LValue),
+    Operands(this, LValue),
     IsTake(IsTake) {
 }
 
 
 StoreInst::StoreInst(AssignStmt *S, Value *Src, Value *Dest)
   : Instruction(ValueKind::StoreInst, S, getVoidType(Src->getType())),
-    Src(Src), Dest(Dest), IsInitialization(false) {
+    Operands(this, Src, Dest), IsInitialization(false) {
 }
 
 StoreInst::StoreInst(VarDecl *VD, Value *Src, Value *Dest)
   : Instruction(ValueKind::StoreInst, VD, getVoidType(Src->getType())),
-    Src(Src), Dest(Dest), IsInitialization(true) {
+    Operands(this, Src, Dest), IsInitialization(true) {
 }
 
 
 StoreInst::StoreInst(MaterializeExpr *E, Value *Src, Value *Dest)
   : Instruction(ValueKind::StoreInst, E, getVoidType(Src->getType())),
-    Src(Src), Dest(Dest), IsInitialization(true) {
+    Operands(this, Src, Dest), IsInitialization(true) {
 }
 
 StoreInst::StoreInst(Expr *E, bool IsInitialization, Value *Src, Value *Dest)
   : Instruction(ValueKind::StoreInst, E, getVoidType(Src->getType())),
-    Src(Src), Dest(Dest), IsInitialization(IsInitialization) {
+    Operands(this, Src, Dest), IsInitialization(IsInitialization) {
   // This happens in a store to an array initializer for varargs tuple shuffle.
 }
 
 
 CopyInst::CopyInst(Expr *E, Value *SrcLValue, Value *DestLValue,
                    bool IsTakeOfSrc, bool IsInitializationOfDest)
-  : Instruction(ValueKind::CopyInst, E, getVoidType(Src->getType())),
-    Src(SrcLValue), Dest(DestLValue),
+  : Instruction(ValueKind::CopyInst, E, getVoidType(SrcLValue->getType())),
+    Operands(this, SrcLValue, DestLValue),
     IsTakeOfSrc(IsTakeOfSrc), IsInitializationOfDest(IsInitializationOfDest) {
 }
 
 
 SpecializeInst::SpecializeInst(SpecializeExpr *SE, Value *Operand, Type DestTy)
-  : Instruction(ValueKind::SpecializeInst, SE, DestTy), Operand(Operand) {
+  : Instruction(ValueKind::SpecializeInst, SE, DestTy),
+    Operands(this, Operand) {
 }
 
 
 TypeConversionInst::TypeConversionInst(ImplicitConversionExpr *E,
                                        Value *Operand)
   : Instruction(ValueKind::TypeConversionInst, E, E->getType()),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 TypeConversionInst::TypeConversionInst(Type Ty, Value *Operand)
   : Instruction(ValueKind::TypeConversionInst, (Expr*)nullptr, Ty),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 
@@ -272,14 +316,16 @@ TupleInst *TupleInst::createImpl(Expr *E, Type Ty, ArrayRef<Value*> Elements,
   if (E) Ty = E->getType();
 
   void *Buffer = F.allocate(sizeof(TupleInst) +
-                            Elements.size() * sizeof(Value*),
+                            Elements.size() * sizeof(Operand),
                             llvm::AlignOf<TupleInst>::Alignment);
   return ::new(Buffer) TupleInst(E, Ty, Elements);
 }
 
 TupleInst::TupleInst(Expr *E, Type Ty, ArrayRef<Value*> Elems)
   : Instruction(ValueKind::TupleInst, E, Ty), NumArgs(Elems.size()) {
-  memcpy(getElementsStorage(), Elems.data(), Elems.size() * sizeof(Value*));
+  Operand *Storage = getElementsStorage();
+  for (unsigned i = 0, e = Elems.size(); i != e; ++i)
+    ::new(&Storage[i]) Operand(this, Elems[i]);
 }
 
 MetatypeInst::MetatypeInst(MetatypeExpr *E)
@@ -298,34 +344,34 @@ Type MetatypeInst::getMetaType() const {
 TupleElementInst::TupleElementInst(TupleElementExpr *E, Value *Operand,
                                    unsigned FieldNo)
   : Instruction(ValueKind::TupleElementInst, E, E->getType()),
-    Operand(Operand), FieldNo(FieldNo) {
+    Operands(this, Operand), FieldNo(FieldNo) {
 }
 
 TupleElementInst::TupleElementInst(Type ResultTy, Value *Operand,
                                    unsigned FieldNo)
   : Instruction(ValueKind::TupleElementInst, (Expr*)nullptr, ResultTy),
-    Operand(Operand), FieldNo(FieldNo) {
+    Operands(this, Operand), FieldNo(FieldNo) {
   
 }
 
 RetainInst::RetainInst(Expr *E, Value *Operand)
   : Instruction(ValueKind::RetainInst, E, Operand->getType()),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 ReleaseInst::ReleaseInst(Expr *E, Value *Operand)
   : Instruction(ValueKind::ReleaseInst, E, getVoidType(Operand->getType())),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 DeallocInst::DeallocInst(Expr *E, Value *Operand)
   : Instruction(ValueKind::DeallocInst, E, getVoidType(Operand->getType())),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 DestroyInst::DestroyInst(Expr *E, Value *Operand)
   : Instruction(ValueKind::DestroyInst, E, getVoidType(Operand->getType())),
-    Operand(Operand) {
+    Operands(this, Operand) {
 }
 
 //===----------------------------------------------------------------------===//
@@ -334,7 +380,7 @@ DestroyInst::DestroyInst(Expr *E, Value *Operand)
 
 IndexLValueInst::IndexLValueInst(Expr *E, Value *Operand, unsigned Index)
   : Instruction(ValueKind::IndexLValueInst, E, Operand->getType()),
-    Operand(Operand), Index(Index) {
+    Operands(this, Operand), Index(Index) {
 }
 
 IntegerValueInst::IntegerValueInst(uint64_t Val, Type Ty)
@@ -364,13 +410,23 @@ UnreachableInst::UnreachableInst(Function &F)
 
 ReturnInst::ReturnInst(ReturnStmt *S, Value *ReturnValue)
   : TermInst(ValueKind::ReturnInst, S, getVoidType(ReturnValue->getType())),
-    ReturnValue(ReturnValue) {
+    Operands(this, ReturnValue) {
 }
 
-BranchInst::BranchInst(BasicBlock *DestBB, Function &F)
+BranchInst::BranchInst(BasicBlock *DestBB, ArrayRef<Value*> Args, Function &F)
   : TermInst(ValueKind::BranchInst, SILLocation(),
              F.getContext().TheEmptyTupleType),
-    DestBB(this, DestBB) {
+    DestBB(this, DestBB), NumArgs(Args.size()) {
+  Operand *Storage = getArgsStorage();
+  for (unsigned i = 0, e = Args.size(); i != e; ++i)
+    ::new(&Storage[i]) Operand(this, Args[i]);
+}
+
+BranchInst *BranchInst::create(BasicBlock *DestBB, ArrayRef<Value*> Args,
+                               Function &F) {
+  void *Buffer = F.allocate(sizeof(BranchInst) + Args.size() * sizeof(Operand),
+                            llvm::AlignOf<BranchInst>::Alignment);
+  return ::new(Buffer) BranchInst(DestBB, Args, F);
 }
 
 
@@ -378,7 +434,7 @@ CondBranchInst::CondBranchInst(Stmt *TheStmt, Value *Condition,
                                BasicBlock *TrueBB, BasicBlock *FalseBB)
   : TermInst(ValueKind::CondBranchInst, TheStmt,
              getVoidType(Condition->getType())),
-    Condition(Condition) {
+    Operands(this, Condition) {
   DestBBs[0].init(this);
   DestBBs[1].init(this);
   DestBBs[0] = TrueBB;
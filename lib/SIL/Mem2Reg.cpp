@@ -0,0 +1,498 @@
+//===--- Mem2Reg.cpp - Promote Local Variables to SSA Values --------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file promotes the memory of local variables to SSA values.  SILGen
+// gives every 'var' an alloc_var that is only accessed through load, store,
+// destroy and dealloc.  When nothing else refers to the allocation, and no
+// closure captures the variable, each load is replaced by the value stored
+// last, and block arguments are added where different values meet.  The
+// blocks that need arguments are found with dominance frontiers, pruned to
+// the blocks where the variable is live.
+//
+// The ownership of the value in memory moves to the SSA value: a load that
+// copies the value retains it, a destroy becomes a release of the current
+// value, a reassignment releases the value it overwrites, and the dealloc goes
+// away.  Finally, a retain inserted here that is released again before
+// anything can observe the reference count is deleted along with the release.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-mem2reg"
+#include "swift/Subsystems.h"
+#include "swift/AST/Decl.h"
+#include "swift/AST/Types.h"
+#include "swift/SIL/BBArgument.h"
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/Function.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILPassManager.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include <algorithm>
+#include <utility>
+using namespace swift;
+
+STATISTIC(NumAllocsPromoted, "Number of alloc_vars promoted to SSA values");
+STATISTIC(NumBBArgsInserted, "Number of block arguments inserted");
+STATISTIC(NumEdgesSplit, "Number of conditional branch edges split");
+STATISTIC(NumRetainReleasePairs,
+          "Number of retain/release pairs of promoted values eliminated");
+
+/// isPromotable - Return true if the allocation is only ever loaded from,
+/// stored to, destroyed and deallocated, and no closure captures the variable.
+static bool isPromotable(AllocVarInst *AVI) {
+  // Capture analysis clears this for variables that escape into closures.
+  if (!AVI->getDecl()->hasFixedLifetime())
+    return false;
+
+  for (auto UI = AVI->use_begin(), E = AVI->use_end(); UI != E; ++UI) {
+    Instruction *User = UI.getUser();
+    if (isa<LoadInst>(User) || isa<DestroyInst>(User) ||
+        isa<DeallocInst>(User))
+      continue;
+    if (StoreInst *SI = dyn_cast<StoreInst>(User))
+      if (SI->getDest() == AVI)
+        continue;
+    return false;
+  }
+  return true;
+}
+
+/// getAccessedAddress - If the instruction is a load, store, destroy or
+/// dealloc, return the address it accesses.
+static Value *getAccessedAddress(Instruction *I) {
+  if (LoadInst *LI = dyn_cast<LoadInst>(I))
+    return LI->getLValue();
+  if (StoreInst *SI = dyn_cast<StoreInst>(I))
+    return SI->getDest();
+  if (DestroyInst *DI = dyn_cast<DestroyInst>(I))
+    return DI->getOperand();
+  if (DeallocInst *DI = dyn_cast<DeallocInst>(I))
+    return DI->getOperand();
+  return nullptr;
+}
+
+namespace {
+
+/// MemoryToRegisters - Promotes all the promotable allocations of a function
+/// at once.
+class MemoryToRegisters {
+  Function &F;
+  DominanceInfo DT;
+
+  /// Allocs - The allocations being promoted.  They are referred to by their
+  /// index in this list below.
+  SmallVector<AllocVarInst*, 8> Allocs;
+  llvm::DenseMap<Value*, unsigned> AllocNumbers;
+
+  /// ZeroValues - The value of each allocation where it has not been
+  /// initialized, created on demand.
+  SmallVector<Value*, 8> ZeroValues;
+
+  /// BlockArgs - The arguments added to each block, and the allocation whose
+  /// value each of them carries.
+  typedef SmallVector<std::pair<unsigned, BBArgument*>, 2> BlockArgList;
+  llvm::DenseMap<BasicBlock*, BlockArgList> BlockArgs;
+
+  /// NewBranchArgs - The values that each branch to a block with new
+  /// arguments has to pass to them.
+  llvm::DenseMap<BranchInst*, SmallVector<Value*, 4>> NewBranchArgs;
+
+  /// Retains - The retains inserted for loads that copy a promoted value.
+  llvm::SmallPtrSet<RetainInst*, 16> Retains;
+
+  typedef SmallVector<Value*, 8> ValueList;
+
+  void placeBlockArgs(unsigned AllocNo);
+  void splitConditionalEdges();
+  Value *getZeroValue(unsigned AllocNo);
+  Value *getCurrentValue(unsigned AllocNo, const ValueList &Values) {
+    return Values[AllocNo] ? Values[AllocNo] : getZeroValue(AllocNo);
+  }
+  void renameBlock(BasicBlock *BB, ValueList &Values);
+  void rename();
+  void rewriteBranches();
+  void removeAllocs();
+  void removeRetainReleasePairs();
+
+public:
+  explicit MemoryToRegisters(Function &F) : F(F), DT(F) {}
+
+  bool run();
+};
+
+} // end anonymous namespace
+
+/// placeBlockArgs - Add an argument for the allocation to each block that is
+/// in the iterated dominance frontier of its stores and where its value is
+/// live on entry.
+void MemoryToRegisters::placeBlockArgs(unsigned AllocNo) {
+  AllocVarInst *AVI = Allocs[AllocNo];
+  BasicBlock *AllocBB = AVI->getParent();
+
+  // The allocation itself and every store define a new value.
+  llvm::SmallPtrSet<BasicBlock*, 16> DefBlocks;
+  SmallVector<BasicBlock*, 16> UseBlocks;
+  DefBlocks.insert(AllocBB);
+  for (auto UI = AVI->use_begin(), E = AVI->use_end(); UI != E; ++UI) {
+    BasicBlock *BB = UI.getUser()->getParent();
+    if (!DT.isReachable(BB))
+      continue;
+    if (isa<StoreInst>(UI.getUser()))
+      DefBlocks.insert(BB);
+    else if (!isa<DeallocInst>(UI.getUser()))
+      UseBlocks.push_back(BB);
+  }
+
+  // The variable is live into each block that uses it before defining it, and
+  // from there into every predecessor that does not define it.
+  llvm::SmallPtrSet<BasicBlock*, 16> LiveInBlocks;
+  SmallVector<BasicBlock*, 16> Worklist;
+  for (BasicBlock *BB : UseBlocks) {
+    if (DefBlocks.count(BB)) {
+      bool UsedFirst = false;
+      for (Instruction &I : *BB) {
+        if (&I == AVI)
+          break;
+        if (getAccessedAddress(&I) != AVI)
+          continue;
+        UsedFirst = !isa<StoreInst>(&I);
+        break;
+      }
+      if (!UsedFirst)
+        continue;
+    }
+    if (LiveInBlocks.insert(BB))
+      Worklist.push_back(BB);
+  }
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.pop_back_val();
+    for (auto PI = BB->pred_begin(), PE = BB->pred_end(); PI != PE; ++PI) {
+      BasicBlock *Pred = *PI;
+      if (DefBlocks.count(Pred) || !DT.isReachable(Pred))
+        continue;
+      if (LiveInBlocks.insert(Pred))
+        Worklist.push_back(Pred);
+    }
+  }
+
+  // Place arguments at the iterated dominance frontier.  Blocks that the
+  // allocation does not strictly dominate never see a value from it.
+  llvm::SmallPtrSet<BasicBlock*, 16> ArgBlocks;
+  Worklist.append(DefBlocks.begin(), DefBlocks.end());
+  // Visit the definitions in a deterministic order.
+  std::sort(Worklist.begin(), Worklist.end(),
+            [&](BasicBlock *A, BasicBlock *B) {
+    return DT.getRPONumber(A) < DT.getRPONumber(B);
+  });
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.pop_back_val();
+    for (BasicBlock *FrontierBB : DT.getDominanceFrontier(BB)) {
+      if (!LiveInBlocks.count(FrontierBB) ||
+          !DT.properlyDominates(AllocBB, FrontierBB) ||
+          !ArgBlocks.insert(FrontierBB))
+        continue;
+
+      Type Ty = AVI->getType()->getRValueType();
+      BBArgument *Arg = new (F) BBArgument(Ty, FrontierBB);
+      BlockArgs[FrontierBB].push_back(std::make_pair(AllocNo, Arg));
+      ++NumBBArgsInserted;
+
+      if (!DefBlocks.count(FrontierBB))
+        Worklist.push_back(FrontierBB);
+    }
+  }
+}
+
+/// splitConditionalEdges - Conditional branches cannot pass arguments, so
+/// give each conditional edge into a block with new arguments a block of its
+/// own that just branches on.
+void MemoryToRegisters::splitConditionalEdges() {
+  // Visit the blocks in order, so that the new blocks are laid out
+  // deterministically.
+  SmallVector<BasicBlock*, 8> DestBlocks;
+  for (BasicBlock &BB : F)
+    if (BlockArgs.count(&BB))
+      DestBlocks.push_back(&BB);
+
+  for (BasicBlock *DestBB : DestBlocks) {
+    SmallVector<CondBranchInst*, 4> CondBranches;
+    for (auto PI = DestBB->pred_begin(), PE = DestBB->pred_end(); PI != PE;
+         ++PI) {
+      TermInst *TI = (*PI)->getTerminator();
+      if (CondBranchInst *CBI = dyn_cast<CondBranchInst>(TI))
+        CondBranches.push_back(CBI);
+    }
+
+    for (CondBranchInst *CBI : CondBranches) {
+      // A branch with both edges to the block shows up as two predecessors.
+      if (CBI->getTrueBB() != DestBB && CBI->getFalseBB() != DestBB)
+        continue;
+
+      BasicBlock *EdgeBB = new (F) BasicBlock(&F);
+      SILBuilder(EdgeBB, F).createBranch(DestBB);
+
+      // Keep the new block next to the branch for readability.
+      Function::iterator InsertPt = CBI->getParent();
+      F.getBlocks().splice(++InsertPt, F.getBlocks(), EdgeBB);
+
+      if (CBI->getTrueBB() == DestBB)
+        CBI->setTrueBB(EdgeBB);
+      if (CBI->getFalseBB() == DestBB)
+        CBI->setFalseBB(EdgeBB);
+      ++NumEdgesSplit;
+    }
+  }
+}
+
+/// getZeroValue - Return the value that a load of uninitialized memory
+/// produces.  SILGen always initializes variables, so this is only needed
+/// for paths that never reach a use.
+Value *MemoryToRegisters::getZeroValue(unsigned AllocNo) {
+  if (!ZeroValues[AllocNo]) {
+    BasicBlock &Entry = *F.begin();
+    ZeroValues[AllocNo] =
+      SILBuilder(&Entry, Entry.begin(), F).createZeroValue(
+                                                  Allocs[AllocNo]->getDecl());
+  }
+  return ZeroValues[AllocNo];
+}
+
+/// renameBlock - Rewrite the accesses to the promoted allocations in the
+/// block in terms of the values they hold, given their values on entry.  On
+/// return, Values holds their values on exit.
+void MemoryToRegisters::renameBlock(BasicBlock *BB, ValueList &Values) {
+  auto ArgsI = BlockArgs.find(BB);
+  if (ArgsI != BlockArgs.end())
+    for (auto &Arg : ArgsI->second)
+      Values[Arg.first] = Arg.second;
+
+  for (auto II = BB->begin(), IE = BB->end(); II != IE; ) {
+    Instruction *I = &*II++;
+
+    if (AllocVarInst *AVI = dyn_cast<AllocVarInst>(I)) {
+      auto AllocI = AllocNumbers.find(AVI);
+      if (AllocI != AllocNumbers.end())
+        Values[AllocI->second] = nullptr;
+      continue;
+    }
+
+    Value *Address = getAccessedAddress(I);
+    if (!Address)
+      continue;
+    auto AllocI = AllocNumbers.find(Address);
+    if (AllocI == AllocNumbers.end())
+      continue;
+    unsigned AllocNo = AllocI->second;
+
+    if (LoadInst *LI = dyn_cast<LoadInst>(I)) {
+      if (LI->isTake()) {
+        LI->replaceAllUsesWith(getCurrentValue(AllocNo, Values));
+        Values[AllocNo] = nullptr;
+      } else if (Values[AllocNo]) {
+        // A copy leaves the value in memory, so it needs a reference of its
+        // own.
+        RetainInst *RI = SILBuilder(LI, F).createRetain(nullptr,
+                                                        Values[AllocNo]);
+        Retains.insert(RI);
+        LI->replaceAllUsesWith(RI);
+      } else {
+        LI->replaceAllUsesWith(getZeroValue(AllocNo));
+      }
+    } else if (StoreInst *SI = dyn_cast<StoreInst>(I)) {
+      // A reassignment releases the old value.
+      if (!SI->isInitialization() && Values[AllocNo])
+        SILBuilder(SI, F).createRelease(nullptr, Values[AllocNo]);
+      Values[AllocNo] = SI->getSrc();
+    } else if (isa<DestroyInst>(I)) {
+      if (Values[AllocNo])
+        SILBuilder(I, F).createRelease(nullptr, Values[AllocNo]);
+      Values[AllocNo] = nullptr;
+    }
+    // Deallocations just go away.
+    I->eraseFromParent();
+  }
+
+  // Pass the current values to the new arguments of the successor.
+  if (BranchInst *BI = dyn_cast<BranchInst>(BB->getTerminator())) {
+    auto DestArgsI = BlockArgs.find(BI->getDestBB());
+    if (DestArgsI != BlockArgs.end()) {
+      auto &NewArgs = NewBranchArgs[BI];
+      for (auto &Arg : DestArgsI->second)
+        NewArgs.push_back(getCurrentValue(Arg.first, Values));
+    }
+  }
+}
+
+/// rename - Rewrite every access to the promoted allocations, visiting the
+/// blocks in depth-first order from the entry block.
+void MemoryToRegisters::rename() {
+  llvm::SmallPtrSet<BasicBlock*, 32> Visited;
+  SmallVector<std::pair<BasicBlock*, ValueList>, 32> Worklist;
+
+  BasicBlock *Entry = &*F.begin();
+  Visited.insert(Entry);
+  Worklist.push_back(std::make_pair(Entry, ValueList(Allocs.size())));
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.back().first;
+    ValueList Values = std::move(Worklist.back().second);
+    Worklist.pop_back();
+
+    renameBlock(BB, Values);
+
+    for (const SILSuccessor &Succ : BB->getSuccs()) {
+      BasicBlock *SuccBB = Succ;
+      if (Visited.insert(SuccBB))
+        Worklist.push_back(std::make_pair(SuccBB, Values));
+    }
+  }
+}
+
+/// rewriteBranches - Replace each branch to a block with new arguments with
+/// one that passes them.
+void MemoryToRegisters::rewriteBranches() {
+  for (auto &Entry : NewBranchArgs) {
+    BranchInst *BI = Entry.first;
+    SmallVector<Value*, 8> Args;
+    for (Value *Arg : BI->getArgs())
+      Args.push_back(Arg);
+    Args.append(Entry.second.begin(), Entry.second.end());
+    SILBuilder(BI, F).createBranch(BI->getDestBB(), Args);
+    BI->eraseFromParent();
+  }
+}
+
+/// removeAllocs - Delete the promoted allocations, along with any accesses to
+/// them left in unreachable blocks.
+void MemoryToRegisters::removeAllocs() {
+  for (unsigned AllocNo = 0, e = Allocs.size(); AllocNo != e; ++AllocNo) {
+    AllocVarInst *AVI = Allocs[AllocNo];
+    while (!AVI->use_empty()) {
+      Instruction *User = AVI->use_begin().getUser();
+      if (!User->use_empty())
+        User->replaceAllUsesWith(getZeroValue(AllocNo));
+      User->eraseFromParent();
+    }
+    AVI->eraseFromParent();
+    ++NumAllocsPromoted;
+  }
+}
+
+/// getRetainedValue - Look through retains, which return their operand.
+static Value *getRetainedValue(Value *V) {
+  while (RetainInst *RI = dyn_cast<RetainInst>(V))
+    V = RI->getOperand();
+  return V;
+}
+
+/// mayObserveRetainCount - Return true if the instruction may release a
+/// reference or otherwise depend on the retain count of a value.
+static bool mayObserveRetainCount(Instruction *I) {
+  switch (I->getKind()) {
+  case ValueKind::ConstantRefInst:
+  case ValueKind::ZeroValueInst:
+  case ValueKind::IntegerLiteralInst:
+  case ValueKind::FloatLiteralInst:
+  case ValueKind::CharacterLiteralInst:
+  case ValueKind::StringLiteralInst:
+  case ValueKind::LoadInst:
+  case ValueKind::MetatypeInst:
+  case ValueKind::IntegerValueInst:
+  case ValueKind::RetainInst:
+    return false;
+  default:
+    return true;
+  }
+}
+
+/// removeRetainReleasePairs - Delete a retain inserted for a load when the
+/// same object is released later in the block, and nothing in between uses
+/// the object or can tell the difference.  The retain's users take over the
+/// reference the release would have dropped.
+void MemoryToRegisters::removeRetainReleasePairs() {
+  for (BasicBlock &BB : F) {
+    for (auto II = BB.begin(), IE = BB.end(); II != IE; ) {
+      ReleaseInst *RI = dyn_cast<ReleaseInst>(&*II++);
+      if (!RI)
+        continue;
+      Value *Object = getRetainedValue(RI->getOperand());
+
+      // Scan backwards for the matching retain.
+      for (auto PrevI = BasicBlock::iterator(RI); PrevI != BB.begin(); ) {
+        Instruction *Prev = &*--PrevI;
+        RetainInst *Retain = dyn_cast<RetainInst>(Prev);
+        if (Retain && Retains.count(Retain) &&
+            getRetainedValue(Retain) == Object) {
+          Retain->replaceAllUsesWith(Retain->getOperand());
+          Retains.erase(Retain);
+          Retain->eraseFromParent();
+          RI->eraseFromParent();
+          ++NumRetainReleasePairs;
+          break;
+        }
+        if (mayObserveRetainCount(Prev))
+          break;
+        bool UsesObject = false;
+        for (Operand &Op : Prev->getAllOperands())
+          UsesObject |= getRetainedValue(Op.get()) == Object;
+        if (UsesObject)
+          break;
+      }
+    }
+  }
+}
+
+bool MemoryToRegisters::run() {
+  if (F.empty())
+    return false;
+
+  for (BasicBlock &BB : F) {
+    if (!DT.isReachable(&BB))
+      continue;
+    for (Instruction &I : BB)
+      if (AllocVarInst *AVI = dyn_cast<AllocVarInst>(&I))
+        if (isPromotable(AVI)) {
+          AllocNumbers[AVI] = Allocs.size();
+          Allocs.push_back(AVI);
+        }
+  }
+  if (Allocs.empty())
+    return false;
+
+  ZeroValues.resize(Allocs.size());
+  for (unsigned AllocNo = 0, e = Allocs.size(); AllocNo != e; ++AllocNo)
+    placeBlockArgs(AllocNo);
+
+  splitConditionalEdges();
+  rename();
+  rewriteBranches();
+  removeAllocs();
+  removeRetainReleasePairs();
+  return true;
+}
+
+namespace {
+class SILMem2Reg : public SILFunctionPass {
+public:
+  SILMem2Reg() : SILFunctionPass("mem2reg") {}
+
+  virtual bool runOnFunction(Function &F) {
+    return MemoryToRegisters(F).run();
+  }
+};
+} // end anonymous namespace
+
+SILFunctionPass *swift::createSILMem2RegPass() {
+  return new SILMem2Reg();
+}
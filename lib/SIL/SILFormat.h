@@ -0,0 +1,98 @@
+//===--- SILFormat.h - The In-Process SIL Encoding --------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the block and record codes of the binary SIL encoding,
+// which is an LLVM bitstream.  The stream starts with a signature and holds one
+// FUNCTION_BLOCK per function.  Types and locations are indexes into the
+// SILSerializationTable of the writer, so the stream is only meaningful to
+// the process that wrote it.
+//
+// Within a function, the values are numbered in the order the reader creates
+// them: first the arguments of every block, in block order, and then the
+// instructions, in the order of their records.  Instruction records are
+// written block by block in reverse post-order, so that the definition of an
+// operand almost always precedes its uses; the rare forward reference (in
+// unreachable code) is announced by a FORWARD_REF record.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_SILFORMAT_H
+#define SWIFT_SIL_SILFORMAT_H
+
+#include "swift/SIL/Value.h"
+#include "llvm/Bitcode/BitCodes.h"
+
+namespace swift {
+namespace sil_format {
+
+/// Signature - The bytes that every binary SIL stream starts with.
+const unsigned char Signature[] = { 'S', 'I', 'L', 'B' };
+
+/// VersionNumber - The version of the format.  Instruction record codes are
+/// derived from ValueKind, so this must be bumped whenever SILNodes.def
+/// changes.
+const unsigned VersionNumber = 1;
+
+/// The width of the abbreviation IDs in a FUNCTION_BLOCK.
+const unsigned FunctionBlockAbbrevWidth = 4;
+
+enum BlockID {
+  FUNCTION_BLOCK_ID = llvm::bitc::FIRST_APPLICATION_BLOCKID
+};
+
+enum RecordCode {
+  /// FUNCTION_HEADER: [version, number of blocks, number of values]
+  FUNCTION_HEADER = 1,
+
+  /// BASIC_BLOCK: [type of each argument...]
+  /// One per block, in block order, before any instruction record.
+  BASIC_BLOCK = 2,
+
+  /// INSERT_BLOCK: [block number]
+  /// The following instructions are appended to the given block.
+  INSERT_BLOCK = 3,
+
+  /// FORWARD_REF: [value number, type]
+  /// The value is used before the record that defines it.
+  FORWARD_REF = 4,
+
+  /// The record code of an instruction is FIRST_INSTRUCTION plus its
+  /// ValueKind.  The record is [location, type, fields..., operands...],
+  /// where the fields depend on the kind of instruction and the operands are
+  /// value numbers.
+  FIRST_INSTRUCTION = 16
+};
+
+/// getNumInstructionFields - Return the number of fields in the record of an
+/// instruction of the given kind, between its type and its operands.
+inline unsigned getNumInstructionFields(ValueKind Kind) {
+  switch (Kind) {
+  case ValueKind::AllocArrayInst:   // element type
+  case ValueKind::LoadInst:         // is take
+  case ValueKind::StoreInst:        // is initialization
+  case ValueKind::TupleElementInst: // field number
+  case ValueKind::IndexLValueInst:  // index
+  case ValueKind::IntegerValueInst: // value
+  case ValueKind::BranchInst:       // destination block
+    return 1;
+  case ValueKind::CopyInst:         // is take of source, is initialization
+  case ValueKind::CondBranchInst:   // true block, false block
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+} // end sil_format namespace
+} // end swift namespace
+
+#endif
@@ -11,7 +11,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "SILGen.h"
+#include "Scope.h"
 #include "swift/AST/AST.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 using namespace swift;
 using namespace Lowering;
 
@@ -36,6 +42,10 @@ SILGen::SILGen(Function &F, FuncExpr *FE)
   emitProlog(FE);
 }
 
+SILGen::SILGen(Function &F)
+  : F(F), B(new (F) BasicBlock(&F), F), Cleanups(*this), hasVoidReturn(true) {
+}
+
 /// SILGen destructor - called when the entire AST has been visited.  This
 /// handles "falling off the end of the function" logic.
 SILGen::~SILGen() {
@@ -64,4 +74,87 @@ Function *Function::constructSIL(FuncExpr *FE) {
   return C;
 }
 
+Function *Function::constructTopLevelSIL(TranslationUnit *TU,
+                                         unsigned StartElem) {
+  ArrayRef<Decl*> Decls = ArrayRef<Decl*>(TU->Decls).slice(StartElem);
+  auto IsTopLevelCode = [](Decl *D) {
+    return isa<PatternBindingDecl>(D) || isa<TopLevelCodeDecl>(D);
+  };
+  if (std::none_of(Decls.begin(), Decls.end(), IsTopLevelCode))
+    return nullptr;
+
+  Function *C = new Function(TU->getASTContext());
+  {
+    SILGen Gen(*C);
+    for (Decl *D : Decls) {
+      // Stop emitting once the code becomes unreachable.
+      if (!Gen.B.hasValidInsertionPoint())
+        break;
 
+      // Global variables live for the rest of the program, so the cleanups
+      // pushed for them are never emitted.
+      if (PatternBindingDecl *PBD = dyn_cast<PatternBindingDecl>(D)) {
+        Gen.visitPatternBindingDecl(PBD);
+        continue;
+      }
+
+      TopLevelCodeDecl *TLCD = dyn_cast<TopLevelCodeDecl>(D);
+      if (!TLCD)
+        continue;
+      if (Expr *E = TLCD->getBody().dyn_cast<Expr*>()) {
+        FullExpr Scope(Gen.Cleanups);
+        Gen.visit(E);
+      } else if (Stmt *S = TLCD->getBody().dyn_cast<Stmt*>()) {
+        Gen.visit(S);
+      }
+    }
+  }
+
+  C->verify();
+  return C;
+}
+
+SILModule *SILModule::constructSIL(TranslationUnit *TU, unsigned StartElem,
+                                   unsigned NumThreads) {
+  SILModule *M = new SILModule(TU);
+  for (Decl *D : ArrayRef<Decl*>(TU->Decls).slice(StartElem)) {
+    FuncDecl *FD = dyn_cast<FuncDecl>(D);
+    if (!FD || !FD->getBody() || !FD->getBody()->getBody())
+      continue;
+    M->FunctionIndex[FD] = M->Functions.size();
+    M->Functions.push_back({ FD, nullptr });
+  }
+
+  // Each Function allocates from its own arena, and the only state SILGen
+  // shares between functions is the ASTContext's type uniquing, which locks
+  // in multithreaded mode.  That lets the bodies be emitted concurrently.
+  if (NumThreads == 0)
+    NumThreads = std::max(std::thread::hardware_concurrency(), 1U);
+  NumThreads = std::min<size_t>(NumThreads, M->Functions.size());
+  if (NumThreads > 1 && !llvm::llvm_is_multithreaded() &&
+      !llvm::llvm_start_multithreaded())
+    NumThreads = 1;
+
+  // Threads claim functions in declaration order until none are left.
+  std::atomic<unsigned> NextFunction(0);
+  auto EmitFunctions = [&] {
+    for (unsigned i = NextFunction++, e = M->Functions.size(); i < e;
+         i = NextFunction++) {
+      FuncDecl *FD = M->Functions[i].first;
+      M->Functions[i].second = Function::constructSIL(FD->getBody());
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (unsigned i = 1; i < NumThreads; ++i)
+    Threads.push_back(std::thread(EmitFunctions));
+
+  // The top-level code is emitted on this thread while the others start on
+  // the functions.
+  M->TopLevelCode = Function::constructTopLevelSIL(TU, StartElem);
+  EmitFunctions();
+
+  for (std::thread &T : Threads)
+    T.join();
+  return M;
+}
@@ -50,6 +50,10 @@ public:
     
 public:
   SILGen(Function &F, FuncExpr *FE);
+
+  /// Construct a SILGen for top-level code, which takes no arguments and
+  /// returns nothing.
+  explicit SILGen(Function &F);
   ~SILGen();
 
   void emitProlog(FuncExpr *FE);
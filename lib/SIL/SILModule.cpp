@@ -0,0 +1,52 @@
+//===--- SILModule.cpp - Defines the SILModule class ----------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/SIL/SILModule.h"
+#include "swift/AST/Decl.h"
+#include "swift/SIL/Function.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace swift;
+
+SILModule::~SILModule() {
+  for (auto &Entry : Functions)
+    delete Entry.second;
+  delete TopLevelCode;
+}
+
+Function *SILModule::getFunction(FuncDecl *FD) const {
+  auto Found = FunctionIndex.find(FD);
+  if (Found == FunctionIndex.end())
+    return nullptr;
+  return Functions[Found->second].second;
+}
+
+void SILModule::verify() const {
+  for (auto &Entry : Functions)
+    Entry.second->verify();
+  if (TopLevelCode)
+    TopLevelCode->verify();
+}
+
+void SILModule::dump() const {
+  print(llvm::errs());
+}
+
+void SILModule::print(raw_ostream &OS) const {
+  for (auto &Entry : Functions) {
+    OS << "func_decl " << Entry.first->getName() << '\n';
+    Entry.second->print(OS);
+  }
+  if (TopLevelCode) {
+    OS << "top_level_code\n";
+    TopLevelCode->print(OS);
+  }
+}
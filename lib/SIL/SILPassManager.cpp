@@ -0,0 +1,88 @@
+//===--- SILPassManager.cpp - Running Passes over SIL ---------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the SILPassManager class.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-passmanager"
+#include "swift/SIL/SILPassManager.h"
+#include "swift/SIL/Function.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace swift;
+
+STATISTIC(NumPassesRun, "Number of SIL passes run over a function");
+STATISTIC(NumPassesChanged, "Number of SIL passes that changed a function");
+
+SILFunctionPass::~SILFunctionPass() {}
+
+SILPassManager::SILPassManager(const Options &Opts) : Opts(Opts) {
+  if (Opts.TimePasses)
+    Timers.reset(new llvm::TimerGroup("SIL Passes"));
+}
+
+SILPassManager::~SILPassManager() {
+  for (PassEntry &Entry : Passes) {
+    delete Entry.Timer;
+    delete Entry.Pass;
+  }
+  // Destroying the timer group prints its report.
+}
+
+void SILPassManager::add(SILFunctionPass *P) {
+  PassEntry Entry = { P, nullptr, 0, 0 };
+  if (Timers)
+    Entry.Timer = new llvm::Timer(P->getName(), *Timers);
+  Passes.push_back(Entry);
+}
+
+bool SILPassManager::run(Function &F) {
+  bool Changed = false;
+  for (PassEntry &Entry : Passes) {
+    bool PassChanged;
+    {
+      llvm::TimeRegion Region(Entry.Timer);
+      PassChanged = Entry.Pass->runOnFunction(F);
+    }
+
+    ++Entry.NumRuns;
+    ++NumPassesRun;
+    if (!PassChanged)
+      continue;
+
+    ++Entry.NumChanged;
+    ++NumPassesChanged;
+    Changed = true;
+
+    if (Opts.PrintAfterEachPass) {
+      llvm::errs() << "*** SIL function after " << Entry.Pass->getName()
+                   << " ***\n";
+      F.print(llvm::errs());
+    }
+    if (Opts.VerifyAfterEachPass)
+      F.verify();
+  }
+  return Changed;
+}
+
+void SILPassManager::printStatistics(raw_ostream &OS) const {
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                          SIL pass statistics\n"
+     << "===" << std::string(73, '-') << "===\n\n"
+     << "   Runs  Changed  Pass\n";
+  for (const PassEntry &Entry : Passes)
+    OS << llvm::format("%7u  %7u  ", Entry.NumRuns, Entry.NumChanged)
+       << Entry.Pass->getName() << '\n';
+}
@@ -226,6 +226,18 @@ public:
 
   void visitBranchInst(BranchInst *UBI) {
     OS << "br " << getID(UBI->getDestBB());
+    if (!UBI->getArgs().empty()) {
+      OS << '(';
+      bool first = true;
+      for (auto Arg : UBI->getArgs()) {
+        if (first)
+          first = false;
+        else
+          OS << ", ";
+        OS << getID(Arg);
+      }
+      OS << ')';
+    }
   }
 
   void visitCondBranchInst(CondBranchInst *CBI) {
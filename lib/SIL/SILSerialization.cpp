@@ -0,0 +1,695 @@
+//===--- SILSerialization.cpp - In-Process SIL Cache ----------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements caching SIL Functions in the binary SIL encoding and
+// reading them back in the same process.  The layout of the stream is
+// described in SILFormat.h.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-serialization"
+#include "swift/SIL/SILSerialization.h"
+#include "SILFormat.h"
+#include "swift/AST/AST.h"
+#include "swift/SIL/BBArgument.h"
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/Function.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Bitcode/BitstreamReader.h"
+#include "llvm/Bitcode/BitstreamWriter.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace swift;
+using namespace sil_format;
+
+STATISTIC(NumFunctionsWritten, "Number of SIL functions serialized");
+STATISTIC(NumFunctionsRead, "Number of SIL functions deserialized");
+STATISTIC(NumForwardRefs, "Number of forward references in serialized SIL");
+
+//===----------------------------------------------------------------------===//
+// SILSerializationTable Implementation
+//===----------------------------------------------------------------------===//
+
+SILSerializationTable::SILSerializationTable() {
+  Types.push_back(nullptr);
+  Locations.push_back(SILLocation());
+}
+
+unsigned SILSerializationTable::getTypeID(Type Ty) {
+  if (Ty.isNull())
+    return 0;
+
+  unsigned &ID = TypeIDs[Ty.getPointer()];
+  if (ID == 0) {
+    ID = Types.size();
+    Types.push_back(Ty.getPointer());
+  }
+  return ID;
+}
+
+unsigned SILSerializationTable::getLocationID(SILLocation Loc) {
+  if (Loc.isNull())
+    return 0;
+
+  unsigned &ID = LocationIDs[Loc.getOpaqueValue()];
+  if (ID == 0) {
+    ID = Locations.size();
+    Locations.push_back(Loc);
+  }
+  return ID;
+}
+
+//===----------------------------------------------------------------------===//
+// Writer
+//===----------------------------------------------------------------------===//
+
+namespace {
+  class SILWriter {
+    SILSerializationTable &Table;
+    llvm::BitstreamWriter &Out;
+
+    /// ValueIDs/BlockIDs - The numbering of the function being written.
+    llvm::DenseMap<const Value*, unsigned> ValueIDs;
+    llvm::DenseMap<const BasicBlock*, unsigned> BlockIDs;
+
+    SmallVector<uint64_t, 16> Record;
+
+  public:
+    SILWriter(SILSerializationTable &Table, llvm::BitstreamWriter &Out)
+      : Table(Table), Out(Out) {}
+
+    void writeFunction(const Function &F);
+
+  private:
+    void writeInstruction(const Instruction &I);
+  };
+}
+
+void SILWriter::writeFunction(const Function &F) {
+  // Number the blocks and their arguments in function order.
+  unsigned NumBlocks = 0, NumValues = 0;
+  for (const BasicBlock &BB : F) {
+    BlockIDs[&BB] = NumBlocks++;
+    for (auto AI = BB.bbarg_begin(), E = BB.bbarg_end(); AI != E; ++AI)
+      ValueIDs[*AI] = NumValues++;
+  }
+
+  // Write the reachable blocks in reverse post-order, so that every operand
+  // is defined before it is used, followed by the unreachable blocks.
+  DominanceInfo DI(const_cast<Function&>(F));
+  SmallVector<const BasicBlock*, 32> Order;
+  for (BasicBlock *BB : DI.getReversePostOrder())
+    Order.push_back(BB);
+  for (const BasicBlock &BB : F)
+    if (!DI.isReachable(&BB))
+      Order.push_back(&BB);
+
+  unsigned NextValueID = NumValues;
+  for (const BasicBlock *BB : Order)
+    for (const Instruction &I : *BB)
+      ValueIDs[&I] = NumValues++;
+
+  Out.EnterSubblock(FUNCTION_BLOCK_ID, FunctionBlockAbbrevWidth);
+
+  Record.clear();
+  Record.push_back(VersionNumber);
+  Record.push_back(NumBlocks);
+  Record.push_back(NumValues);
+  Out.EmitRecord(FUNCTION_HEADER, Record);
+
+  for (const BasicBlock &BB : F) {
+    Record.clear();
+    for (auto AI = BB.bbarg_begin(), E = BB.bbarg_end(); AI != E; ++AI)
+      Record.push_back(Table.getTypeID((*AI)->getType()));
+    Out.EmitRecord(BASIC_BLOCK, Record);
+  }
+
+  llvm::SmallPtrSet<const Value*, 4> ForwardRefs;
+  for (const BasicBlock *BB : Order) {
+    Record.clear();
+    Record.push_back(BlockIDs[BB]);
+    Out.EmitRecord(INSERT_BLOCK, Record);
+
+    for (const Instruction &I : *BB) {
+      // Announce operands that are only defined further down the stream.
+      for (const Operand &Op : I.getAllOperands()) {
+        assert(ValueIDs.count(Op.get()) && "Operand from another function");
+        unsigned ID = ValueIDs[Op.get()];
+        if (ID < NextValueID || !ForwardRefs.insert(Op.get()))
+          continue;
+        Record.clear();
+        Record.push_back(ID);
+        Record.push_back(Table.getTypeID(Op.get()->getType()));
+        Out.EmitRecord(FORWARD_REF, Record);
+        ++NumForwardRefs;
+      }
+
+      writeInstruction(I);
+      ++NextValueID;
+    }
+  }
+
+  Out.ExitBlock();
+  ValueIDs.clear();
+  BlockIDs.clear();
+  ++NumFunctionsWritten;
+}
+
+void SILWriter::writeInstruction(const Instruction &I) {
+  Record.clear();
+  Record.push_back(Table.getLocationID(I.getLoc()));
+  Record.push_back(Table.getTypeID(I.getType()));
+
+  switch (I.getKind()) {
+  case ValueKind::AllocArrayInst:
+    Record.push_back(
+      Table.getTypeID(cast<AllocArrayInst>(I).getElementType()));
+    break;
+  case ValueKind::LoadInst:
+    Record.push_back(cast<LoadInst>(I).isTake());
+    break;
+  case ValueKind::StoreInst:
+    Record.push_back(cast<StoreInst>(I).isInitialization());
+    break;
+  case ValueKind::CopyInst:
+    Record.push_back(cast<CopyInst>(I).isTakeOfSrc());
+    Record.push_back(cast<CopyInst>(I).isInitializationOfDest());
+    break;
+  case ValueKind::TupleElementInst:
+    Record.push_back(cast<TupleElementInst>(I).getFieldNo());
+    break;
+  case ValueKind::IndexLValueInst:
+    Record.push_back(cast<IndexLValueInst>(I).getIndex());
+    break;
+  case ValueKind::IntegerValueInst:
+    Record.push_back(cast<IntegerValueInst>(I).getValue());
+    break;
+  case ValueKind::BranchInst:
+    Record.push_back(BlockIDs[cast<BranchInst>(I).getDestBB()]);
+    break;
+  case ValueKind::CondBranchInst:
+    Record.push_back(BlockIDs[cast<CondBranchInst>(I).getTrueBB()]);
+    Record.push_back(BlockIDs[cast<CondBranchInst>(I).getFalseBB()]);
+    break;
+  default:
+    break;
+  }
+  assert(Record.size() == 2 + getNumInstructionFields(I.getKind()) &&
+         "Instruction fields out of sync with SILFormat.h");
+
+  for (const Operand &Op : I.getAllOperands())
+    Record.push_back(ValueIDs[Op.get()]);
+
+  Out.EmitRecord(FIRST_INSTRUCTION + unsigned(I.getKind()), Record);
+}
+
+void swift::writeSIL(ArrayRef<const Function*> Functions,
+                     SILSerializationTable &Table, raw_ostream &OS) {
+  SmallVector<char, 4096> Buffer;
+  {
+    llvm::BitstreamWriter Out(Buffer);
+    for (unsigned char C : Signature)
+      Out.Emit(C, 8);
+
+    SILWriter Writer(Table, Out);
+    for (const Function *F : Functions)
+      Writer.writeFunction(*F);
+  }
+  OS.write(Buffer.data(), Buffer.size());
+}
+
+//===----------------------------------------------------------------------===//
+// Reader
+//===----------------------------------------------------------------------===//
+
+template<typename T>
+static T *getLocExpr(SILLocation Loc) {
+  return dyn_cast_or_null<T>(Loc.dyn_cast<Expr*>());
+}
+
+template<typename T>
+static T *getLocStmt(SILLocation Loc) {
+  return dyn_cast_or_null<T>(Loc.dyn_cast<Stmt*>());
+}
+
+template<typename T>
+static T *getLocDecl(SILLocation Loc) {
+  return dyn_cast_or_null<T>(Loc.dyn_cast<Decl*>());
+}
+
+namespace {
+  /// FunctionReader - Decodes the records of one FUNCTION_BLOCK into a
+  /// Function.  Every read method returns false if the input is malformed.
+  class FunctionReader {
+    const SILSerializationTable &Table;
+    llvm::BitstreamCursor &Cursor;
+    Function &F;
+
+    bool HaveHeader = false;
+    unsigned NumBlocks = 0;
+    std::vector<BasicBlock*> Blocks;
+
+    /// Values - Every value of the function, by number.  A slot past
+    /// NextValueID holds a placeholder if the value was forward referenced.
+    std::vector<Value*> Values;
+    unsigned NextValueID = 0;
+
+    /// CurBB - The block instructions are appended to.
+    BasicBlock *CurBB = nullptr;
+
+    SmallVector<uint64_t, 16> Record;
+
+  public:
+    FunctionReader(const SILSerializationTable &Table,
+                   llvm::BitstreamCursor &Cursor, Function &F)
+      : Table(Table), Cursor(Cursor), F(F) {}
+
+    bool read();
+
+  private:
+    bool readRecord(unsigned Code);
+    bool readInstruction(ValueKind Kind);
+    Instruction *createInstruction(ValueKind Kind, SILLocation Loc, Type Ty,
+                                   ArrayRef<uint64_t> Fields,
+                                   ArrayRef<Value*> Ops);
+    bool finish();
+
+    Type getType(uint64_t ID) const {
+      if (ID >= Table.getNumTypes())
+        return Type();
+      return Table.getType(ID);
+    }
+
+    BasicBlock *getBlock(uint64_t ID) const {
+      return ID < Blocks.size() ? Blocks[ID] : nullptr;
+    }
+
+    Value *getValue(uint64_t ID) const {
+      return ID < Values.size() ? Values[ID] : nullptr;
+    }
+  };
+}
+
+bool FunctionReader::read() {
+  while (!Cursor.AtEndOfStream()) {
+    unsigned Code = Cursor.ReadCode();
+    switch (Code) {
+    case llvm::bitc::END_BLOCK:
+      if (Cursor.ReadBlockEnd())
+        return false;
+      return finish();
+
+    case llvm::bitc::ENTER_SUBBLOCK:
+      // No nested blocks are defined yet; skip them.
+      Cursor.ReadSubBlockID();
+      if (Cursor.SkipBlock())
+        return false;
+      break;
+
+    case llvm::bitc::DEFINE_ABBREV:
+      Cursor.ReadAbbrevRecord();
+      break;
+
+    default:
+      Record.clear();
+      if (!readRecord(Cursor.ReadRecord(Code, Record)))
+        return false;
+      break;
+    }
+  }
+  return false;
+}
+
+bool FunctionReader::readRecord(unsigned Code) {
+  switch (Code) {
+  case FUNCTION_HEADER:
+    if (HaveHeader || Record.size() != 3 || Record[0] != VersionNumber)
+      return false;
+    HaveHeader = true;
+    NumBlocks = Record[1];
+    Values.resize(Record[2]);
+    return true;
+
+  case BASIC_BLOCK: {
+    if (!HaveHeader || Blocks.size() == NumBlocks)
+      return false;
+    BasicBlock *BB = new (F) BasicBlock(&F);
+    Blocks.push_back(BB);
+    for (uint64_t TypeID : Record) {
+      Type Ty = getType(TypeID);
+      if (!Ty || NextValueID == Values.size())
+        return false;
+      Values[NextValueID++] = new (F) BBArgument(Ty, BB);
+    }
+    return true;
+  }
+
+  case INSERT_BLOCK:
+    // All the blocks and their arguments come before any instruction.
+    if (!HaveHeader || Blocks.size() != NumBlocks || Record.size() != 1)
+      return false;
+    CurBB = getBlock(Record[0]);
+    return CurBB != nullptr;
+
+  case FORWARD_REF: {
+    if (Record.size() != 2 || Record[0] < NextValueID ||
+        Record[0] >= Values.size())
+      return false;
+    Type Ty = getType(Record[1]);
+    if (!Ty)
+      return false;
+    // The placeholder is replaced when the value is read.
+    if (!Values[Record[0]])
+      Values[Record[0]] = new (F) IntegerValueInst(0, Ty);
+    return true;
+  }
+
+  default:
+    if (Code < FIRST_INSTRUCTION)
+      return false;
+    Code -= FIRST_INSTRUCTION;
+    if (Code < unsigned(ValueKind::First_Instruction) ||
+        Code > unsigned(ValueKind::Last_Instruction))
+      return false;
+    return readInstruction(ValueKind(Code));
+  }
+}
+
+bool FunctionReader::readInstruction(ValueKind Kind) {
+  if (!CurBB || NextValueID == Values.size())
+    return false;
+
+  // Nothing may follow a terminator.
+  if (!CurBB->empty() && isa<TermInst>(CurBB->getInsts().back()))
+    return false;
+
+  unsigned NumFields = getNumInstructionFields(Kind);
+  if (Record.size() < 2 + NumFields || Record[0] >= Table.getNumLocations())
+    return false;
+  SILLocation Loc = Table.getLocation(Record[0]);
+  Type Ty = getType(Record[1]);
+  if (!Ty)
+    return false;
+
+  ArrayRef<uint64_t> Fields = makeArrayRef(Record).slice(2, NumFields);
+  SmallVector<Value*, 4> Ops;
+  for (uint64_t ID : makeArrayRef(Record).slice(2 + NumFields)) {
+    Value *V = getValue(ID);
+    if (!V)
+      return false;
+    Ops.push_back(V);
+  }
+
+  Instruction *I = createInstruction(Kind, Loc, Ty, Fields, Ops);
+  if (!I || !I->getType()->isEqual(Ty))
+    return false;
+  CurBB->getInsts().push_back(I);
+
+  Value *&Slot = Values[NextValueID++];
+  if (Slot) {
+    // Resolve the forward reference to this instruction.
+    if (!Slot->getType()->isEqual(Ty))
+      return false;
+    Slot->replaceAllUsesWith(I);
+  }
+  Slot = I;
+  return true;
+}
+
+/// createInstruction - Rebuild an instruction through the constructor that
+/// produced it, which is determined by the kind of its location.
+Instruction *FunctionReader::createInstruction(ValueKind Kind,
+                                               SILLocation Loc, Type Ty,
+                                               ArrayRef<uint64_t> Fields,
+                                               ArrayRef<Value*> Ops) {
+  // Most instructions are located at an expression, if anywhere.
+  bool HasExprLoc = Loc.isNull() || Loc.is<Expr*>();
+  Expr *E = Loc.dyn_cast<Expr*>();
+
+  switch (Kind) {
+  case ValueKind::AllocVarInst:
+    if (VarDecl *VD = getLocDecl<VarDecl>(Loc))
+      if (Ops.empty())
+        return new AllocVarInst(VD);
+    return nullptr;
+
+  case ValueKind::AllocTmpInst:
+    if (MaterializeExpr *ME = getLocExpr<MaterializeExpr>(Loc))
+      if (Ops.empty())
+        return new AllocTmpInst(ME);
+    return nullptr;
+
+  case ValueKind::AllocArrayInst: {
+    Type ElementType = getType(Fields[0]);
+    if (!HasExprLoc || !ElementType || Ops.size() != 1)
+      return nullptr;
+    return new AllocArrayInst(E, ElementType, Ops[0]);
+  }
+
+  case ValueKind::ApplyInst: {
+    if (Ops.empty() || !Ops[0]->getType()->is<FunctionType>())
+      return nullptr;
+    if (ApplyExpr *AE = getLocExpr<ApplyExpr>(Loc)) {
+      Type ResTy = Ops[0]->getType()->castTo<FunctionType>()->getResult();
+      if (!ResTy->isEqual(AE->getType()))
+        return nullptr;
+      return ApplyInst::create(AE, Ops[0], Ops.slice(1), F);
+    }
+    if (!Loc.isNull())
+      return nullptr;
+    return ApplyInst::create(Ops[0], Ops.slice(1), F);
+  }
+
+  case ValueKind::ConstantRefInst:
+    if (DeclRefExpr *DRE = getLocExpr<DeclRefExpr>(Loc))
+      if (Ops.empty())
+        return new ConstantRefInst(DRE);
+    return nullptr;
+
+  case ValueKind::ZeroValueInst:
+    if (VarDecl *VD = getLocDecl<VarDecl>(Loc))
+      if (Ops.empty())
+        return new ZeroValueInst(VD);
+    return nullptr;
+
+  case ValueKind::IntegerLiteralInst:
+    if (IntegerLiteralExpr *ILE = getLocExpr<IntegerLiteralExpr>(Loc))
+      if (Ops.empty())
+        return new IntegerLiteralInst(ILE);
+    return nullptr;
+
+  case ValueKind::FloatLiteralInst:
+    if (FloatLiteralExpr *FLE = getLocExpr<FloatLiteralExpr>(Loc))
+      if (Ops.empty())
+        return new FloatLiteralInst(FLE);
+    return nullptr;
+
+  case ValueKind::CharacterLiteralInst:
+    if (CharacterLiteralExpr *CLE = getLocExpr<CharacterLiteralExpr>(Loc))
+      if (Ops.empty())
+        return new CharacterLiteralInst(CLE);
+    return nullptr;
+
+  case ValueKind::StringLiteralInst:
+    if (StringLiteralExpr *SLE = getLocExpr<StringLiteralExpr>(Loc))
+      if (Ops.empty())
+        return new StringLiteralInst(SLE);
+    return nullptr;
+
+  case ValueKind::LoadInst:
+    if (LoadExpr *LE = getLocExpr<LoadExpr>(Loc))
+      if (Ops.size() == 1)
+        return new LoadInst(LE, Ops[0], Fields[0]);
+    return nullptr;
+
+  case ValueKind::StoreInst: {
+    if (Ops.size() != 2)
+      return nullptr;
+    bool IsInit = Fields[0];
+    if (AssignStmt *AS = getLocStmt<AssignStmt>(Loc))
+      return IsInit ? nullptr : new StoreInst(AS, Ops[0], Ops[1]);
+    if (VarDecl *VD = getLocDecl<VarDecl>(Loc))
+      return IsInit ? new StoreInst(VD, Ops[0], Ops[1]) : nullptr;
+    if (!HasExprLoc)
+      return nullptr;
+    return new StoreInst(E, IsInit, Ops[0], Ops[1]);
+  }
+
+  case ValueKind::CopyInst:
+    if (!HasExprLoc || Ops.size() != 2)
+      return nullptr;
+    return new CopyInst(E, Ops[0], Ops[1], Fields[0], Fields[1]);
+
+  case ValueKind::SpecializeInst:
+    if (SpecializeExpr *SE = getLocExpr<SpecializeExpr>(Loc))
+      if (Ops.size() == 1)
+        return new SpecializeInst(SE, Ops[0], Ty);
+    return nullptr;
+
+  case ValueKind::TypeConversionInst:
+    if (Ops.size() != 1)
+      return nullptr;
+    if (auto *ICE = getLocExpr<ImplicitConversionExpr>(Loc))
+      return new TypeConversionInst(ICE, Ops[0]);
+    if (!Loc.isNull())
+      return nullptr;
+    return new TypeConversionInst(Ty, Ops[0]);
+
+  case ValueKind::TupleInst:
+    if (E)
+      return TupleInst::create(E, Ops, F);
+    if (!Loc.isNull())
+      return nullptr;
+    return TupleInst::create(Ty, Ops, F);
+
+  case ValueKind::MetatypeInst:
+    if (MetatypeExpr *ME = getLocExpr<MetatypeExpr>(Loc))
+      if (Ops.empty())
+        return new MetatypeInst(ME);
+    return nullptr;
+
+  case ValueKind::TupleElementInst:
+    if (Ops.size() != 1)
+      return nullptr;
+    if (TupleElementExpr *TEE = getLocExpr<TupleElementExpr>(Loc))
+      return new TupleElementInst(TEE, Ops[0], Fields[0]);
+    if (!Loc.isNull())
+      return nullptr;
+    return new TupleElementInst(Ty, Ops[0], Fields[0]);
+
+  case ValueKind::RetainInst:
+    if (!HasExprLoc || Ops.size() != 1)
+      return nullptr;
+    return new RetainInst(E, Ops[0]);
+
+  case ValueKind::ReleaseInst:
+    if (!HasExprLoc || Ops.size() != 1)
+      return nullptr;
+    return new ReleaseInst(E, Ops[0]);
+
+  case ValueKind::DeallocInst:
+    if (!HasExprLoc || Ops.size() != 1)
+      return nullptr;
+    return new DeallocInst(E, Ops[0]);
+
+  case ValueKind::DestroyInst:
+    if (!HasExprLoc || Ops.size() != 1)
+      return nullptr;
+    return new DestroyInst(E, Ops[0]);
+
+  case ValueKind::IndexLValueInst:
+    if (!HasExprLoc || Ops.size() != 1)
+      return nullptr;
+    return new IndexLValueInst(E, Ops[0], Fields[0]);
+
+  case ValueKind::IntegerValueInst:
+    if (!Loc.isNull() || !Ops.empty())
+      return nullptr;
+    return new IntegerValueInst(Fields[0], Ty);
+
+  case ValueKind::UnreachableInst:
+    if (!Loc.isNull() || !Ops.empty())
+      return nullptr;
+    return new UnreachableInst(F);
+
+  case ValueKind::ReturnInst:
+    if (!(Loc.isNull() || getLocStmt<ReturnStmt>(Loc)) || Ops.size() != 1)
+      return nullptr;
+    return new ReturnInst(getLocStmt<ReturnStmt>(Loc), Ops[0]);
+
+  case ValueKind::BranchInst: {
+    BasicBlock *DestBB = getBlock(Fields[0]);
+    if (!DestBB || !Loc.isNull())
+      return nullptr;
+    return BranchInst::create(DestBB, Ops, F);
+  }
+
+  case ValueKind::CondBranchInst: {
+    BasicBlock *TrueBB = getBlock(Fields[0]);
+    BasicBlock *FalseBB = getBlock(Fields[1]);
+    if (!TrueBB || !FalseBB || Ops.size() != 1 ||
+        !(Loc.isNull() || Loc.is<Stmt*>()))
+      return nullptr;
+    return new CondBranchInst(Loc.dyn_cast<Stmt*>(), Ops[0], TrueBB, FalseBB);
+  }
+
+  case ValueKind::BBArgument:
+    break;
+  }
+  return nullptr;
+}
+
+bool FunctionReader::finish() {
+  if (!HaveHeader || Blocks.size() != NumBlocks ||
+      NextValueID != Values.size())
+    return false;
+
+  for (BasicBlock *BB : Blocks)
+    if (BB->empty() || !isa<TermInst>(BB->getInsts().back()))
+      return false;
+  return true;
+}
+
+SILReader::SILReader(llvm::MemoryBuffer *Buffer, ASTContext &Context,
+                     const SILSerializationTable &Table)
+  : Context(Context), Table(Table), Buffer(Buffer), Malformed(true) {
+  // The bitstream is read a word at a time.
+  size_t Size = Buffer->getBufferSize();
+  if (Size < sizeof(Signature) || Size % 4 != 0)
+    return;
+
+  const unsigned char *Start =
+    reinterpret_cast<const unsigned char*>(Buffer->getBufferStart());
+  llvm::BitstreamReader Reader(Start, Start + Size);
+  llvm::BitstreamCursor Cursor(Reader);
+  for (unsigned char C : Signature)
+    if (Cursor.Read(8) != C)
+      return;
+
+  // Find where each function starts without decoding it.
+  while (!Cursor.AtEndOfStream()) {
+    if (Cursor.ReadCode() != llvm::bitc::ENTER_SUBBLOCK ||
+        Cursor.ReadSubBlockID() != FUNCTION_BLOCK_ID) {
+      FunctionOffsets.clear();
+      return;
+    }
+    FunctionOffsets.push_back(Cursor.GetCurrentBitNo());
+    if (Cursor.SkipBlock()) {
+      FunctionOffsets.clear();
+      return;
+    }
+  }
+  Malformed = false;
+}
+
+SILReader::~SILReader() {}
+
+Function *SILReader::readFunction(unsigned Index) {
+  assert(Index < FunctionOffsets.size() && "Function index out of range");
+
+  const unsigned char *Start =
+    reinterpret_cast<const unsigned char*>(Buffer->getBufferStart());
+  llvm::BitstreamReader Reader(Start, Start + Buffer->getBufferSize());
+  llvm::BitstreamCursor Cursor(Reader);
+  Cursor.JumpToBit(FunctionOffsets[Index]);
+  if (Cursor.EnterSubBlock(FUNCTION_BLOCK_ID))
+    return nullptr;
+
+  Function *F = new Function(Context);
+  if (!FunctionReader(Table, Cursor, *F).read()) {
+    delete F;
+    return nullptr;
+  }
+  ++NumFunctionsRead;
+  return F;
+}
@@ -36,7 +36,22 @@ public:
              "Terminator must be the last in block");
     }
 
-    
+    // Check that each operand is on the use list of the value it uses.
+    for (Operand &Op : I->getAllOperands()) {
+      assert(Op.getUser() == I && "Operand does not belong to its user");
+      if (!Op.get())
+        continue;
+      bool FoundUse = false;
+      for (auto UI = Op.get()->use_begin(), E = Op.get()->use_end();
+           UI != E; ++UI)
+        if (*UI == &Op) {
+          FoundUse = true;
+          break;
+        }
+      assert(FoundUse && "Operand is missing from its value's use list");
+      (void)FoundUse;
+    }
+
     // Dispatch to our more-specialized instances below.
     ((SILVisitor<SILVerifier>*)this)->visit(I);
   }
@@ -164,11 +179,25 @@ public:
   }
   
   void visitBranchInst(BranchInst *BI) {
+    const BasicBlock *DestBB = BI->getDestBB(); (void)DestBB;
+    assert(unsigned(DestBB->bbarg_end() - DestBB->bbarg_begin()) ==
+             BI->getArgs().size() &&
+           "Branch has the wrong number of arguments for its destination");
+    auto BBArgI = DestBB->bbarg_begin();
+    for (auto Arg : BI->getArgs()) {
+      assert(Arg->getType()->isEqual((*BBArgI)->getType()) &&
+             "Branch argument type does not match destination block");
+      (void)Arg;
+      ++BBArgI;
+    }
   }
   
   void visitCondBranchInst(CondBranchInst *CBI) {
     assert(CBI->getCondition() &&
            "Condition of conditional branch can't be missing");
+    assert(CBI->getTrueBB()->bbarg_empty() &&
+           CBI->getFalseBB()->bbarg_empty() &&
+           "Conditional branch cannot pass arguments to its destinations");
   }
 };
 } // end anonymous namespace
@@ -186,7 +186,21 @@ void NameBinder::addImport(ImportDecl *ID,
     diagnose(Path[2].second, diag::invalid_declaration_imported);
     return;
   }
-  
+
+  // An import that is checked again (because the chunk containing it was
+  // reparsed) must not add the module a second time.
+  for (const ImportedModule &Existing : Result) {
+    if (Existing.second != M || Existing.first.size() != Path.size() - 1)
+      continue;
+    if (std::equal(Existing.first.begin(), Existing.first.end(),
+                   Path.begin() + 1,
+                   [](const std::pair<Identifier, SourceLoc> &LHS,
+                      const std::pair<Identifier, SourceLoc> &RHS) {
+                     return LHS.first == RHS.first;
+                   }))
+      return;
+  }
+
   Result.push_back(std::make_pair(Path.slice(1), M));
 }
 
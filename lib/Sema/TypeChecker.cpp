@@ -524,6 +524,14 @@ void swift::performTypeChecking(TranslationUnit *TU, unsigned StartElem) {
     TC.typeCheckDecl(D, /*isFirstPass*/true);
   }
 
+  // Once the error limit has been hit, nothing else we diagnose would be
+  // shown; don't spend any more time checking.
+  DiagnosticEngine &Diags = TC.Context.Diags;
+  if (Diags.hadTooManyErrors()) {
+    TU->ASTStage = TranslationUnit::TypeChecked;
+    return;
+  }
+
   // Check for explicit conformance to protocols and for circularity in
   // protocol definitions.
   {
@@ -691,6 +699,10 @@ void swift::performTypeChecking(TranslationUnit *TU, unsigned StartElem) {
     if (TU->Kind == TranslationUnit::Repl && !TC.Context.hadError())
       if (PatternBindingDecl *PBD = dyn_cast<PatternBindingDecl>(D))
         TC.REPLCheckPatternBinding(PBD);
+    if (Diags.hadTooManyErrors()) {
+      TU->ASTStage = TranslationUnit::TypeChecked;
+      return;
+    }
   }
 
   // Check overloaded vars/funcs.
@@ -736,9 +748,12 @@ void swift::performTypeChecking(TranslationUnit *TU, unsigned StartElem) {
     PrettyStackTraceExpr StackEntry(TC.Context, "type-checking", FE);
 
     TC.typeCheckFunctionBody(FE);
+    if (Diags.hadTooManyErrors())
+      break;
   }
 
   // Verify that we've checked types correctly.
   TU->ASTStage = TranslationUnit::TypeChecked;
-  verify(TU);
+  if (!Diags.hadTooManyErrors())
+    verify(TU);
 }
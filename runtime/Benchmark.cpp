@@ -0,0 +1,290 @@
+//===--- Benchmark.cpp - Swift Benchmark Timing Harness -------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementations of the benchmark harness functions.
+//
+// Time comes from the monotonic clock rather than from rdtsc, so the harness
+// works on any processor and doesn't need to calibrate the counter against
+// the loop overhead or the CPU's frequency scaling.  Instead of asking for
+// real-time priority, it takes many samples and reports robust statistics.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Benchmark.h"
+#include "FileIO.h"
+#include "Formatting.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace swift;
+
+/// The defaults for the configuration.
+static const unsigned DefaultNumSamples = 20;
+static const double DefaultSampleSeconds = 0.01;
+static const double DefaultWarmupSeconds = 0.1;
+
+/// Batches never grow by more than this factor at once, so that a body
+/// whose first iterations are unusually fast isn't run for far too long.
+static const int64_t MaxBatchGrowth = 10;
+
+static const int64_t MaxBatchSize = int64_t(1) << 40;
+
+static double getEnvDouble(const char *name, double defaultValue) {
+  const char *value = getenv(name);
+  if (!value)
+    return defaultValue;
+  char *end;
+  double result = strtod(value, &end);
+  if (end == value || *end || !(result > 0))
+    return defaultValue;
+  return result;
+}
+
+//===----------------------------------------------------------------------===//
+// Hardware counters
+//===----------------------------------------------------------------------===//
+
+/// Open a counter of user-space events for this thread, or return -1.
+static int openCounter(unsigned config) {
+#if defined(__linux__)
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  return -1;
+#endif
+}
+
+static uint64_t readCounter(int fd) {
+  uint64_t value = 0;
+  if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value))
+    value = 0;
+  return value;
+}
+
+static void openCounters(Benchmark *benchmark) {
+  benchmark->CyclesFD = benchmark->InstructionsFD = -1;
+  const char *enabled = getenv("SWIFT_BENCHMARK_COUNTERS");
+  if (enabled && !strcmp(enabled, "0"))
+    return;
+#if defined(__linux__)
+  benchmark->CyclesFD = openCounter(PERF_COUNT_HW_CPU_CYCLES);
+  benchmark->InstructionsFD = openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+// Statistics
+//===----------------------------------------------------------------------===//
+
+static double sortedMedian(const std::vector<double> &sorted) {
+  size_t middle = sorted.size() / 2;
+  if (sorted.size() % 2)
+    return sorted[middle];
+  return (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+SampleStatistics swift::computeSampleStatistics(std::vector<double> samples) {
+  SampleStatistics stats;
+  std::sort(samples.begin(), samples.end());
+  stats.Median = sortedMedian(samples);
+  stats.Min = samples.front();
+  stats.Max = samples.back();
+  for (double &sample : samples)
+    sample = std::fabs(sample - stats.Median);
+  std::sort(samples.begin(), samples.end());
+  stats.MAD = sortedMedian(samples);
+  return stats;
+}
+
+//===----------------------------------------------------------------------===//
+// JSON
+//===----------------------------------------------------------------------===//
+
+static void appendJSONString(std::string &out, const std::string &value) {
+  static const char HexDigits[] = "0123456789abcdef";
+  out += '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += "\\u00";
+      out += HexDigits[c >> 4];
+      out += HexDigits[c & 0xF];
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+static void appendJSONInteger(std::string &out, int64_t value) {
+  char buffer[MaxDecimalInt64Length];
+  out.append(buffer, swift_int64ToString(buffer, sizeof(buffer), value, 10));
+}
+
+static void appendJSONNumber(std::string &out, double value) {
+  char buffer[MaxDoubleLength];
+  out.append(buffer, swift_doubleToString(buffer, sizeof(buffer), value));
+}
+
+static void appendJSONField(std::string &out, const char *key, double value) {
+  out += ", \"";
+  out += key;
+  out += "\": ";
+  appendJSONNumber(out, value);
+}
+
+std::string Benchmark::toJSON() const {
+  std::string out = "{\"name\": ";
+  appendJSONString(out, Name);
+  out += ", \"samples\": ";
+  appendJSONInteger(out, Seconds.size());
+  out += ", \"iterations\": ";
+  appendJSONInteger(out, BatchSize);
+
+  if (!Seconds.empty()) {
+    std::vector<double> nanoseconds;
+    for (double seconds : Seconds)
+      nanoseconds.push_back(seconds * 1e9);
+    SampleStatistics time = computeSampleStatistics(nanoseconds);
+    appendJSONField(out, "median_ns", time.Median);
+    appendJSONField(out, "mad_ns", time.MAD);
+    appendJSONField(out, "min_ns", time.Min);
+    appendJSONField(out, "max_ns", time.Max);
+  }
+  if (!Cycles.empty()) {
+    SampleStatistics cycles = computeSampleStatistics(Cycles);
+    appendJSONField(out, "median_cycles", cycles.Median);
+    appendJSONField(out, "mad_cycles", cycles.MAD);
+  }
+  if (!Instructions.empty()) {
+    SampleStatistics instructions = computeSampleStatistics(Instructions);
+    appendJSONField(out, "median_instructions", instructions.Median);
+    appendJSONField(out, "mad_instructions", instructions.MAD);
+  }
+  out += "}\n";
+  return out;
+}
+
+//===----------------------------------------------------------------------===//
+// Running benchmarks
+//===----------------------------------------------------------------------===//
+
+Benchmark *swift::swift_benchmark_begin(const char *name,
+                                        int64_t nameLength) {
+  auto benchmark = new Benchmark;
+  benchmark->Name.assign(name, nameLength);
+  benchmark->NumSamples = unsigned(getEnvDouble("SWIFT_BENCHMARK_SAMPLES",
+                                                DefaultNumSamples));
+  benchmark->SampleSeconds = getEnvDouble("SWIFT_BENCHMARK_SAMPLE_TIME",
+                                          DefaultSampleSeconds);
+  benchmark->WarmupSeconds = getEnvDouble("SWIFT_BENCHMARK_WARMUP_TIME",
+                                          DefaultWarmupSeconds);
+  if (benchmark->NumSamples == 0)
+    benchmark->NumSamples = 1;
+  benchmark->CurrentPhase = Benchmark::Phase::Warmup;
+  benchmark->BatchSize = 0;
+  benchmark->WarmupElapsed = 0;
+  benchmark->BatchCycles = benchmark->BatchInstructions = 0;
+  openCounters(benchmark);
+  return benchmark;
+}
+
+/// Pick the size of the next warmup batch from the time the last one took.
+static int64_t growBatch(int64_t batchSize, double elapsed, double target) {
+  int64_t limit = std::min(batchSize * MaxBatchGrowth, MaxBatchSize);
+  if (elapsed <= 0)
+    return limit;
+  double wanted = batchSize * (target / elapsed);
+  if (wanted >= limit)
+    return limit;
+  return std::max(batchSize + 1, int64_t(wanted));
+}
+
+/// Account for a batch that has just finished.
+static void finishBatch(Benchmark *b, double elapsed, uint64_t cycles,
+                        uint64_t instructions) {
+  switch (b->CurrentPhase) {
+  case Benchmark::Phase::Warmup: {
+    b->WarmupElapsed += elapsed;
+    // A batch within a factor of two of the target is long enough.
+    if (elapsed < b->SampleSeconds / 2) {
+      b->BatchSize = growBatch(b->BatchSize, elapsed, b->SampleSeconds);
+      if (b->BatchSize < MaxBatchSize)
+        return;
+    }
+    if (b->WarmupElapsed >= b->WarmupSeconds)
+      b->CurrentPhase = Benchmark::Phase::Measure;
+    return;
+  }
+
+  case Benchmark::Phase::Measure:
+    b->Seconds.push_back(elapsed / b->BatchSize);
+    if (b->CyclesFD >= 0)
+      b->Cycles.push_back(double(cycles) / b->BatchSize);
+    if (b->InstructionsFD >= 0)
+      b->Instructions.push_back(double(instructions) / b->BatchSize);
+    if (b->Seconds.size() >= b->NumSamples)
+      b->CurrentPhase = Benchmark::Phase::Done;
+    return;
+
+  case Benchmark::Phase::Done:
+    return;
+  }
+}
+
+int64_t swift::swift_benchmark_nextBatch(Benchmark *b) {
+  Benchmark::Clock::time_point now = Benchmark::Clock::now();
+  uint64_t cycles = readCounter(b->CyclesFD);
+  uint64_t instructions = readCounter(b->InstructionsFD);
+
+  if (b->BatchSize == 0) {
+    b->BatchSize = 1;
+  } else {
+    std::chrono::duration<double> elapsed = now - b->BatchStart;
+    finishBatch(b, elapsed.count(), cycles - b->BatchCycles,
+                instructions - b->BatchInstructions);
+    if (b->CurrentPhase == Benchmark::Phase::Done)
+      return 0;
+  }
+
+  // Read the counters first and the clock last, so that neither includes
+  // the harness's own work.
+  b->BatchCycles = readCounter(b->CyclesFD);
+  b->BatchInstructions = readCounter(b->InstructionsFD);
+  b->BatchStart = Benchmark::Clock::now();
+  return b->BatchSize;
+}
+
+void swift::swift_benchmark_end(Benchmark *b) {
+  std::string json = b->toJSON();
+  swift_stdout_write(json.data(), json.size());
+  if (b->CyclesFD >= 0)
+    close(b->CyclesFD);
+  if (b->InstructionsFD >= 0)
+    close(b->InstructionsFD);
+  delete b;
+}
@@ -0,0 +1,132 @@
+//===--- Benchmark.h - Swift Benchmark Timing Harness -----------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A portable harness for timing benchmark loops.  The caller owns the loop:
+//
+//   Benchmark *b = swift_benchmark_begin(name, length);
+//   while (int64_t n = swift_benchmark_nextBatch(b))
+//     for (int64_t i = 0; i != n; ++i)
+//       body();
+//   swift_benchmark_end(b);
+//
+// The harness warms the body up, picks a batch size that makes each sample
+// long enough to time reliably, collects a number of samples, and prints
+// one line of JSON with the median and median absolute deviation of the
+// time per iteration.  Where the kernel allows it, CPU cycles and retired
+// instructions are counted as well.
+//
+// The defaults can be overridden with the environment variables
+// SWIFT_BENCHMARK_SAMPLES, SWIFT_BENCHMARK_SAMPLE_TIME and
+// SWIFT_BENCHMARK_WARMUP_TIME (both in seconds), and
+// SWIFT_BENCHMARK_COUNTERS=0 turns the hardware counters off.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_ABI_BENCHMARK_H
+#define SWIFT_ABI_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace swift {
+
+/// Summary statistics of a set of samples.
+struct SampleStatistics {
+  double Median;
+
+  /// The median absolute deviation from the median.  Unlike the standard
+  /// deviation, one descheduled sample barely moves it.
+  double MAD;
+
+  double Min;
+  double Max;
+};
+
+/// Compute the statistics of a non-empty set of samples.
+SampleStatistics computeSampleStatistics(std::vector<double> samples);
+
+/// The state of one benchmark run.
+struct Benchmark {
+  typedef std::chrono::steady_clock Clock;
+
+  enum class Phase {
+    /// Running the body, and growing the batch size until a batch takes
+    /// about SampleSeconds.
+    Warmup,
+    /// Recording one sample per batch.
+    Measure,
+    Done
+  };
+
+  std::string Name;
+
+  /// The configuration.
+  unsigned NumSamples;
+  double SampleSeconds;
+  double WarmupSeconds;
+
+  Phase CurrentPhase;
+
+  /// The number of iterations in the current batch, or 0 before the first.
+  int64_t BatchSize;
+
+  /// The time spent warming up so far.
+  double WarmupElapsed;
+
+  /// The clock and counter readings at the start of the current batch.
+  Clock::time_point BatchStart;
+  uint64_t BatchCycles;
+  uint64_t BatchInstructions;
+
+  /// Hardware counter descriptors, or -1 where counting isn't available.
+  int CyclesFD;
+  int InstructionsFD;
+
+  /// The samples: seconds, cycles and instructions per iteration.
+  std::vector<double> Seconds;
+  std::vector<double> Cycles;
+  std::vector<double> Instructions;
+
+  /// Render the results as one line of JSON, including the newline.
+  std::string toJSON() const;
+};
+
+/// Start timing a benchmark.  The name is copied.
+extern "C" Benchmark *swift_benchmark_begin(const char *name,
+                                            int64_t nameLength);
+
+/// Finish the batch that is running, if any, and return the number of
+/// iterations to run in the next one, or 0 when all of the samples have
+/// been taken.
+extern "C" int64_t swift_benchmark_nextBatch(Benchmark *benchmark);
+
+/// Print the results to standard output and destroy the benchmark.
+extern "C" void swift_benchmark_end(Benchmark *benchmark);
+
+/// Time the body the way the Swift benchmark() function does.  This is for
+/// benchmarks that drive the runtime directly.
+template <typename Fn>
+void benchmark(const char *name, Fn body) {
+  Benchmark *b = swift_benchmark_begin(name, strlen(name));
+  while (int64_t n = swift_benchmark_nextBatch(b))
+    for (int64_t i = 0; i != n; ++i)
+      body();
+  swift_benchmark_end(b);
+}
+
+} // end namespace swift
+
+#endif /* SWIFT_ABI_BENCHMARK_H */
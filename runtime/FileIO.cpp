@@ -0,0 +1,375 @@
+//===--- FileIO.cpp - Swift Buffered and Mapped File I/O ------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementations of the file I/O functions.
+//
+// Everything here is about making fewer, larger system calls: whole files
+// are mapped instead of read, readers pull 256KB at a time and find line
+// breaks with memchr, and standard output is written 64KB at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#include "FileIO.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace swift;
+
+/// Read, retrying if a signal interrupts us.
+static ssize_t readRetrying(int fd, char *buffer, size_t length) {
+  ssize_t result;
+  do {
+    result = read(fd, buffer, length);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+/// Write all of the bytes, retrying after signals and partial writes.
+/// Gives up silently on any other error.
+static void writeAll(int fd, const char *data, size_t length) {
+  while (length) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    data += written;
+    length -= written;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Files
+//===----------------------------------------------------------------------===//
+
+int swift::swift_file_open(const char *filename) {
+  return open(filename, O_RDONLY);
+}
+
+int swift::swift_file_close(int fd) {
+  return close(fd);
+}
+
+int64_t swift::swift_file_read(int fd, char *buffer, int64_t length) {
+  return readRetrying(fd, buffer, length);
+}
+
+int64_t swift::swift_file_size(const char *filename) {
+  struct stat buf;
+  if (stat(filename, &buf) != 0)
+    return -1;
+  return buf.st_size;
+}
+
+int64_t swift::swift_fd_size(int fd) {
+  struct stat buf;
+  if (fstat(fd, &buf) != 0)
+    return -1;
+  return buf.st_size;
+}
+
+const char *swift::swift_file_map(int fd, int64_t length) {
+  // mmap refuses empty mappings.
+  if (length == 0)
+    return "";
+
+  void *data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data != MAP_FAILED) {
+    // Mapped files are almost always scanned front to back.
+    madvise(data, length, MADV_SEQUENTIAL);
+    return static_cast<const char *>(data);
+  }
+
+  // Some files can't be mapped.  Read those into anonymous memory, so that
+  // swift_file_unmap works the same way on the result.
+  data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON,
+              -1, 0);
+  if (data == MAP_FAILED)
+    return nullptr;
+  char *bytes = static_cast<char *>(data);
+  for (int64_t done = 0; done < length; ) {
+    ssize_t count = readRetrying(fd, bytes + done, length - done);
+    if (count <= 0) {
+      // The file shrank or couldn't be read; don't hand out a view that
+      // is partly zeros.
+      int savedErrno = count == 0 ? EIO : errno;
+      munmap(data, length);
+      errno = savedErrno;
+      return nullptr;
+    }
+    done += count;
+  }
+  return bytes;
+}
+
+int swift::swift_file_unmap(const char *data, int64_t length) {
+  if (length == 0)
+    return 0;
+  return munmap(const_cast<char *>(data), length);
+}
+
+//===----------------------------------------------------------------------===//
+// Buffered readers
+//===----------------------------------------------------------------------===//
+
+/// The initial size of a reader's buffer.  It doubles whenever a single
+/// line doesn't fit.
+static const size_t ReaderBufferSize = 256 * 1024;
+
+/// Page-aligned buffers let the kernel copy whole pages.
+static const size_t ReaderBufferAlignment = 4096;
+
+struct swift::BufferedReader {
+  /// The descriptor being read.
+  int FD;
+
+  /// Whether swift_reader_close should close FD.
+  bool OwnsFD;
+
+  /// Whether a read has returned the end of the file or an error.
+  bool AtEnd;
+
+  /// The buffer, and its size.
+  char *Buffer;
+  size_t Capacity;
+
+  /// The buffered bytes that haven't been consumed are [Begin, End).
+  size_t Begin;
+  size_t End;
+
+  /// The start of the line returned by the last swift_reader_nextLine.
+  const char *Line;
+};
+
+static char *allocateReaderBuffer(size_t capacity) {
+  void *buffer;
+  if (posix_memalign(&buffer, ReaderBufferAlignment, capacity) != 0)
+    abort();
+  return static_cast<char *>(buffer);
+}
+
+static BufferedReader *createReader(int fd, bool ownsFD) {
+  auto reader = new BufferedReader;
+  reader->FD = fd;
+  reader->OwnsFD = ownsFD;
+  reader->AtEnd = fd < 0;
+  reader->Buffer = allocateReaderBuffer(ReaderBufferSize);
+  reader->Capacity = ReaderBufferSize;
+  reader->Begin = 0;
+  reader->End = 0;
+  reader->Line = reader->Buffer;
+  return reader;
+}
+
+BufferedReader *swift::swift_reader_open(const char *filename) {
+  int fd = open(filename, O_RDONLY);
+  return createReader(fd, fd >= 0);
+}
+
+BufferedReader *swift::swift_reader_create(int fd) {
+  return createReader(fd, false);
+}
+
+void swift::swift_reader_close(BufferedReader *reader) {
+  if (reader->OwnsFD)
+    close(reader->FD);
+  free(reader->Buffer);
+  delete reader;
+}
+
+/// Read more of the file into the buffer, moving or growing the buffer
+/// as needed to keep the unconsumed bytes.  Returns false at the end of
+/// the file.
+static bool fillReader(BufferedReader *reader) {
+  if (reader->AtEnd)
+    return false;
+
+  size_t pending = reader->End - reader->Begin;
+  if (pending == 0) {
+    reader->Begin = reader->End = 0;
+  } else if (reader->Begin != 0 &&
+             reader->Capacity - reader->End < reader->Capacity / 2) {
+    // Slide the unconsumed bytes down so that the next read is large.
+    memmove(reader->Buffer, reader->Buffer + reader->Begin, pending);
+    reader->Begin = 0;
+    reader->End = pending;
+  }
+
+  if (reader->End == reader->Capacity) {
+    // The buffer is full of one unfinished line.
+    size_t capacity = reader->Capacity * 2;
+    char *buffer = allocateReaderBuffer(capacity);
+    memcpy(buffer, reader->Buffer + reader->Begin, pending);
+    free(reader->Buffer);
+    reader->Buffer = buffer;
+    reader->Capacity = capacity;
+    reader->Begin = 0;
+    reader->End = pending;
+  }
+
+  ssize_t count = readRetrying(reader->FD, reader->Buffer + reader->End,
+                               reader->Capacity - reader->End);
+  if (count <= 0) {
+    reader->AtEnd = true;
+    return false;
+  }
+  reader->End += count;
+  return true;
+}
+
+int64_t swift::swift_reader_nextLine(BufferedReader *reader,
+                                     int32_t delimiter) {
+  // The number of unconsumed bytes we've already searched.
+  size_t searched = 0;
+  for (;;) {
+    char *start = reader->Buffer + reader->Begin;
+    size_t pending = reader->End - reader->Begin;
+    auto found = static_cast<char *>(memchr(start + searched, delimiter,
+                                            pending - searched));
+    if (found) {
+      size_t length = found - start;
+      reader->Begin += length + 1;
+      reader->Line = start;
+      if (delimiter == '\n' && length != 0 && start[length - 1] == '\r')
+        --length;
+      return length;
+    }
+
+    searched = pending;
+    if (!fillReader(reader))
+      break;
+  }
+
+  // The last line needn't end with a delimiter.
+  if (reader->Begin == reader->End)
+    return -1;
+  size_t length = reader->End - reader->Begin;
+  reader->Line = reader->Buffer + reader->Begin;
+  reader->Begin = reader->End;
+  return length;
+}
+
+const char *swift::swift_reader_line(BufferedReader *reader) {
+  return reader->Line;
+}
+
+int64_t swift::swift_reader_read(BufferedReader *reader, char *buffer,
+                                 int64_t length) {
+  if (length <= 0)
+    return 0;
+
+  if (reader->Begin == reader->End) {
+    // Large reads go straight into the caller's buffer.
+    if (size_t(length) >= reader->Capacity) {
+      if (reader->AtEnd)
+        return 0;
+      ssize_t count = readRetrying(reader->FD, buffer, length);
+      if (count <= 0) {
+        reader->AtEnd = true;
+        return 0;
+      }
+      return count;
+    }
+    if (!fillReader(reader))
+      return 0;
+  }
+
+  // Like read(2), return what's available rather than waiting for more.
+  size_t count = reader->End - reader->Begin;
+  if (count > size_t(length))
+    count = length;
+  memcpy(buffer, reader->Buffer + reader->Begin, count);
+  reader->Begin += count;
+  return count;
+}
+
+int32_t swift::swift_reader_getc(BufferedReader *reader) {
+  if (reader->Begin == reader->End && !fillReader(reader))
+    return -1;
+  return static_cast<unsigned char>(reader->Buffer[reader->Begin++]);
+}
+
+//===----------------------------------------------------------------------===//
+// Standard output
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// The buffer behind swift_stdout_write.
+  class StdoutBuffer {
+    static const size_t Capacity = 64 * 1024;
+
+    char Data[Capacity];
+    size_t Used;
+
+    /// Whether to write out every complete line, as stdio does for
+    /// terminals, so that interactive output shows up promptly.
+    bool LineBuffered;
+
+  public:
+    StdoutBuffer() : Used(0), LineBuffered(isatty(STDOUT_FILENO)) {}
+
+    ~StdoutBuffer() {
+      flush();
+    }
+
+    void write(const char *data, size_t length) {
+      if (length > Capacity - Used) {
+        flush();
+        if (length >= Capacity) {
+          writeAll(STDOUT_FILENO, data, length);
+          return;
+        }
+      }
+      memcpy(Data + Used, data, length);
+      Used += length;
+      if (LineBuffered && memchr(data, '\n', length))
+        flush();
+    }
+
+    void putchar(char c) {
+      if (Used == Capacity)
+        flush();
+      Data[Used++] = c;
+      if (LineBuffered && c == '\n')
+        flush();
+    }
+
+    void flush() {
+      writeAll(STDOUT_FILENO, Data, Used);
+      Used = 0;
+    }
+  };
+}
+
+/// The standard output buffer, which flushes itself at exit.
+static StdoutBuffer &getStdoutBuffer() {
+  static StdoutBuffer buffer;
+  return buffer;
+}
+
+void swift::swift_stdout_write(const char *data, int64_t length) {
+  getStdoutBuffer().write(data, length);
+}
+
+void swift::swift_stdout_putchar(int32_t c) {
+  getStdoutBuffer().putchar(char(c));
+}
+
+void swift::swift_stdout_flush() {
+  getStdoutBuffer().flush();
+}
@@ -0,0 +1,102 @@
+//===--- FileIO.h - Swift Buffered and Mapped File I/O ----------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// The runtime's I/O layer: plain file descriptor operations, read-only
+// memory-mapped views of files, buffered readers that split lines in large
+// chunks, and a buffered writer for standard output.  Errors are reported
+// the POSIX way, with a -1 or null result and errno set.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_ABI_FILEIO_H
+#define SWIFT_ABI_FILEIO_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace swift {
+
+/// Open a file for reading.  Returns the descriptor, or -1.
+extern "C" int swift_file_open(const char *filename);
+
+/// Close a file descriptor.  Returns 0, or -1.
+extern "C" int swift_file_close(int fd);
+
+/// Read up to 'length' bytes.  Returns the number read, 0 at the end of the
+/// file, or -1.
+extern "C" int64_t swift_file_read(int fd, char *buffer, int64_t length);
+
+/// Returns the size of the named file, or -1.
+extern "C" int64_t swift_file_size(const char *filename);
+
+/// Returns the size of the file open on the descriptor, or -1.
+extern "C" int64_t swift_fd_size(int fd);
+
+/// Map the first 'length' bytes of an open file read-only into memory.
+/// The mapping stays valid after the descriptor is closed.  A file that
+/// can't be mapped is read into anonymous memory instead.  Returns null,
+/// with errno set, if there is no memory for that or if fewer than
+/// 'length' bytes can be read.
+extern "C" const char *swift_file_map(int fd, int64_t length);
+
+/// Unmap a view returned by swift_file_map.  Returns 0, or -1.
+extern "C" int swift_file_unmap(const char *data, int64_t length);
+
+/// A reader over a file descriptor with a large, page-aligned buffer.
+struct BufferedReader;
+
+/// Open the named file for buffered reading.  This never returns null: if
+/// the file can't be opened, the reader is immediately at its end and
+/// errno says why.
+extern "C" BufferedReader *swift_reader_open(const char *filename);
+
+/// Create a buffered reader for a descriptor the caller keeps ownership
+/// of, such as standard input.
+extern "C" BufferedReader *swift_reader_create(int fd);
+
+/// Close the reader, and its descriptor if it opened it.
+extern "C" void swift_reader_close(BufferedReader *reader);
+
+/// Advance to the next line, which ends at the delimiter character or the
+/// end of the file.  The delimiter is not part of the line, and a '\r'
+/// before a '\n' delimiter is dropped as well.  Returns the length of the
+/// line, or -1 at the end of the file.  The line's characters are at
+/// swift_reader_line until the next call on the reader.
+extern "C" int64_t swift_reader_nextLine(BufferedReader *reader,
+                                         int32_t delimiter);
+
+/// The characters of the line found by the last swift_reader_nextLine.
+extern "C" const char *swift_reader_line(BufferedReader *reader);
+
+/// Read up to 'length' bytes.  Returns the number read, or 0 at the end
+/// of the file.
+extern "C" int64_t swift_reader_read(BufferedReader *reader, char *buffer,
+                                     int64_t length);
+
+/// Read one byte.  Returns it, or -1 at the end of the file.
+extern "C" int32_t swift_reader_getc(BufferedReader *reader);
+
+/// Append bytes to the standard output buffer.  The buffer is written out
+/// when it fills up, at every newline when standard output is a terminal,
+/// and at exit.
+extern "C" void swift_stdout_write(const char *data, int64_t length);
+
+/// Append one byte to the standard output buffer.
+extern "C" void swift_stdout_putchar(int32_t c);
+
+/// Write out the standard output buffer.  Anything else that writes to
+/// file descriptor 1 must call this first to keep the output in order.
+extern "C" void swift_stdout_flush();
+
+} // end namespace swift
+
+#endif /* SWIFT_ABI_FILEIO_H */
@@ -0,0 +1,581 @@
+//===--- Formatting.cpp - Swift Number Formatting -------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementations of the number formatting functions.
+//
+// Decimal integers are produced two digits at a time from a table, and only
+// fall back to 128-bit division for values that don't fit in 64 bits.
+//
+// Doubles are produced with Florian Loitsch's Grisu3 algorithm ("Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010),
+// which finds the shortest digit string that reads back as the same double
+// for all but about 0.5% of inputs, and knows when it has failed.  For
+// those we search for the shortest precision that round-trips through the
+// C library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringExtras.h"
+#include "Formatting.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace swift;
+
+//===----------------------------------------------------------------------===//
+// Integers
+//===----------------------------------------------------------------------===//
+
+/// The decimal digits of 00 through 99.
+static const char DigitPairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/// Return the number of decimal digits in the value.
+static unsigned countDecimalDigits(uint64_t value) {
+  unsigned count = 1;
+  for (;;) {
+    if (value < 10) return count;
+    if (value < 100) return count + 1;
+    if (value < 1000) return count + 2;
+    if (value < 10000) return count + 3;
+    value /= 10000;
+    count += 4;
+  }
+}
+
+/// Write the decimal digits of the value into the buffer.
+static size_t formatDecimal(char *buffer, uint64_t value) {
+  unsigned length = countDecimalDigits(value);
+  char *end = buffer + length;
+  while (value >= 100) {
+    unsigned pair = unsigned(value % 100) * 2;
+    value /= 100;
+    *--end = DigitPairs[pair + 1];
+    *--end = DigitPairs[pair];
+  }
+  if (value >= 10) {
+    unsigned pair = unsigned(value) * 2;
+    *--end = DigitPairs[pair + 1];
+    *--end = DigitPairs[pair];
+  } else {
+    *--end = char('0' + value);
+  }
+  return length;
+}
+
+/// Write exactly 'width' decimal digits of a value less than 10^width into
+/// the buffer, padding with leading zeros.
+static void formatDecimalPadded(char *buffer, uint64_t value,
+                                unsigned width) {
+  char *end = buffer + width;
+  while (end - buffer >= 2) {
+    unsigned pair = unsigned(value % 100) * 2;
+    value /= 100;
+    *--end = DigitPairs[pair + 1];
+    *--end = DigitPairs[pair];
+  }
+  if (end != buffer)
+    *--end = char('0' + value);
+}
+
+/// Write the digits of the value in a radix other than 10 into the buffer.
+static size_t formatRadix(char *buffer, size_t bufferLength,
+                          __uint128_t value, uint64_t radix) {
+  char digits[128];
+  char *p = digits + sizeof(digits);
+  if (value >> 64) {
+    do {
+      *--p = llvm::hexdigit(unsigned(value % radix));
+      value /= radix;
+    } while (value >> 64);
+  }
+  // Finish with 64-bit divides.
+  uint64_t value64 = uint64_t(value);
+  do {
+    *--p = llvm::hexdigit(unsigned(value64 % radix));
+    value64 /= radix;
+  } while (value64);
+  size_t length = digits + sizeof(digits) - p;
+  assert(length <= bufferLength && "buffer too small");
+  memcpy(buffer, p, length);
+  return length;
+}
+
+size_t swift::formatUInt128(char *buffer, size_t bufferLength,
+                            __uint128_t value, uint64_t radix) {
+  assert(radix >= 2 && radix <= 36 && "Invalid radix for string conversion");
+  if (radix != 10)
+    return formatRadix(buffer, bufferLength, value, radix);
+
+  assert(bufferLength >= 39 && "buffer too small");
+  if (!(value >> 64))
+    return formatDecimal(buffer, uint64_t(value));
+
+  // Peel off 19 digits at a time, which is the most that fit in 64 bits,
+  // so that only the top chunk needs a 128-bit divide.
+  const uint64_t TenToThe19 = 10000000000000000000ULL;
+  uint64_t low = uint64_t(value % TenToThe19);
+  value /= TenToThe19;
+  size_t length;
+  if (!(value >> 64)) {
+    length = formatDecimal(buffer, uint64_t(value));
+  } else {
+    uint64_t middle = uint64_t(value % TenToThe19);
+    length = formatDecimal(buffer, uint64_t(value / TenToThe19));
+    formatDecimalPadded(buffer + length, middle, 19);
+    length += 19;
+  }
+  formatDecimalPadded(buffer + length, low, 19);
+  return length + 19;
+}
+
+uint64_t swift::swift_uint64ToString(char *buffer, size_t bufferLength,
+                                     uint64_t value, int64_t radix) {
+  assert(radix >= 2 && radix <= 36 && "Invalid radix for string conversion");
+  if (radix != 10)
+    return formatRadix(buffer, bufferLength, value, radix);
+  assert(countDecimalDigits(value) <= bufferLength && "buffer too small");
+  return formatDecimal(buffer, value);
+}
+
+uint64_t swift::swift_int64ToString(char *buffer, size_t bufferLength,
+                                    int64_t value, int64_t radix) {
+  if (value >= 0)
+    return swift_uint64ToString(buffer, bufferLength, value, radix);
+  *buffer = '-';
+  return 1 + swift_uint64ToString(buffer + 1, bufferLength - 1,
+                                  -uint64_t(value), radix);
+}
+
+//===----------------------------------------------------------------------===//
+// Grisu3
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// A floating-point number with a 64-bit significand and no implicit
+  /// bits: f * 2^e.
+  struct DiyFp {
+    uint64_t f;
+    int e;
+
+    DiyFp() = default;
+    DiyFp(uint64_t f, int e) : f(f), e(e) {}
+
+    /// Subtract two numbers with the same exponent.
+    DiyFp operator-(DiyFp other) const {
+      assert(e == other.e && f >= other.f);
+      return DiyFp(f - other.f, e);
+    }
+
+    /// Multiply, rounding the 128-bit product to its upper 64 bits.
+    DiyFp operator*(DiyFp other) const {
+      __uint128_t product = __uint128_t(f) * other.f;
+      uint64_t high = uint64_t(product >> 64);
+      uint64_t low = uint64_t(product);
+      return DiyFp(high + (low >> 63), e + other.e + 64);
+    }
+
+    /// Shift the significand left until its top bit is set.
+    DiyFp normalize() const {
+      assert(f != 0);
+      int shift = __builtin_clzll(f);
+      return DiyFp(f << shift, e - shift);
+    }
+  };
+
+  /// A power of ten, 10^decimalExponent ~= significand * 2^binaryExponent.
+  struct CachedPower {
+    uint64_t significand;
+    int16_t binaryExponent;
+    int16_t decimalExponent;
+  };
+}
+
+/// Normalized powers of ten from 10^-348 to 10^340 in steps of 10^8, which
+/// cover every scaling Grisu needs for a double.
+static const CachedPower CachedPowers[] = {
+{ 0xfa8fd5a0081c0288ULL, -1220, -348 },
+  { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+  { 0x8b16fb203055ac76ULL, -1166, -332 },
+  { 0xcf42894a5dce35eaULL, -1140, -324 },
+  { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+  { 0xe61acf033d1a45dfULL, -1087, -308 },
+  { 0xab70fe17c79ac6caULL, -1060, -300 },
+  { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+  { 0xbe5691ef416bd60cULL, -1007, -284 },
+  { 0x8dd01fad907ffc3cULL,  -980, -276 },
+  { 0xd3515c2831559a83ULL,  -954, -268 },
+  { 0x9d71ac8fada6c9b5ULL,  -927, -260 },
+  { 0xea9c227723ee8bcbULL,  -901, -252 },
+  { 0xaecc49914078536dULL,  -874, -244 },
+  { 0x823c12795db6ce57ULL,  -847, -236 },
+  { 0xc21094364dfb5637ULL,  -821, -228 },
+  { 0x9096ea6f3848984fULL,  -794, -220 },
+  { 0xd77485cb25823ac7ULL,  -768, -212 },
+  { 0xa086cfcd97bf97f4ULL,  -741, -204 },
+  { 0xef340a98172aace5ULL,  -715, -196 },
+  { 0xb23867fb2a35b28eULL,  -688, -188 },
+  { 0x84c8d4dfd2c63f3bULL,  -661, -180 },
+  { 0xc5dd44271ad3cdbaULL,  -635, -172 },
+  { 0x936b9fcebb25c996ULL,  -608, -164 },
+  { 0xdbac6c247d62a584ULL,  -582, -156 },
+  { 0xa3ab66580d5fdaf6ULL,  -555, -148 },
+  { 0xf3e2f893dec3f126ULL,  -529, -140 },
+  { 0xb5b5ada8aaff80b8ULL,  -502, -132 },
+  { 0x87625f056c7c4a8bULL,  -475, -124 },
+  { 0xc9bcff6034c13053ULL,  -449, -116 },
+  { 0x964e858c91ba2655ULL,  -422, -108 },
+  { 0xdff9772470297ebdULL,  -396, -100 },
+  { 0xa6dfbd9fb8e5b88fULL,  -369,  -92 },
+  { 0xf8a95fcf88747d94ULL,  -343,  -84 },
+  { 0xb94470938fa89bcfULL,  -316,  -76 },
+  { 0x8a08f0f8bf0f156bULL,  -289,  -68 },
+  { 0xcdb02555653131b6ULL,  -263,  -60 },
+  { 0x993fe2c6d07b7facULL,  -236,  -52 },
+  { 0xe45c10c42a2b3b06ULL,  -210,  -44 },
+  { 0xaa242499697392d3ULL,  -183,  -36 },
+  { 0xfd87b5f28300ca0eULL,  -157,  -28 },
+  { 0xbce5086492111aebULL,  -130,  -20 },
+  { 0x8cbccc096f5088ccULL,  -103,  -12 },
+  { 0xd1b71758e219652cULL,   -77,   -4 },
+  { 0x9c40000000000000ULL,   -50,    4 },
+  { 0xe8d4a51000000000ULL,   -24,   12 },
+  { 0xad78ebc5ac620000ULL,     3,   20 },
+  { 0x813f3978f8940984ULL,    30,   28 },
+  { 0xc097ce7bc90715b3ULL,    56,   36 },
+  { 0x8f7e32ce7bea5c70ULL,    83,   44 },
+  { 0xd5d238a4abe98068ULL,   109,   52 },
+  { 0x9f4f2726179a2245ULL,   136,   60 },
+  { 0xed63a231d4c4fb27ULL,   162,   68 },
+  { 0xb0de65388cc8ada8ULL,   189,   76 },
+  { 0x83c7088e1aab65dbULL,   216,   84 },
+  { 0xc45d1df942711d9aULL,   242,   92 },
+  { 0x924d692ca61be758ULL,   269,  100 },
+  { 0xda01ee641a708deaULL,   295,  108 },
+  { 0xa26da3999aef774aULL,   322,  116 },
+  { 0xf209787bb47d6b85ULL,   348,  124 },
+  { 0xb454e4a179dd1877ULL,   375,  132 },
+  { 0x865b86925b9bc5c2ULL,   402,  140 },
+  { 0xc83553c5c8965d3dULL,   428,  148 },
+  { 0x952ab45cfa97a0b3ULL,   455,  156 },
+  { 0xde469fbd99a05fe3ULL,   481,  164 },
+  { 0xa59bc234db398c25ULL,   508,  172 },
+  { 0xf6c69a72a3989f5cULL,   534,  180 },
+  { 0xb7dcbf5354e9beceULL,   561,  188 },
+  { 0x88fcf317f22241e2ULL,   588,  196 },
+  { 0xcc20ce9bd35c78a5ULL,   614,  204 },
+  { 0x98165af37b2153dfULL,   641,  212 },
+  { 0xe2a0b5dc971f303aULL,   667,  220 },
+  { 0xa8d9d1535ce3b396ULL,   694,  228 },
+  { 0xfb9b7cd9a4a7443cULL,   720,  236 },
+  { 0xbb764c4ca7a44410ULL,   747,  244 },
+  { 0x8bab8eefb6409c1aULL,   774,  252 },
+  { 0xd01fef10a657842cULL,   800,  260 },
+  { 0x9b10a4e5e9913129ULL,   827,  268 },
+  { 0xe7109bfba19c0c9dULL,   853,  276 },
+  { 0xac2820d9623bf429ULL,   880,  284 },
+  { 0x80444b5e7aa7cf85ULL,   907,  292 },
+  { 0xbf21e44003acdd2dULL,   933,  300 },
+  { 0x8e679c2f5e44ff8fULL,   960,  308 },
+  { 0xd433179d9c8cb841ULL,   986,  316 },
+  { 0x9e19db92b4e31ba9ULL,  1013,  324 },
+  { 0xeb96bf6ebadf77d9ULL,  1039,  332 },
+  { 0xaf87023b9bf0ee6bULL,  1066,  340 },
+};
+
+static const int CachedPowersMinDecimalExponent = -348;
+static const int CachedPowersDecimalExponentStep = 8;
+
+/// The range of binary exponents we scale the value into, so that its
+/// integral part fits in 32 bits.
+static const int MinTargetExponent = -60;
+static const int MaxTargetExponent = -32;
+
+/// Find a cached power of ten c such that the exponent of w * c falls in
+/// the target range.  Returns c, and the decimal exponent of c in mk.
+static DiyFp getCachedPower(int e, int &mk) {
+  // 1 / log2(10)
+  const double OneOverLog2Of10 = 0.30102999566398114;
+  int minExponent = MinTargetExponent - (e + 64);
+  int k = int(std::ceil((minExponent + 63) * OneOverLog2Of10));
+  unsigned index = (k - CachedPowersMinDecimalExponent - 1) /
+                     CachedPowersDecimalExponentStep + 1;
+  assert(index < sizeof(CachedPowers) / sizeof(CachedPowers[0]));
+  const CachedPower &power = CachedPowers[index];
+  assert(MinTargetExponent <= e + power.binaryExponent + 64 &&
+         e + power.binaryExponent + 64 <= MaxTargetExponent);
+  (void) MaxTargetExponent;
+  mk = power.decimalExponent;
+  return DiyFp(power.significand, power.binaryExponent);
+}
+
+/// Return the largest power of ten not greater than the value, and the
+/// number of its digits.  A zero value has no digits.
+static void getBiggestPowerOfTen(uint32_t value, uint32_t &power,
+                                 int &numDigits) {
+  if (value == 0) {
+    power = 0;
+    numDigits = 0;
+    return;
+  }
+  power = 1;
+  numDigits = 1;
+  while (value / 10 >= power) {
+    power *= 10;
+    ++numDigits;
+  }
+}
+
+/// Adjust the last digit of the generated digits toward the real value,
+/// and check that the result is guaranteed to be the closest shortest
+/// representation.  All the distances are in the same scaled units:
+///   distanceTooHighW - the distance from the upper bound to the value
+///   unsafeInterval   - the width of the rounding interval
+///   rest             - the distance from the digits to the upper bound
+///   tenKappa         - the weight of the last digit
+///   unit             - the possible error in each of the above
+static bool roundWeed(char *buffer, int length, uint64_t distanceTooHighW,
+                      uint64_t unsafeInterval, uint64_t rest,
+                      uint64_t tenKappa, uint64_t unit) {
+  uint64_t smallDistance = distanceTooHighW - unit;
+  uint64_t bigDistance = distanceTooHighW + unit;
+
+  // Decrement the last digit while that brings us closer to the value and
+  // keeps us inside the interval.
+  while (rest < smallDistance &&
+         unsafeInterval - rest >= tenKappa &&
+         (rest + tenKappa < smallDistance ||
+          smallDistance - rest >= rest + tenKappa - smallDistance)) {
+    buffer[length - 1]--;
+    rest += tenKappa;
+  }
+
+  // If the error could make another candidate closer, give up.
+  if (rest < bigDistance &&
+      unsafeInterval - rest >= tenKappa &&
+      (rest + tenKappa < bigDistance ||
+       bigDistance - rest > rest + tenKappa - bigDistance))
+    return false;
+
+  // The digits must be safely inside the interval.
+  return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+/// Generate the shortest digits of a number in the interval (low, high)
+/// that is closest to w.  All three have the same exponent.  Returns false
+/// if the result can't be guaranteed; otherwise the value is
+/// buffer * 10^kappa.
+static bool generateDigits(DiyFp low, DiyFp w, DiyFp high, char *buffer,
+                           int &length, int &kappa) {
+  // The boundaries are imprecise by one unit each way; only accept digits
+  // inside the narrower, unsafe interval.
+  uint64_t unit = 1;
+  DiyFp tooLow(low.f - unit, low.e);
+  DiyFp tooHigh(high.f + unit, high.e);
+  uint64_t unsafeInterval = (tooHigh - tooLow).f;
+
+  // Split tooHigh into its integral and fractional parts.
+  DiyFp one(uint64_t(1) << -w.e, w.e);
+  uint32_t integrals = uint32_t(tooHigh.f >> -one.e);
+  uint64_t fractionals = tooHigh.f & (one.f - 1);
+
+  uint32_t divisor;
+  getBiggestPowerOfTen(integrals, divisor, kappa);
+  length = 0;
+
+  while (kappa > 0) {
+    buffer[length++] = char('0' + integrals / divisor);
+    integrals %= divisor;
+    --kappa;
+    uint64_t rest = (uint64_t(integrals) << -one.e) + fractionals;
+    if (rest < unsafeInterval)
+      return roundWeed(buffer, length, (tooHigh - w).f, unsafeInterval, rest,
+                       uint64_t(divisor) << -one.e, unit);
+    divisor /= 10;
+  }
+
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafeInterval *= 10;
+    buffer[length++] = char('0' + (fractionals >> -one.e));
+    fractionals &= one.f - 1;
+    --kappa;
+    if (fractionals < unsafeInterval)
+      return roundWeed(buffer, length, (tooHigh - w).f * unit, unsafeInterval,
+                       fractionals, one.f, unit);
+  }
+}
+
+/// Produce the shortest digits of a finite positive double with Grisu3,
+/// such that the value is digits * 10^exponent.  Returns false if Grisu3
+/// can't guarantee its result.
+static bool grisu3(double value, char *digits, int &length, int &exponent) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint64_t SignificandMask = (uint64_t(1) << 52) - 1;
+  const uint64_t HiddenBit = uint64_t(1) << 52;
+  const int ExponentBias = 1023 + 52;
+  const int DenormalExponent = 1 - ExponentBias;
+
+  int biasedExponent = int(bits >> 52) & 0x7FF;
+  uint64_t significand = bits & SignificandMask;
+  DiyFp v;
+  if (biasedExponent == 0)
+    v = DiyFp(significand, DenormalExponent);
+  else
+    v = DiyFp(significand | HiddenBit, biasedExponent - ExponentBias);
+
+  // The boundaries are halfway to the neighboring doubles.  The lower
+  // neighbor is closer when the significand is a power of two.
+  DiyFp plus = DiyFp((v.f << 1) + 1, v.e - 1).normalize();
+  DiyFp minus;
+  if (significand == 0 && biasedExponent > 1)
+    minus = DiyFp((v.f << 2) - 1, v.e - 2);
+  else
+    minus = DiyFp((v.f << 1) - 1, v.e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  DiyFp w = v.normalize();
+
+  int mk;
+  DiyFp tenMK = getCachedPower(w.e, mk);
+
+  int kappa;
+  if (!generateDigits(minus * tenMK, w * tenMK, plus * tenMK, digits,
+                      length, kappa))
+    return false;
+  exponent = kappa - mk;
+  return true;
+}
+
+/// Produce the shortest digits of a finite positive double by asking the
+/// C library for more and more precision until the result reads back as
+/// the same value.
+static void shortestDigitsSlow(double value, char *digits, int &length,
+                               int &exponent) {
+  char scientific[32];
+  for (int precision = 1; precision <= 17; ++precision) {
+    snprintf(scientific, sizeof(scientific), "%.*e", precision - 1, value);
+    if (precision != 17 && strtod(scientific, nullptr) != value)
+      continue;
+
+    // Collect the digits of "d.ddde[+-]xx".
+    const char *p = scientific;
+    length = 0;
+    for (; *p != 'e'; ++p)
+      if (*p != '.')
+        digits[length++] = *p;
+    exponent = atoi(p + 1) - (length - 1);
+
+    // Drop trailing zeros.
+    while (length > 1 && digits[length - 1] == '0') {
+      --length;
+      ++exponent;
+    }
+    return;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Doubles
+//===----------------------------------------------------------------------===//
+
+uint64_t swift::swift_doubleToString(char *buffer, size_t bufferLength,
+                                     double value) {
+  assert(bufferLength >= MaxDoubleLength && "buffer too small");
+  char *p = buffer;
+
+  if (std::isnan(value)) {
+    memcpy(p, "nan", 3);
+    return 3;
+  }
+  if (std::signbit(value)) {
+    *p++ = '-';
+    value = -value;
+  }
+  if (std::isinf(value)) {
+    memcpy(p, "inf", 3);
+    return p + 3 - buffer;
+  }
+  if (value == 0) {
+    memcpy(p, "0.0", 3);
+    return p + 3 - buffer;
+  }
+
+  char digits[18];
+  int length, exponent;
+  if (!grisu3(value, digits, length, exponent))
+    shortestDigitsSlow(value, digits, length, exponent);
+
+  // The value is 0.digits * 10^point.
+  int point = length + exponent;
+
+  if (point > 16 || point < -3) {
+    // Scientific notation: d[.ddd]e[+-]xx.
+    *p++ = digits[0];
+    if (length > 1) {
+      *p++ = '.';
+      memcpy(p, digits + 1, length - 1);
+      p += length - 1;
+    }
+    *p++ = 'e';
+    int scientificExponent = point - 1;
+    if (scientificExponent < 0) {
+      *p++ = '-';
+      scientificExponent = -scientificExponent;
+    } else {
+      *p++ = '+';
+    }
+    if (scientificExponent < 10)
+      *p++ = '0';
+    p += formatDecimal(p, scientificExponent);
+  } else if (point <= 0) {
+    // 0.000ddd
+    *p++ = '0';
+    *p++ = '.';
+    memset(p, '0', -point);
+    p += -point;
+    memcpy(p, digits, length);
+    p += length;
+  } else if (point >= length) {
+    // ddd000.0
+    memcpy(p, digits, length);
+    p += length;
+    memset(p, '0', point - length);
+    p += point - length;
+    *p++ = '.';
+    *p++ = '0';
+  } else {
+    // ddd.ddd
+    memcpy(p, digits, point);
+    p += point;
+    *p++ = '.';
+    memcpy(p, digits + point, length - point);
+    p += length - point;
+  }
+
+  assert(size_t(p - buffer) <= MaxDoubleLength);
+  return p - buffer;
+}
@@ -0,0 +1,63 @@
+//===--- Formatting.h - Swift Number Formatting ABI -------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Conversion of integers and floating-point numbers to text.  Every entry
+// point writes its characters directly into a caller-provided buffer, which
+// may be the storage of the String being built, and returns the number of
+// characters written.  Nothing is NUL-terminated.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_ABI_FORMATTING_H
+#define SWIFT_ABI_FORMATTING_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace swift {
+
+/// The most characters swift_int64ToString or swift_uint64ToString write
+/// in radix 10.
+const size_t MaxDecimalInt64Length = 20;
+
+/// The most characters swift_int64ToString or swift_uint64ToString write
+/// in any radix.
+const size_t MaxInt64Length = 65;
+
+/// The most characters swift_doubleToString writes.
+const size_t MaxDoubleLength = 24;
+
+/// Format a signed integer in the given radix, which must be between 2 and
+/// 36.  Digits above 9 are upper-case letters.
+extern "C" uint64_t swift_int64ToString(char *buffer, size_t bufferLength,
+                                        int64_t value, int64_t radix);
+
+/// Format an unsigned integer in the given radix, which must be between 2
+/// and 36.  Digits above 9 are upper-case letters.
+extern "C" uint64_t swift_uint64ToString(char *buffer, size_t bufferLength,
+                                         uint64_t value, int64_t radix);
+
+/// Format a 128-bit unsigned integer in the given radix.
+size_t formatUInt128(char *buffer, size_t bufferLength, __uint128_t value,
+                     uint64_t radix);
+
+/// Format a double as the shortest decimal string that reads back as the
+/// same value.  Values whose decimal exponent is in [-4, 16) are written
+/// positionally and always have a fractional part ("1.0", "0.001"); other
+/// values use scientific notation ("1e+16", "2.5e-07").  Infinities and
+/// NaNs are written as "inf", "-inf" and "nan".
+extern "C" uint64_t swift_doubleToString(char *buffer, size_t bufferLength,
+                                         double value);
+
+} // end namespace swift
+
+#endif /* SWIFT_ABI_FORMATTING_H */
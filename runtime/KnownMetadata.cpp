@@ -16,12 +16,27 @@
 
 #include "Metadata.h"
 #include "Alloc.h"
+#include <cstring>
 
 using namespace swift;
 
+/// The flags for types with no ownership semantics, such as integers.
+static const uintptr_t PODFlags =
+  uintptr_t(ValueWitnessFlags::IsPOD) |
+  uintptr_t(ValueWitnessFlags::IsBitwiseTakable) |
+  uintptr_t(ValueWitnessFlags::IsInline);
+
+/// The flags for types that hold a reference, such as object pointers.
+static const uintptr_t ReferenceFlags =
+  uintptr_t(ValueWitnessFlags::IsBitwiseTakable) |
+  uintptr_t(ValueWitnessFlags::IsInline);
+
 /// A function which helpfully does nothing.
 static void doNothing(void *ptr, const void *self) {}
 
+/// A destroyArray implementation which helpfully does nothing.
+static void doNothingArray(void *array, size_t n, const void *self) {}
+
 /// A projectBuffer implementation which just reinterprets the buffer.
 static OpaqueValue *projectBuffer(ValueBuffer *dest,
                                   const ValueWitnessTable *self) {
@@ -35,10 +50,30 @@ template <class T> static T *copy(T *dest, T *src,
   return dest;
 }
 
+/// A function which does a naive copy of an array of values.  The
+/// arrays must not overlap.
+template <class T> static T *copyArray(T *dest, T *src, size_t n,
+                                       const ValueWitnessTable *self) {
+  memcpy(dest, src, n * sizeof(T));
+  return dest;
+}
+
+/// A function which does a naive move of an array of values.  The
+/// arrays may overlap, so this serves for both directions of take.
+template <class T> static T *takeArray(T *dest, T *src, size_t n,
+                                       const ValueWitnessTable *self) {
+  memmove(dest, src, n * sizeof(T));
+  return dest;
+}
+
 // Work around a Xcode 4.5 bug (rdar://12288058) by explicitly
-// instantiating this function template at the types we'll need.
+// instantiating these function templates at the types we'll need.
 #define INSTANTIATE(TYPE) \
-  template TYPE *copy<TYPE>(TYPE*, TYPE*, const ValueWitnessTable*);
+  template TYPE *copy<TYPE>(TYPE*, TYPE*, const ValueWitnessTable*); \
+  template TYPE *copyArray<TYPE>(TYPE*, TYPE*, size_t,                \
+                                 const ValueWitnessTable*);           \
+  template TYPE *takeArray<TYPE>(TYPE*, TYPE*, size_t,                \
+                                 const ValueWitnessTable*);
 INSTANTIATE(uint8_t);
 INSTANTIATE(uint16_t);
 INSTANTIATE(uint32_t);
@@ -59,9 +94,16 @@ INSTANTIATE(uintptr_t);
   (value_witness_types::initializeWithTake*) &copy<TYPE>,               \
   (value_witness_types::assignWithTake*) &copy<TYPE>,                   \
   (value_witness_types::allocateBuffer*) &projectBuffer,                \
+  (value_witness_types::destroyArray*) &doNothingArray,                 \
+  (value_witness_types::initializeArrayWithCopy*) &copyArray<TYPE>,     \
+  (value_witness_types::initializeArrayWithTakeFrontToBack*)            \
+    &takeArray<TYPE>,                                                   \
+  (value_witness_types::initializeArrayWithTakeBackToFront*)            \
+    &takeArray<TYPE>,                                                   \
   (value_witness_types::size) (SIZE),                                   \
   (value_witness_types::alignment) (SIZE),                              \
-  (value_witness_types::stride) (SIZE)                                  \
+  (value_witness_types::stride) (SIZE),                                 \
+  (value_witness_types::flags) PODFlags                                 \
 }
 
 const ValueWitnessTable swift::_TWVBi8_ = POD_VALUE_WITNESS_TABLE(uint8_t, 1);
@@ -84,6 +126,24 @@ static void destroyWithRelease(HeapObject **var,
   swift_release(*var);
 }
 
+/// A function to destroy an array of variables by releasing the values
+/// in them.
+static void destroyArrayWithRelease(HeapObject **array, size_t n,
+                                    const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i)
+    swift_release(array[i]);
+}
+
+/// A function to initialize an array of variables by retaining the
+/// given pointers and then assigning them.
+static HeapObject **initArrayWithRetain(HeapObject **dest,
+                                        HeapObject **src, size_t n,
+                                        const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i)
+    dest[i] = swift_retain(src[i]);
+  return dest;
+}
+
 /// A function to assign to a variable by copying from an existing one.
 static HeapObject **assignWithRetain(HeapObject **dest,
                                      HeapObject **src,
@@ -118,9 +178,16 @@ const ValueWitnessTable swift::_TWVBo = {
   (value_witness_types::initializeWithTake*) &copy<uintptr_t>,
   (value_witness_types::assignWithTake*) &assignWithoutRetain,
   (value_witness_types::allocateBuffer*) &projectBuffer,
+  (value_witness_types::destroyArray*) &destroyArrayWithRelease,
+  (value_witness_types::initializeArrayWithCopy*) &initArrayWithRetain,
+  (value_witness_types::initializeArrayWithTakeFrontToBack*)
+    &takeArray<uintptr_t>,
+  (value_witness_types::initializeArrayWithTakeBackToFront*)
+    &takeArray<uintptr_t>,
   (value_witness_types::size) sizeof(void*),
   (value_witness_types::alignment) sizeof(void*),
-  (value_witness_types::stride) sizeof(void*)
+  (value_witness_types::stride) sizeof(void*),
+  (value_witness_types::flags) ReferenceFlags
 };
 
 /*** Objective-C pointers ****************************************************/
@@ -146,6 +213,23 @@ static void destroyWithObjCRelease(void **var,
   objc_release(*var);
 }
 
+/// A function to destroy an array of variables by releasing the values
+/// in them.
+static void destroyArrayWithObjCRelease(void **array, size_t n,
+                                        const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i)
+    objc_release(array[i]);
+}
+
+/// A function to initialize an array of variables by retaining the
+/// given pointers and then assigning them.
+static void **initArrayWithObjCRetain(void **dest, void **src, size_t n,
+                                      const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i)
+    dest[i] = objc_retain(src[i]);
+  return dest;
+}
+
 /// A function to assign to a variable by copying from an existing one.
 static void **assignWithObjCRetain(void **dest, void **src,
                                    const ValueWitnessTable *self) {
@@ -178,9 +262,16 @@ const ValueWitnessTable swift::_TWVBO = {
   (value_witness_types::initializeWithTake*) &copy<uintptr_t>,
   (value_witness_types::assignWithTake*) &assignWithoutObjCRetain,
   (value_witness_types::allocateBuffer*) &projectBuffer,
+  (value_witness_types::destroyArray*) &destroyArrayWithObjCRelease,
+  (value_witness_types::initializeArrayWithCopy*) &initArrayWithObjCRetain,
+  (value_witness_types::initializeArrayWithTakeFrontToBack*)
+    &takeArray<uintptr_t>,
+  (value_witness_types::initializeArrayWithTakeBackToFront*)
+    &takeArray<uintptr_t>,
   (value_witness_types::size) sizeof(void*),
   (value_witness_types::alignment) alignof(void*),
-  (value_witness_types::stride) sizeof(void*)
+  (value_witness_types::stride) sizeof(void*),
+  (value_witness_types::flags) ReferenceFlags
 };
 
 /*** Functions ***************************************************************/
@@ -214,6 +305,28 @@ static Function *function_initWithoutRetain(Function *dest, Function *src,
   return dest;
 }
 
+static void function_destroyArray(Function *array, size_t n,
+                                  const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i)
+    swift_release(array[i].Data);
+}
+
+static Function *function_initArrayWithRetain(Function *dest, Function *src,
+                                              size_t n,
+                                              const ValueWitnessTable *self) {
+  for (size_t i = 0; i != n; ++i) {
+    dest[i].FnPtr = src[i].FnPtr;
+    dest[i].Data = swift_retain(src[i].Data);
+  }
+  return dest;
+}
+
+static Function *function_takeArray(Function *dest, Function *src, size_t n,
+                                    const ValueWitnessTable *self) {
+  memmove(dest, src, n * sizeof(Function));
+  return dest;
+}
+
 static Function *function_assignWithRetain(Function *dest, Function *src,
                                            const ValueWitnessTable *self) {
   dest->FnPtr = src->FnPtr;
@@ -248,9 +361,16 @@ const ValueWitnessTable swift::_TWVFT_T_ = {
   (value_witness_types::initializeWithTake*) &function_initWithoutRetain,
   (value_witness_types::assignWithTake*) &function_assignWithoutRetain,
   (value_witness_types::allocateBuffer*) &projectBuffer,
+  (value_witness_types::destroyArray*) &function_destroyArray,
+  (value_witness_types::initializeArrayWithCopy*) &function_initArrayWithRetain,
+  (value_witness_types::initializeArrayWithTakeFrontToBack*)
+    &function_takeArray,
+  (value_witness_types::initializeArrayWithTakeBackToFront*)
+    &function_takeArray,
   (value_witness_types::size) sizeof(Function),
   (value_witness_types::alignment) alignof(Function),
-  (value_witness_types::stride) sizeof(Function)
+  (value_witness_types::stride) sizeof(Function),
+  (value_witness_types::flags) ReferenceFlags
 };
 
 /*** Empty tuples ************************************************************/
@@ -260,6 +380,11 @@ static void *doNothing3(void *dest, void *src, void *self) {
   return dest;
 }
 
+// An array operation which does nothing and returns its first argument.
+static void *doNothing4(void *dest, void *src, size_t n, void *self) {
+  return dest;
+}
+
 /// The basic value-witness table for empty types.
 const ValueWitnessTable swift::_TWVT_ = {
   (value_witness_types::destroyBuffer*) &doNothing,
@@ -274,9 +399,14 @@ const ValueWitnessTable swift::_TWVT_ = {
   (value_witness_types::initializeWithTake*) &doNothing3,
   (value_witness_types::assignWithTake*) &doNothing3,
   (value_witness_types::allocateBuffer*) &projectBuffer,
+  (value_witness_types::destroyArray*) &doNothingArray,
+  (value_witness_types::initializeArrayWithCopy*) &doNothing4,
+  (value_witness_types::initializeArrayWithTakeFrontToBack*) &doNothing4,
+  (value_witness_types::initializeArrayWithTakeBackToFront*) &doNothing4,
   (value_witness_types::size) 0,
   (value_witness_types::alignment) 1,
-  (value_witness_types::stride) 0
+  (value_witness_types::stride) 0,
+  (value_witness_types::flags) PODFlags
 };
 
 /*** Known metadata **********************************************************/
@@ -56,11 +56,23 @@ namespace {
     }
 
   public:
+    /// Return the number of bytes an entry with the given number of
+    /// arguments and payload size occupies.
+    static size_t getAllocationSize(size_t numArguments, size_t payloadSize) {
+      return sizeof(Impl) + numArguments * sizeof(void*) + payloadSize;
+    }
+
     static Impl *allocate(const void * const *arguments,
                           size_t numArguments, size_t payloadSize) {
-      void *buffer = operator new(sizeof(Impl) +
-                                  numArguments * sizeof(void*) +
-                                  payloadSize);
+      void *buffer = operator new(getAllocationSize(numArguments,
+                                                    payloadSize));
+      return allocateIn(buffer, arguments, numArguments);
+    }
+
+    /// Create an entry in memory the caller has already allocated, which
+    /// must be at least getAllocationSize bytes.
+    static Impl *allocateIn(void *buffer, const void * const *arguments,
+                            size_t numArguments) {
       auto result = new (buffer) Impl(numArguments);
 
       // Copy the arguments into the right place for the key.
@@ -121,10 +133,13 @@ namespace {
     const Entry *Head;
 
   public:
-    /// Try to find an existing entry in this cache.
-    const Entry *find(const void * const *arguments, size_t numArguments) const {
+    /// Try to find an existing entry in this cache.  Any extra keys are
+    /// passed on to the entries' matches method.
+    template <class... ExtraKeys>
+    const Entry *find(const void * const *arguments, size_t numArguments,
+                      ExtraKeys... extraKeys) const {
       for (auto entry = Head; entry != nullptr; entry = entry->getNext())
-        if (entry->matches(arguments, numArguments))
+        if (entry->matches(arguments, numArguments, extraKeys...))
           return entry;
       return nullptr;
     }
@@ -188,12 +203,8 @@ instantiateGenericMetadata(GenericMetadata *pattern,
 const void *
 swift::swift_dynamicCast(const void *object, const ClassMetadata *targetType) {
   const ClassMetadata *isa = *reinterpret_cast<ClassMetadata *const*>(object);
-  do {
-    if (isa == targetType) {
-      return object;
-    }
-    isa = isa->SuperClass;
-  } while (targetType);
+  if (isa->isSubclassOf(targetType))
+    return object;
   return NULL;
 }
 
@@ -255,26 +266,68 @@ swift::swift_getFunctionTypeMetadata(const Metadata *argMetadata,
 
 /*** Tuples ****************************************************************/
 
-typedef HeterogeneousCacheEntry TupleCacheEntry;
+namespace {
+  /// Matches tuple cache entries with the given element types, whatever
+  /// their labels.
+  enum AnyLabels_t { AnyLabels };
+
+  /// The cache entry for a tuple type, which is keyed by its element
+  /// types and its labels.
+  ///
+  /// The data of the entry is the tuple metadata, including its variably-
+  /// sized array of elements.  If the tuple needs a value witness table of
+  /// its own, that follows the elements.
+  class TupleCacheEntry : public CacheEntry<TupleCacheEntry> {
+    const size_t NumArguments;
+
+    static bool labelsMatch(const char *a, const char *b) {
+      // Labels strings are usually uniqued within a linkage unit.
+      if (a == b) return true;
+      if (!a || !b) return false;
+      return strcmp(a, b) == 0;
+    }
+
+  public:
+    /// The labels string of the tuple type.
+    const char *Labels = nullptr;
+
+    TupleCacheEntry(size_t numArguments) : NumArguments(numArguments) {}
+
+    /// Does this cache entry match the given element types and labels?
+    bool matches(const void * const *arguments, size_t numArguments,
+                 const char *labels) const {
+      return NumArguments == numArguments && labelsMatch(Labels, labels) &&
+             argumentsBufferMatches(arguments, numArguments);
+    }
+
+    /// Does this cache entry have the given element types?
+    bool matches(const void * const *arguments, size_t numArguments,
+                 AnyLabels_t) const {
+      return NumArguments == numArguments &&
+             argumentsBufferMatches(arguments, numArguments);
+    }
+
+    const TupleTypeMetadata *getMetadata() const {
+      return getData<TupleTypeMetadata>(NumArguments);
+    }
+  };
+}
 
 /// The uniquing structure for tuple type metadata.
 static MetadataCache<TupleCacheEntry> TupleTypes;
 
-namespace {
-  /// The data structure carried by the entries in TupleTypes.
-  ///
-  /// All of the generic tuple witnesses below expect to be able to
-  /// cast their witness-table pointers to this type.
-  struct TupleTypeData {
-    ValueWitnessTable Witnesses;
-    TupleTypeMetadata Metadata; // includes a variably-sized array of elements
-  };
+/// Return the size of the data of a tuple cache entry.
+static size_t getTupleDataSize(size_t numElements, bool hasOwnWitnesses) {
+  return sizeof(TupleTypeMetadata) +
+         numElements * sizeof(TupleTypeMetadata::Element) +
+         (hasOwnWitnesses ? sizeof(ValueWitnessTable) : 0);
 }
 
 /// Given a metatype pointer, produce the value-witness table for it.
-/// This is equivalent to metatype->ValueWitnesses but more efficient.
+/// Tuples with the same layout can share a table, so it can't be found
+/// at a fixed offset from the metadata.
 static const ValueWitnessTable *tuple_getValueWitnesses(const Metadata *metatype) {
-  return ((const ValueWitnessTable*) metatype) - 1;
+  return metatype->ValueWitnesses;
 }
 
 /// Generic tuple value witness for 'projectBuffer'.
@@ -313,6 +366,9 @@ static void tuple_deallocateBuffer(ValueBuffer *buffer,
 
 /// Generic tuple value witness for 'destroy'.
 static void tuple_destroy(OpaqueValue *tuple, const Metadata *_metatype) {
+  if (tuple_getValueWitnesses(_metatype)->isPOD())
+    return;
+
   auto &metadata = *(const TupleTypeMetadata*) _metatype;
   for (size_t i = 0, e = metadata.NumElements; i != e; ++i) {
     auto &eltInfo = metadata.getElements()[i];
@@ -352,10 +408,25 @@ static OpaqueValue *tuple_forEachField(OpaqueValue *destTuple,
   return destTuple;
 }
 
+/// Copy the whole of a tuple whose value witnesses say that doing so
+/// bitwise is correct.  Assignments have to tolerate aliasing.
+static OpaqueValue *tuple_memcpy(OpaqueValue *dest, OpaqueValue *src,
+                                 const Metadata *metatype) {
+  memcpy(dest, src, tuple_getValueWitnesses(metatype)->size);
+  return dest;
+}
+static OpaqueValue *tuple_memmove(OpaqueValue *dest, OpaqueValue *src,
+                                  const Metadata *metatype) {
+  memmove(dest, src, tuple_getValueWitnesses(metatype)->size);
+  return dest;
+}
+
 /// Generic tuple value witness for 'initializeWithCopy'.
 static OpaqueValue *tuple_initializeWithCopy(OpaqueValue *dest,
                                              OpaqueValue *src,
                                              const Metadata *metatype) {
+  if (tuple_getValueWitnesses(metatype)->isPOD())
+    return tuple_memcpy(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::initializeWithCopy);
 }
@@ -364,6 +435,8 @@ static OpaqueValue *tuple_initializeWithCopy(OpaqueValue *dest,
 static OpaqueValue *tuple_initializeWithTake(OpaqueValue *dest,
                                              OpaqueValue *src,
                                              const Metadata *metatype) {
+  if (tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_memcpy(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::initializeWithTake);
 }
@@ -372,6 +445,8 @@ static OpaqueValue *tuple_initializeWithTake(OpaqueValue *dest,
 static OpaqueValue *tuple_assignWithCopy(OpaqueValue *dest,
                                          OpaqueValue *src,
                                          const Metadata *metatype) {
+  if (tuple_getValueWitnesses(metatype)->isPOD())
+    return tuple_memmove(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::assignWithCopy);
 }
@@ -380,6 +455,8 @@ static OpaqueValue *tuple_assignWithCopy(OpaqueValue *dest,
 static OpaqueValue *tuple_assignWithTake(OpaqueValue *dest,
                                          OpaqueValue *src,
                                          const Metadata *metatype) {
+  if (tuple_getValueWitnesses(metatype)->isPOD())
+    return tuple_memmove(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::assignWithTake);
 }
@@ -411,65 +488,210 @@ static OpaqueValue *tuple_initializeBufferWithCopyOfBuffer(ValueBuffer *dest,
                                         metatype);
 }
 
+/// Return the address of the element at the given index in an array of
+/// tuples.
+static OpaqueValue *tuple_getArrayElement(OpaqueValue *array, size_t index,
+                                          const Metadata *metatype) {
+  size_t stride = tuple_getValueWitnesses(metatype)->stride;
+  return reinterpret_cast<OpaqueValue*>(
+                          reinterpret_cast<char*>(array) + index * stride);
+}
+
+/// Generic tuple value witness for 'destroyArray'.
+static void tuple_destroyArray(OpaqueValue *array, size_t n,
+                               const Metadata *metatype) {
+  if (tuple_getValueWitnesses(metatype)->isPOD())
+    return;
+  for (size_t i = 0; i != n; ++i)
+    tuple_destroy(tuple_getArrayElement(array, i, metatype), metatype);
+}
+
+/// Generic tuple value witness for 'initializeArrayWithCopy'.
+static OpaqueValue *tuple_initializeArrayWithCopy(OpaqueValue *dest,
+                                                  OpaqueValue *src,
+                                                  size_t n,
+                                                  const Metadata *metatype) {
+  auto wtable = tuple_getValueWitnesses(metatype);
+  if (wtable->isPOD()) {
+    memcpy(dest, src, n * wtable->stride);
+    return dest;
+  }
+  for (size_t i = 0; i != n; ++i)
+    tuple_initializeWithCopy(tuple_getArrayElement(dest, i, metatype),
+                             tuple_getArrayElement(src, i, metatype),
+                             metatype);
+  return dest;
+}
+
+/// Generic tuple value witness for 'initializeArrayWithTakeFrontToBack'.
+static OpaqueValue *
+tuple_initializeArrayWithTakeFrontToBack(OpaqueValue *dest, OpaqueValue *src,
+                                         size_t n, const Metadata *metatype) {
+  auto wtable = tuple_getValueWitnesses(metatype);
+  if (wtable->isBitwiseTakable()) {
+    memmove(dest, src, n * wtable->stride);
+    return dest;
+  }
+  for (size_t i = 0; i != n; ++i)
+    tuple_initializeWithTake(tuple_getArrayElement(dest, i, metatype),
+                             tuple_getArrayElement(src, i, metatype),
+                             metatype);
+  return dest;
+}
+
+/// Generic tuple value witness for 'initializeArrayWithTakeBackToFront'.
+static OpaqueValue *
+tuple_initializeArrayWithTakeBackToFront(OpaqueValue *dest, OpaqueValue *src,
+                                         size_t n, const Metadata *metatype) {
+  auto wtable = tuple_getValueWitnesses(metatype);
+  if (wtable->isBitwiseTakable()) {
+    memmove(dest, src, n * wtable->stride);
+    return dest;
+  }
+  for (size_t i = n; i != 0; --i)
+    tuple_initializeWithTake(tuple_getArrayElement(dest, i - 1, metatype),
+                             tuple_getArrayElement(src, i - 1, metatype),
+                             metatype);
+  return dest;
+}
+
 /// Standard, inefficient witness table for tuples.
 static const ValueWitnessTable tuple_witnesses = {
 #define TUPLE_WITNESS(NAME) &tuple_##NAME,
   FOR_ALL_FUNCTION_VALUE_WITNESSES(TUPLE_WITNESS)
 #undef TUPLE_WITNESS
+  0,
   0,
   0,
   0
 };
 
-const TupleTypeMetadata *
-swift::swift_getTupleTypeMetadata(size_t numElements,
-                                  const Metadata * const *elements,
-                                  const char *labels,
-                                  const ValueWitnessTable *proposedWitnesses) {
-  if (numElements == 0)
-    return &_TMdT_;
+/// Fill in the layout of a tuple's value witness table.
+static void initTupleLayoutWitnesses(ValueWitnessTable *witnesses,
+                                     size_t size, size_t alignment,
+                                     bool isPOD, bool isBitwiseTakable) {
+  witnesses->size = size;
+  witnesses->alignment = alignment;
+  witnesses->stride = llvm::RoundUpToAlignment(size, alignment);
+
+  uintptr_t flags = 0;
+  if (isPOD) flags |= uintptr_t(ValueWitnessFlags::IsPOD);
+  if (isBitwiseTakable) flags |= uintptr_t(ValueWitnessFlags::IsBitwiseTakable);
+  if (isValueInline(size, alignment))
+    flags |= uintptr_t(ValueWitnessFlags::IsInline);
+  witnesses->flags = flags;
+}
 
-  // FIXME: include labels when uniquing!
+typedef HomogeneousCacheEntry PODWitnessCacheEntry;
+
+/// The value witness tables shared by all POD tuples of a given size
+/// and alignment.
+static MetadataCache<PODWitnessCacheEntry> PODTupleWitnesses;
+
+/// Return the shared value witness table for POD tuples of the given
+/// size and alignment.
+static const ValueWitnessTable *getPODTupleWitnesses(size_t size,
+                                                     size_t alignment) {
+  const size_t numKeys = 2;
+  const void *key[] = { (const void*) size, (const void*) alignment };
+  if (auto entry = PODTupleWitnesses.find(key, numKeys))
+    return entry->getData<ValueWitnessTable>(numKeys);
+
+  auto entry = PODWitnessCacheEntry::allocate(key, numKeys,
+                                              sizeof(ValueWitnessTable));
+  auto witnesses = entry->getData<ValueWitnessTable>(numKeys);
+  *witnesses = tuple_witnesses;
+  initTupleLayoutWitnesses(witnesses, size, alignment,
+                           /*isPOD*/ true, /*isBitwiseTakable*/ true);
+  return PODTupleWitnesses.add(entry)->getData<ValueWitnessTable>(numKeys);
+}
 
+/// Find an existing tuple metadata, or return null.
+static const TupleTypeMetadata *
+findTupleTypeMetadata(size_t numElements, const Metadata * const *elements,
+                      const char *labels) {
+  if (numElements == 0)
+    return &_TMdT_;
   auto genericArgs = (const void * const *) elements;
-  if (auto entry = TupleTypes.find(genericArgs, numElements)) {
-    return &entry->getData<TupleTypeData>(numElements)->Metadata;
-  }
+  if (auto entry = TupleTypes.find(genericArgs, numElements, labels))
+    return entry->getMetadata();
+  return nullptr;
+}
 
+/// Instantiate the metadata for a tuple type that isn't in the cache.  If
+/// an arena is given, the entry is carved out of it and the arena pointer
+/// is advanced past it; the arena must have room for an entry with its
+/// own value witnesses.
+static const TupleTypeMetadata *
+instantiateTupleTypeMetadata(size_t numElements,
+                             const Metadata * const *elements,
+                             const char *labels,
+                             const ValueWitnessTable *proposedWitnesses,
+                             char **arena = nullptr) {
   typedef TupleTypeMetadata::Element Element;
+  auto genericArgs = (const void * const *) elements;
 
-  // This is actually a bit silly because the data is *completely*
-  // shared between the header and the tuple metadata itself.
-  auto entry = TupleCacheEntry::allocate(genericArgs, numElements,
-                                         sizeof(TupleTypeData) +
-                                         numElements * sizeof(Element));
-
-  auto data = entry->getData<TupleTypeData>(numElements);
-  auto witnesses = &data->Witnesses;
+  // The labels don't affect the layout, so a tuple with the same element
+  // types and different labels can share its layout and witnesses.
+  auto sibling = TupleTypes.find(genericArgs, numElements, AnyLabels);
+
+  // A tuple is only as trivial as its least trivial element.  POD tuples
+  // share a witness table with the other POD tuples of their size.
+  bool isPOD = true;
+  if (!sibling)
+    for (size_t i = 0; i != numElements; ++i)
+      isPOD &= elements[i]->ValueWitnesses->isPOD();
+  bool hasOwnWitnesses = !sibling && !isPOD;
+
+  size_t dataSize = getTupleDataSize(numElements, hasOwnWitnesses);
+  TupleCacheEntry *entry;
+  if (arena) {
+    entry = TupleCacheEntry::allocateIn(*arena, genericArgs, numElements);
+    *arena += TupleCacheEntry::getAllocationSize(numElements, dataSize);
+  } else {
+    entry = TupleCacheEntry::allocate(genericArgs, numElements, dataSize);
+  }
+  entry->Labels = labels;
 
-  auto metadata = &data->Metadata;
+  auto metadata = entry->getData<TupleTypeMetadata>(numElements);
   metadata->Base.Kind = MetadataKind::Tuple;
-  metadata->Base.ValueWitnesses = witnesses;
   metadata->NumElements = numElements;
   metadata->Labels = labels;
 
+  if (sibling) {
+    auto siblingMetadata = sibling->getMetadata();
+    metadata->Base.ValueWitnesses = siblingMetadata->Base.ValueWitnesses;
+    memcpy(metadata->getElements(), siblingMetadata->getElements(),
+           numElements * sizeof(Element));
+    return TupleTypes.add(entry)->getMetadata();
+  }
+
   size_t size = 0;
   size_t alignment = 1;
+  bool isBitwiseTakable = true;
   for (unsigned i = 0; i != numElements; ++i) {
     auto elt = elements[i];
 
-    metadata->getElements()[i].Type = elt;
-    metadata->getElements()[i].Offset = size;
-
     // Lay out this tuple element.
     size = llvm::RoundUpToAlignment(size, elt->ValueWitnesses->alignment);
+    metadata->getElements()[i].Type = elt;
+    metadata->getElements()[i].Offset = size;
     size += elt->ValueWitnesses->size;
     alignment = std::max(alignment, elt->ValueWitnesses->alignment);
+
+    isBitwiseTakable &= elt->ValueWitnesses->isBitwiseTakable();
   }
 
-  witnesses->size = size;
-  witnesses->alignment = alignment;
-  witnesses->stride = llvm::RoundUpToAlignment(size, alignment);
+  if (!hasOwnWitnesses) {
+    metadata->Base.ValueWitnesses = getPODTupleWitnesses(size, alignment);
+    return TupleTypes.add(entry)->getMetadata();
+  }
+
+  auto witnesses = reinterpret_cast<ValueWitnessTable*>(
+                                       metadata->getElements() + numElements);
+  metadata->Base.ValueWitnesses = witnesses;
+  initTupleLayoutWitnesses(witnesses, size, alignment, isPOD,
+                           isBitwiseTakable);
 
   // Copy the function witnesses in, either from the proposed
   // witnesses or from the standard table.
@@ -479,7 +701,53 @@ swift::swift_getTupleTypeMetadata(size_t numElements,
   FOR_ALL_FUNCTION_VALUE_WITNESSES(ASSIGN_TUPLE_WITNESS)
 #undef ASSIGN_TUPLE_WITNESS
 
-  return &TupleTypes.add(entry)->getData<TupleTypeData>(numElements)->Metadata;
+  return TupleTypes.add(entry)->getMetadata();
+}
+
+const TupleTypeMetadata *
+swift::swift_getTupleTypeMetadata(size_t numElements,
+                                  const Metadata * const *elements,
+                                  const char *labels,
+                                  const ValueWitnessTable *proposedWitnesses) {
+  if (auto metadata = findTupleTypeMetadata(numElements, elements, labels))
+    return metadata;
+  return instantiateTupleTypeMetadata(numElements, elements, labels,
+                                      proposedWitnesses);
+}
+
+void
+swift::swift_getTupleTypeMetadataArray(size_t numTuples,
+                                       const TupleTypeDescriptor *tuples,
+                                       const TupleTypeMetadata **results) {
+  // Look everything up first, so that all the missing tuples can be
+  // allocated at once.
+  size_t arenaSize = 0;
+  for (size_t i = 0; i != numTuples; ++i) {
+    auto &tuple = tuples[i];
+    results[i] = findTupleTypeMetadata(tuple.NumElements, tuple.Elements,
+                                       tuple.Labels);
+    if (!results[i])
+      arenaSize += TupleCacheEntry::getAllocationSize(tuple.NumElements,
+                                 getTupleDataSize(tuple.NumElements, true));
+  }
+  if (arenaSize == 0)
+    return;
+
+  char *arena = (char*) operator new(arenaSize);
+  for (size_t i = 0; i != numTuples; ++i) {
+    if (results[i])
+      continue;
+
+    // An earlier tuple in the array may have had the same type.
+    auto &tuple = tuples[i];
+    results[i] = findTupleTypeMetadata(tuple.NumElements, tuple.Elements,
+                                       tuple.Labels);
+    if (!results[i])
+      results[i] = instantiateTupleTypeMetadata(tuple.NumElements,
+                                                tuple.Elements, tuple.Labels,
+                                                tuple.ProposedWitnesses,
+                                                &arena);
+  }
 }
 
 /*** Metatypes *************************************************************/
@@ -243,6 +243,69 @@ typedef OpaqueValue *assignWithTake(OpaqueValue *dest,
 typedef OpaqueValue *allocateBuffer(ValueBuffer *buffer,
                                     const Metadata *self);
 
+/// Given an array of initialized objects, destroy them.
+///
+/// Preconditions:
+///   'array' holds 'n' initialized objects, 'stride' bytes apart
+/// Postconditions:
+///   'array' holds 'n' uninitialized objects
+typedef void destroyArray(OpaqueValue *array, size_t n,
+                          const Metadata *self);
+
+/// Given an array of uninitialized objects and an array of initialized
+/// objects, copy the values from one to the other.
+///
+/// This operation does not need to be safe aginst 'dest' and 'src' aliasing.
+///
+/// Returns the dest array.
+///
+/// Preconditions:
+///   'dest' holds 'n' uninitialized objects
+/// Postconditions:
+///   'dest' holds 'n' initialized objects
+/// Invariants:
+///   'src' holds 'n' initialized objects
+typedef OpaqueValue *initializeArrayWithCopy(OpaqueValue *dest,
+                                             OpaqueValue *src,
+                                             size_t n,
+                                             const Metadata *self);
+
+/// Given an array of uninitialized objects and an array of initialized
+/// objects, move the values from one to the other, leaving the source
+/// objects uninitialized.  Elements are moved in order from first to
+/// last, so this is safe if 'dest' is below an overlapping 'src'.
+///
+/// Returns the dest array.
+///
+/// Preconditions:
+///   'dest' holds 'n' uninitialized objects
+///   'src' holds 'n' initialized objects
+/// Postconditions:
+///   'dest' holds 'n' initialized objects
+///   'src' holds 'n' uninitialized objects
+typedef OpaqueValue *initializeArrayWithTakeFrontToBack(OpaqueValue *dest,
+                                                        OpaqueValue *src,
+                                                        size_t n,
+                                                        const Metadata *self);
+
+/// Given an array of uninitialized objects and an array of initialized
+/// objects, move the values from one to the other, leaving the source
+/// objects uninitialized.  Elements are moved in order from last to
+/// first, so this is safe if 'dest' is above an overlapping 'src'.
+///
+/// Returns the dest array.
+///
+/// Preconditions:
+///   'dest' holds 'n' uninitialized objects
+///   'src' holds 'n' initialized objects
+/// Postconditions:
+///   'dest' holds 'n' initialized objects
+///   'src' holds 'n' uninitialized objects
+typedef OpaqueValue *initializeArrayWithTakeBackToFront(OpaqueValue *dest,
+                                                        OpaqueValue *src,
+                                                        size_t n,
+                                                        const Metadata *self);
+
 /// The number of bytes required to store an object of this type.
 /// This value may be zero.  This value is not necessarily a
 /// multiple of the alignment.
@@ -256,6 +319,13 @@ typedef size_t alignment;
 /// a multiple of the alignment.
 typedef size_t stride;
 
+/// A set of ValueWitnessFlags describing the type.  Clients may use
+/// these to skip calling the function witnesses: a POD type can be
+/// copied with memcpy and needs no destruction, a bitwise-takable type
+/// can be taken with memcpy, and an inline type never side-allocates
+/// its value buffer.
+typedef uintptr_t flags;
+
 } // end namespace value_witness_types
 
 #define FOR_ALL_FUNCTION_VALUE_WITNESSES(MACRO) \
@@ -270,7 +340,11 @@ typedef size_t stride;
   MACRO(initializeBufferWithTake) \
   MACRO(initializeWithTake) \
   MACRO(assignWithTake) \
-  MACRO(allocateBuffer)
+  MACRO(allocateBuffer) \
+  MACRO(destroyArray) \
+  MACRO(initializeArrayWithCopy) \
+  MACRO(initializeArrayWithTakeFrontToBack) \
+  MACRO(initializeArrayWithTakeBackToFront)
 
 /// A value-witness table.  A value witness table is built around
 /// the requirements of some specific type.  The information in
@@ -288,13 +362,30 @@ struct ValueWitnessTable {
   value_witness_types::size size;
   value_witness_types::alignment alignment;
   value_witness_types::stride stride;
+  value_witness_types::flags flags;
 
   /// Are values of this type allocated inline?
   bool isValueInline() const {
-    return (size <= sizeof(ValueBuffer) && alignment <= alignof(ValueBuffer));
+    return flags & uintptr_t(ValueWitnessFlags::IsInline);
+  }
+
+  /// Are values of this type plain old data?
+  bool isPOD() const {
+    return flags & uintptr_t(ValueWitnessFlags::IsPOD);
+  }
+
+  /// Can values of this type be taken with memcpy?
+  bool isBitwiseTakable() const {
+    return flags & uintptr_t(ValueWitnessFlags::IsBitwiseTakable);
   }
 };
 
+/// Compute whether values with the given size and alignment fit inline
+/// in a ValueBuffer.
+static inline bool isValueInline(size_t size, size_t alignment) {
+  return (size <= sizeof(ValueBuffer) && alignment <= alignof(ValueBuffer));
+}
+
 // Standard value-witness tables.
 
 // The "Int" tables are used for arbitrary POD data with the matching
@@ -396,6 +487,31 @@ struct ClassMetadata : public HeapMetadata {
   /// The metadata for the super class.  This is null for the root class.
   const ClassMetadata *SuperClass;
 
+  /// The number of superclasses of this class.  This is zero for the
+  /// root class.
+  uintptr_t Depth;
+
+  /// The display of this class's ancestors, indexed by depth:  entry 0
+  /// is the root class and entry Depth is this class itself.  This
+  /// lets a subclass check be answered with a single load and compare.
+  ///
+  /// This is null if the compiler could not build the display
+  /// statically, as for instantiations of generic classes; such classes
+  /// are checked by walking the SuperClass chain instead.
+  const ClassMetadata * const *Ancestors;
+
+  /// Is this class the given class or one of its subclasses?
+  bool isSubclassOf(const ClassMetadata *other) const {
+    if (Ancestors && other->Ancestors) {
+      uintptr_t depth = other->Depth;
+      return depth <= Depth && Ancestors[depth] == other;
+    }
+    for (const ClassMetadata *cls = this; cls; cls = cls->SuperClass)
+      if (cls == other)
+        return true;
+    return false;
+  }
+
   // After this come the class members, laid out as follows:
   //   - class members for the base class (recursively)
   //   - metadata reference for the parent, if applicable
@@ -560,7 +676,9 @@ struct GenericMetadata {
   }
 };
 
-/// \brief Simple proof of concept dynamic_cast API
+/// \brief Cast an object to the given class, or to one of its subclasses.
+///
+/// \returns the object, or null if it is not an instance of the class.
 extern "C" const void *
 swift_dynamicCast(const void *object, const ClassMetadata *targetType);
 
@@ -620,6 +738,27 @@ swift_getTupleTypeMetadata(size_t numElements,
                            const char *labels,
                            const ValueWitnessTable *proposedWitnesses);
 
+/// \brief The arguments of one call to swift_getTupleTypeMetadata, for
+/// swift_getTupleTypeMetadataArray.
+struct TupleTypeDescriptor {
+  size_t NumElements;
+  const Metadata * const *Elements;
+  const char *Labels;
+  const ValueWitnessTable *ProposedWitnesses;
+};
+
+/// \brief Fetch uniqued metadata for several tuple types at once.
+///
+/// This is equivalent to calling swift_getTupleTypeMetadata for each
+/// tuple in turn, storing the results in the corresponding elements of
+/// the results array, but the tuple types that haven't been instantiated
+/// yet are allocated together.  Generic code that needs the metadata for
+/// several tuple types can fetch it all in one call.
+extern "C" void
+swift_getTupleTypeMetadataArray(size_t numTuples,
+                                const TupleTypeDescriptor *tuples,
+                                const TupleTypeMetadata **results);
+
 /// \brief Fetch a uniqued metadata for a metatype type.
 extern "C" const MetatypeMetadata *
 swift_getMetatypeMetadata(const Metadata *instanceType);
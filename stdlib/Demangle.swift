@@ -433,6 +433,10 @@ func demangleType(i : Int, mangled : String) -> (Int, String) {
 //                Tk  # InitializeBufferWithTake
 //                tk  # InitializeWithTake
 //                pr  # ProjectBuffer
+//                Xx  # DestroyArray
+//                Cc  # InitializeArrayWithCopy
+//                Tt  # InitializeArrayWithTakeFrontToBack
+//                tT  # InitializeArrayWithTakeBackToFront
 //                sa  # SizeAndAlignment
 
 // mangled-nmae:= '_Tw' <witness-kind> <type>
@@ -5,18 +5,19 @@
 // XXX FIXME -- replace and flush this out with parsing logic
 
 class Keyboard {
+  // Standard input is read through a buffer, not a byte at a time.
+  var reader : Builtin.RawPointer
+
+  constructor() {
+    reader = c_reader_create(0)
+  }
+
   func read(buf : UInt8[]) -> Int {
-    var r = posix_read(0, buf.base.value, buf.length)
-    assert(r >= 0)
-    return r
+    return c_reader_read(reader, buf.base.value, buf.length)
   }
 
   func read() -> Int {
-    var c = new UInt8[1]
-    if read(c) != 1 {
-      return -1
-    }
-    return Int(c[0])
+    return Int(c_reader_getc(reader))
   }
 }
 
@@ -26,6 +27,14 @@ extension Keyboard {
   }
 
   func getline(delim : Char) -> String {
+    if UInt32(delim) < 0x80 {
+      var length = c_reader_nextLine(reader, Int32(UInt32(delim)))
+      if length < 0 {
+        return ""
+      }
+      return _copyReaderLine(reader, length)
+    }
+
     var r : String
     var i = read()
     while i != -1 {
@@ -185,14 +185,18 @@ struct Format {
 
 // Terminal input & output
 
+// Console writes bypass the buffer behind print, so they flush it first to
+// keep the output in order.
 class Console {
   func write(buf : UInt8[]) -> Int {
+    c_stdout_flush()
     var r = posix_write(1, buf.base.value, buf.length)
     assert(r != -1)
     return r
   }
 
   func write(buf : String) -> Int {
+    c_stdout_flush()
     var r = posix_write(1, buf.str_value.base.value, buf.length)
     assert(r != -1)
     return r
@@ -207,18 +211,19 @@ class Console {
 }
 
 class Keyboard {
+  // Standard input is read through a buffer, not a byte at a time.
+  var reader : Builtin.RawPointer
+
+  constructor() {
+    reader = c_reader_create(0)
+  }
+
   func read(buf : UInt8[]) -> Int {
-    var r = posix_read(0, buf.base.value, buf.length)
-    assert(r >= 0)
-    return r
+    return c_reader_read(reader, buf.base.value, buf.length)
   }
 
   func read() -> Int {
-    var c = new UInt8[1]
-    if read(c) != 1 {
-      return -1
-    }
-    return Int(c[0])
+    return Int(c_reader_getc(reader))
   }
 }
 
@@ -228,6 +233,14 @@ extension Keyboard {
   }
 
   func getline(delim : Char) -> String {
+    if UInt32(delim) < 0x80 {
+      var length = c_reader_nextLine(reader, Int32(UInt32(delim)))
+      if length < 0 {
+        return ""
+      }
+      return _copyReaderLine(reader, length)
+    }
+
     var r : String
     var i = read()
     while i != -1 {
@@ -321,6 +334,31 @@ struct UnsafePointer<T> {
     Builtin.destroy(T, value)
   }
 
+  // The array operations below act on 'count' consecutive elements and
+  // go through the element type's array value witnesses, so that POD
+  // elements are handled with a single memcpy or memmove.
+
+  func destroyArray(count : Int) {
+    Builtin.destroyArray(T, value, count.value)
+  }
+
+  /// Initialize 'count' elements starting here with copies of the
+  /// elements starting at 'src'.  The two ranges must not overlap.
+  func initArrayWithCopy(src : UnsafePointer<T>, count : Int) {
+    Builtin.copyArray(T, value, src.value, count.value)
+  }
+
+  /// Initialize 'count' elements starting here by moving the elements
+  /// starting at 'src', which become uninitialized.  The two ranges may
+  /// overlap.
+  func initArrayWithTake(src : UnsafePointer<T>, count : Int) {
+    if (this - src) <= 0 {
+      Builtin.takeArrayFrontToBack(T, value, src.value, count.value)
+    } else {
+      Builtin.takeArrayBackToFront(T, value, src.value, count.value)
+    }
+  }
+
   static func alloc(num : Int) -> UnsafePointer<T> {
     typealias Ty = UnsafePointer<T>
     // Don't both with overflow checking.
@@ -428,6 +466,15 @@ struct Slice<T> : Enumerable {
 
        (base + i).set(value)
      }
+
+     // Lets element updates like 'a[i] += 1' happen in place.
+     address {
+       if i >= length {
+         Builtin.trap()
+       }
+
+       return (base + i).value
+     }
    }
 
    // Slicing via subscripting with a range.
@@ -737,32 +784,29 @@ func print(val : Int)
 func print(val : UInt64)
 func print(val : Double)
 func print(val : String) {
-  var len = val.byteLength()
-  for var i = 0; i < len; ++i {
-    c_putchar(Int32(val.str_value[i]))
-  }
+  c_stdout_write(val.str_value.base.value, val.byteLength())
 }
 func print(val : Char) {
   var wc = UInt32(val)
   if wc < 0x000080 {
-    c_putchar(Int32(wc))
+    c_stdout_putchar(Int32(wc))
     return
   } else if wc < 0x000800 {
-    c_putchar(Int32(0xC0 | (wc >> 6)))
-    c_putchar(Int32(0x80 | (wc & 0x03F)))
+    c_stdout_putchar(Int32(0xC0 | (wc >> 6)))
+    c_stdout_putchar(Int32(0x80 | (wc & 0x03F)))
     return
   } else if wc < 0x010000 {
     if !(0x00D800 <= wc && wc < 0x00E000) {
-      c_putchar(Int32(0xE0 |  (wc >> 12)))
-      c_putchar(Int32(0x80 | ((wc & 0x0FC0) >> 6)))
-      c_putchar(Int32(0x80 |  (wc & 0x003F)))
+      c_stdout_putchar(Int32(0xE0 |  (wc >> 12)))
+      c_stdout_putchar(Int32(0x80 | ((wc & 0x0FC0) >> 6)))
+      c_stdout_putchar(Int32(0x80 |  (wc & 0x003F)))
       return
     }
   } else if wc < 0x110000 {
-    c_putchar(Int32(0xF0 |  (wc >> 18)))
-    c_putchar(Int32(0x80 | ((wc & 0x03F000) >> 12)))
-    c_putchar(Int32(0x80 | ((wc & 0x000FC0) >> 6)))
-    c_putchar(Int32(0x80 |  (wc & 0x00003F)))
+    c_stdout_putchar(Int32(0xF0 |  (wc >> 18)))
+    c_stdout_putchar(Int32(0x80 | ((wc & 0x03F000) >> 12)))
+    c_stdout_putchar(Int32(0x80 | ((wc & 0x000FC0) >> 6)))
+    c_stdout_putchar(Int32(0x80 |  (wc & 0x00003F)))
     return
   }
   print(Char(0xFFFD))
@@ -900,6 +944,14 @@ func [asmname="print_int"] c_print_int(p : Builtin.RawPointer, buf_len : Int,
                                        x : Int128, Radix : Int) -> UInt64
 func [asmname="print_double"] c_print_double(p : Builtin.RawPointer, x : Double)
                                                                        -> UInt64
+func [asmname="swift_int64ToString"] c_int64ToString(p : Builtin.RawPointer,
+                                    buf_len : Int, x : Int64, Radix : Int)
+                                                                       -> UInt64
+func [asmname="swift_uint64ToString"] c_uint64ToString(p : Builtin.RawPointer,
+                                    buf_len : Int, x : UInt64, Radix : Int)
+                                                                       -> UInt64
+func [asmname="swift_doubleToString"] c_doubleToString(p : Builtin.RawPointer,
+                                    buf_len : Int, x : Double) -> UInt64
 
 // Some math stuff.
 func [asmname="sqrtf"] sqrt(a : Float) -> Float
@@ -930,6 +982,80 @@ c_file_read(fd : Int32, buf : Builtin.RawPointer, sz : Int) -> Int
 func [asmname="swift_file_size"]
 c_file_size(filename : Builtin.RawPointer) -> Int
 
+func [asmname="swift_fd_size"]
+c_fd_size(fd : Int32) -> Int
+
+func [asmname="swift_file_map"]
+c_file_map(fd : Int32, sz : Int) -> Builtin.RawPointer
+
+func [asmname="swift_file_unmap"]
+c_file_unmap(data : Builtin.RawPointer, sz : Int) -> Int32
+
+func [asmname="swift_reader_open"]
+c_reader_open(filename : Builtin.RawPointer) -> Builtin.RawPointer
+
+func [asmname="swift_reader_create"]
+c_reader_create(fd : Int32) -> Builtin.RawPointer
+
+func [asmname="swift_reader_close"]
+c_reader_close(reader : Builtin.RawPointer)
+
+func [asmname="swift_reader_nextLine"]
+c_reader_nextLine(reader : Builtin.RawPointer, delim : Int32) -> Int
+
+func [asmname="swift_reader_line"]
+c_reader_line(reader : Builtin.RawPointer) -> Builtin.RawPointer
+
+func [asmname="swift_reader_read"]
+c_reader_read(reader : Builtin.RawPointer, buf : Builtin.RawPointer,
+              sz : Int) -> Int
+
+func [asmname="swift_reader_getc"]
+c_reader_getc(reader : Builtin.RawPointer) -> Int32
+
+/// Copy the line a buffered reader just found into a new string.
+func _copyReaderLine(reader : Builtin.RawPointer, length : Int) -> String {
+  var bytes = StringByteData.getNew(length)
+  bytes.base.initArrayWithCopy(UnsafePointer<UInt8>(c_reader_line(reader)),
+                               length)
+  bytes.setASCII(false)
+  return String(bytes)
+}
+
+func [asmname="swift_stdout_write"]
+c_stdout_write(data : Builtin.RawPointer, sz : Int)
+
+func [asmname="swift_stdout_putchar"]
+c_stdout_putchar(val : Int32)
+
+func [asmname="swift_stdout_flush"]
+c_stdout_flush()
+
+func [asmname="swift_benchmark_begin"]
+c_benchmark_begin(name : Builtin.RawPointer, sz : Int) -> Builtin.RawPointer
+
+func [asmname="swift_benchmark_nextBatch"]
+c_benchmark_nextBatch(benchmark : Builtin.RawPointer) -> Int
+
+func [asmname="swift_benchmark_end"]
+c_benchmark_end(benchmark : Builtin.RawPointer)
+
+/// Time the body: warm it up, run it in batches large enough to time
+/// reliably, and print the median time per call as a line of JSON.
+func benchmark(name : String, body : () -> ()) {
+  var b = c_benchmark_begin(name.str_value.base.value, name.byteLength())
+  while true {
+    var n = c_benchmark_nextBatch(b)
+    if n == 0 {
+      break
+    }
+    for var i = 0; i < n; ++i {
+      body()
+    }
+  }
+  c_benchmark_end(b)
+}
+
 func [asmname="getchar"]
 getchar() -> Int32
 
@@ -159,14 +159,18 @@ struct Format {
 
 // Terminal input & output
 
+// Console writes bypass the buffer behind print, so they flush it first to
+// keep the output in order.
 class Console {
   func write(buf : UInt8[]) -> Int {
+    c_stdout_flush()
     var r = posix_write(1, buf.base.value, buf.length)
     assert(r != -1)
     return r
   }
 
   func write(buf : String) -> Int {
+    c_stdout_flush()
     var r = posix_write(1, buf.str_value.base.value, buf.length)
     assert(r != -1)
     return r
@@ -297,32 +301,29 @@ func print(val : Int)
 func print(val : UInt64)
 func print(val : Double)
 func print(val : String) {
-  var len = val.byteLength()
-  for var i = 0; i < len; ++i {
-    c_putchar(Int32(val.str_value[i]))
-  }
+  c_stdout_write(val.str_value.base.value, val.byteLength())
 }
 func print(val : Char) {
   var wc = UInt32(val)
   if wc < 0x000080 {
-    c_putchar(Int32(wc))
+    c_stdout_putchar(Int32(wc))
     return
   } else if wc < 0x000800 {
-    c_putchar(Int32(0xC0 | (wc >> 6)))
-    c_putchar(Int32(0x80 | (wc & 0x03F)))
+    c_stdout_putchar(Int32(0xC0 | (wc >> 6)))
+    c_stdout_putchar(Int32(0x80 | (wc & 0x03F)))
     return
   } else if wc < 0x010000 {
     if !(0x00D800 <= wc && wc < 0x00E000) {
-      c_putchar(Int32(0xE0 |  (wc >> 12)))
-      c_putchar(Int32(0x80 | ((wc & 0x0FC0) >> 6)))
-      c_putchar(Int32(0x80 |  (wc & 0x003F)))
+      c_stdout_putchar(Int32(0xE0 |  (wc >> 12)))
+      c_stdout_putchar(Int32(0x80 | ((wc & 0x0FC0) >> 6)))
+      c_stdout_putchar(Int32(0x80 |  (wc & 0x003F)))
       return
     }
   } else if wc < 0x110000 {
-    c_putchar(Int32(0xF0 |  (wc >> 18)))
-    c_putchar(Int32(0x80 | ((wc & 0x03F000) >> 12)))
-    c_putchar(Int32(0x80 | ((wc & 0x000FC0) >> 6)))
-    c_putchar(Int32(0x80 |  (wc & 0x00003F)))
+    c_stdout_putchar(Int32(0xF0 |  (wc >> 18)))
+    c_stdout_putchar(Int32(0x80 | ((wc & 0x03F000) >> 12)))
+    c_stdout_putchar(Int32(0x80 | ((wc & 0x000FC0) >> 6)))
+    c_stdout_putchar(Int32(0x80 |  (wc & 0x00003F)))
     return
   }
   print(Char(0xFFFD))
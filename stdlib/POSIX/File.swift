@@ -1,18 +1,39 @@
 class VFSObject : Descriptor {
 }
 
+// The owner of a read-only mapping of a file.  Strings that point into the
+// mapping keep it alive.
+class MappedRegion {
+  var base : Builtin.RawPointer
+  var size : Int
+
+  destructor {
+    var e = c_file_unmap(base, size)
+    assert(e == 0)
+  }
+}
+
 class File : VFSObject {
   var body : String
   var size : Int
 
   constructor (filename : String) {
-    size = c_file_size(filename.str_value.base.value)
     fd = c_file_open(filename.str_value.base.value)
     assert(fd != 0)
+    size = c_fd_size(fd)
+    assert(size >= 0)
 
-    var buf : StringByteData = StringByteData.getNew(size)
-    var sz = c_file_read(fd, buf.base.value, size)
-    body.str_value = buf
+    // Map the file instead of copying it into memory.  The body is a view
+    // of the mapping.
+    var base = c_file_map(fd, size)
+    assert(Int(Builtin.ptrtoint_Int64(base)) != 0)
+    var region = new MappedRegion
+    region.base = base
+    region.size = size
+    body.str_value = StringByteData.convertFromHeapArray(
+                       region.base, Builtin.castToObjectPointer(region),
+                       size.value)
+    body.str_value.setASCII(false)
   }
 
   var lines : String[] {
@@ -33,5 +54,50 @@ extension String {
   }
 }
 
+// Reads a file one line at a time through a large buffer, without holding
+// the whole file in memory:
+//
+//   foreach line in LineReader("access.log") { ... }
+//
+// A file that can't be opened has no lines, and errno says why.
+class LineReader : Enumerable, Range {
+  typealias Element = String
+  typealias Elements = LineReader
+
+  var reader : Builtin.RawPointer
+  // The length of the line the reader has found but we haven't returned,
+  // -1 at the end of the file, or -2 if we haven't looked for one yet.
+  var pending : Int
+
+  constructor (filename : String) {
+    reader = c_reader_open(filename.str_value.base.value)
+    pending = -2
+  }
+
+  destructor {
+    c_reader_close(reader)
+  }
+
+  func getElements() -> LineReader {
+    return this
+  }
+
+  func isEmpty() -> Bool {
+    if pending == -2 {
+      pending = c_reader_nextLine(reader, 10)
+    }
+    return pending < 0
+  }
+
+  func getFirstAndAdvance() -> String {
+    if isEmpty() {
+      Builtin.trap()
+    }
+    var line = _copyReaderLine(reader, pending)
+    pending = -2
+    return line
+  }
+}
+
 class Directory : VFSObject {
 }
@@ -454,31 +454,41 @@ extension String {
   }
 
   constructor(v : Int8, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    this = String(Int64(v), radix)
   }
   constructor(v : UInt8, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    this = String(Int64(v), radix)
   }
   constructor(v : Int16, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    this = String(Int64(v), radix)
   }
   constructor(v : Int32, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    this = String(Int64(v), radix)
   }
   constructor(v : UInt32, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    this = String(Int64(v), radix)
   }
+
+  // The 64-bit and floating-point conversions format straight into the
+  // new string's storage, and then trim its length to what was written.
   constructor(v : Int64, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    var capacity = 20
+    if radix != 10 { capacity = 65 }
+    str_value = StringByteData.getNew(capacity)
+    str_value.setLength(Int(c_int64ToString(str_value.base.value, capacity,
+                                            v, radix)))
   }
   constructor(v : UInt64, radix : Int = 10) {
-    this = String(Int128(v), radix)
+    var capacity = 20
+    if radix != 10 { capacity = 64 }
+    str_value = StringByteData.getNew(capacity)
+    str_value.setLength(Int(c_uint64ToString(str_value.base.value, capacity,
+                                             v, radix)))
   }
 
   constructor(v : Double) {
-    var Buffer = StringByteData.getNew(256)
-    var i = c_print_double(Buffer.base.value, v)
-    this = String(Buffer[0..Int(i)])
+    str_value = StringByteData.getNew(24)
+    str_value.setLength(Int(c_doubleToString(str_value.base.value, 24, v)))
   }
   constructor(v : Float) {
     this = String(Double(v))
@@ -35,10 +35,8 @@ class Vector<T> : Enumerable {
   }
 
   func clear() {
-    while _size > 0 {
-      --_size
-      (_base + _size).destroy()
-    }
+    _base.destroyArray(_size)
+    _size = 0
   }
   var length : Int {
     get { return _size }
@@ -53,9 +51,7 @@ class Vector<T> : Enumerable {
       var newCapacity = max(2*_capacity, cap)
       var newElements = _UnsafePtr.alloc(newCapacity)
       if _capacity > 0 {
-        for i in 0.._size {
-          (newElements + i).init((_base + i).move())
-        }
+        newElements.initArrayWithTake(_base, _size)
         _base.dealloc(_capacity)
       }
       _base = newElements
@@ -92,6 +88,10 @@ class Vector<T> : Enumerable {
       assert(i < _size)
       (_base + i).set(value)
     }
+    address {
+      assert(i < _size)
+      return (_base + i).value
+    }
   }
 
   func copy() -> Vector<T> {
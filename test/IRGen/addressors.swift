@@ -0,0 +1,63 @@
+// RUN: %swift -triple x86_64-apple-darwin10 -I %S/.. %s -emit-llvm | FileCheck %s
+
+class Buffer {
+  var base : Builtin.RawPointer
+
+  subscript (i : Int) -> Int {
+    get {
+      return Builtin.load(Builtin.gep_Int64(base, (i * 8).value))
+    }
+    set {
+      Builtin.assign(value, Builtin.gep_Int64(base, (i * 8).value))
+    }
+    address {
+      return Builtin.gep_Int64(base, (i * 8).value)
+    }
+  }
+}
+
+// The addressor is emitted like the getter, but returns a raw pointer.
+// CHECK: define i8* @_TC10addressors6Buffer{{.*}}a(
+
+// A [byref] argument updates the element in place instead of copying it
+// out through the getter and back in through the setter.
+
+// CHECK:    define void @_T10addressors9increment
+// CHECK-NOT:  Buffer{{.*}}g(
+// CHECK:      [[RAW:%.*]] = call i8* @_TC10addressors6Buffer{{.*}}a(
+// CHECK-NEXT: [[ADDR:%.*]] = bitcast i8* [[RAW]] to
+// CHECK-NOT:  Buffer{{.*}}s(
+// CHECK:      ret void
+func increment(b : Buffer, i : Int) {
+  ++b[i]
+}
+
+// The other arguments are evaluated before the address of a [byref]
+// argument is projected, so it can still be updated in place.
+
+// CHECK:    define void @_T10addressors3add
+// CHECK-NOT:  Buffer{{.*}}g(
+// CHECK:      call i8* @_TC10addressors6Buffer{{.*}}a(
+// CHECK-NOT:  Buffer{{.*}}s(
+// CHECK:      ret void
+func add(b : Buffer, i : Int, x : Int) {
+  b[i] += x
+}
+
+// Plain loads and stores go through the addressor too.
+
+// CHECK:    define i64 @_T10addressors4read
+// CHECK-NOT:  Buffer{{.*}}g(
+// CHECK:      call i8* @_TC10addressors6Buffer{{.*}}a(
+// CHECK:      ret i64
+func read(b : Buffer, i : Int) -> Int {
+  return b[i]
+}
+
+// CHECK:    define void @_T10addressors5write
+// CHECK-NOT:  Buffer{{.*}}s(
+// CHECK:      call i8* @_TC10addressors6Buffer{{.*}}a(
+// CHECK:      ret void
+func write(b : Buffer, i : Int, x : Int) {
+  b[i] = x
+}
@@ -24,8 +24,7 @@ func f0() {
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds { i8*, [[REFCOUNT]]* }* [[F]], i32 0, i32 0
 // CHECK-NEXT: [[FN_RAW:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds { i8*, [[REFCOUNT]]* }* [[F]], i32 0, i32 1
-// CHECK-NEXT: [[DATA_RAW:%.*]] = load [[REFCOUNT]]** [[T0]], align 8
-// CHECK-NEXT: [[DATA:%.*]] = call [[REFCOUNT]]* @swift_retain([[REFCOUNT]]* [[DATA_RAW]]) nounwind
+// CHECK-NEXT: [[DATA:%.*]] = load [[REFCOUNT]]** [[T0]], align 8
 // CHECK-NEXT: [[FN:%.*]] = bitcast i8* [[FN_RAW]] to i64 ([[INT]]*, [[REFCOUNT]]*, [[REFCOUNT]]*)*
 // CHECK-NEXT: [[I_RETAINED:%.*]] = call [[REFCOUNT]]* @swift_retain([[REFCOUNT]]* [[I_ALLOC]]) nounwind
 // CHECK-NEXT: call i64 [[FN]]([[INT]]* [[I]], [[REFCOUNT]]* [[I_RETAINED]], [[REFCOUNT]]* [[DATA]])
@@ -49,8 +48,7 @@ func f1(i : int) {
 // CHECK:      [[T0:%.*]] = getelementptr inbounds { i8*, [[REFCOUNT]]* }* [[F]], i32 0, i32 0
 // CHECK-NEXT: [[FN_RAW:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds { i8*, [[REFCOUNT]]* }* [[F]], i32 0, i32 1
-// CHECK-NEXT: [[DATA_RAW:%.*]] = load [[REFCOUNT]]** [[T0]], align 8
-// CHECK-NEXT: [[DATA:%.*]] = call [[REFCOUNT]]* @swift_retain([[REFCOUNT]]* [[DATA_RAW]]) nounwind
+// CHECK-NEXT: [[DATA:%.*]] = load [[REFCOUNT]]** [[T0]], align 8
 // CHECK-NEXT: [[FN:%.*]] = bitcast i8* [[FN_RAW]] to i64 ([[INT]]*, [[REFCOUNT]]*, [[REFCOUNT]]*)*
 // CHECK-NEXT: [[I_RETAINED:%.*]] = call [[REFCOUNT]]* @swift_retain([[REFCOUNT]]* [[I_ALLOC]]) nounwind
 // CHECK-NEXT: call i64 [[FN]]([[INT]]* [[I]], [[REFCOUNT]]* [[I_RETAINED]], [[REFCOUNT]]* [[DATA]])
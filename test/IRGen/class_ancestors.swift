@@ -0,0 +1,18 @@
+// RUN: %swift -triple x86_64-apple-darwin10 %s -emit-llvm | FileCheck %s
+
+// Every non-generic class gets a constant display of its ancestors,
+// root first, for constant-time subclass checks.
+
+// CHECK: @ancestors = internal constant [1 x %swift.type*]
+class A {}
+
+// CHECK: @ancestors1 = internal constant [2 x %swift.type*]
+class B : A {}
+
+// CHECK: @ancestors2 = internal constant [3 x %swift.type*]
+class C : B {}
+
+// Generic classes are instantiated at runtime, so they record their
+// depth but have no display.
+// CHECK: i64 1, %swift.type** null
+class D<T> : A {}
@@ -11,12 +11,19 @@ class A<T> {
 // CHECK:    define void @_TC13generic_types1A3runU__fGS0_Q__FT1tQ__T_([[OPAQUE]]* %t, [[A]]* %this, i8** %T) {
 // CHECK:      [[THIS:%.*]] = alloca [[A]]*, align 8
 // CHECK-NEXT: store [[A]]* %this, [[A]]** [[THIS]], align 8
-// CHECK-NEXT: load [[A]]** [[THIS]], align 8
-// CHECK-NEXT: @swift_release
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* %t, i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
 // CHECK-NEXT: ret void
 }
 
@@ -28,8 +35,6 @@ func foo(y : A<Int>) {
 // CHECK-NEXT: [[TEMP:%.*]] = alloca [[INT]], align 8
 // CHECK-NEXT: store [[A]]* %y, [[A]]** [[Y]], align 8
 // CHECK-NEXT: [[T0:%.*]] = load [[A]]** [[Y]], align 8
-// CHECK-NEXT: [[T1:%.*]] = bitcast [[A]]* [[T0]] to [[REF]]*
-// CHECK-NEXT: call void @swift_retain_noresult([[REF]]* [[T1]]) nounwind
 // CHECK-NEXT: [[T1:%.*]] = call i64 @_TSi25convertFromIntegerLiteralFT3valBi64__Si(i64 15)
 // CHECK-NEXT: [[T2:%.*]] = getelementptr inbounds [[INT]]* [[TEMP]], i32 0, i32 0
 // CHECK-NEXT: store i64 [[T1]], i64* [[T2]], align 8
@@ -13,46 +13,152 @@ func test0<T,U>(t : T, u : U) {
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to [[OPAQUE]]* ([[BUFFER]]*, i8**)*
 // CHECK-NEXT: [[X:%.*]] = call [[OPAQUE]]* [[T2]]([[BUFFER]]* [[XBUF]], i8** %T) nounwind
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[BITWISE:bitwise[0-9]*]], label %[[WITNESS:witness[0-9]*]]
+// CHECK:    [[BITWISE]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 16
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[SIZE:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[DEST:%.*]] = bitcast [[OPAQUE]]* [[X]] to i8*
+// CHECK-NEXT: [[SRC:%.*]] = bitcast [[OPAQUE]]* %t to i8*
+// CHECK-NEXT: call void @llvm.memcpy.p0i8.p0i8.i64(i8* [[DEST]], i8* [[SRC]], i64 [[SIZE]], i32 {{[0-9]+}}, i1 false)
+// CHECK-NEXT: br label %[[CONT:cont[0-9]*]]
+// CHECK:    [[WITNESS]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 6
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to [[OPAQUE]]* ([[OPAQUE]]*, [[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call [[OPAQUE]]* [[T2]]([[OPAQUE]]* [[X]], [[OPAQUE]]* %t, i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 11
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to [[OPAQUE]]* ([[BUFFER]]*, i8**)*
 // CHECK-NEXT: [[Y:%.*]] = call [[OPAQUE]]* [[T2]]([[BUFFER]]* [[YBUF]], i8** %U) nounwind
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[BITWISE:bitwise[0-9]*]], label %[[WITNESS:witness[0-9]*]]
+// CHECK:    [[BITWISE]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 16
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[SIZE:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[DEST:%.*]] = bitcast [[OPAQUE]]* [[Y]] to i8*
+// CHECK-NEXT: [[SRC:%.*]] = bitcast [[OPAQUE]]* %u to i8*
+// CHECK-NEXT: call void @llvm.memcpy.p0i8.p0i8.i64(i8* [[DEST]], i8* [[SRC]], i64 [[SIZE]], i32 {{[0-9]+}}, i1 false)
+// CHECK-NEXT: br label %[[CONT:cont[0-9]*]]
+// CHECK:    [[WITNESS]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 6
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to [[OPAQUE]]* ([[OPAQUE]]*, [[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call [[OPAQUE]]* [[T2]]([[OPAQUE]]* [[Y]], [[OPAQUE]]* %u, i8** %U) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* [[Y]], i8** %U) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* [[X]], i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %U, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* %u, i8** %U) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* %t, i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
 // CHECK-NEXT: ret void
 
 func test1<T>(t : T) -> T {
   return t
 }
 // CHECK:    define void @_T8generics5test1UFT1tV_V([[OPAQUE]]* noalias sret, [[OPAQUE]]* %t, i8** %T) {
-// CHECK:      [[T0:%.*]] = getelementptr inbounds i8** %T, i32 6
+// CHECK:      [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[BITWISE:bitwise[0-9]*]], label %[[WITNESS:witness[0-9]*]]
+// CHECK:    [[BITWISE]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 16
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[SIZE:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[DEST:%.*]] = bitcast [[OPAQUE]]* %0 to i8*
+// CHECK-NEXT: [[SRC:%.*]] = bitcast [[OPAQUE]]* %t to i8*
+// CHECK-NEXT: call void @llvm.memcpy.p0i8.p0i8.i64(i8* [[DEST]], i8* [[SRC]], i64 [[SIZE]], i32 {{[0-9]+}}, i1 false)
+// CHECK-NEXT: br label %[[CONT:cont[0-9]*]]
+// CHECK:    [[WITNESS]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 6
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to [[OPAQUE]]* ([[OPAQUE]]*, [[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call [[OPAQUE]]* [[T2]]([[OPAQUE]]* %0, [[OPAQUE]]* %t, i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
+// CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 19
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[FLAGS:%.*]] = ptrtoint i8* [[T1]] to i64
+// CHECK-NEXT: [[T2:%.*]] = and i64 [[FLAGS]], 1
+// CHECK-NEXT: [[T3:%.*]] = icmp ne i64 [[T2]], 0
+// CHECK-NEXT: br i1 [[T3]], label %[[CONT:cont[0-9]*]], label %[[DESTROY:destroy[0-9]*]]
+// CHECK:    [[DESTROY]]:
 // CHECK-NEXT: [[T0:%.*]] = getelementptr inbounds i8** %T, i32 4
 // CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
 // CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i8**)*
 // CHECK-NEXT: call void [[T2]]([[OPAQUE]]* %t, i8** %T) nounwind
+// CHECK-NEXT: br label %[[CONT]]
+// CHECK:    [[CONT]]:
 // CHECK-NEXT: ret void
+
+func test_destroyArray<T>(p : Builtin.RawPointer, n : Builtin.Int64) {
+  Builtin.destroyArray(T, p, n)
+}
+// CHECK:    define void @_T8generics17test_destroyArray{{.*}}(i8* %p, i64 %n, i8** %T) {
+// CHECK:      [[ARRAY:%.*]] = bitcast i8* {{%.*}} to [[OPAQUE]]*
+// CHECK:      [[T0:%.*]] = getelementptr inbounds i8** %T, i32 12
+// CHECK-NEXT: [[T1:%.*]] = load i8** [[T0]], align 8
+// CHECK-NEXT: [[T2:%.*]] = bitcast i8* [[T1]] to void ([[OPAQUE]]*, i64, i8**)*
+// CHECK-NEXT: call void [[T2]]([[OPAQUE]]* [[ARRAY]], i64 {{%.*}}, i8** %T) nounwind
@@ -0,0 +1,32 @@
+// RUN: %swift -triple x86_64-apple-darwin10 -I %S/.. %s -emit-llvm | FileCheck %s
+
+import swift
+
+class C {
+  func f() {}
+
+  // A method borrows 'this' and lends it straight to the next method.
+  func g() { f() }
+}
+// CHECK:     define void @_TN17guaranteed_params1C1g{{.*}}(%_T17guaranteed_params1C* %this) {
+// CHECK-NOT:   @swift_retain
+// CHECK-NOT:   @swift_release
+// CHECK:       ret void
+
+// An immutable local is lent to the method without a retain.
+func h(c : C) {
+  c.f()
+}
+// CHECK:     define void @_T17guaranteed_params1h{{.*}}(%_T17guaranteed_params1C* %c) {
+// CHECK-NOT:   @swift_retain
+// CHECK:       call void
+// CHECK:       @swift_release
+// CHECK:       ret void
+
+// A closure borrows its context.
+func k(i : Int) -> () -> Int {
+  return { i }
+}
+// CHECK:     define internal i64 @closure{{.*}} {
+// CHECK-NOT:   @swift_release
+// CHECK:       ret i64
@@ -0,0 +1,43 @@
+// RUN: %swift -triple x86_64-apple-darwin10 %s -emit-llvm | FileCheck %s
+
+class A<T> {
+  var x : Int
+}
+
+func id<T>(x : T) -> T { return x }
+
+// The metadata for a concrete instance of a generic type comes from an
+// access function rather than a call to the runtime at every use.
+
+// CHECK:    define [[A:%.*]]* @_T18metadata_accessors10useConcrete{{.*}}
+// CHECK-NOT:  @swift_getGenericMetadata
+// CHECK:      [[METADATA:%.*]] = call %swift.type* @_TMaGC18metadata_accessors1ASi_() nounwind
+// CHECK-NOT:  @swift_getGenericMetadata
+// CHECK:      ret
+func useConcrete(a : A<Int>) -> A<Int> {
+  return id(a)
+}
+
+// Dependent instances still instantiate the metadata every time.
+
+// CHECK:    define void @_T18metadata_accessors12useDependent{{.*}}
+// CHECK:      call %swift.type* @swift_getGenericMetadata(
+func useDependent<T>(a : A<T>) {
+  id(a)
+}
+
+// The access function caches the metadata in a variable of its own.  The
+// cache is read with acquire and filled with release ordering, so that a
+// thread that finds it filled also sees the metadata it points to.
+
+// CHECK:    define linkonce_odr hidden %swift.type* @_TMaGC18metadata_accessors1ASi_() nounwind {
+// CHECK:      [[CACHED:%.*]] = load atomic %swift.type** @_TMLGC18metadata_accessors1ASi_ acquire, align 8
+// CHECK-NEXT: [[ISNULL:%.*]] = icmp eq %swift.type* [[CACHED]], null
+// CHECK-NEXT: br i1 [[ISNULL]], label %cache.init, label %cache.done
+// CHECK:    cache.init:
+// CHECK:      [[NEW:%.*]] = call %swift.type* @swift_getGenericMetadata(
+// CHECK-NEXT: store atomic %swift.type* [[NEW]], %swift.type** @_TMLGC18metadata_accessors1ASi_ release, align 8
+// CHECK-NEXT: br label %cache.done
+// CHECK:    cache.done:
+// CHECK-NEXT: [[RESULT:%.*]] = phi %swift.type* [ [[CACHED]], %entry ], [ [[NEW]], %cache.init ]
+// CHECK-NEXT: ret %swift.type* [[RESULT]]
@@ -0,0 +1,27 @@
+// RUN: %swift -triple x86_64-apple-darwin10 %s -emit-llvm | FileCheck %s
+
+// Fields are laid out in order of decreasing alignment, so the small
+// fields are packed together at the end without padding.
+
+// CHECK: %_T13struct_layout5Mixed = type { i64, i32, i8, i8 }
+struct Mixed {
+  var a : Builtin.Int8
+  var b : Builtin.Int64
+  var c : Builtin.Int8
+  var d : Builtin.Int32
+}
+
+// Class fields follow the heap header.
+// CHECK: %_T13struct_layout5Boxed = type { %swift.refcounted, i64, i8 }
+class Boxed {
+  var flag : Builtin.Int8
+  var count : Builtin.Int64
+}
+
+func useBoxed(x : Boxed) -> Builtin.Int64 {
+  return x.count
+}
+
+// Elements keep their identity when they're reordered.
+// CHECK:    define i64 @_T13struct_layout8useBoxed
+// CHECK:      getelementptr inbounds %_T13struct_layout5Boxed* {{%.*}}, i32 0, i32 1
@@ -22,8 +22,6 @@ func test0(x : B) {
 // CHECK:      [[X:%.*]] = alloca [[B]]*, align 8
 // CHECK-NEXT: store [[B]]* %x, [[B]]** [[X]], align 8
 // CHECK-NEXT: [[T0:%.*]] = load [[B]]** [[X]], align 8
-// CHECK-NEXT: [[T1:%.*]] = bitcast [[B]]* [[T0]] to [[REF]]*
-// CHECK-NEXT: call void @swift_retain_noresult([[REF]]* [[T1]]) nounwind
 // CHECK-NEXT: [[THIS:%.*]] = bitcast [[B]]* [[T0]] to [[A]]*
 // CHECK-NEXT: [[T0:%.*]] = bitcast [[A]]* [[THIS]] to [[HEAPMETADATA]]**
 // CHECK-NEXT: [[META:%.*]] = load [[HEAPMETADATA]]** [[T0]], align 8
@@ -42,8 +40,6 @@ func test1(x : B) {
 // CHECK:      [[X:%.*]] = alloca [[B]]*, align 8
 // CHECK-NEXT: store [[B]]* %x, [[B]]** [[X]], align 8
 // CHECK-NEXT: [[THIS:%.*]] = load [[B]]** [[X]], align 8
-// CHECK-NEXT: [[T1:%.*]] = bitcast [[B]]* [[THIS]] to [[REF]]*
-// CHECK-NEXT: call void @swift_retain_noresult([[REF]]* [[T1]]) nounwind
 // CHECK-NEXT: [[T0:%.*]] = bitcast [[B]]* [[THIS]] to [[HEAPMETADATA]]**
 // CHECK-NEXT: [[META:%.*]] = load [[HEAPMETADATA]]** [[T0]], align 8
 // CHECK-NEXT: [[T0:%.*]] = bitcast [[HEAPMETADATA]]* [[META]] to void ([[B]]*)**
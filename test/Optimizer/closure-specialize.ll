@@ -0,0 +1,54 @@
+; RUN: %swift %s -closure-specialize | FileCheck %s
+target datalayout = "e-p:64:64:64-S128-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f128:128:128-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64"
+target triple = "x86_64-apple-darwin11.3.0"
+
+%swift.refcounted = type { %swift.heapmetadata*, i64 }
+%swift.heapmetadata = type { i64 (%swift.refcounted*)*, i64 (%swift.refcounted*)* }
+
+; A higher-order function which calls its function argument in a loop.
+define void @each(i64 %n, i8* %f, %swift.refcounted* %ctx) {
+entry:
+  %fn = bitcast i8* %f to void (i64, %swift.refcounted*)*
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %next, %loop ]
+  call void %fn(i64 %i, %swift.refcounted* %ctx)
+  %next = add i64 %i, 1
+  %done = icmp eq i64 %next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+define internal void @body(i64 %x, %swift.refcounted* %ctx) {
+entry:
+  ret void
+}
+
+; CHECK:      define void @caller(i64 %n, %swift.refcounted* %ctx) {
+; CHECK-NEXT: entry:
+; CHECK-NEXT:   call void @each.closure.body(i64 %n, %swift.refcounted* %ctx)
+; CHECK-NEXT:   ret void
+define void @caller(i64 %n, %swift.refcounted* %ctx) {
+entry:
+  call void @each(i64 %n, i8* bitcast (void (i64, %swift.refcounted*)* @body to i8*), %swift.refcounted* %ctx)
+  ret void
+}
+
+; An unknown function pointer leaves the call alone.
+; CHECK:      define void @unknown(i64 %n, i8* %f, %swift.refcounted* %ctx) {
+; CHECK-NEXT: entry:
+; CHECK-NEXT:   call void @each(i64 %n, i8* %f, %swift.refcounted* %ctx)
+define void @unknown(i64 %n, i8* %f, %swift.refcounted* %ctx) {
+entry:
+  call void @each(i64 %n, i8* %f, %swift.refcounted* %ctx)
+  ret void
+}
+
+; The clone calls the closure directly.
+; CHECK:      define internal void @each.closure.body(i64 %n, %swift.refcounted* %ctx) {
+; CHECK-NOT:    bitcast
+; CHECK:        call void @body(i64 %i, %swift.refcounted* %ctx)
+; CHECK:        ret void
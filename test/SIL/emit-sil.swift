@@ -0,0 +1,23 @@
+// RUN: %swift -emit-sil %s | FileCheck %s
+
+// Functions are printed in declaration order, however many threads emit
+// them, followed by the top-level code.
+
+// CHECK: func_decl first
+func first(x : Int) -> Int {
+  return x
+}
+// CHECK: return
+
+// CHECK: func_decl second
+func second(x : Int) -> Int {
+  var y = first(x)
+  return y
+}
+// CHECK: apply
+
+// CHECK: top_level_code
+// CHECK: alloc_var global
+var global : Int = second(1)
+// CHECK: store
+// CHECK: return
@@ -0,0 +1,450 @@
+//===-- FrontendBench.cpp - Frontend compile-time benchmark ---------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// swift-frontend-bench generates a synthetic translation unit of a given
+// shape and size, runs it through the frontend one phase at a time, and
+// prints the wall time and peak memory of each phase as a line of JSON.
+//
+// The standard library is parsed and type-checked up front and handed to
+// name binding as an already-loaded module, so that importing it isn't
+// charged to the synthetic input.  Each workload is meant to run in its own
+// process, since the peak resident set size only ever goes up; for the same
+// reason, memory is only recorded on the first of the -repeat runs.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../swift/Frontend.h"
+#include "../swift/PrintingDiagnosticConsumer.h"
+#include "swift/Subsystems.h"
+#include "swift/AST/AST.h"
+#include "swift/AST/Component.h"
+#include "swift/AST/Diagnostics.h"
+#include "swift/AST/NameLookup.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/IRGen/Options.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILPassManager.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+using namespace swift;
+
+static llvm::cl::opt<std::string>
+Workload("workload", llvm::cl::desc("The shape of the synthetic input: "
+                                    "functions, generics, overloads, "
+                                    "operators, oneofs, or stdlib for "
+                                    "queries against the stdlib alone"),
+         llvm::cl::init("functions"));
+
+static llvm::cl::opt<unsigned>
+Scale("scale", llvm::cl::desc("The size of the synthetic input"),
+      llvm::cl::init(1000));
+
+static llvm::cl::opt<unsigned>
+Repeat("repeat", llvm::cl::desc("Compile the input this many times and "
+                                "report the fastest time of each phase"),
+       llvm::cl::init(3));
+
+static llvm::cl::opt<std::string>
+StdlibPath("stdlib", llvm::cl::desc("The standard library source, swift.swift"),
+           llvm::cl::value_desc("path"));
+
+static llvm::cl::opt<bool>
+UseConstraintChecker("constraint-checker",
+                     llvm::cl::desc("Type-check with the constraint solver"));
+
+static llvm::cl::opt<bool>
+DumpSource("dump-source",
+           llvm::cl::desc("Print the synthetic input instead of compiling it"));
+
+//===----------------------------------------------------------------------===//
+// Synthetic inputs
+//===----------------------------------------------------------------------===//
+
+/// Functions that each call the one before, as generated code tends to.
+static void generateFunctions(llvm::raw_ostream &OS, unsigned N) {
+  OS << "func f0(x : Int) -> Int { return x }\n";
+  for (unsigned i = 1; i != N; ++i)
+    OS << "func f" << i << "(x : Int) -> Int {\n"
+       << "  var y = x * " << i << "\n"
+       << "  return f" << i - 1 << "(y + 1)\n"
+       << "}\n";
+}
+
+/// Print Box<Box<...<Int>...>> with the given nesting depth.
+static void printNestedType(llvm::raw_ostream &OS, unsigned Depth) {
+  for (unsigned i = 0; i != Depth; ++i)
+    OS << "Box<";
+  OS << "Int";
+  for (unsigned i = 0; i != Depth; ++i)
+    OS << ">";
+}
+
+/// A fixed number of functions over generic types nested N deep.
+static void generateGenerics(llvm::raw_ostream &OS, unsigned N) {
+  OS << "struct Box<T> {\n"
+     << "  var value : T\n"
+     << "}\n";
+  for (unsigned i = 0; i != 20; ++i) {
+    OS << "func unbox" << i << "(b : ";
+    printNestedType(OS, N + 1);
+    OS << ") -> ";
+    printNestedType(OS, N);
+    OS << " {\n"
+       << "  return b.value\n"
+       << "}\n";
+  }
+}
+
+/// N overloads of one function, and a fixed number of calls that each have
+/// to pick one of them.
+static void generateOverloads(llvm::raw_ostream &OS, unsigned N) {
+  for (unsigned i = 0; i != N; ++i)
+    OS << "struct S" << i << " {\n"
+       << "  var value : Int\n"
+       << "}\n"
+       << "func overloaded(x : S" << i << ") -> Int { return " << i << " }\n";
+  OS << "func callOverloads() -> Int {\n"
+     << "  var total = 0\n";
+  for (unsigned i = 0; i != 100; ++i)
+    OS << "  total = total + overloaded(S" << i * N / 100 << "(" << i
+       << "))\n";
+  OS << "  return total\n"
+     << "}\n";
+}
+
+/// Expressions that chain N binary operators of mixed precedence.
+static void generateOperators(llvm::raw_ostream &OS, unsigned N) {
+  static const char *const Operators[] = { " + ", " * ", " - ", " / " };
+  for (unsigned f = 0; f != 10; ++f) {
+    OS << "func chain" << f << "(x : Int) -> Int {\n"
+       << "  return x";
+    for (unsigned i = 0; i != N; ++i) {
+      OS << Operators[i % 4] << (i % 9 + 1);
+      if (i % 8 == 7)
+        OS << "\n    ";
+    }
+    OS << "\n"
+       << "}\n";
+  }
+}
+
+/// A oneof with N cases, and a function that builds each case.
+static void generateOneofs(llvm::raw_ostream &OS, unsigned N) {
+  OS << "oneof Big {\n";
+  for (unsigned i = 0; i != N; ++i)
+    OS << "  Case" << i << " : Int" << (i + 1 == N ? "\n" : ",\n");
+  OS << "}\n";
+  for (unsigned i = 0; i != N; ++i)
+    OS << "func make" << i << "() -> Big {\n"
+       << "  return :Case" << i << "(" << i << ")\n"
+       << "}\n";
+}
+
+/// Generate the named workload.  Returns false if there is no such
+/// workload.
+static bool generateWorkload(StringRef Name, unsigned N, std::string &Source) {
+  llvm::raw_string_ostream OS(Source);
+  if (Name == "functions")
+    generateFunctions(OS, N);
+  else if (Name == "generics")
+    generateGenerics(OS, N);
+  else if (Name == "overloads")
+    generateOverloads(OS, N);
+  else if (Name == "operators")
+    generateOperators(OS, N);
+  else if (Name == "oneofs")
+    generateOneofs(OS, N);
+  else if (Name == "stdlib")
+    ; // The queries are made by runStdlibQueries.
+  else
+    return false;
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Measurement
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// The measurements of one phase.
+  struct PhaseResult {
+    const char *Name;
+    double WallSeconds;
+    uint64_t PeakRSS;
+  };
+
+  /// Times a sequence of phases.
+  class PhaseTimer {
+    std::vector<PhaseResult> &Results;
+    unsigned Index = 0;
+    llvm::TimeRecord Start;
+
+  public:
+    explicit PhaseTimer(std::vector<PhaseResult> &Results)
+      : Results(Results) {}
+
+    void start() {
+      Start = llvm::TimeRecord::getCurrentTime(true);
+    }
+
+    /// Finish the phase that is running, keeping its time if it's the
+    /// fastest so far.  Its peak memory is only recorded the first time,
+    /// since later runs start from the peak the first one reached.
+    void stop(const char *Name);
+  };
+}
+
+/// The peak resident set size of the process in bytes.
+static uint64_t getPeakRSS() {
+  struct rusage Usage;
+  if (getrusage(RUSAGE_SELF, &Usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return Usage.ru_maxrss;
+#else
+  return uint64_t(Usage.ru_maxrss) * 1024;
+#endif
+}
+
+void PhaseTimer::stop(const char *Name) {
+  llvm::TimeRecord Elapsed = llvm::TimeRecord::getCurrentTime(false);
+  Elapsed -= Start;
+  PhaseResult Result = { Name, Elapsed.getWallTime(), getPeakRSS() };
+  if (Index == Results.size())
+    Results.push_back(Result);
+  else if (Result.WallSeconds < Results[Index].WallSeconds)
+    Results[Index].WallSeconds = Result.WallSeconds;
+  ++Index;
+}
+
+/// Everything one compilation needs.
+struct Compilation {
+  llvm::SourceMgr SM;
+  PrintingDiagnosticConsumer Consumer;
+  DiagnosticEngine Diags;
+  LangOptions LangOpts;
+  ASTContext Context;
+
+  Compilation() : Diags(SM, Consumer), Context(LangOpts, SM, Diags) {
+    // A broken workload tends to fail the same way many times over.
+    Diags.setErrorLimit(10);
+  }
+
+  TranslationUnit *createTU(StringRef Name) {
+    Component *Comp = new (Context.Allocate<Component>(1)) Component();
+    return new (Context) TranslationUnit(Context.getIdentifier(Name), Comp,
+                                         Context, /*IsMainModule=*/false,
+                                         /*IsReplModule=*/false);
+  }
+
+  unsigned addBuffer(StringRef Text, StringRef Name) {
+    return SM.AddNewSourceBuffer(
+        llvm::MemoryBuffer::getMemBufferCopy(Text, Name), llvm::SMLoc());
+  }
+};
+
+/// Keeps the results of the stdlib queries alive.
+static volatile unsigned QuerySink;
+
+/// The stdlib workload has no input of its own.  Instead it times the
+/// queries the type checker spends most of its time in, made N times over
+/// the types and names of the standard library.
+static void runStdlibQueries(TranslationUnit *StdlibTU, unsigned N,
+                             PhaseTimer &Timer) {
+  std::vector<Type> Types;
+  std::vector<Identifier> Names;
+  for (Decl *D : StdlibTU->Decls) {
+    if (ValueDecl *VD = dyn_cast<ValueDecl>(D)) {
+      if (!VD->hasType() || VD->getType()->is<ErrorType>())
+        continue;
+      Types.push_back(VD->getType());
+      Names.push_back(VD->getName());
+    }
+    if (NominalTypeDecl *NTD = dyn_cast<NominalTypeDecl>(D))
+      for (Decl *Member : NTD->getMembers())
+        if (ValueDecl *VD = dyn_cast<ValueDecl>(Member))
+          if (VD->hasType())
+            Types.push_back(VD->getType());
+  }
+  if (Types.empty())
+    return;
+
+  // Canonicalization and type equality once every canonical type has been
+  // computed, which is the state the type checker is in most of the time.
+  unsigned NumEqual = 0;
+  Timer.start();
+  for (unsigned Iter = 0; Iter != N; ++Iter) {
+    for (unsigned i = 0, e = Types.size(); i != e; ++i) {
+      CanType Canon = Types[i]->getCanonicalType();
+      NumEqual += Canon->isEqual(Types[i]);
+      NumEqual += Types[i]->isEqual(Types[(i + 1) % e]);
+    }
+  }
+  Timer.stop("canonical_types");
+
+  // Unqualified lookup of every top-level name from the top level.
+  unsigned NumFound = 0;
+  Timer.start();
+  for (unsigned Iter = 0; Iter != N; ++Iter)
+    for (Identifier Name : Names)
+      NumFound += UnqualifiedLookup(Name, StdlibTU).isSuccess();
+  Timer.stop("lookup");
+
+  QuerySink = NumEqual + NumFound;
+}
+
+/// Compile the source once, recording the time of each phase.  Returns
+/// false if it had errors.
+static bool compile(StringRef Stdlib, StringRef Source,
+                    std::vector<PhaseResult> &Results) {
+  Compilation C;
+  PhaseTimer Timer(Results);
+
+  // The standard library isn't part of the input, but how long it takes
+  // is worth knowing.
+  Timer.start();
+  TranslationUnit *StdlibTU = C.createTU("swift");
+  parseIntoTranslationUnit(StdlibTU, C.addBuffer(Stdlib, "swift.swift"));
+  performNameBinding(StdlibTU);
+  performTypeChecking(StdlibTU);
+  C.Context.LoadedModules["swift"] = StdlibTU;
+  Timer.stop("stdlib");
+  if (C.Diags.hadAnyError())
+    return false;
+
+  if (Workload == "stdlib") {
+    runStdlibQueries(StdlibTU, Scale, Timer);
+    return true;
+  }
+
+  C.LangOpts.UseConstraintSolver = UseConstraintChecker;
+  TranslationUnit *TU = C.createTU("bench");
+  unsigned BufferID = C.addBuffer(Source, "bench.swift");
+
+  Timer.start();
+  parseIntoTranslationUnit(TU, BufferID);
+  Timer.stop("parse");
+
+  Timer.start();
+  performNameBinding(TU);
+  Timer.stop("namebinding");
+
+  Timer.start();
+  performTypeChecking(TU);
+  Timer.stop("typecheck");
+  if (C.Diags.hadAnyError())
+    return false;
+
+  Timer.start();
+  SILPassManager PM;
+  PM.add(createSILMem2RegPass());
+  llvm::OwningPtr<SILModule> SILMod(emitAndOptimizeSIL(TU, PM));
+  Timer.stop("sil");
+
+  irgen::Options Options;
+  Options.Triple = llvm::sys::getDefaultTargetTriple();
+  Options.OutputKind = irgen::OutputKind::Module;
+  Options.Verify = false;
+  llvm::LLVMContext LLVMContext;
+  llvm::Module Module("bench", LLVMContext);
+
+  Timer.start();
+  performIRGeneration(Options, &Module, TU, 0, SILMod.get());
+  Timer.stop("irgen");
+
+  return !C.Diags.hadAnyError();
+}
+
+static void printJSON(llvm::raw_ostream &OS, size_t InputBytes,
+                      const std::vector<PhaseResult> &Results) {
+  OS << "{\"workload\": \"" << Workload << "\", \"scale\": " << Scale
+     << ", \"input_bytes\": " << InputBytes << ", \"phases\": {";
+  for (unsigned i = 0, e = Results.size(); i != e; ++i) {
+    if (i)
+      OS << ", ";
+    OS << "\"" << Results[i].Name << "\": {\"wall_s\": ";
+    OS << llvm::format("%.6f", Results[i].WallSeconds);
+    OS << ", \"peak_rss_bytes\": " << Results[i].PeakRSS << "}";
+  }
+  OS << "}}\n";
+}
+
+/// Find the standard library the build put next to the tool.
+static std::string getDefaultStdlibPath() {
+  llvm::sys::Path Path =
+      llvm::sys::Path::GetMainExecutable(0, (void*)&getDefaultStdlibPath);
+  Path.eraseComponent();
+  Path.eraseComponent();
+  Path.appendComponent("lib");
+  Path.appendComponent("swift");
+  Path.appendComponent("swift.swift");
+  return Path.str();
+}
+
+int main(int argc, char **argv) {
+  llvm::sys::PrintStackTraceOnErrorSignal();
+  llvm::PrettyStackTraceProgram StackPrinter(argc, argv);
+  llvm::llvm_shutdown_obj Shutdown;
+  llvm::cl::ParseCommandLineOptions(argc, argv,
+                                    "Swift frontend compile-time benchmark\n");
+
+  std::string Source;
+  if (!generateWorkload(Workload, Scale, Source)) {
+    llvm::errs() << "error: unknown workload '" << Workload << "'\n";
+    return 1;
+  }
+  if (DumpSource) {
+    llvm::outs() << Source;
+    return 0;
+  }
+
+  std::string Path = StdlibPath.empty() ? getDefaultStdlibPath()
+                                        : std::string(StdlibPath);
+  llvm::OwningPtr<llvm::MemoryBuffer> Stdlib;
+  if (llvm::error_code Err = llvm::MemoryBuffer::getFile(Path, Stdlib)) {
+    llvm::errs() << "error: cannot read '" << Path << "': " << Err.message()
+                 << "\n";
+    return 1;
+  }
+
+  llvm::InitializeAllTargets();
+  llvm::InitializeAllTargetMCs();
+
+  std::vector<PhaseResult> Results;
+  for (unsigned i = 0; i < std::max(1U, unsigned(Repeat)); ++i) {
+    if (!compile(Stdlib->getBuffer(), Source, Results)) {
+      llvm::errs() << "error: the " << Workload << " workload didn't compile\n";
+      return 1;
+    }
+  }
+
+  printJSON(llvm::outs(), Source.size(), Results);
+  return 0;
+}
@@ -18,15 +18,25 @@
 #include "Frontend.h"
 #include "swift/AST/Identifier.h"
 #include "swift/AST/ASTContext.h"
+#include "swift/AST/ASTWalker.h"
 #include "swift/AST/Component.h"
+#include "swift/AST/Decl.h"
 #include "swift/AST/Diagnostics.h"
 #include "swift/AST/Module.h"
+#include "swift/AST/Expr.h"
 #include "swift/AST/Stmt.h"
+#include "swift/AST/Types.h"
 #include "swift/Parse/Lexer.h"
+#include "swift/Parse/TokenCache.h"
+#include "swift/SIL/Function.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILPassManager.h"
 #include "swift/Subsystems.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PathV2.h"
 #include "llvm/Support/SourceMgr.h"
+#include <algorithm>
 
 using namespace swift;
 
@@ -60,15 +70,21 @@ swift::buildSingleTranslationUnit(ASTContext &Context, unsigned BufferID,
                                                       IsMainModule,
                                                       /*IsReplModule=*/false);
 
+  // The main module is parsed in pieces; share one token stream among them.
+  TokenCache Toks(Buffer->getBuffer(), Context.SourceMgr, &Context.Diags);
   unsigned BufferOffset = 0;
   unsigned CurTUElem = 0;
   do {
-    parseIntoTranslationUnit(TU, BufferID, &BufferOffset);
+    // Hold the diagnostics of each piece back until it has been checked, so
+    // that formatting them stays out of the type checker's way.
+    Context.Diags.setBufferDiagnostics(true);
+    parseIntoTranslationUnit(TU, BufferID, &BufferOffset, 0, &Toks);
     if (!ParseOnly) {
       performNameBinding(TU, CurTUElem);
       performTypeChecking(TU, CurTUElem);
       CurTUElem = TU->Decls.size();
     }
+    Context.Diags.setBufferDiagnostics(false);
   } while (BufferOffset != Buffer->getBufferSize());
 
   return TU;
@@ -77,15 +93,263 @@ swift::buildSingleTranslationUnit(ASTContext &Context, unsigned BufferID,
 bool swift::appendToMainTranslationUnit(TranslationUnit *TU, unsigned BufferID,
                                         unsigned CurTUElem,
                                         unsigned &BufferOffset,
-                                        unsigned BufferEndOffset) {
+                                        unsigned BufferEndOffset,
+                                        TokenCache *Toks) {
   bool FoundAnySideEffects = false;
   do {
     FoundAnySideEffects |= parseIntoTranslationUnit(TU, BufferID,
                                                     &BufferOffset,
-                                                    BufferEndOffset);
+                                                    BufferEndOffset,
+                                                    Toks);
     performNameBinding(TU, CurTUElem);
     performTypeChecking(TU, CurTUElem);
     CurTUElem = TU->Decls.size();
   } while (BufferOffset != BufferEndOffset);
   return FoundAnySideEffects;
 }
+
+SILModule *swift::emitAndOptimizeSIL(TranslationUnit *TU, SILPassManager &PM,
+                                     unsigned StartElem, unsigned NumThreads) {
+  // The SIL passes rely on capture analysis to know which local variables
+  // escape into closures.
+  performCaptureAnalysis(TU, StartElem);
+
+  SILModule *M = SILModule::constructSIL(TU, StartElem, NumThreads);
+
+  // The pass manager keeps per-pass statistics, so the pipeline runs on this
+  // thread once emission is done.
+  for (auto &Entry : *M)
+    PM.run(*Entry.second);
+  if (Function *TopLevelCode = M->getTopLevelCode())
+    PM.run(*TopLevelCode);
+  return M;
+}
+
+
+//===----------------------------------------------------------------------===//
+// IncrementalTranslationUnit
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// ChunkUseCollector - Walk the checked decls of a chunk, recording the
+  /// name of every non-local decl they refer to.  Names that failed to
+  /// resolve are recorded too, so that a chunk that later defines them
+  /// triggers a recheck.
+  class ChunkUseCollector : public ASTWalker {
+    SmallVectorImpl<Identifier> &Uses;
+
+    void addUse(ValueDecl *VD) {
+      if (!VD->getName().empty() && !VD->getDeclContext()->isLocalContext())
+        Uses.push_back(VD->getName());
+    }
+
+  public:
+    explicit ChunkUseCollector(SmallVectorImpl<Identifier> &Uses)
+      : Uses(Uses) {}
+
+    bool walkToExprPre(Expr *E) {
+      if (auto DRE = dyn_cast<DeclRefExpr>(E))
+        addUse(DRE->getDecl());
+      else if (auto OSRE = dyn_cast<OverloadSetRefExpr>(E))
+        for (ValueDecl *VD : OSRE->getDecls())
+          addUse(VD);
+      else if (auto MRE = dyn_cast<MemberRefExpr>(E))
+        addUse(MRE->getDecl());
+      else if (auto EMRE = dyn_cast<ExistentialMemberRefExpr>(E))
+        addUse(EMRE->getDecl());
+      else if (auto AMRE = dyn_cast<ArchetypeMemberRefExpr>(E))
+        addUse(AMRE->getDecl());
+      else if (auto GMRE = dyn_cast<GenericMemberRefExpr>(E))
+        addUse(GMRE->getDecl());
+      else if (auto UDRE = dyn_cast<UnresolvedDeclRefExpr>(E))
+        Uses.push_back(UDRE->getName());
+      else if (auto UDE = dyn_cast<UnresolvedDotExpr>(E))
+        Uses.push_back(UDE->getName());
+      else if (auto UME = dyn_cast<UnresolvedMemberExpr>(E))
+        Uses.push_back(UME->getName());
+      return true;
+    }
+  };
+}
+
+/// addMemberNames - Record the names of the given members as defined by a
+/// chunk: other chunks reach them through member references.
+static void addMemberNames(ArrayRef<Decl*> Members,
+                           SmallVectorImpl<Identifier> &Defines) {
+  for (Decl *Member : Members)
+    if (ValueDecl *VD = dyn_cast<ValueDecl>(Member))
+      if (!VD->getName().empty())
+        Defines.push_back(VD->getName());
+}
+
+ArrayRef<Decl*>
+IncrementalTranslationUnit::getChunkDecls(unsigned Index) const {
+  const Chunk &C = Chunks[Index];
+  return ArrayRef<Decl*>(TU->Decls).slice(C.FirstDecl, C.NumDecls);
+}
+
+void IncrementalTranslationUnit::checkChunk(unsigned Index) {
+  Chunk &C = Chunks[Index];
+  DiagnosticEngine &Diags = TU->Ctx.Diags;
+
+  // Check the chunk against only the chunks before it, as when it was first
+  // appended: set the decls of the later chunks aside, and put them back
+  // after the chunk's own.
+  std::vector<Decl*> Later(TU->Decls.begin() + C.FirstDecl, TU->Decls.end());
+  if (!Later.empty()) {
+    TU->Decls.resize(C.FirstDecl);
+    TU->clearLookupCache();
+  }
+
+  DiagnosticEngine::ErrorState SavedErrors = Diags.saveErrorState();
+  C.Defines.clear();
+  C.Uses.clear();
+  C.HadSideEffects = false;
+
+  // This is appendToMainTranslationUnit, except that the identifier types of
+  // each piece have to be captured before name binding consumes them.
+  unsigned BufferOffset = C.Offset;
+  unsigned CurTUElem = C.FirstDecl;
+  do {
+    C.HadSideEffects |= parseIntoTranslationUnit(TU, C.BufferID,
+                                                 &BufferOffset, C.EndOffset,
+                                                 C.Toks);
+    for (auto TypeAndContext : TU->getUnresolvedIdentifierTypes())
+      for (auto &Component : TypeAndContext.first->Components)
+        C.Uses.push_back(Component.Id);
+    performNameBinding(TU, CurTUElem);
+    performTypeChecking(TU, CurTUElem);
+    CurTUElem = TU->Decls.size();
+  } while (BufferOffset != C.EndOffset);
+
+  C.NumDecls = TU->Decls.size() - C.FirstDecl;
+  C.HadError = Diags.hadAnyError();
+  Diags.restoreErrorState(SavedErrors);
+
+  if (!Later.empty()) {
+    TU->Decls.insert(TU->Decls.end(), Later.begin(), Later.end());
+    TU->clearLookupCache();
+    for (unsigned i = Index + 1, e = Chunks.size(); i != e; ++i)
+      Chunks[i].FirstDecl += C.NumDecls;
+  }
+
+  ChunkUseCollector Collector(C.Uses);
+  for (Decl *D : getChunkDecls(Index)) {
+    D->walk(Collector);
+
+    if (ValueDecl *VD = dyn_cast<ValueDecl>(D))
+      if (!VD->getName().empty())
+        C.Defines.push_back(VD->getName());
+    if (NominalTypeDecl *NTD = dyn_cast<NominalTypeDecl>(D))
+      addMemberNames(NTD->getMembers(), C.Defines);
+    if (ExtensionDecl *ED = dyn_cast<ExtensionDecl>(D)) {
+      // Extending a type can change how every use of it checks.
+      Type Extended = ED->getExtendedType();
+      if (auto IT = dyn_cast<IdentifierType>(Extended.getPointer()))
+        C.Defines.push_back(IT->Components.back().Id);
+      addMemberNames(ED->getMembers(), C.Defines);
+    }
+  }
+}
+
+void IncrementalTranslationUnit::removeChunkDecls(ArrayRef<unsigned> Indexes) {
+  std::vector<bool> Dead(TU->Decls.size());
+  for (unsigned Index : Indexes) {
+    Chunk &C = Chunks[Index];
+    std::fill(Dead.begin() + C.FirstDecl,
+              Dead.begin() + C.FirstDecl + C.NumDecls, true);
+    C.NumDecls = 0;
+  }
+
+  // NewIndex[i] - The position of TU->Decls[i] once the dead decls are gone.
+  std::vector<unsigned> NewIndex(TU->Decls.size() + 1);
+  unsigned Live = 0;
+  for (unsigned i = 0, e = TU->Decls.size(); i != e; ++i) {
+    NewIndex[i] = Live;
+    if (!Dead[i])
+      TU->Decls[Live++] = TU->Decls[i];
+  }
+  NewIndex[TU->Decls.size()] = Live;
+  TU->Decls.resize(Live);
+
+  for (Chunk &C : Chunks)
+    C.FirstDecl = NewIndex[C.FirstDecl];
+
+  // Lookups may have cached the decls that were just removed.
+  TU->clearLookupCache();
+}
+
+unsigned IncrementalTranslationUnit::appendChunk(unsigned BufferID,
+                                                 unsigned Offset,
+                                                 unsigned EndOffset,
+                                                 TokenCache *Toks) {
+  Chunks.push_back(Chunk(BufferID, Offset, EndOffset, Toks));
+  Chunks.back().FirstDecl = TU->Decls.size();
+  checkChunk(Chunks.size() - 1);
+  return Chunks.size() - 1;
+}
+
+void IncrementalTranslationUnit::removeLastChunk() {
+  unsigned Last = Chunks.size() - 1;
+  removeChunkDecls(Last);
+  Chunks.pop_back();
+}
+
+bool IncrementalTranslationUnit::replaceChunk(unsigned Index,
+                                              unsigned BufferID,
+                                              unsigned Offset,
+                                              unsigned EndOffset,
+                                              TokenCache *Toks) {
+  Chunk &Replaced = Chunks[Index];
+  Replaced.BufferID = BufferID;
+  Replaced.Offset = Offset;
+  Replaced.EndOffset = EndOffset;
+  Replaced.Toks = Toks;
+
+  // Changed - Every name whose meaning may have changed: the old and new
+  // definitions of every chunk rechecked so far.
+  llvm::DenseSet<Identifier> Changed;
+  std::vector<bool> Done(Chunks.size());
+  bool HadError = false;
+
+  // Each round rechecks the chunks affected by the names changed so far.  A
+  // recheck can only add names (ones the new text defines), so this stops.
+  for (bool FirstRound = true; ; FirstRound = false) {
+    SmallVector<unsigned, 8> Recheck;
+    for (unsigned CI = 0, CE = Chunks.size(); CI != CE; ++CI) {
+      if (Done[CI])
+        continue;
+      Chunk &C = Chunks[CI];
+      bool Affected = CI == Index || (FirstRound && C.HadError);
+      // Only chunks after the replaced one can depend on it.
+      if (!Affected && CI > Index)
+        for (Identifier Name : C.Uses)
+          if (Changed.count(Name)) {
+            Affected = true;
+            break;
+          }
+      if (!Affected)
+        continue;
+
+      // Its decls are about to be replaced, so its dependents are affected
+      // in turn.
+      Recheck.push_back(CI);
+      Changed.insert(C.Defines.begin(), C.Defines.end());
+    }
+    if (Recheck.empty())
+      break;
+
+    // Recheck in order, so that each chunk sees the chunks it was
+    // originally checked against.
+    removeChunkDecls(Recheck);
+    for (unsigned CI : Recheck) {
+      Chunk &C = Chunks[CI];
+      checkChunk(CI);
+      Done[CI] = true;
+      HadError |= C.HadError;
+      Changed.insert(C.Defines.begin(), C.Defines.end());
+    }
+  }
+
+  return HadError;
+}
@@ -15,8 +15,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#ifndef SWIFT_FRONTEND_H
+#define SWIFT_FRONTEND_H
+
+#include "swift/AST/Identifier.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include <vector>
+
 namespace swift {
   class ASTContext;
+  class Decl;
+  class SILModule;
+  class SILPassManager;
+  class TokenCache;
   class TranslationUnit;
   
   TranslationUnit* buildSingleTranslationUnit(ASTContext &Context,
@@ -27,5 +39,113 @@ namespace swift {
   bool appendToMainTranslationUnit(TranslationUnit *TU, unsigned BufferID,
                                    unsigned CurTUElem,
                                    unsigned &BufferOffset,
-                                   unsigned BufferEndOffset);
+                                   unsigned BufferEndOffset,
+                                   TokenCache *Toks = nullptr);
+
+  /// emitAndOptimizeSIL - Run capture analysis over the translation unit,
+  /// from StartElem on, then lower it to a SILModule, emitting function
+  /// bodies on up to NumThreads threads (0 for one per hardware thread), and
+  /// run the given passes over each function.  The caller is responsible for
+  /// deleting the module.
+  SILModule *emitAndOptimizeSIL(TranslationUnit *TU, SILPassManager &PM,
+                                unsigned StartElem = 0,
+                                unsigned NumThreads = 0);
+
+  /// IncrementalTranslationUnit - Drives a main translation unit that is
+  /// built up from a series of chunks of source, any of which can later be
+  /// replaced with new text.  Each chunk records the names its top-level
+  /// decls define and the names it refers to, as resolved by name binding and
+  /// type checking.  Replacing a chunk only reparses and rechecks it and the
+  /// chunks that (transitively) refer to something it defines; the decls of
+  /// every other chunk, and the ASTContext state built for them, are kept.
+  ///
+  /// Dependencies are tracked by name rather than by decl, so that a chunk
+  /// that starts defining a name some later chunk uses is caught as well as
+  /// one that stops defining it.  Chunks that had errors are retried on every
+  /// replacement, since the new text may be what they were missing.
+  class IncrementalTranslationUnit {
+    struct Chunk {
+      /// BufferID, Offset, EndOffset - The source of the chunk.  Chunks may
+      /// share a buffer (as in the REPL) or each have their own.
+      unsigned BufferID;
+      unsigned Offset;
+      unsigned EndOffset;
+
+      /// Toks - The token stream for the buffer, if the caller keeps one.
+      TokenCache *Toks;
+
+      /// FirstDecl, NumDecls - The range of TU->Decls produced by the chunk.
+      /// The decls of the chunks are kept in the order of the chunks.
+      unsigned FirstDecl;
+      unsigned NumDecls;
+
+      /// Defines - The names of the top-level decls of the chunk, including
+      /// the members of types and extensions it declares.
+      llvm::SmallVector<Identifier, 4> Defines;
+
+      /// Uses - The names of the non-local decls and types the chunk refers
+      /// to.
+      llvm::SmallVector<Identifier, 8> Uses;
+
+      /// HadError - Whether any error was diagnosed while checking the chunk.
+      bool HadError;
+
+      /// HadSideEffects - Whether the chunk has any expression, statement or
+      /// decl that might have side-effects when run.
+      bool HadSideEffects;
+
+      Chunk(unsigned BufferID, unsigned Offset, unsigned EndOffset,
+            TokenCache *Toks)
+        : BufferID(BufferID), Offset(Offset), EndOffset(EndOffset),
+          Toks(Toks), FirstDecl(0), NumDecls(0), HadError(false),
+          HadSideEffects(false) {}
+    };
+
+    TranslationUnit *TU;
+    std::vector<Chunk> Chunks;
+
+    /// checkChunk - Parse, name bind and type check the given chunk at its
+    /// FirstDecl, seeing only the decls of the chunks before it, and record
+    /// its dependencies.  The diagnostic engine's error state is kept.
+    void checkChunk(unsigned Index);
+
+    /// removeChunkDecls - Remove the decls of the given chunks from the
+    /// translation unit, keeping the order of everything else.
+    void removeChunkDecls(ArrayRef<unsigned> Indexes);
+
+  public:
+    explicit IncrementalTranslationUnit(TranslationUnit *TU) : TU(TU) {}
+
+    TranslationUnit *getTranslationUnit() const { return TU; }
+    unsigned getNumChunks() const { return Chunks.size(); }
+
+    /// getChunkDecls - Return the top-level decls of the given chunk.
+    ArrayRef<Decl*> getChunkDecls(unsigned Index) const;
+
+    /// chunkHadError - Return whether the given chunk failed to check.
+    bool chunkHadError(unsigned Index) const { return Chunks[Index].HadError; }
+
+    /// chunkHadSideEffects - Return whether the given chunk has anything
+    /// worth running.
+    bool chunkHadSideEffects(unsigned Index) const {
+      return Chunks[Index].HadSideEffects;
+    }
+
+    /// appendChunk - Parse and check [Offset, EndOffset) of the buffer as a
+    /// new chunk at the end of the translation unit, returning its index.
+    unsigned appendChunk(unsigned BufferID, unsigned Offset,
+                         unsigned EndOffset, TokenCache *Toks = nullptr);
+
+    /// replaceChunk - Replace the source of the given chunk, then reparse and
+    /// recheck it along with everything that depends on it.  Returns true if
+    /// any of the rechecked chunks had errors.
+    bool replaceChunk(unsigned Index, unsigned BufferID, unsigned Offset,
+                      unsigned EndOffset, TokenCache *Toks = nullptr);
+
+    /// removeLastChunk - Remove the last chunk and its decls, as if it had
+    /// never been appended.
+    void removeLastChunk();
+  };
 }
+
+#endif
@@ -20,6 +20,7 @@
 #include "swift/Subsystems.h"
 #include "swift/IRGen/Options.h"
 #include "swift/Parse/Lexer.h"
+#include "swift/Parse/TokenCache.h"
 #include "swift/AST/ASTContext.h"
 #include "swift/AST/Component.h"
 #include "swift/AST/Decl.h"
@@ -64,6 +65,16 @@ static void LoadSwiftRuntime() {
   dlopen(LibPath.c_str(), 0);
 }
 
+/// Write out whatever the program has printed.  The runtime buffers
+/// standard output, and the REPL's own output must come after it.
+static void FlushSwiftOutput() {
+  typedef void (*FlushFn)();
+  static FlushFn Flush =
+    reinterpret_cast<FlushFn>(dlsym(RTLD_DEFAULT, "swift_stdout_flush"));
+  if (Flush)
+    Flush();
+}
+
 static bool IRGenImportedModules(TranslationUnit *TU,
                                  llvm::Module &Module,
                                  llvm::SmallPtrSet<TranslationUnit*, 8>
@@ -288,7 +299,6 @@ void swift::REPL(ASTContext &Context) {
   unsigned CurBufferOffset = 0;
   unsigned CurBufferEndOffset = 0;
   
-  unsigned CurTUElem = 0;
   unsigned CurIRGenElem = 0;
   unsigned BraceCount = 0;
   bool HadLineContinuation = false;
@@ -303,13 +313,20 @@ void swift::REPL(ASTContext &Context) {
   CurBufferEndOffset += strlen(importstmt);
   char* LastValidLineEnd = CurBuffer;
 
-  swift::appendToMainTranslationUnit(TU, BufferID, CurTUElem,
-                                     CurBufferOffset,
-                                     CurBufferEndOffset);
-  if (Context.hadError())
+  // Every chunk is parsed out of the same buffer; keep its tokens around so
+  // that the boundaries between chunks are not relexed.
+  TokenCache Toks(Buffer->getBuffer(), Context.SourceMgr, &Context.Diags);
+
+  // Each chunk of input that parses and checks is kept as a chunk of the
+  // translation unit.
+  IncrementalTranslationUnit ITU(TU);
+  unsigned Chunk = ITU.appendChunk(BufferID, CurBufferOffset,
+                                   CurBufferEndOffset, &Toks);
+  if (ITU.chunkHadError(Chunk))
     return;
 
-  CurTUElem = CurIRGenElem = TU->Decls.size();
+  CurBufferOffset = CurBufferEndOffset;
+  CurIRGenElem = TU->Decls.size();
 
   if (llvm::sys::Process::StandardInIsUserInput())
     printf("%s", "Welcome to swift.  Type ':help' for assistance.\n");
@@ -427,15 +444,12 @@ void swift::REPL(ASTContext &Context) {
       continue;
 
     // Parse the current line(s).
-    bool ShouldRun =
-        swift::appendToMainTranslationUnit(TU, BufferID, CurTUElem,
-                                           CurBufferOffset,
-                                           CurBufferEndOffset);
-
-    if (Context.hadError()) {
-      Context.Diags.resetHadAnyError();
-      while (TU->Decls.size() > CurTUElem)
-        TU->Decls.pop_back();
+    Chunk = ITU.appendChunk(BufferID, CurBufferOffset, CurBufferEndOffset,
+                            &Toks);
+    CurBufferOffset = CurBufferEndOffset;
+
+    if (ITU.chunkHadError(Chunk)) {
+      ITU.removeLastChunk();
       TU->clearUnresolvedIdentifierTypes();
 
       // FIXME: Handling of "import" declarations?  Is there any other
@@ -448,7 +462,6 @@ void swift::REPL(ASTContext &Context) {
       continue;
     }
 
-    CurTUElem = TU->Decls.size();
     CurChunkLines = 0;
     
     DumpSource.append(LastValidLineEnd, CurBuffer);
@@ -456,14 +469,14 @@ void swift::REPL(ASTContext &Context) {
 
     // If we didn't see an expression, statement, or decl which might have
     // side-effects, keep reading.
-    if (!ShouldRun)
+    if (!ITU.chunkHadSideEffects(Chunk))
       continue;
 
     // IRGen the current line(s).
     llvm::Module LineModule("REPLLine", LLVMContext);
     performCaptureAnalysis(TU, CurIRGenElem);
     performIRGeneration(Options, &LineModule, TU, CurIRGenElem);
-    CurIRGenElem = CurTUElem;
+    CurIRGenElem = TU->Decls.size();
 
     if (Context.hadError())
       return;
@@ -497,6 +510,7 @@ void swift::REPL(ASTContext &Context) {
     // improve this.
     llvm::Function *EntryFn = Module.getFunction("main");
     EE->runFunctionAsMain(EntryFn, std::vector<std::string>(), 0);
+    FlushSwiftOutput();
     EE->freeMachineCodeForFunction(EntryFn);
     EntryFn->eraseFromParent();
   }
@@ -16,12 +16,36 @@
 
 #include "PrintingDiagnosticConsumer.h"
 #include "swift/Basic/LLVM.h"
-#include "swift/Parse/Lexer.h"
+#include "swift/Parse/TokenCache.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 using namespace swift;
 
+PrintingDiagnosticConsumer::~PrintingDiagnosticConsumer() {
+  for (auto &Entry : TokenCaches)
+    delete Entry.second;
+}
+
+SourceLoc PrintingDiagnosticConsumer::getLocForEndOfToken(llvm::SourceMgr &SM,
+                                                          SourceLoc Loc) {
+  if (!Loc.isValid())
+    return Loc;
+
+  int BufferID = SM.FindBufferContainingLoc(Loc.Value);
+  if (BufferID < 0)
+    return SourceLoc();
+
+  // The lexer already reported its own diagnostics for the buffer, so the
+  // cache doesn't report them again.
+  TokenCache *&Toks = TokenCaches[BufferID];
+  if (!Toks)
+    Toks = new TokenCache(SM.getMemoryBuffer(BufferID)->getBuffer(), SM,
+                          nullptr);
+  return Toks->getLocForEndOfToken(Loc);
+}
+
 void 
 PrintingDiagnosticConsumer::handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
                                              DiagnosticKind Kind, 
@@ -45,7 +69,7 @@ PrintingDiagnosticConsumer::handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
   // Translate ranges.
   SmallVector<llvm::SMRange, 2> Ranges;
   for (SourceRange R : Info.Ranges) {
-    SourceLoc End = Lexer::getLocForEndOfToken(SM, R.End);
+    SourceLoc End = getLocForEndOfToken(SM, R.End);
     
     // FIXME: SMRange is an inclusive range [start, end], so step the
     // end location back by one to get SourceMgr to highlight ranges
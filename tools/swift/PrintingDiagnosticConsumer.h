@@ -19,12 +19,23 @@
 #define SWIFT_PRINTINGDIAGNOSTICCONSUMER_H
 
 #include "swift/Basic/DiagnosticConsumer.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace swift {
+  class TokenCache;
 
 /// \brief Diagnostic consumer that displays diagnostics to standard error.
 class PrintingDiagnosticConsumer : public DiagnosticConsumer {
+  /// TokenCaches - The tokens of each buffer that a highlighted range has
+  /// ended in, by buffer ID, so that finding the end of each range doesn't
+  /// relex the buffer up to it.
+  llvm::DenseMap<unsigned, TokenCache*> TokenCaches;
+
+  SourceLoc getLocForEndOfToken(llvm::SourceMgr &SM, SourceLoc Loc);
+
 public:
+  ~PrintingDiagnosticConsumer();
+
   virtual void handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
                                 DiagnosticKind Kind, llvm::StringRef Text,
                                 const DiagnosticInfo &Info);
@@ -0,0 +1,99 @@
+//===- SerializedDiagnosticConsumer.cpp - Machine-Readable Diags ----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the SerializedDiagnosticConsumer class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SerializedDiagnosticConsumer.h"
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace swift;
+
+/// \brief Write the given text as a JSON string literal.
+static void writeJSONString(raw_ostream &OS, StringRef Text) {
+  OS << '"';
+  for (char C : Text) {
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\n': OS << "\\n"; break;
+    case '\r': OS << "\\r"; break;
+    case '\t': OS << "\\t"; break;
+    default:
+      if ((unsigned char)C < 0x20) {
+        static const char Hex[] = "0123456789abcdef";
+        OS << "\\u00" << Hex[(C >> 4) & 0xF] << Hex[C & 0xF];
+      } else {
+        OS << C;
+      }
+      break;
+    }
+  }
+  OS << '"';
+}
+
+void
+SerializedDiagnosticConsumer::handleDiagnostic(llvm::SourceMgr &SM,
+                                               SourceLoc Loc,
+                                               DiagnosticKind Kind,
+                                               llvm::StringRef Text,
+                                               const DiagnosticInfo &Info) {
+  OS << "{\"kind\":";
+  switch (Kind) {
+  case DiagnosticKind::Error:   OS << "\"error\""; break;
+  case DiagnosticKind::Warning: OS << "\"warning\""; break;
+  case DiagnosticKind::Note:    OS << "\"note\""; break;
+  }
+
+  OS << ",\"id\":";
+  writeJSONString(OS, Info.Name);
+
+  int BufferID = Loc.isValid() ? SM.FindBufferContainingLoc(Loc.Value) : -1;
+  if (BufferID != -1) {
+    auto LineAndCol = SM.getLineAndColumn(Loc.Value, BufferID);
+    OS << ",\"file\":";
+    writeJSONString(OS,
+                    SM.getMemoryBuffer(BufferID)->getBufferIdentifier());
+    OS << ",\"line\":" << LineAndCol.first
+       << ",\"column\":" << LineAndCol.second;
+  }
+
+  OS << ",\"message\":";
+  writeJSONString(OS, Text);
+
+  // Ranges are [startLine, startColumn, endLine, endColumn], where the end is
+  // the start of the last token in the range.
+  OS << ",\"ranges\":[";
+  bool First = true;
+  for (SourceRange R : Info.Ranges) {
+    if (!R.Start.isValid() || !R.End.isValid())
+      continue;
+    int RangeBufferID = SM.FindBufferContainingLoc(R.Start.Value);
+    if (RangeBufferID == -1)
+      continue;
+    auto Start = SM.getLineAndColumn(R.Start.Value, RangeBufferID);
+    auto End = SM.getLineAndColumn(R.End.Value, RangeBufferID);
+    if (!First)
+      OS << ',';
+    First = false;
+    OS << '[' << Start.first << ',' << Start.second << ','
+       << End.first << ',' << End.second << ']';
+  }
+  OS << "]}\n";
+
+  if (Next)
+    Next->handleDiagnostic(SM, Loc, Kind, Text, Info);
+}
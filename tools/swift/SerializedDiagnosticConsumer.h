@@ -0,0 +1,56 @@
+//===- SerializedDiagnosticConsumer.h - Machine-Readable Diags --*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the SerializedDiagnosticConsumer class, which writes
+//  diagnostics in a form meant for tools rather than people.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SERIALIZEDDIAGNOSTICCONSUMER_H
+#define SWIFT_SERIALIZEDDIAGNOSTICCONSUMER_H
+
+#include "swift/Basic/DiagnosticConsumer.h"
+
+namespace llvm {
+  class raw_ostream;
+}
+
+namespace swift {
+
+/// \brief Diagnostic consumer that writes each diagnostic as one line of
+/// JSON, for example:
+///
+/// \code
+/// {"kind":"error","id":"expected_expr","file":"t.swift","line":3,
+///  "column":9,"message":"expected expression","ranges":[[3,9,3,12]]}
+/// \endcode
+///
+/// (all on one line).  Locations that are not in a known buffer have no
+/// "file", "line" or "column" keys.  Diagnostics can also be passed on to
+/// another consumer, so that the usual text output is kept.
+class SerializedDiagnosticConsumer : public DiagnosticConsumer {
+  llvm::raw_ostream &OS;
+  DiagnosticConsumer *Next;
+
+public:
+  explicit SerializedDiagnosticConsumer(llvm::raw_ostream &OS,
+                                        DiagnosticConsumer *Next = nullptr)
+    : OS(OS), Next(Next) {}
+
+  virtual void handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
+                                DiagnosticKind Kind, llvm::StringRef Text,
+                                const DiagnosticInfo &Info);
+};
+
+}
+
+#endif
@@ -1,3 +1,146 @@
+//===-- swift.cpp - Swift compiler and interpreter ------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This is the entry point to the swift tool: it runs the given file
+// immediately, or prints its SIL with -emit-sil, or starts the REPL when
+// there is no file.
+//
+//===----------------------------------------------------------------------===//
 
-int main() {
+#include "Frontend.h"
+#include "Immediate.h"
+#include "PrintingDiagnosticConsumer.h"
+#include "SerializedDiagnosticConsumer.h"
+#include "swift/AST/ASTContext.h"
+#include "swift/AST/DiagnosticEngine.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILPassManager.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <string>
+
+using namespace swift;
+
+static llvm::cl::opt<std::string>
+InputFilename(llvm::cl::Positional, llvm::cl::desc("<input file>"));
+
+static llvm::cl::list<std::string>
+ImportPaths("I", llvm::cl::desc("Add a directory to the import search path"),
+            llvm::cl::Prefix);
+
+static llvm::cl::opt<unsigned>
+ErrorLimit("error-limit",
+           llvm::cl::desc("Stop after this many errors (0 for no limit)"),
+           llvm::cl::init(20));
+
+static llvm::cl::opt<std::string>
+SerializeDiagnostics("serialize-diagnostics",
+                     llvm::cl::desc("Also write diagnostics as JSON lines "
+                                    "to the given file"),
+                     llvm::cl::value_desc("file"));
+
+static llvm::cl::opt<bool>
+EmitSIL("emit-sil",
+        llvm::cl::desc("Print the SIL of the input file instead of running "
+                       "it"));
+
+/// Find the standard library the build put next to the tool.
+static std::string getDefaultImportPath() {
+  llvm::sys::Path Path =
+      llvm::sys::Path::GetMainExecutable(0, (void*)&getDefaultImportPath);
+  Path.eraseComponent();
+  Path.eraseComponent();
+  Path.appendComponent("lib");
+  Path.appendComponent("swift");
+  return Path.str();
+}
+
+int main(int argc, char **argv) {
+  llvm::sys::PrintStackTraceOnErrorSignal();
+  llvm::PrettyStackTraceProgram StackPrinter(argc, argv);
+  llvm::llvm_shutdown_obj Shutdown;
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Swift\n");
+
+  llvm::InitializeNativeTarget();
+
+  llvm::SourceMgr SM;
+  PrintingDiagnosticConsumer PrintingConsumer;
+
+  // The JSON consumer passes everything on to the printing one.
+  llvm::OwningPtr<llvm::raw_fd_ostream> SerializedOS;
+  llvm::OwningPtr<SerializedDiagnosticConsumer> SerializedConsumer;
+  DiagnosticConsumer *Consumer = &PrintingConsumer;
+  if (!SerializeDiagnostics.empty()) {
+    std::string ErrorInfo;
+    SerializedOS.reset(new llvm::raw_fd_ostream(SerializeDiagnostics.c_str(),
+                                                ErrorInfo));
+    if (!ErrorInfo.empty()) {
+      llvm::errs() << "error: cannot open '" << SerializeDiagnostics
+                   << "': " << ErrorInfo << "\n";
+      return 1;
+    }
+    SerializedConsumer.reset(new SerializedDiagnosticConsumer(
+        *SerializedOS, &PrintingConsumer));
+    Consumer = SerializedConsumer.get();
+  }
+
+  DiagnosticEngine Diags(SM, *Consumer);
+  Diags.setErrorLimit(ErrorLimit);
+  LangOptions LangOpts;
+  ASTContext Context(LangOpts, SM, Diags);
+  Context.ImportSearchPaths.insert(Context.ImportSearchPaths.end(),
+                                   ImportPaths.begin(), ImportPaths.end());
+  Context.ImportSearchPaths.push_back(getDefaultImportPath());
+
+  if (InputFilename.empty()) {
+    REPL(Context);
+    return Context.hadError();
+  }
+
+  llvm::OwningPtr<llvm::MemoryBuffer> Buffer;
+  if (llvm::error_code Err =
+        llvm::MemoryBuffer::getFileOrSTDIN(InputFilename, Buffer)) {
+    llvm::errs() << "error: cannot read '" << InputFilename << "': "
+                 << Err.message() << "\n";
+    return 1;
+  }
+  unsigned BufferID = SM.AddNewSourceBuffer(Buffer.take(), llvm::SMLoc());
+
+  TranslationUnit *TU = buildSingleTranslationUnit(Context, BufferID,
+                                                   /*ParseOnly=*/false,
+                                                   /*IsMainModule=*/true);
+  if (Context.hadError())
+    return 1;
+
+  if (EmitSIL) {
+    // Print the SIL as SILGen emits it, before any passes run over it.
+    SILPassManager PM;
+    llvm::OwningPtr<SILModule> M(emitAndOptimizeSIL(TU, PM));
+    if (Context.hadError())
+      return 1;
+    M->print(llvm::outs());
+    return 0;
+  }
+
+  RunImmediately(TU);
+  return Context.hadError();
 }
@@ -0,0 +1,143 @@
+//===- swift/unittests/AST/DiagnosticEngineTest.cpp - Diagnostic engine ---===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/AST/Diagnostics.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  /// Records the name and text of every diagnostic it is handed.
+  class RecordingConsumer : public DiagnosticConsumer {
+  public:
+    std::vector<std::string> Names;
+    std::vector<std::string> Texts;
+
+    virtual void handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
+                                  DiagnosticKind Kind, llvm::StringRef Text,
+                                  const DiagnosticInfo &Info) {
+      Names.push_back(Info.Name);
+      Texts.push_back(Text);
+    }
+  };
+
+  class DiagnosticEngineTest : public ::testing::Test {
+  protected:
+    llvm::SourceMgr SM;
+    RecordingConsumer Consumer;
+    DiagnosticEngine Diags;
+    const char *Start;
+
+    DiagnosticEngineTest() : Diags(SM, Consumer) {
+      llvm::MemoryBuffer *Buffer =
+        llvm::MemoryBuffer::getMemBuffer("var x = y + z\n", "test.swift");
+      SM.AddNewSourceBuffer(Buffer, llvm::SMLoc());
+      Start = Buffer->getBufferStart();
+    }
+
+    SourceLoc getLoc(unsigned Offset) {
+      return SourceLoc(llvm::SMLoc::getFromPointer(Start + Offset));
+    }
+  };
+}
+
+TEST_F(DiagnosticEngineTest, dropsRepeats) {
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  Diags.diagnose(getLoc(0), diag::opening_brace);
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  Diags.diagnose(getLoc(0), diag::opening_brace);
+  Diags.diagnose(getLoc(4), diag::extra_rbrace);
+
+  ASSERT_EQ(3U, Consumer.Names.size());
+  EXPECT_EQ("extra_rbrace", Consumer.Names[0]);
+  EXPECT_EQ("opening_brace", Consumer.Names[1]);
+  EXPECT_EQ("extra_rbrace", Consumer.Names[2]);
+  EXPECT_TRUE(Diags.hadAnyError());
+}
+
+TEST_F(DiagnosticEngineTest, repeatsIgnoreArguments) {
+  Diags.diagnose(getLoc(0), diag::expected_identifier_in_decl, "var");
+  Diags.diagnose(getLoc(0), diag::expected_identifier_in_decl, "func");
+  Diags.diagnose(getLoc(4), diag::expected_identifier_in_decl, "func");
+
+  ASSERT_EQ(2U, Consumer.Texts.size());
+  EXPECT_EQ("expected identifier in var declaration", Consumer.Texts[0]);
+  EXPECT_EQ("expected identifier in func declaration", Consumer.Texts[1]);
+}
+
+TEST_F(DiagnosticEngineTest, keepsRepeatsWithoutLocation) {
+  Diags.diagnose(SourceLoc(), diag::extra_rbrace);
+  Diags.diagnose(SourceLoc(), diag::extra_rbrace);
+  EXPECT_EQ(2U, Consumer.Names.size());
+}
+
+TEST_F(DiagnosticEngineTest, errorLimit) {
+  Diags.setErrorLimit(2);
+  for (unsigned i = 0; i != 10; ++i)
+    Diags.diagnose(getLoc(i), diag::extra_rbrace);
+
+  ASSERT_EQ(3U, Consumer.Names.size());
+  EXPECT_EQ("too_many_errors", Consumer.Names[2]);
+  EXPECT_TRUE(Diags.hadTooManyErrors());
+
+  Diags.resetHadAnyError();
+  EXPECT_FALSE(Diags.hadTooManyErrors());
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  EXPECT_EQ(4U, Consumer.Names.size());
+}
+
+TEST_F(DiagnosticEngineTest, saveErrorState) {
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  ASSERT_TRUE(Diags.hadAnyError());
+
+  // A repeat is reported again once the state is set aside, and errors
+  // emitted in between aren't lost when it is restored.
+  DiagnosticEngine::ErrorState Saved = Diags.saveErrorState();
+  EXPECT_FALSE(Diags.hadAnyError());
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  EXPECT_TRUE(Diags.hadAnyError());
+  EXPECT_EQ(2U, Consumer.Names.size());
+  Diags.restoreErrorState(Saved);
+  EXPECT_TRUE(Diags.hadAnyError());
+
+  // A clean stretch doesn't clear the errors emitted before it.
+  Saved = Diags.saveErrorState();
+  Diags.restoreErrorState(Saved);
+  EXPECT_TRUE(Diags.hadAnyError());
+
+  // The record of what was emitted is back, so repeats are dropped again.
+  Diags.diagnose(getLoc(0), diag::extra_rbrace);
+  EXPECT_EQ(2U, Consumer.Names.size());
+}
+
+TEST_F(DiagnosticEngineTest, buffering) {
+  Diags.setBufferDiagnostics(true);
+  {
+    // The argument has to outlive the temporary it was built in.
+    llvm::SmallString<16> Kind("struct");
+    Diags.diagnose(getLoc(0), diag::expected_identifier_in_decl, Kind.str());
+    Kind = "xxxxxx";
+  }
+  Diags.diagnose(getLoc(4), diag::extra_rbrace);
+  EXPECT_TRUE(Consumer.Names.empty());
+  EXPECT_TRUE(Diags.hadAnyError());
+
+  Diags.setBufferDiagnostics(false);
+  ASSERT_EQ(2U, Consumer.Texts.size());
+  EXPECT_EQ("expected identifier in struct declaration", Consumer.Texts[0]);
+  EXPECT_EQ("extraneous '}' at top level", Consumer.Texts[1]);
+}
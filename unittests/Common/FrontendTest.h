@@ -0,0 +1,112 @@
+//===- swift/unittests/Common/FrontendTest.h - Test fixture -----*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// The fixture shared by tests that run source through the frontend: it owns
+// an ASTContext, counts the errors diagnosed, and can take a source string
+// through parsing, name binding and type checking, and down to SIL.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_UNITTESTS_COMMON_FRONTENDTEST_H
+#define SWIFT_UNITTESTS_COMMON_FRONTENDTEST_H
+
+#include "swift/Subsystems.h"
+#include "swift/AST/AST.h"
+#include "swift/AST/Component.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/SIL/Function.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+namespace swift {
+namespace unittest {
+
+/// CountingConsumer - Counts the errors it is handed and otherwise ignores
+/// them.
+class CountingConsumer : public DiagnosticConsumer {
+public:
+  unsigned NumErrors = 0;
+
+  virtual void handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
+                                DiagnosticKind Kind, llvm::StringRef Text,
+                                const DiagnosticInfo &Info) {
+    if (Kind == DiagnosticKind::Error)
+      ++NumErrors;
+  }
+};
+
+/// FrontendTest - A fixture for tests that compile source strings.
+class FrontendTest : public ::testing::Test {
+protected:
+  llvm::SourceMgr SM;
+  CountingConsumer Consumer;
+  DiagnosticEngine Diags;
+  LangOptions LangOpts;
+  ASTContext Context;
+
+  /// Functions - The SIL functions emitted by emitSIL, which are deleted
+  /// along with the fixture.
+  std::vector<Function*> Functions;
+
+  FrontendTest() : Diags(SM, Consumer), Context(LangOpts, SM, Diags) {}
+  ~FrontendTest() {
+    for (Function *F : Functions)
+      delete F;
+  }
+
+  /// addBuffer - Add a buffer holding a copy of the given source.
+  unsigned addBuffer(StringRef Source) {
+    return SM.AddNewSourceBuffer(
+        llvm::MemoryBuffer::getMemBufferCopy(Source, "test.swift"),
+        llvm::SMLoc());
+  }
+
+  /// createTU - Create an empty translation unit named 'test'.
+  TranslationUnit *createTU(bool IsMainModule = false) {
+    Component *Comp = new (Context.Allocate<Component>(1)) Component();
+    return new (Context) TranslationUnit(Context.getIdentifier("test"), Comp,
+                                         Context, IsMainModule,
+                                         /*IsReplModule=*/false);
+  }
+
+  /// check - Parse, name bind and type check the given source as a library.
+  TranslationUnit *check(StringRef Source) {
+    TranslationUnit *TU = createTU();
+    parseIntoTranslationUnit(TU, addBuffer(Source));
+    performNameBinding(TU);
+    performTypeChecking(TU);
+    return TU;
+  }
+
+  /// emitSIL - Check the given source, then lower each of its functions
+  /// with a body to SIL, in order.  Returns the new functions, which are
+  /// also added to Functions.
+  std::vector<Function*> emitSIL(StringRef Source) {
+    TranslationUnit *TU = check(Source);
+    performCaptureAnalysis(TU);
+
+    std::vector<Function*> Emitted;
+    for (Decl *D : TU->Decls)
+      if (FuncDecl *FD = dyn_cast<FuncDecl>(D))
+        if (FD->getBody() && FD->getBody()->getBody())
+          Emitted.push_back(Function::constructSIL(FD->getBody()));
+    Functions.insert(Functions.end(), Emitted.begin(), Emitted.end());
+    return Emitted;
+  }
+};
+
+} // end namespace unittest
+} // end namespace swift
+
+#endif
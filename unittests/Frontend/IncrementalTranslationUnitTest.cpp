@@ -0,0 +1,117 @@
+//===- swift/unittests/Frontend/IncrementalTranslationUnitTest.cpp --------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "../../tools/swift/Frontend.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  class IncrementalTranslationUnitTest : public unittest::FrontendTest {
+  protected:
+    /// Parse and check the given source as a new chunk of the unit.
+    unsigned append(IncrementalTranslationUnit &ITU, StringRef Source) {
+      return ITU.appendChunk(addBuffer(Source), 0, Source.size());
+    }
+
+    /// Replace the source of the given chunk.
+    bool replace(IncrementalTranslationUnit &ITU, unsigned Index,
+                 StringRef Source) {
+      return ITU.replaceChunk(Index, addBuffer(Source), 0, Source.size());
+    }
+
+    /// The names of the top-level decls of the unit, in order.
+    static std::vector<std::string> getDeclNames(TranslationUnit *TU) {
+      std::vector<std::string> Names;
+      for (Decl *D : TU->Decls)
+        if (ValueDecl *VD = dyn_cast<ValueDecl>(D))
+          Names.push_back(VD->getName().str());
+      return Names;
+    }
+  };
+}
+
+TEST_F(IncrementalTranslationUnitTest, ReplaceMiddleChunk) {
+  IncrementalTranslationUnit ITU(createTU(/*IsMainModule=*/true));
+  TranslationUnit *TU = ITU.getTranslationUnit();
+  append(ITU, "struct S {}\n"
+              "func a() -> S { return S() }\n");
+  append(ITU, "func b() -> S { return a() }\n");
+  append(ITU, "func c() -> S { return b() }\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+  std::vector<std::string> Expected = { "S", "a", "b", "c" };
+  EXPECT_EQ(Expected, getDeclNames(TU));
+
+  // The edited chunk is checked against the chunks before it only, so it
+  // can't see 'c'.  Its decls stay where they were, and the chunk after it,
+  // which uses 'b', is rechecked against the new ones.
+  EXPECT_TRUE(replace(ITU, 1, "func b() -> S { return c() }\n"));
+  unsigned NumErrors = Consumer.NumErrors;
+  EXPECT_LT(0U, NumErrors);
+  EXPECT_TRUE(ITU.chunkHadError(1));
+  EXPECT_FALSE(ITU.chunkHadError(2));
+  EXPECT_EQ(Expected, getDeclNames(TU));
+  ASSERT_EQ(1U, ITU.getChunkDecls(1).size());
+  EXPECT_EQ("b", cast<ValueDecl>(ITU.getChunkDecls(1)[0])->getName().str());
+  ASSERT_EQ(1U, ITU.getChunkDecls(2).size());
+  EXPECT_EQ("c", cast<ValueDecl>(ITU.getChunkDecls(2)[0])->getName().str());
+
+  // Fixing the chunk doesn't clear the errors the caller has seen.
+  EXPECT_FALSE(replace(ITU, 1, "func b() -> S { return a() }\n"));
+  EXPECT_EQ(NumErrors, Consumer.NumErrors);
+  EXPECT_FALSE(ITU.chunkHadError(1));
+  EXPECT_TRUE(Diags.hadAnyError());
+  EXPECT_EQ(Expected, getDeclNames(TU));
+}
+
+TEST_F(IncrementalTranslationUnitTest, ReplaceDefinitionChangesUses) {
+  IncrementalTranslationUnit ITU(createTU(/*IsMainModule=*/true));
+  TranslationUnit *TU = ITU.getTranslationUnit();
+  append(ITU, "struct S {}\n");
+  append(ITU, "func a() -> S { return S() }\n");
+  append(ITU, "func b() -> S { return a() }\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // Removing 'a' breaks the chunk that uses it; putting it back fixes it.
+  EXPECT_TRUE(replace(ITU, 1, "func z() -> S { return S() }\n"));
+  EXPECT_TRUE(ITU.chunkHadError(2));
+  std::vector<std::string> Expected = { "S", "z", "b" };
+  EXPECT_EQ(Expected, getDeclNames(TU));
+
+  EXPECT_FALSE(replace(ITU, 1, "func a() -> S { return S() }\n"));
+  EXPECT_FALSE(ITU.chunkHadError(2));
+  Expected = { "S", "a", "b" };
+  EXPECT_EQ(Expected, getDeclNames(TU));
+}
+
+TEST_F(IncrementalTranslationUnitTest, RemoveLastChunk) {
+  IncrementalTranslationUnit ITU(createTU(/*IsMainModule=*/true));
+  TranslationUnit *TU = ITU.getTranslationUnit();
+  unsigned Chunk = append(ITU, "func a() -> Int { return 1 }\n");
+  EXPECT_FALSE(ITU.chunkHadSideEffects(Chunk));
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // As in the REPL, input that fails to check is dropped.
+  Chunk = append(ITU, "func b() -> Int { return c() }\n");
+  EXPECT_TRUE(ITU.chunkHadError(Chunk));
+  ITU.removeLastChunk();
+  EXPECT_EQ(1U, ITU.getNumChunks());
+  std::vector<std::string> Expected = { "a" };
+  EXPECT_EQ(Expected, getDeclNames(TU));
+
+  Chunk = append(ITU, "a()\n");
+  EXPECT_FALSE(ITU.chunkHadError(Chunk));
+  EXPECT_TRUE(ITU.chunkHadSideEffects(Chunk));
+}
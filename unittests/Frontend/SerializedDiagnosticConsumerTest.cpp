@@ -0,0 +1,72 @@
+//===- swift/unittests/Frontend/SerializedDiagnosticConsumerTest.cpp ------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "../../tools/swift/SerializedDiagnosticConsumer.h"
+#include "swift/AST/Diagnostics.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace swift;
+
+namespace {
+  class SerializedDiagnosticConsumerTest : public ::testing::Test {
+  protected:
+    llvm::SourceMgr SM;
+    std::string Output;
+    llvm::raw_string_ostream OS;
+    unittest::CountingConsumer Next;
+    SerializedDiagnosticConsumer Consumer;
+    DiagnosticEngine Diags;
+    const char *Start;
+
+    SerializedDiagnosticConsumerTest()
+      : OS(Output), Consumer(OS, &Next), Diags(SM, Consumer) {
+      llvm::MemoryBuffer *Buffer =
+        llvm::MemoryBuffer::getMemBuffer("var x = y + z\n", "test.swift");
+      SM.AddNewSourceBuffer(Buffer, llvm::SMLoc());
+      Start = Buffer->getBufferStart();
+    }
+
+    SourceLoc getLoc(unsigned Offset) {
+      return SourceLoc(llvm::SMLoc::getFromPointer(Start + Offset));
+    }
+
+    std::string getOutput() { return OS.str(); }
+  };
+}
+
+TEST_F(SerializedDiagnosticConsumerTest, LocationAndRanges) {
+  Diags.diagnose(getLoc(8), diag::extra_rbrace)
+    << SourceRange(getLoc(8), getLoc(12));
+  EXPECT_EQ("{\"kind\":\"error\",\"id\":\"extra_rbrace\","
+            "\"file\":\"test.swift\",\"line\":1,\"column\":9,"
+            "\"message\":\"extraneous '}' at top level\","
+            "\"ranges\":[[1,9,1,13]]}\n",
+            getOutput());
+
+  // Diagnostics are passed on as well as written.
+  EXPECT_EQ(1U, Next.NumErrors);
+}
+
+TEST_F(SerializedDiagnosticConsumerTest, NoLocation) {
+  // Diagnostics without a location leave out the location keys, and the
+  // message is escaped.
+  Diags.diagnose(SourceLoc(), diag::expected_identifier_in_decl, "a\"b\t");
+  EXPECT_EQ("{\"kind\":\"error\",\"id\":\"expected_identifier_in_decl\","
+            "\"message\":\"expected identifier in a\\\"b\\t declaration\","
+            "\"ranges\":[]}\n",
+            getOutput());
+}
@@ -0,0 +1,278 @@
+//===- swift/unittests/IRGen/SILLoweringTest.cpp - IRGen from SIL ---------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "swift/IRGen/Options.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILPassManager.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/Support/TargetSelect.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  class SILLoweringTest : public unittest::FrontendTest {
+  protected:
+    llvm::LLVMContext LLVMContext;
+    llvm::Module Module;
+
+    SILLoweringTest() : Module("test", LLVMContext) {
+      llvm::InitializeAllTargets();
+      llvm::InitializeAllTargetMCs();
+    }
+
+    /// Check the given source, lower it to SIL and promote its variables,
+    /// then generate IR for it into Module.
+    void emitIR(StringRef Source, bool EmitFromSIL = true) {
+      TranslationUnit *TU = check(Source);
+      ASSERT_EQ(0U, Consumer.NumErrors);
+      performCaptureAnalysis(TU);
+
+      llvm::OwningPtr<SILModule> SILMod(SILModule::constructSIL(TU, 0, 1));
+      SILPassManager::Options PMOpts;
+      PMOpts.VerifyAfterEachPass = true;
+      SILPassManager PM(PMOpts);
+      PM.add(createSILMem2RegPass());
+      for (auto &Entry : *SILMod)
+        PM.run(*Entry.second);
+
+      irgen::Options Opts;
+      Opts.Triple = "x86_64-apple-darwin10";
+      Opts.OutputKind = irgen::OutputKind::Module;
+      Opts.EmitFromSIL = EmitFromSIL;
+      performIRGeneration(Opts, &Module, TU, 0, SILMod.get());
+      ASSERT_EQ(0U, Consumer.NumErrors);
+    }
+
+    /// Return the definition of the global function with the given name.
+    llvm::Function *getFunction(StringRef Name) {
+      std::string Prefix = ("_T4test" + llvm::Twine(Name.size()) + Name).str();
+      for (llvm::Function &F : Module)
+        if (!F.isDeclaration() && StringRef(F.getName()).startswith(Prefix))
+          return &F;
+      return nullptr;
+    }
+
+    template <typename Inst>
+    static unsigned count(llvm::Function *F) {
+      unsigned N = 0;
+      for (llvm::BasicBlock &BB : *F)
+        for (llvm::Instruction &I : BB)
+          N += llvm::isa<Inst>(&I);
+      return N;
+    }
+
+    static llvm::Argument *getArg(llvm::Function *F, unsigned Index) {
+      llvm::Function::arg_iterator AI = F->arg_begin();
+      std::advance(AI, Index);
+      return &*AI;
+    }
+
+    typedef std::vector<std::pair<unsigned, unsigned>> RefCountList;
+
+    /// Add the number of retains and releases on each path from the block
+    /// to a return, on top of the given counts.  The function must not
+    /// loop.
+    static void countRefCounting(llvm::BasicBlock *BB, unsigned Retains,
+                                 unsigned Releases, RefCountList &Paths) {
+      for (llvm::Instruction &I : *BB)
+        if (llvm::CallInst *CI = llvm::dyn_cast<llvm::CallInst>(&I))
+          if (llvm::Function *Callee = CI->getCalledFunction()) {
+            StringRef Name = Callee->getName();
+            Retains += Name.startswith("swift_retain");
+            Releases += Name == "swift_release";
+          }
+
+      llvm::TerminatorInst *TI = BB->getTerminator();
+      if (llvm::isa<llvm::ReturnInst>(TI))
+        Paths.push_back(std::make_pair(Retains, Releases));
+      for (unsigned i = 0, e = TI->getNumSuccessors(); i != e; ++i)
+        countRefCounting(TI->getSuccessor(i), Retains, Releases, Paths);
+    }
+
+    /// Return the number of retains and releases on each path through the
+    /// function.
+    static RefCountList countRefCounting(llvm::Function *F) {
+      RefCountList Paths;
+      countRefCounting(&F->front(), 0, 0, Paths);
+      return Paths;
+    }
+  };
+}
+
+TEST_F(SILLoweringTest, StraightLine) {
+  emitIR("import Builtin\n"
+         "func f(a : Builtin.Int64, b : Builtin.Int64) -> Builtin.Int64 {\n"
+         "  var x = a\n"
+         "  x = b\n"
+         "  return x\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+
+  // Once its variables are promoted, the function needs no memory.
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+  EXPECT_EQ(0U, count<llvm::PHINode>(F));
+  llvm::ReturnInst *Ret =
+    llvm::dyn_cast<llvm::ReturnInst>(F->back().getTerminator());
+  ASSERT_TRUE(Ret != nullptr);
+  EXPECT_EQ(getArg(F, 1), Ret->getReturnValue());
+}
+
+TEST_F(SILLoweringTest, OffByDefault) {
+  emitIR("import Builtin\n"
+         "func f(a : Builtin.Int64) -> Builtin.Int64 {\n"
+         "  var x = a\n"
+         "  return x\n"
+         "}\n", /*EmitFromSIL=*/false);
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+
+  // The AST emitter keeps variables in memory.
+  EXPECT_LT(0U, count<llvm::AllocaInst>(F));
+}
+
+TEST_F(SILLoweringTest, Branch) {
+  emitIR("import Builtin\n"
+         "func f(c : Builtin.Int1, a : Builtin.Int64, b : Builtin.Int64)\n"
+         "    -> Builtin.Int64 {\n"
+         "  var x = a\n"
+         "  if c {\n"
+         "    x = b\n"
+         "  }\n"
+         "  return x\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+
+  // The branch tests the parameter directly.
+  llvm::BranchInst *Br =
+    llvm::dyn_cast<llvm::BranchInst>(F->front().getTerminator());
+  ASSERT_TRUE(Br != nullptr);
+  ASSERT_TRUE(Br->isConditional());
+  EXPECT_EQ(getArg(F, 0), Br->getCondition());
+
+  // The join merges the two values of 'x' with a phi, and returns it.
+  ASSERT_EQ(1U, count<llvm::PHINode>(F));
+  llvm::PHINode *Phi = nullptr;
+  for (llvm::BasicBlock &BB : *F)
+    if (llvm::PHINode *P = llvm::dyn_cast<llvm::PHINode>(&BB.front()))
+      Phi = P;
+  ASSERT_EQ(2U, Phi->getNumIncomingValues());
+  EXPECT_NE(Phi->getIncomingValue(0), Phi->getIncomingValue(1));
+  for (unsigned i = 0; i != 2; ++i) {
+    llvm::Value *V = Phi->getIncomingValue(i);
+    EXPECT_TRUE(V == getArg(F, 1) || V == getArg(F, 2));
+  }
+}
+
+TEST_F(SILLoweringTest, LoopBlockArgument) {
+  emitIR("import Builtin\n"
+         "func f(c : Builtin.Int1, a : Builtin.Int64, b : Builtin.Int64)\n"
+         "    -> Builtin.Int64 {\n"
+         "  var x = a\n"
+         "  while c {\n"
+         "    x = b\n"
+         "  }\n"
+         "  return x\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+
+  // The loop header takes 'a' from the entry block and 'b' from the back
+  // edge.
+  ASSERT_EQ(1U, count<llvm::PHINode>(F));
+  llvm::BasicBlock *Header =
+    llvm::cast<llvm::BranchInst>(F->front().getTerminator())->getSuccessor(0);
+  llvm::PHINode *Phi = llvm::dyn_cast<llvm::PHINode>(&Header->front());
+  ASSERT_TRUE(Phi != nullptr);
+  ASSERT_EQ(2U, Phi->getNumIncomingValues());
+  EXPECT_EQ(getArg(F, 1), Phi->getIncomingValueForBlock(&F->front()));
+  for (unsigned i = 0; i != 2; ++i)
+    if (Phi->getIncomingBlock(i) != &F->front())
+      EXPECT_EQ(getArg(F, 2), Phi->getIncomingValue(i));
+}
+
+TEST_F(SILLoweringTest, ReleaseWithoutMemory) {
+  emitIR("import Builtin\n"
+         "class C {}\n"
+         "func f(a : C, b : C) -> C {\n"
+         "  var x = a\n"
+         "  x = b\n"
+         "  return x\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+
+  // Overwriting 'a' releases it in place, without a temporary.
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+
+  // The function owns 'a' and 'b' and gives up one reference, to 'b', on
+  // return, so every path releases once more than it retains.
+  RefCountList Paths = countRefCounting(F);
+  ASSERT_FALSE(Paths.empty());
+  for (auto &Counts : Paths) {
+    EXPECT_EQ(Counts.first + 1, Counts.second);
+    EXPECT_LE(1U, Counts.second);
+  }
+}
+
+TEST_F(SILLoweringTest, ReleaseOnEachPath) {
+  emitIR("import Builtin\n"
+         "class C {}\n"
+         "func f(c : Builtin.Int1, a : C, b : C) -> C {\n"
+         "  var x = a\n"
+         "  if c {\n"
+         "    x = b\n"
+         "  }\n"
+         "  return x\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+
+  // Whichever of 'a' and 'b' is returned, the other one is released.
+  RefCountList Paths = countRefCounting(F);
+  EXPECT_EQ(2U, Paths.size());
+  for (auto &Counts : Paths)
+    EXPECT_EQ(Counts.first + 1, Counts.second);
+}
+
+TEST_F(SILLoweringTest, CopyPromotedValue) {
+  emitIR("import Builtin\n"
+         "class C {}\n"
+         "func f(a : C) -> (C, C) {\n"
+         "  var x = a\n"
+         "  return (x, x)\n"
+         "}\n");
+  llvm::Function *F = getFunction("f");
+  ASSERT_TRUE(F != nullptr);
+  EXPECT_EQ(0U, count<llvm::AllocaInst>(F));
+
+  // Reading 'x' copies it, so returning two references to the one 'a' the
+  // function owns takes exactly one retain more than it releases.
+  RefCountList Paths = countRefCounting(F);
+  ASSERT_FALSE(Paths.empty());
+  for (auto &Counts : Paths)
+    EXPECT_EQ(Counts.second + 1, Counts.first);
+}
@@ -0,0 +1,144 @@
+//===- swift/unittests/Parse/LexerBenchmark.cpp - Lexer throughput --------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Parse/Lexer.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/PathV2.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace swift;
+
+/// Lex the whole buffer, appending the kind of every token to Kinds.
+static void lexAll(StringRef Text, std::vector<tok> &Kinds) {
+  llvm::SourceMgr SM;
+  Lexer L(Text, SM, nullptr);
+  Token Tok;
+  do {
+    L.lex(Tok);
+    Kinds.push_back(Tok.getKind());
+  } while (Tok.isNot(tok::eof));
+}
+
+TEST(LexerTest, keywords) {
+  std::vector<tok> Kinds;
+  lexAll("class constructor destructor extension func import oneof metatype "
+         "protocol requires struct typealias var static subscript if in do "
+         "else for while return break continue new", Kinds);
+
+  tok Expected[] = {
+    tok::kw_class, tok::kw_constructor, tok::kw_destructor,
+    tok::kw_extension, tok::kw_func, tok::kw_import, tok::kw_oneof,
+    tok::kw_metatype, tok::kw_protocol, tok::kw_requires, tok::kw_struct,
+    tok::kw_typealias, tok::kw_var, tok::kw_static, tok::kw_subscript,
+    tok::kw_if, tok::kw_in, tok::kw_do, tok::kw_else, tok::kw_for,
+    tok::kw_while, tok::kw_return, tok::kw_break, tok::kw_continue,
+    tok::kw_new, tok::eof
+  };
+  ASSERT_EQ(sizeof(Expected) / sizeof(Expected[0]), Kinds.size());
+  for (unsigned i = 0, e = Kinds.size(); i != e; ++i)
+    EXPECT_EQ(Expected[i], Kinds[i]);
+}
+
+TEST(LexerTest, keywordNearMisses) {
+  // Identifiers that share a length, first and last character with some
+  // keyword must not be mistaken for it.
+  std::vector<tok> Kinds;
+  lexAll("cless fur iF nEw dx classes continues _if $in", Kinds);
+  for (unsigned i = 0, e = Kinds.size() - 2; i != e; ++i)
+    EXPECT_EQ(tok::identifier, Kinds[i]);
+  EXPECT_EQ(tok::dollarident, Kinds[Kinds.size() - 2]);
+  EXPECT_EQ(tok::eof, Kinds.back());
+}
+
+TEST(LexerTest, longRuns) {
+  // Runs long enough to exercise the vectorized scanners, including ones
+  // that end right at the buffer boundary.
+  std::vector<tok> Kinds;
+  lexAll("                                                              "
+         "a_very_long_identifier_name_that_spans_several_vectors$0123456789 "
+         "// a line comment that also spans more than a couple of vectors\n"
+         "/* a block /* nested */ comment with * and / sprinkled about  */"
+         "\"a string literal body with enough text to need vector loads\" "
+         "x                                                               ",
+         Kinds);
+
+  tok Expected[] = {
+    tok::identifier, tok::string_literal, tok::identifier, tok::eof
+  };
+  ASSERT_EQ(sizeof(Expected) / sizeof(Expected[0]), Kinds.size());
+  for (unsigned i = 0, e = Kinds.size(); i != e; ++i)
+    EXPECT_EQ(Expected[i], Kinds[i]);
+}
+
+/// Recursively collect the .swift files under the given directory.
+static void collectSwiftSources(StringRef Dir,
+                  std::vector<llvm::MemoryBuffer *> &Buffers) {
+  llvm::error_code EC;
+  for (llvm::sys::fs::directory_iterator I(Dir, EC), E; I != E && !EC;
+       I.increment(EC)) {
+    StringRef Path = I->path();
+    bool IsDirectory = false;
+    if (!llvm::sys::fs::is_directory(Path, IsDirectory) && IsDirectory) {
+      collectSwiftSources(Path, Buffers);
+      continue;
+    }
+    if (llvm::sys::path::extension(Path) != ".swift")
+      continue;
+
+    llvm::OwningPtr<llvm::MemoryBuffer> Buffer;
+    if (!llvm::MemoryBuffer::getFile(Path, Buffer))
+      Buffers.push_back(Buffer.take());
+  }
+}
+
+TEST(LexerTest, stdlibThroughput) {
+  std::vector<llvm::MemoryBuffer *> Buffers;
+  collectSwiftSources(SWIFT_STDLIB_SOURCE_DIR, Buffers);
+  ASSERT_FALSE(Buffers.empty());
+
+  const unsigned Iterations = 200;
+  size_t TotalBytes = 0, TotalTokens = 0;
+  llvm::SourceMgr SM;
+
+  llvm::TimeRecord Start = llvm::TimeRecord::getCurrentTime(true);
+  for (unsigned Iter = 0; Iter != Iterations; ++Iter) {
+    for (auto *Buffer : Buffers) {
+      Lexer L(Buffer->getBuffer(), SM, nullptr);
+      Token Tok;
+      do {
+        L.lex(Tok);
+        ++TotalTokens;
+      } while (Tok.isNot(tok::eof));
+      TotalBytes += Buffer->getBufferSize();
+    }
+  }
+  llvm::TimeRecord Elapsed = llvm::TimeRecord::getCurrentTime(false);
+  Elapsed -= Start;
+
+  double Seconds = Elapsed.getWallTime();
+  llvm::outs() << "Lexed " << TotalBytes << " bytes (" << TotalTokens
+               << " tokens) of stdlib source in " << Seconds << "s";
+  if (Seconds > 0)
+    llvm::outs() << ", " << (TotalBytes / Seconds) / (1024 * 1024) << " MB/s";
+  llvm::outs() << "\n";
+
+  for (auto *Buffer : Buffers)
+    delete Buffer;
+}
@@ -0,0 +1,106 @@
+//===- swift/unittests/Parse/TokenCacheTest.cpp - TokenCache tests --------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Parse/TokenCache.h"
+#include "swift/Parse/Lexer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace swift;
+
+TEST(TokenCacheTest, matchesLexer) {
+  StringRef Text = "func f(x : Int) -> Int { return x+1 } // done\n";
+  llvm::SourceMgr SM;
+  TokenCache Toks(Text, SM, nullptr);
+  Lexer L(Text, SM, nullptr);
+
+  Token Expected;
+  unsigned Index = 0;
+  do {
+    L.lex(Expected);
+    Token Cached = Toks.getToken(Index++);
+    EXPECT_EQ(Expected.getKind(), Cached.getKind());
+    EXPECT_EQ(Expected.getText().data(), Cached.getText().data());
+    EXPECT_EQ(Expected.getLength(), Cached.getLength());
+  } while (Expected.isNot(tok::eof));
+
+  // Asking again, or past the end, does not lex anything new.
+  EXPECT_EQ(tok::kw_func, Toks.getToken(0).getKind());
+  EXPECT_EQ(tok::eof, Toks.getToken(Index + 10).getKind());
+}
+
+TEST(TokenCacheTest, seeking) {
+  StringRef Text = "var abc = 42 /* xyz */ foo\n";
+  llvm::SourceMgr SM;
+  TokenCache Toks(Text, SM, nullptr);
+
+  // Token starts and token ends are both positions in the cached stream.
+  EXPECT_EQ(0U, Toks.getIndexForOffset(0));
+  EXPECT_EQ(tok::identifier, Toks.getToken(1).getKind());
+  EXPECT_EQ(1U, Toks.getIndexForOffset(Text.find("abc")));
+  EXPECT_EQ(2U, Toks.getIndexForOffset(Text.find("abc") + 3));
+
+  // Starting inside a comment has to relex: "xyz" becomes an identifier.
+  unsigned Index = Toks.getIndexForOffset(Text.find("xyz"));
+  Token Tok = Toks.getToken(Index);
+  EXPECT_EQ(tok::identifier, Tok.getKind());
+  EXPECT_EQ("xyz", Tok.getText());
+
+  // Going back to the beginning relexes from there.
+  Index = Toks.getIndexForOffset(0);
+  EXPECT_EQ(tok::kw_var, Toks.getToken(Index).getKind());
+}
+
+TEST(TokenCacheTest, growingBuffer) {
+  // Simulate the REPL, which appends lines to a fixed-size buffer.
+  std::string Storage(64, '\0');
+  StringRef Text(Storage.data(), Storage.size() - 1);
+  llvm::SourceMgr SM;
+  TokenCache Toks(Text, SM, nullptr);
+
+  Storage.replace(0, 4, "foo\n");
+  Toks.setEndOffset(4);
+  EXPECT_EQ(tok::identifier, Toks.getToken(0).getKind());
+  EXPECT_EQ(tok::eof, Toks.getToken(1).getKind());
+
+  Storage.replace(4, 6, "(bar)\n");
+  Toks.setEndOffset(10);
+  unsigned Index = Toks.getIndexForOffset(4);
+  EXPECT_EQ(1U, Index);
+  EXPECT_EQ(tok::l_paren_space, Toks.getToken(Index).getKind());
+  EXPECT_EQ("bar", Toks.getToken(Index + 1).getText());
+  EXPECT_EQ(tok::eof, Toks.getToken(Index + 3).getKind());
+
+  // Token kinds can be answered from the cache.
+  EXPECT_EQ(tok::identifier, Toks.getTokenKind(Text.substr(5, 3)));
+
+  // So can token ends.
+  EXPECT_EQ(Lexer::getSourceLoc(Text.data() + 8),
+            Toks.getLocForEndOfToken(Lexer::getSourceLoc(Text.data() + 5)));
+}
+
+TEST(TokenCacheTest, splitOperators) {
+  StringRef Text = "a >= b\nc >>d\n";
+  llvm::SourceMgr SM;
+  TokenCache Toks(Text, SM, nullptr);
+
+  // Whole operators come straight from the cache.
+  EXPECT_EQ(tok::oper_binary, Toks.getTokenKind(Text.substr(2, 2)));
+  EXPECT_EQ(tok::oper_prefix, Toks.getTokenKind(Text.substr(9, 2)));
+
+  // The parser splits '>' off the front of operators when closing generic
+  // argument lists; both halves are classified without lexing them.
+  EXPECT_EQ(tok::oper_prefix, Toks.getTokenKind(Text.substr(2, 1)));
+  EXPECT_EQ(tok::equal, Toks.getTokenKind(Text.substr(3, 1)));
+  EXPECT_EQ(tok::oper_binary, Toks.getTokenKind(Text.substr(10, 1)));
+}
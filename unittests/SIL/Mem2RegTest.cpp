@@ -0,0 +1,250 @@
+//===- swift/unittests/SIL/Mem2RegTest.cpp - SIL memory promotion ---------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/SILPassManager.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  class Mem2RegTest : public unittest::FrontendTest {
+  protected:
+    /// Lower the given source, which must declare exactly one function with
+    /// a body, to SIL.
+    Function *emitFunction(StringRef Source) {
+      std::vector<Function*> Emitted = emitSIL(Source);
+      EXPECT_EQ(1U, Emitted.size());
+      return Emitted.back();
+    }
+
+    static std::map<ValueKind, unsigned> countInstructions(Function &F) {
+      std::map<ValueKind, unsigned> Counts;
+      for (BasicBlock &BB : F)
+        for (Instruction &I : BB)
+          ++Counts[I.getKind()];
+      return Counts;
+    }
+
+    static std::map<BasicBlock*, unsigned> countBlockArgs(Function &F) {
+      std::map<BasicBlock*, unsigned> Counts;
+      for (BasicBlock &BB : F)
+        Counts[&BB] = BB.bbarg_end() - BB.bbarg_begin();
+      return Counts;
+    }
+
+    static std::vector<BasicBlock*> getPreds(BasicBlock *BB) {
+      return std::vector<BasicBlock*>(BB->pred_begin(), BB->pred_end());
+    }
+
+    /// Run mem2reg over the function, verifying the result.
+    static void promote(Function &F) {
+      SILPassManager::Options Opts;
+      Opts.VerifyAfterEachPass = true;
+      SILPassManager PM(Opts);
+      PM.add(createSILMem2RegPass());
+      EXPECT_TRUE(PM.run(F));
+    }
+  };
+}
+
+TEST_F(Mem2RegTest, StraightLine) {
+  Function *F = emitFunction(
+    "struct S {}\n"
+    "func f(a : S, b : S) -> S {\n"
+    "  var x = a\n"
+    "  x = b\n"
+    "  return x\n"
+    "}\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  auto Before = countInstructions(*F);
+  EXPECT_EQ(3U, Before[ValueKind::AllocVarInst]);
+  EXPECT_EQ(0U, Before[ValueKind::RetainInst]);
+  EXPECT_EQ(0U, Before[ValueKind::ReleaseInst]);
+  unsigned NumCopies = 0;
+  for (BasicBlock &BB : *F)
+    for (Instruction &I : BB)
+      if (LoadInst *LI = dyn_cast<LoadInst>(&I))
+        NumCopies += !LI->isTake();
+  EXPECT_LT(0U, NumCopies);
+
+  SILPassManager::Options Opts;
+  Opts.VerifyAfterEachPass = true;
+  SILPassManager PM(Opts);
+  PM.add(createSILMem2RegPass());
+  EXPECT_TRUE(PM.run(*F));
+
+  auto After = countInstructions(*F);
+  EXPECT_EQ(0U, After[ValueKind::AllocVarInst]);
+  EXPECT_EQ(0U, After[ValueKind::LoadInst]);
+  EXPECT_EQ(0U, After[ValueKind::StoreInst]);
+  EXPECT_EQ(0U, After[ValueKind::DestroyInst]);
+  EXPECT_EQ(0U, After[ValueKind::DeallocInst]);
+
+  // Each copy retains, each destroy releases, and so does the reassignment.
+  // Retains released again right away cancel out, so there are fewer of
+  // both, but they still balance.
+  unsigned NumRetains = After[ValueKind::RetainInst];
+  unsigned NumReleases = After[ValueKind::ReleaseInst];
+  EXPECT_EQ(Before[ValueKind::DestroyInst] + 1 + NumRetains,
+            NumReleases + NumCopies);
+  EXPECT_LT(NumRetains, NumCopies);
+
+  // The straight-line code needs no block arguments beyond the parameters.
+  for (BasicBlock &BB : *F)
+    if (&BB != &*F->begin())
+      EXPECT_TRUE(BB.bbarg_empty());
+
+  // Nothing is left to promote.
+  EXPECT_FALSE(PM.run(*F));
+}
+
+TEST_F(Mem2RegTest, Dominance) {
+  Function *F = emitFunction(
+    "struct S {}\n"
+    "func f(a : S) -> S {\n"
+    "  var x = a\n"
+    "  return x\n"
+    "}\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  DominanceInfo DT(*F);
+  BasicBlock *Entry = &*F->begin();
+  EXPECT_TRUE(DT.isReachable(Entry));
+  EXPECT_FALSE(DT.getIDom(Entry));
+  EXPECT_EQ(0U, DT.getRPONumber(Entry));
+  EXPECT_TRUE(DT.getDominanceFrontier(Entry).empty());
+  for (BasicBlock &BB : *F) {
+    if (!DT.isReachable(&BB))
+      continue;
+    EXPECT_TRUE(DT.dominates(Entry, &BB));
+    EXPECT_FALSE(DT.properlyDominates(&BB, &BB));
+  }
+}
+
+TEST_F(Mem2RegTest, Diamond) {
+  Function *F = emitFunction(
+    "import Builtin\n"
+    "struct S {}\n"
+    "func f(c : Builtin.Int1, a : S, b : S) -> S {\n"
+    "  var x = a\n"
+    "  if c {\n"
+    "    x = b\n"
+    "  }\n"
+    "  return x\n"
+    "}\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // The 'if' has no else, so the false edge goes straight to the join.
+  BasicBlock *Entry = &*F->begin();
+  CondBranchInst *CBI = dyn_cast<CondBranchInst>(Entry->getTerminator());
+  ASSERT_TRUE(CBI);
+  BasicBlock *Then = CBI->getTrueBB();
+  BasicBlock *Join = CBI->getFalseBB();
+  ASSERT_EQ(Join, cast<BranchInst>(Then->getTerminator())->getDestBB());
+
+  {
+    DominanceInfo DT(*F);
+    EXPECT_EQ(Entry, DT.getIDom(Then));
+    EXPECT_EQ(Entry, DT.getIDom(Join));
+    EXPECT_FALSE(DT.dominates(Then, Join));
+    ASSERT_EQ(1U, DT.getDominanceFrontier(Then).size());
+    EXPECT_EQ(Join, DT.getDominanceFrontier(Then)[0]);
+    EXPECT_TRUE(DT.getDominanceFrontier(Join).empty());
+  }
+
+  auto ArgsBefore = countBlockArgs(*F);
+  size_t NumBlocksBefore = F->getBlocks().size();
+  promote(*F);
+  EXPECT_EQ(0U, countInstructions(*F)[ValueKind::AllocVarInst]);
+
+  // The join is the only block that needs the value of 'x'.
+  for (auto &Args : countBlockArgs(*F))
+    EXPECT_EQ(ArgsBefore[Args.first] + (Args.first == Join), Args.second);
+
+  // The conditional edge into the join is split, so the join is reached
+  // only by branches that pass the value along.
+  EXPECT_EQ(NumBlocksBefore + 1, F->getBlocks().size());
+  EXPECT_EQ(Then, CBI->getTrueBB());
+  BasicBlock *Edge = CBI->getFalseBB();
+  EXPECT_NE(Join, Edge);
+  std::vector<BasicBlock*> Preds = getPreds(Join);
+  ASSERT_EQ(2U, Preds.size());
+  for (BasicBlock *Pred : Preds) {
+    EXPECT_TRUE(Pred == Then || Pred == Edge);
+    BranchInst *BI = cast<BranchInst>(Pred->getTerminator());
+    EXPECT_EQ(ArgsBefore[Join] + 1, BI->getArgs().size());
+  }
+
+  DominanceInfo DT(*F);
+  EXPECT_EQ(Entry, DT.getIDom(Edge));
+  EXPECT_EQ(Entry, DT.getIDom(Join));
+}
+
+TEST_F(Mem2RegTest, Loop) {
+  Function *F = emitFunction(
+    "import Builtin\n"
+    "struct S {}\n"
+    "func f(c : Builtin.Int1, a : S, b : S) -> S {\n"
+    "  var x = a\n"
+    "  while c {\n"
+    "    x = b\n"
+    "  }\n"
+    "  return x\n"
+    "}\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // The entry block falls into the loop header, which branches to the body
+  // or out of the loop; the body branches back.
+  BasicBlock *Entry = &*F->begin();
+  BasicBlock *Header = cast<BranchInst>(Entry->getTerminator())->getDestBB();
+  CondBranchInst *CBI = cast<CondBranchInst>(Header->getTerminator());
+  BasicBlock *Body = CBI->getTrueBB();
+  BasicBlock *Exit = CBI->getFalseBB();
+  ASSERT_EQ(Header, cast<BranchInst>(Body->getTerminator())->getDestBB());
+
+  {
+    DominanceInfo DT(*F);
+    EXPECT_EQ(Entry, DT.getIDom(Header));
+    EXPECT_EQ(Header, DT.getIDom(Body));
+    EXPECT_EQ(Header, DT.getIDom(Exit));
+    EXPECT_LT(DT.getRPONumber(Header), DT.getRPONumber(Body));
+    ASSERT_EQ(1U, DT.getDominanceFrontier(Body).size());
+    EXPECT_EQ(Header, DT.getDominanceFrontier(Body)[0]);
+    // The back edge puts the header in its own frontier.
+    ASSERT_EQ(1U, DT.getDominanceFrontier(Header).size());
+    EXPECT_EQ(Header, DT.getDominanceFrontier(Header)[0]);
+  }
+
+  auto ArgsBefore = countBlockArgs(*F);
+  size_t NumBlocksBefore = F->getBlocks().size();
+  promote(*F);
+  EXPECT_EQ(0U, countInstructions(*F)[ValueKind::AllocVarInst]);
+
+  // The header is the only block that needs the value of 'x'.  Both edges
+  // into it are unconditional, so none are split.
+  for (auto &Args : countBlockArgs(*F))
+    EXPECT_EQ(ArgsBefore[Args.first] + (Args.first == Header), Args.second);
+  EXPECT_EQ(NumBlocksBefore, F->getBlocks().size());
+
+  // The entry passes 'a' in, and the body passes 'b' around the loop.
+  BranchInst *EntryBr = cast<BranchInst>(Entry->getTerminator());
+  BranchInst *BackBr = cast<BranchInst>(Body->getTerminator());
+  unsigned ArgNo = ArgsBefore[Header];
+  ASSERT_EQ(ArgNo + 1, EntryBr->getArgs().size());
+  ASSERT_EQ(ArgNo + 1, BackBr->getArgs().size());
+  EXPECT_NE(EntryBr->getArgs()[ArgNo], BackBr->getArgs()[ArgNo]);
+}
@@ -0,0 +1,92 @@
+//===- swift/unittests/SIL/SILModuleTest.cpp - Whole-module SILGen --------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace swift;
+
+namespace {
+  class SILModuleTest : public unittest::FrontendTest {
+  protected:
+    static std::string print(const SILModule &M) {
+      std::string Text;
+      llvm::raw_string_ostream OS(Text);
+      M.print(OS);
+      return OS.str();
+    }
+  };
+}
+
+TEST_F(SILModuleTest, Functions) {
+  TranslationUnit *TU = check(
+    "struct S {}\n"
+    "var global : S\n"
+    "func f(a : S) -> S { return a }\n"
+    "func g(a : S) -> S { var x = f(a); return x }\n"
+    "func h(a : S) -> S\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  llvm::OwningPtr<SILModule> M(SILModule::constructSIL(TU, 0, 1));
+  M->verify();
+
+  // Functions without bodies have no SIL.
+  unsigned NumFunctions = 0;
+  for (auto &Entry : *M) {
+    EXPECT_EQ(Entry.second, M->getFunction(Entry.first));
+    ++NumFunctions;
+  }
+  EXPECT_EQ(2U, NumFunctions);
+
+  // The initializer of the global is part of the top-level code.
+  ASSERT_TRUE(M->getTopLevelCode() != nullptr);
+  bool SawAllocVar = false;
+  for (BasicBlock &BB : *M->getTopLevelCode())
+    for (Instruction &I : BB)
+      SawAllocVar |= isa<AllocVarInst>(&I);
+  EXPECT_TRUE(SawAllocVar);
+
+  std::string Text = print(*M);
+  EXPECT_LT(Text.find("func_decl f"), Text.find("func_decl g"));
+  EXPECT_NE(std::string::npos, Text.find("top_level_code"));
+}
+
+TEST_F(SILModuleTest, ParallelMatchesSerial) {
+  // Each function works on a type of its own, so the threads build new
+  // types in the context at the same time rather than finding them there.
+  std::string Source;
+  llvm::raw_string_ostream OS(Source);
+  for (unsigned i = 0; i != 64; ++i)
+    OS << "struct S" << i << " {}\n"
+       << "func f" << i << "(a : S" << i << ", b : S" << i << ")"
+       << " -> (S" << i << ", S" << i << ") {\n"
+       << "  var x = a\n"
+       << "  x = b\n"
+       << "  return (x, a)\n"
+       << "}\n";
+  OS.flush();
+
+  TranslationUnit *TU = check(Source);
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // Emit in parallel first, while the types SILGen needs are still missing
+  // from the context; the serial run then finds them all uniqued.
+  llvm::OwningPtr<SILModule> Parallel(SILModule::constructSIL(TU, 0, 4));
+  Parallel->verify();
+  EXPECT_FALSE(Parallel->getTopLevelCode());
+  llvm::OwningPtr<SILModule> Serial(SILModule::constructSIL(TU, 0, 1));
+  EXPECT_EQ(print(*Serial), print(*Parallel));
+}
@@ -0,0 +1,93 @@
+//===- swift/unittests/SIL/SILPassManagerTest.cpp - SIL pass manager ------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "swift/SIL/SILPassManager.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  /// Records the order in which passes ran, and counts the calls it sees.
+  class CountCallsPass : public SILFunctionPass {
+    std::vector<std::string> &Log;
+  public:
+    unsigned NumCalls = 0;
+
+    explicit CountCallsPass(std::vector<std::string> &Log)
+      : SILFunctionPass("count-calls"), Log(Log) {}
+
+    virtual bool runOnFunction(Function &F) {
+      Log.push_back(getName());
+      for (BasicBlock &BB : F)
+        for (Instruction &I : BB)
+          if (ApplyInst *AI = dyn_cast<ApplyInst>(&I)) {
+            ++NumCalls;
+            // SILGen should have linked the call into its callee's uses.
+            EXPECT_FALSE(AI->getCallee()->use_empty());
+          }
+      return false;
+    }
+  };
+
+  /// Claims to change every function it is run over.
+  class TouchPass : public SILFunctionPass {
+    std::vector<std::string> &Log;
+  public:
+    explicit TouchPass(std::vector<std::string> &Log)
+      : SILFunctionPass("touch"), Log(Log) {}
+
+    virtual bool runOnFunction(Function &F) {
+      Log.push_back(getName());
+      return true;
+    }
+  };
+
+  class SILPassManagerTest : public unittest::FrontendTest {};
+}
+
+TEST_F(SILPassManagerTest, RunsPipeline) {
+  std::vector<Function*> Functions = emitSIL(
+    "func f() {}\n"
+    "func g() { f(); g() }\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+  ASSERT_EQ(2U, Functions.size());
+
+  std::vector<std::string> Log;
+  SILPassManager::Options Opts;
+  Opts.VerifyAfterEachPass = true;
+  SILPassManager PM(Opts);
+  CountCallsPass *Counter = new CountCallsPass(Log);
+  PM.add(Counter);
+  PM.add(new TouchPass(Log));
+
+  EXPECT_TRUE(PM.run(*Functions[0]));
+  EXPECT_TRUE(PM.run(*Functions[1]));
+  EXPECT_EQ(2U, Counter->NumCalls);
+
+  // Each function goes through the whole pipeline in order.
+  ASSERT_EQ(4U, Log.size());
+  EXPECT_EQ("count-calls", Log[0]);
+  EXPECT_EQ("touch", Log[1]);
+  EXPECT_EQ("count-calls", Log[2]);
+  EXPECT_EQ("touch", Log[3]);
+
+  std::string Stats;
+  llvm::raw_string_ostream OS(Stats);
+  PM.printStatistics(OS);
+  OS.flush();
+  EXPECT_NE(std::string::npos, Stats.find("      2        0  count-calls"));
+  EXPECT_NE(std::string::npos, Stats.find("      2        2  touch"));
+}
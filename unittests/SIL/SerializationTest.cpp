@@ -0,0 +1,194 @@
+//===- swift/unittests/SIL/SerializationTest.cpp - Binary SIL format ------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Common/FrontendTest.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILPassManager.h"
+#include "swift/SIL/SILSerialization.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+  class SerializationTest : public unittest::FrontendTest {
+  protected:
+    SILSerializationTable Table;
+
+    /// Serialize all the functions emitted so far.
+    std::string writeFunctions() {
+      std::vector<const Function*> ToWrite(Functions.begin(),
+                                           Functions.end());
+      std::string Bytes;
+      llvm::raw_string_ostream OS(Bytes);
+      writeSIL(ToWrite, Table, OS);
+      OS.flush();
+      return Bytes;
+    }
+
+    SILReader *createReader(StringRef Bytes) {
+      return new SILReader(
+          llvm::MemoryBuffer::getMemBufferCopy(Bytes, "test.sib"),
+          Context, Table);
+    }
+
+    static std::string print(const Function &F) {
+      std::string Text;
+      llvm::raw_string_ostream OS(Text);
+      F.print(OS);
+      return OS.str();
+    }
+
+    /// Serialize all the functions emitted so far, and check that each reads
+    /// back the same.
+    void expectRoundTrip() {
+      llvm::OwningPtr<SILReader> Reader(createReader(writeFunctions()));
+      ASSERT_FALSE(Reader->isMalformed());
+      ASSERT_EQ(Functions.size(), Reader->getNumFunctions());
+      for (unsigned i = 0, e = Functions.size(); i != e; ++i) {
+        llvm::OwningPtr<Function> F(Reader->readFunction(i));
+        ASSERT_TRUE(F.get() != nullptr);
+        F->verify();
+        EXPECT_EQ(print(*Functions[i]), print(*F));
+      }
+    }
+  };
+}
+
+static const char *const Source =
+  "struct S {}\n"
+  "func f(a : S, b : S) -> S {\n"
+  "  var x = a\n"
+  "  x = b\n"
+  "  return x\n"
+  "}\n"
+  "func g(a : S) -> (S, S) {\n"
+  "  return (f(a, a), a)\n"
+  "}\n";
+
+TEST_F(SerializationTest, RoundTrip) {
+  emitSIL(Source);
+  ASSERT_EQ(0U, Consumer.NumErrors);
+  ASSERT_EQ(2U, Functions.size());
+
+  llvm::OwningPtr<SILReader> Reader(createReader(writeFunctions()));
+  ASSERT_FALSE(Reader->isMalformed());
+  ASSERT_EQ(2U, Reader->getNumFunctions());
+
+  for (unsigned i = 0; i != 2; ++i) {
+    llvm::OwningPtr<Function> F(Reader->readFunction(i));
+    ASSERT_TRUE(F.get() != nullptr);
+    F->verify();
+    EXPECT_EQ(print(*Functions[i]), print(*F));
+  }
+}
+
+TEST_F(SerializationTest, RoundTripAfterMem2Reg) {
+  emitSIL(Source);
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  SILPassManager PM;
+  PM.add(createSILMem2RegPass());
+  for (Function *F : Functions)
+    PM.run(*F);
+
+  llvm::OwningPtr<SILReader> Reader(createReader(writeFunctions()));
+  ASSERT_FALSE(Reader->isMalformed());
+
+  // Functions can be read in any order.
+  llvm::OwningPtr<Function> G(Reader->readFunction(1));
+  llvm::OwningPtr<Function> F(Reader->readFunction(0));
+  ASSERT_TRUE(F.get() && G.get());
+  EXPECT_EQ(print(*Functions[0]), print(*F));
+  EXPECT_EQ(print(*Functions[1]), print(*G));
+}
+
+TEST_F(SerializationTest, RoundTripControlFlow) {
+  emitSIL("import Builtin\n"
+          "struct S {}\n"
+          "func f(c : Builtin.Int1, a : S, b : S) -> S {\n"
+          "  var x = a\n"
+          "  if c {\n"
+          "    x = b\n"
+          "  }\n"
+          "  while c {\n"
+          "    x = a\n"
+          "  }\n"
+          "  return x\n"
+          "}\n");
+  ASSERT_EQ(0U, Consumer.NumErrors);
+  ASSERT_EQ(1U, Functions.size());
+  Function &F = *Functions[0];
+
+  // Conditional branches and back edges, straight from SILGen.
+  expectRoundTrip();
+
+  // After promotion, the join and the loop header take the value of 'x' as
+  // a block argument, and branches pass it.
+  SILPassManager PM;
+  PM.add(createSILMem2RegPass());
+  ASSERT_TRUE(PM.run(F));
+  unsigned NumCondBranches = 0, NumBlocksWithArgs = 0;
+  for (BasicBlock &BB : F) {
+    if (&BB != &*F.begin() && !BB.bbarg_empty())
+      ++NumBlocksWithArgs;
+    NumCondBranches += isa<CondBranchInst>(BB.getTerminator());
+  }
+  ASSERT_EQ(2U, NumCondBranches);
+  ASSERT_EQ(2U, NumBlocksWithArgs);
+  expectRoundTrip();
+}
+
+TEST_F(SerializationTest, ForwardRef) {
+  emitSIL(Source);
+  ASSERT_EQ(0U, Consumer.NumErrors);
+
+  // SILGen never leaves unreachable code, so add some by hand: a block that
+  // uses a value defined in the block after it.  Unreachable blocks are
+  // written in function order, so the use comes first in the stream.
+  Function &F = *Functions[0];
+  BasicBlock *UseBB = new (F) BasicBlock(&F);
+  BasicBlock *DefBB = new (F) BasicBlock(&F);
+  SILBuilder DefB(DefBB, F);
+  Value *V = DefB.createIntegerValueInst(42,
+                                         BuiltinIntegerType::get(64, Context));
+  DefB.createUnreachable();
+  SILBuilder UseB(UseBB, F);
+  UseB.createRelease(nullptr, V);
+  UseB.createBranch(DefBB);
+  F.verify();
+
+  expectRoundTrip();
+}
+
+TEST_F(SerializationTest, Malformed) {
+  emitSIL(Source);
+  ASSERT_EQ(0U, Consumer.NumErrors);
+  std::string Bytes = writeFunctions();
+
+  // A truncated stream is rejected up front.
+  llvm::OwningPtr<SILReader> Truncated(
+    createReader(StringRef(Bytes).drop_back(4)));
+  EXPECT_TRUE(Truncated->isMalformed());
+  EXPECT_EQ(0U, Truncated->getNumFunctions());
+
+  // So is a stream that is not SIL at all.
+  std::string Garbage = Bytes;
+  Garbage[0] = 'X';
+  llvm::OwningPtr<SILReader> WrongSignature(createReader(Garbage));
+  EXPECT_TRUE(WrongSignature->isMalformed());
+
+  llvm::OwningPtr<SILReader> Empty(createReader(""));
+  EXPECT_TRUE(Empty->isMalformed());
+}
@@ -0,0 +1,114 @@
+//===- swift/unittests/SIL/UseListTest.cpp - SIL def-use chains -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/AST/ASTContext.h"
+#include "swift/AST/Diagnostics.h"
+#include "swift/AST/Types.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/SIL/Instruction.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace swift;
+
+namespace {
+  /// Ignores all diagnostics.
+  class NullConsumer : public DiagnosticConsumer {
+  public:
+    virtual void handleDiagnostic(llvm::SourceMgr &SM, SourceLoc Loc,
+                                  DiagnosticKind Kind, llvm::StringRef Text,
+                                  const DiagnosticInfo &Info) {}
+  };
+
+  /// Values are declared before the instructions that use them, so that the
+  /// users are destroyed (and unlink their operands) first.
+  class UseListTest : public ::testing::Test {
+  protected:
+    llvm::SourceMgr SM;
+    NullConsumer Consumer;
+    DiagnosticEngine Diags;
+    LangOptions LangOpts;
+    ASTContext Context;
+    Type Int64Ty;
+
+    UseListTest()
+      : Diags(SM, Consumer), Context(LangOpts, SM, Diags),
+        Int64Ty(BuiltinIntegerType::get(64, Context)) {}
+
+    static unsigned countUses(const Value *V) {
+      unsigned NumUses = 0;
+      for (auto UI = V->use_begin(), E = V->use_end(); UI != E; ++UI)
+        ++NumUses;
+      return NumUses;
+    }
+  };
+}
+
+TEST_F(UseListTest, Operands) {
+  IntegerValueInst A(1, Int64Ty);
+  IntegerValueInst B(2, Int64Ty);
+  EXPECT_TRUE(A.use_empty());
+  EXPECT_EQ(0U, A.getNumOperands());
+
+  TypeConversionInst Conv(Int64Ty, &A);
+  ASSERT_EQ(1U, Conv.getNumOperands());
+  EXPECT_EQ(&A, Conv.getOperand());
+  EXPECT_TRUE(A.hasOneUse());
+  EXPECT_EQ(&Conv, A.use_begin().getUser());
+  EXPECT_EQ(0U, (*A.use_begin())->getOperandNumber());
+
+  RetainInst Retain(nullptr, &A);
+  EXPECT_FALSE(A.hasOneUse());
+  EXPECT_EQ(2U, countUses(&A));
+
+  // Users are found through the use list.
+  bool SawConv = false, SawRetain = false;
+  for (auto UI = A.use_begin(), E = A.use_end(); UI != E; ++UI) {
+    SawConv |= UI.getUser() == &Conv;
+    SawRetain |= UI.getUser() == &Retain;
+  }
+  EXPECT_TRUE(SawConv);
+  EXPECT_TRUE(SawRetain);
+
+  // Changing an operand moves it between use lists.
+  Retain.setOperand(0, &B);
+  EXPECT_TRUE(A.hasOneUse());
+  EXPECT_TRUE(B.hasOneUse());
+  EXPECT_EQ(&B, Retain.getOperand());
+
+  Conv.dropAllReferences();
+  EXPECT_TRUE(A.use_empty());
+  EXPECT_FALSE(Conv.getAllOperands()[0].get());
+}
+
+TEST_F(UseListTest, ReplaceAllUsesWith) {
+  IntegerValueInst A(1, Int64Ty);
+  IntegerValueInst B(2, Int64Ty);
+
+  TypeConversionInst Conv(Int64Ty, &A);
+  RetainInst Retain(nullptr, &A);
+  ReleaseInst Release(nullptr, &B);
+
+  A.replaceAllUsesWith(&B);
+  EXPECT_TRUE(A.use_empty());
+  EXPECT_EQ(3U, countUses(&B));
+  EXPECT_EQ(&B, Conv.getOperand());
+  EXPECT_EQ(&B, Retain.getOperand());
+  EXPECT_EQ(&B, Release.getOperand());
+
+  // Unlinking from the middle of a use list leaves the rest intact.
+  Retain.dropAllReferences();
+  EXPECT_EQ(2U, countUses(&B));
+  Conv.dropAllReferences();
+  Release.dropAllReferences();
+  EXPECT_TRUE(B.use_empty());
+}
@@ -0,0 +1,120 @@
+//===- swift/unittests/runtime/Benchmark.cpp - Benchmark harness tests ----===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Benchmark.h"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace swift;
+
+/// Run a benchmark of the given body with quick settings, and return it
+/// without printing it.
+template <typename Fn>
+static Benchmark *runBenchmark(const std::string &name, Fn body,
+                               int64_t &totalIterations) {
+  setenv("SWIFT_BENCHMARK_SAMPLES", "5", 1);
+  setenv("SWIFT_BENCHMARK_SAMPLE_TIME", "0.001", 1);
+  setenv("SWIFT_BENCHMARK_WARMUP_TIME", "0.002", 1);
+  Benchmark *benchmark = swift_benchmark_begin(name.data(), name.size());
+  totalIterations = 0;
+  while (int64_t n = swift_benchmark_nextBatch(benchmark)) {
+    for (int64_t i = 0; i != n; ++i)
+      body();
+    totalIterations += n;
+  }
+  unsetenv("SWIFT_BENCHMARK_SAMPLES");
+  unsetenv("SWIFT_BENCHMARK_SAMPLE_TIME");
+  unsetenv("SWIFT_BENCHMARK_WARMUP_TIME");
+  return benchmark;
+}
+
+TEST(BenchmarkTest, statistics) {
+  SampleStatistics stats = computeSampleStatistics({ 3, 1, 2 });
+  EXPECT_EQ(2, stats.Median);
+  EXPECT_EQ(1, stats.MAD);
+  EXPECT_EQ(1, stats.Min);
+  EXPECT_EQ(3, stats.Max);
+
+  // One outlier moves neither the median nor the MAD much.
+  stats = computeSampleStatistics({ 10, 11, 9, 10, 1000 });
+  EXPECT_EQ(10, stats.Median);
+  EXPECT_EQ(1, stats.MAD);
+  EXPECT_EQ(1000, stats.Max);
+
+  stats = computeSampleStatistics({ 4, 1, 2, 3 });
+  EXPECT_EQ(2.5, stats.Median);
+  EXPECT_EQ(1, stats.MAD);
+
+  stats = computeSampleStatistics({ 7 });
+  EXPECT_EQ(7, stats.Median);
+  EXPECT_EQ(0, stats.MAD);
+}
+
+TEST(BenchmarkTest, batches) {
+  volatile unsigned counter = 0;
+  int64_t total;
+  Benchmark *benchmark = runBenchmark("count", [&] {
+    for (unsigned i = 0; i != 100; ++i)
+      counter = counter + 1;
+  }, total);
+
+  EXPECT_EQ(5u, benchmark->Seconds.size());
+  EXPECT_EQ(Benchmark::Phase::Done, benchmark->CurrentPhase);
+
+  // The batches grew past one iteration, and every one was run.
+  EXPECT_GT(benchmark->BatchSize, 1);
+  EXPECT_EQ(uint64_t(total) * 100, counter);
+  EXPECT_GE(total, 5 * benchmark->BatchSize);
+  for (double seconds : benchmark->Seconds)
+    EXPECT_GT(seconds, 0);
+
+  // Counters are optional, but there's one sample per batch if they work.
+  if (benchmark->CyclesFD >= 0) {
+    EXPECT_EQ(5u, benchmark->Cycles.size());
+  }
+  swift_benchmark_end(benchmark);
+}
+
+TEST(BenchmarkTest, slowBody) {
+  // A body slower than the sample time is measured one call at a time.
+  int64_t total;
+  Benchmark *benchmark = runBenchmark("sleep", [] { usleep(2000); }, total);
+  EXPECT_EQ(1, benchmark->BatchSize);
+  EXPECT_EQ(5u, benchmark->Seconds.size());
+  EXPECT_GE(computeSampleStatistics(benchmark->Seconds).Median, 0.002);
+  swift_benchmark_end(benchmark);
+}
+
+TEST(BenchmarkTest, json) {
+  std::string name = "quote\" backslash\\ tab\t";
+  Benchmark *benchmark = swift_benchmark_begin(name.data(), name.size());
+  benchmark->BatchSize = 1000;
+  benchmark->Seconds = { 1e-6, 2e-6, 3e-6 };
+  EXPECT_EQ("{\"name\": \"quote\\\" backslash\\\\ tab\\u0009\", "
+            "\"samples\": 3, \"iterations\": 1000, "
+            "\"median_ns\": 2000.0, \"mad_ns\": 1000.0, "
+            "\"min_ns\": 1000.0, \"max_ns\": 3000.0}\n",
+            benchmark->toJSON());
+
+  benchmark->Cycles = { 10, 30, 20 };
+  benchmark->Instructions = { 50, 50 };
+  std::string json = benchmark->toJSON();
+  EXPECT_NE(std::string::npos,
+            json.find("\"median_cycles\": 20.0, \"mad_cycles\": 10.0"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"median_instructions\": 50.0, "
+                      "\"mad_instructions\": 0.0}"));
+  swift_benchmark_end(benchmark);
+}
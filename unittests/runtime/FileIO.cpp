@@ -0,0 +1,162 @@
+//===- swift/unittests/runtime/FileIO.cpp - File I/O tests ----------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/FileIO.h"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace swift;
+
+namespace {
+  /// A temporary file with the given contents, deleted at the end of the
+  /// test.
+  class TempFile {
+    char Path[64];
+
+  public:
+    TempFile(const std::string &contents) {
+      strcpy(Path, "/tmp/swift-fileio-XXXXXX");
+      int fd = mkstemp(Path);
+      EXPECT_GE(fd, 0);
+      EXPECT_EQ(ssize_t(contents.size()),
+                write(fd, contents.data(), contents.size()));
+      close(fd);
+    }
+
+    ~TempFile() {
+      unlink(Path);
+    }
+
+    const char *path() const { return Path; }
+  };
+}
+
+/// Read every line of the file with a buffered reader.
+static std::vector<std::string> readLines(const char *path,
+                                          char delimiter = '\n') {
+  std::vector<std::string> lines;
+  BufferedReader *reader = swift_reader_open(path);
+  int64_t length;
+  while ((length = swift_reader_nextLine(reader, delimiter)) >= 0)
+    lines.push_back(std::string(swift_reader_line(reader), length));
+  swift_reader_close(reader);
+  return lines;
+}
+
+TEST(FileIOTest, size) {
+  TempFile file("hello");
+  EXPECT_EQ(5, swift_file_size(file.path()));
+  int fd = swift_file_open(file.path());
+  EXPECT_EQ(5, swift_fd_size(fd));
+  EXPECT_EQ(0, swift_file_close(fd));
+
+  // Errors are reported, not asserted.
+  EXPECT_EQ(-1, swift_file_size("/nonexistent/file"));
+  EXPECT_EQ(-1, swift_file_open("/nonexistent/file"));
+  EXPECT_EQ(-1, swift_fd_size(-1));
+}
+
+TEST(FileIOTest, map) {
+  TempFile file("mapped contents");
+  int fd = swift_file_open(file.path());
+  const char *data = swift_file_map(fd, 15);
+  EXPECT_EQ(0, swift_file_close(fd));
+
+  // The mapping outlives the descriptor.
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ("mapped contents", std::string(data, 15));
+  EXPECT_EQ(0, swift_file_unmap(data, 15));
+
+  TempFile empty("");
+  fd = swift_file_open(empty.path());
+  data = swift_file_map(fd, 0);
+  EXPECT_NE(nullptr, data);
+  EXPECT_EQ(0, swift_file_unmap(data, 0));
+  swift_file_close(fd);
+}
+
+TEST(FileIOTest, mapUnmappable) {
+  // A pipe can't be mapped, so it's read instead, and a short read fails
+  // rather than returning a partly-filled view.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  EXPECT_EQ(3, write(fds[1], "abc", 3));
+  close(fds[1]);
+  EXPECT_EQ(nullptr, swift_file_map(fds[0], 10));
+  close(fds[0]);
+
+  ASSERT_EQ(0, pipe(fds));
+  EXPECT_EQ(3, write(fds[1], "abc", 3));
+  close(fds[1]);
+  const char *data = swift_file_map(fds[0], 3);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ("abc", std::string(data, 3));
+  EXPECT_EQ(0, swift_file_unmap(data, 3));
+  close(fds[0]);
+}
+
+TEST(FileIOTest, lines) {
+  TempFile file("one\ntwo\r\n\nlast");
+  std::vector<std::string> expected = { "one", "two", "", "last" };
+  EXPECT_EQ(expected, readLines(file.path()));
+
+  TempFile trailing("a\nb\n");
+  expected = { "a", "b" };
+  EXPECT_EQ(expected, readLines(trailing.path()));
+
+  TempFile fields("x,y,,z");
+  expected = { "x", "y", "", "z" };
+  EXPECT_EQ(expected, readLines(fields.path(), ','));
+
+  TempFile empty("");
+  EXPECT_TRUE(readLines(empty.path()).empty());
+
+  // A file that can't be opened has no lines.
+  EXPECT_TRUE(readLines("/nonexistent/file").empty());
+}
+
+TEST(FileIOTest, longLines) {
+  // Lines longer than the buffer, and lines that straddle buffer refills.
+  std::string huge(600 * 1024, 'x');
+  std::string contents;
+  std::vector<std::string> expected;
+  for (unsigned i = 0; i != 20000; ++i) {
+    expected.push_back(std::string(i % 97, 'a' + i % 26));
+    if (i == 7000)
+      expected.push_back(huge);
+  }
+  for (auto &line : expected)
+    contents += line + "\n";
+
+  TempFile file(contents);
+  EXPECT_EQ(expected, readLines(file.path()));
+}
+
+TEST(FileIOTest, read) {
+  TempFile file("abcdefgh");
+  BufferedReader *reader = swift_reader_open(file.path());
+  char buffer[4];
+  EXPECT_EQ('a', swift_reader_getc(reader));
+  EXPECT_EQ(3, swift_reader_read(reader, buffer, 3));
+  EXPECT_EQ("bcd", std::string(buffer, 3));
+
+  // Bytes, lines and characters all come from the same buffer.
+  EXPECT_EQ(3, swift_reader_nextLine(reader, 'h'));
+  EXPECT_EQ("efg", std::string(swift_reader_line(reader), 3));
+  EXPECT_EQ(-1, swift_reader_getc(reader));
+  EXPECT_EQ(0, swift_reader_read(reader, buffer, 4));
+  swift_reader_close(reader);
+}
@@ -0,0 +1,160 @@
+//===- swift/unittests/runtime/Formatting.cpp - Formatting tests ----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "../runtime/Formatting.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace swift;
+
+static std::string formatInt64(int64_t value, int64_t radix = 10) {
+  char buffer[MaxInt64Length];
+  return std::string(buffer,
+                     swift_int64ToString(buffer, sizeof(buffer), value, radix));
+}
+
+static std::string formatUInt64(uint64_t value, int64_t radix = 10) {
+  char buffer[MaxInt64Length];
+  return std::string(buffer,
+                     swift_uint64ToString(buffer, sizeof(buffer), value,
+                                          radix));
+}
+
+static std::string formatDouble(double value) {
+  char buffer[MaxDoubleLength];
+  return std::string(buffer,
+                     swift_doubleToString(buffer, sizeof(buffer), value));
+}
+
+TEST(FormattingTest, int64) {
+  EXPECT_EQ("0", formatInt64(0));
+  EXPECT_EQ("7", formatInt64(7));
+  EXPECT_EQ("42", formatInt64(42));
+  EXPECT_EQ("100", formatInt64(100));
+  EXPECT_EQ("-1", formatInt64(-1));
+  EXPECT_EQ("1234567890", formatInt64(1234567890));
+  EXPECT_EQ("9223372036854775807",
+            formatInt64(std::numeric_limits<int64_t>::max()));
+  EXPECT_EQ("-9223372036854775808",
+            formatInt64(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ("18446744073709551615",
+            formatUInt64(std::numeric_limits<uint64_t>::max()));
+
+  // Every length, and the boundaries around powers of ten.
+  uint64_t power = 1;
+  for (unsigned digits = 1; digits <= 19; ++digits, power *= 10) {
+    EXPECT_EQ(std::to_string(power), formatUInt64(power));
+    EXPECT_EQ(std::to_string(power - 1), formatUInt64(power - 1));
+    EXPECT_EQ(std::to_string(power + 1), formatUInt64(power + 1));
+  }
+}
+
+TEST(FormattingTest, int64Radix) {
+  EXPECT_EQ("5BBF", formatInt64(23487, 16));
+  EXPECT_EQ("-FF", formatInt64(-255, 16));
+  EXPECT_EQ("777", formatInt64(511, 8));
+  EXPECT_EQ("101", formatInt64(5, 2));
+  EXPECT_EQ("Z", formatInt64(35, 36));
+  EXPECT_EQ(std::string(64, '1'),
+            formatUInt64(std::numeric_limits<uint64_t>::max(), 2));
+  EXPECT_EQ("-1" + std::string(63, '0'),
+            formatInt64(std::numeric_limits<int64_t>::min(), 2));
+}
+
+TEST(FormattingTest, uint128) {
+  char buffer[128];
+  auto format = [&](__uint128_t value, uint64_t radix) {
+    return std::string(buffer,
+                       formatUInt128(buffer, sizeof(buffer), value, radix));
+  };
+
+  __uint128_t tenToThe19 = 10000000000000000000ULL;
+  EXPECT_EQ("18446744073709551616", format(__uint128_t(1) << 64, 10));
+  EXPECT_EQ("10000000000000000000000000000000000000",
+            format(tenToThe19 * tenToThe19 / 10, 10));
+  EXPECT_EQ("100000000000000000000000000000000000000",
+            format(tenToThe19 * tenToThe19, 10));
+  EXPECT_EQ("340282366920938463463374607431768211455",
+            format(~__uint128_t(0), 10));
+  EXPECT_EQ(std::string(32, 'F'), format(~__uint128_t(0), 16));
+}
+
+TEST(FormattingTest, doubleSpecialValues) {
+  EXPECT_EQ("0.0", formatDouble(0.0));
+  EXPECT_EQ("-0.0", formatDouble(-0.0));
+  EXPECT_EQ("inf", formatDouble(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("-inf", formatDouble(-std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("nan", formatDouble(std::numeric_limits<double>::quiet_NaN()));
+}
+
+TEST(FormattingTest, doubleShortest) {
+  EXPECT_EQ("1.0", formatDouble(1.0));
+  EXPECT_EQ("-2.5", formatDouble(-2.5));
+  EXPECT_EQ("0.1", formatDouble(0.1));
+  EXPECT_EQ("0.3", formatDouble(0.3));
+  EXPECT_EQ("0.30000000000000004", formatDouble(0.1 + 0.2));
+  EXPECT_EQ("0.6666666666666666", formatDouble(2.0 / 3.0));
+  EXPECT_EQ("3.14159", formatDouble(3.14159));
+  EXPECT_EQ("3.141592653589793", formatDouble(3.141592653589793));
+  EXPECT_EQ("123456789.0", formatDouble(123456789.0));
+  EXPECT_EQ("5e-324", formatDouble(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("2.2250738585072014e-308",
+            formatDouble(std::numeric_limits<double>::min()));
+  EXPECT_EQ("1.7976931348623157e+308",
+            formatDouble(std::numeric_limits<double>::max()));
+}
+
+TEST(FormattingTest, doubleNotation) {
+  // Positional from 1e-4 up to, but not including, 1e16.
+  EXPECT_EQ("0.0001", formatDouble(1e-4));
+  EXPECT_EQ("0.00012", formatDouble(1.2e-4));
+  EXPECT_EQ("1e-05", formatDouble(1e-5));
+  EXPECT_EQ("1.5e-07", formatDouble(1.5e-7));
+  EXPECT_EQ("1000000000000000.0", formatDouble(1e15));
+  EXPECT_EQ("9999999999999998.0", formatDouble(9999999999999998.0));
+  EXPECT_EQ("1e+16", formatDouble(1e16));
+  EXPECT_EQ("1.25e+20", formatDouble(1.25e20));
+  EXPECT_EQ("1e+100", formatDouble(1e100));
+}
+
+TEST(FormattingTest, doubleRoundTrips) {
+  std::mt19937_64 random(42);
+  for (unsigned i = 0; i != 1000000; ++i) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value != value || value - value != 0)
+      continue;
+
+    std::string text = formatDouble(value);
+    EXPECT_EQ(value, strtod(text.c_str(), nullptr)) << text;
+
+    // No shorter precision reads back as the same value.
+    std::string digits;
+    for (char c : text.substr(0, text.find('e')))
+      if (c >= '0' && c <= '9')
+        digits += c;
+    digits.erase(0, digits.find_first_not_of('0'));
+    digits.erase(digits.find_last_not_of('0') + 1);
+    if (digits.size() > 1) {
+      char shorter[32];
+      snprintf(shorter, sizeof(shorter), "%.*e", int(digits.size()) - 2,
+               value);
+      EXPECT_NE(value, strtod(shorter, nullptr)) << text;
+    }
+  }
+}
@@ -99,6 +99,8 @@ TEST(MetadataTest, getMetatypeMetadata) {
   MetadataTest2.getSize = nullptr;
   MetadataTest2.Description = nullptr;
   MetadataTest2.SuperClass = nullptr;
+  MetadataTest2.Depth = 0;
+  MetadataTest2.Ancestors = nullptr;
 
   auto inst3a = swift_getMetatypeMetadata(&MetadataTest2);
   auto inst3b = swift_getMetatypeMetadata(&MetadataTest2);
@@ -128,3 +130,153 @@ TEST(MetadataTest, getMetatypeMetadata) {
   ASSERT_EQ(inst3a, inst4a->InstanceType);
   ASSERT_EQ(inst1a, inst5a->InstanceType);
 }
+
+TEST(MetadataTest, getTupleTypeMetadata) {
+  const Metadata *intAndInt32[] = { &_TMdBi64_.base, &_TMdBi32_.base };
+  auto inst1a = swift_getTupleTypeMetadata(2, intAndInt32, nullptr, nullptr);
+  auto inst1b = swift_getTupleTypeMetadata(2, intAndInt32, nullptr, nullptr);
+  ASSERT_EQ(inst1a, inst1b);
+  ASSERT_EQ(size_t(2), inst1a->NumElements);
+  EXPECT_EQ(size_t(0), inst1a->getElements()[0].Offset);
+  EXPECT_EQ(size_t(8), inst1a->getElements()[1].Offset);
+  EXPECT_EQ(size_t(12), inst1a->Base.ValueWitnesses->size);
+  EXPECT_EQ(size_t(16), inst1a->Base.ValueWitnesses->stride);
+  EXPECT_TRUE(inst1a->Base.ValueWitnesses->isPOD());
+
+  // The labels are part of the type.  Equal labels strings name the same
+  // labels wherever they are.
+  static char labels1[] = "a b ";
+  static char labels2[] = "a b ";
+  static char labels3[] = "a c ";
+  auto inst2a = swift_getTupleTypeMetadata(2, intAndInt32, labels1, nullptr);
+  auto inst2b = swift_getTupleTypeMetadata(2, intAndInt32, labels2, nullptr);
+  auto inst3 = swift_getTupleTypeMetadata(2, intAndInt32, labels3, nullptr);
+  ASSERT_EQ(inst2a, inst2b);
+  ASSERT_NE(inst1a, inst2a);
+  ASSERT_NE(inst2a, inst3);
+  EXPECT_EQ(labels1, inst2a->Labels);
+
+  // ...but they don't affect the layout.
+  EXPECT_EQ(size_t(8), inst2a->getElements()[1].Offset);
+  EXPECT_EQ(inst1a->Base.ValueWitnesses, inst2a->Base.ValueWitnesses);
+  EXPECT_EQ(inst1a->Base.ValueWitnesses, inst3->Base.ValueWitnesses);
+
+  // POD tuples with the same size and alignment share value witnesses.
+  const Metadata *int32AndInt[] = { &_TMdBi32_.base, &_TMdBi64_.base };
+  const Metadata *intAndInt[] = { &_TMdBi64_.base, &_TMdBi64_.base };
+  auto inst4 = swift_getTupleTypeMetadata(2, int32AndInt, nullptr, nullptr);
+  auto inst5 = swift_getTupleTypeMetadata(2, intAndInt, nullptr, nullptr);
+  ASSERT_NE(inst4, inst5);
+  EXPECT_EQ(size_t(16), inst4->Base.ValueWitnesses->size);
+  EXPECT_EQ(inst4->Base.ValueWitnesses, inst5->Base.ValueWitnesses);
+
+  // Other tuples get witnesses of their own.
+  const Metadata *objectAndInt[] = { &_TMdBo.base, &_TMdBi64_.base };
+  auto inst6 = swift_getTupleTypeMetadata(2, objectAndInt, nullptr, nullptr);
+  EXPECT_FALSE(inst6->Base.ValueWitnesses->isPOD());
+  EXPECT_NE(inst5->Base.ValueWitnesses, inst6->Base.ValueWitnesses);
+  EXPECT_EQ(size_t(16), inst6->Base.ValueWitnesses->size);
+}
+
+TEST(MetadataTest, getTupleTypeMetadataArray) {
+  const Metadata *int8AndInt16[] = { &_TMdBi8_.base, &_TMdBi16_.base };
+  const Metadata *int16AndObject[] = { &_TMdBi16_.base, &_TMdBo.base };
+  auto existing = swift_getTupleTypeMetadata(2, int8AndInt16, nullptr,
+                                             nullptr);
+
+  static char labels[] = "x y ";
+  TupleTypeDescriptor tuples[] = {
+    { 2, int8AndInt16, nullptr, nullptr },
+    { 2, int16AndObject, nullptr, nullptr },
+    { 2, int8AndInt16, labels, nullptr },
+    { 2, int16AndObject, nullptr, nullptr },
+    { 0, nullptr, nullptr, nullptr }
+  };
+  const TupleTypeMetadata *results[5];
+  swift_getTupleTypeMetadataArray(5, tuples, results);
+
+  EXPECT_EQ(existing, results[0]);
+  EXPECT_EQ(results[1], results[3]);
+  EXPECT_NE(results[0], results[2]);
+  EXPECT_EQ(&_TMdT_, results[4]);
+  EXPECT_EQ(size_t(8), results[1]->getElements()[1].Offset);
+  EXPECT_EQ(labels, results[2]->Labels);
+
+  // The results are the same as fetching each tuple separately.
+  for (auto &tuple : tuples)
+    EXPECT_EQ(results[&tuple - tuples],
+              swift_getTupleTypeMetadata(tuple.NumElements, tuple.Elements,
+                                         tuple.Labels,
+                                         tuple.ProposedWitnesses));
+}
+
+/// A chain of fake class metadata, each a subclass of the one before it.
+const unsigned ChainDepth = 32;
+ClassMetadata Chain[ChainDepth];
+const ClassMetadata *ChainDisplay[ChainDepth];
+
+/// An unrelated root class.
+ClassMetadata Unrelated;
+const ClassMetadata *UnrelatedDisplay[] = { &Unrelated };
+
+static void fillOutClass(ClassMetadata &cls, const ClassMetadata *superClass,
+                         uintptr_t depth,
+                         const ClassMetadata * const *ancestors) {
+  cls.Kind = MetadataKind::Class;
+  cls.ValueWitnesses = &_TWVBo;
+  cls.destroy = nullptr;
+  cls.getSize = nullptr;
+  cls.Description = nullptr;
+  cls.SuperClass = superClass;
+  cls.Depth = depth;
+  cls.Ancestors = ancestors;
+}
+
+/// Fill out the chain, with or without ancestor displays.  Every class
+/// in the chain can share one display, since the ancestor at a given
+/// depth is the same for all of them.
+static void buildChain(bool withDisplay) {
+  for (unsigned i = 0; i != ChainDepth; ++i) {
+    fillOutClass(Chain[i], i ? &Chain[i-1] : nullptr, i,
+                 withDisplay ? ChainDisplay : nullptr);
+    ChainDisplay[i] = &Chain[i];
+  }
+  fillOutClass(Unrelated, nullptr, 0,
+               withDisplay ? UnrelatedDisplay : nullptr);
+}
+
+/// A fake heap object: just the isa pointer.
+struct FakeObject {
+  const ClassMetadata *isa;
+};
+
+TEST(MetadataTest, dynamicCast) {
+  for (bool withDisplay : { false, true }) {
+    buildChain(withDisplay);
+
+    FakeObject objects[ChainDepth];
+    for (unsigned i = 0; i != ChainDepth; ++i)
+      objects[i].isa = &Chain[i];
+    FakeObject unrelated = { &Unrelated };
+
+    for (unsigned i = 0; i != ChainDepth; ++i) {
+      for (unsigned j = 0; j != ChainDepth; ++j) {
+        const void *expected = j <= i ? &objects[i] : nullptr;
+        EXPECT_EQ(expected, swift_dynamicCast(&objects[i], &Chain[j]));
+      }
+      EXPECT_FALSE(swift_dynamicCast(&objects[i], &Unrelated));
+      EXPECT_FALSE(swift_dynamicCast(&unrelated, &Chain[i]));
+    }
+    EXPECT_EQ(&unrelated, swift_dynamicCast(&unrelated, &Unrelated));
+  }
+
+  // A class without a display, such as a generic instantiation, can
+  // still be cast to one with a display and vice versa.
+  buildChain(true);
+  Chain[ChainDepth-1].Ancestors = nullptr;
+  FakeObject leaf = { &Chain[ChainDepth-1] };
+  FakeObject root = { &Chain[0] };
+  EXPECT_EQ(&leaf, swift_dynamicCast(&leaf, &Chain[0]));
+  EXPECT_EQ(&leaf, swift_dynamicCast(&leaf, &Chain[ChainDepth-1]));
+  EXPECT_FALSE(swift_dynamicCast(&root, &Chain[ChainDepth-1]));
+}